@@ -4,6 +4,7 @@ import glob
 import mimetypes
 import numpy as np
 import os
+import queue
 import shutil
 import subprocess
 import torch
@@ -15,6 +16,11 @@ from tqdm import tqdm
 from realesrgan import RealESRGANer
 from realesrgan.archs.srvgg_arch import SRVGGNetCompact
 
+# dv2plex: input type is detected via mimetypes, whose built-in table (without /etc/mime.types, e.g. in
+# the bundled build) lacks Matroska and DV; chunks, the live file and preview clips are .mkv
+mimetypes.add_type('video/x-matroska', '.mkv')
+mimetypes.add_type('video/x-dv', '.dv')
+
 try:
     import os
     os.environ["PATH"] = r"C:\Users\luisb\PycharmProjects\ACR\dv2plex\bin\ffmpeg\bin;" + os.environ["PATH"]
@@ -32,26 +38,92 @@ def get_video_meta_info(video_path):
     ret['height'] = video_streams[0]['height']
     ret['fps'] = eval(video_streams[0]['avg_frame_rate'])
     ret['audio'] = ffmpeg.input(video_path).audio if has_audio else None
-    ret['nb_frames'] = int(video_streams[0]['nb_frames'])
+    if 'nb_frames' in video_streams[0]:
+        ret['nb_frames'] = int(video_streams[0]['nb_frames'])
+    else:  # dv2plex: mkv/some avi muxers don't store a frame count
+        duration = video_streams[0].get('duration') or probe['format']['duration']
+        ret['nb_frames'] = int(round(float(duration) * ret['fps']))
     return ret
 
 
-def get_sub_video(args, num_process, process_idx):
-    if num_process == 1:
-        return args.input
-    meta = get_video_meta_info(args.input)
-    duration = int(meta['nb_frames'] / meta['fps'])
-    part_time = duration // num_process
-    print(f'duration: {duration}, part_time: {part_time}')
-    os.makedirs(osp.join(args.output, f'{args.video_name}_inp_tmp_videos'), exist_ok=True)
-    out_path = osp.join(args.output, f'{args.video_name}_inp_tmp_videos', f'{process_idx:03d}.mp4')
-    cmd = [
-        args.ffmpeg_bin, f'-i {args.input}', '-ss', f'{part_time * process_idx}',
-        f'-to {part_time * (process_idx + 1)}' if process_idx != num_process - 1 else '', '-async 1', out_path, '-y'
-    ]
-    print(' '.join(cmd))
-    subprocess.call(' '.join(cmd), shell=True)
-    return out_path
+def parse_encoder_options(value):
+    """'crf=18,preset=veryfast' -> {'crf': '18', 'preset': 'veryfast'}"""
+    options = {}
+    for item in (value or '').split(','):
+        if '=' in item:
+            key, option = item.split('=', 1)
+            options[key.strip()] = option.strip()
+    return options
+
+
+def frame_ranges(nb_frames, num_chunks):
+    """dv2plex: split [0, nb_frames) into num_chunks consecutive (start, count) ranges"""
+    base, extra = divmod(nb_frames, num_chunks)
+    ranges, start = [], 0
+    for i in range(num_chunks):
+        count = base + (1 if i < extra else 0)
+        ranges.append((start, count))
+        start += count
+    return ranges
+
+
+def physical_cores():
+    """dv2plex: physical cores (SMT siblings share the FPU, so they add little for the model)"""
+    cores = set()
+    try:
+        with open('/proc/cpuinfo') as f:
+            physical_id = core_id = None
+            for line in f:
+                key, _, value = line.partition(':')
+                key = key.strip()
+                if key == 'physical id':
+                    physical_id = value.strip()
+                elif key == 'core id':
+                    core_id = value.strip()
+                elif not key:
+                    if core_id is not None:
+                        cores.add((physical_id, core_id))
+                    physical_id = core_id = None
+            if core_id is not None:
+                cores.add((physical_id, core_id))
+    except OSError:
+        pass
+    if cores:
+        return len(cores)
+    # no /proc/cpuinfo (Windows, macOS): assume two hardware threads per core
+    return max(1, (os.cpu_count() or 2) // 2)
+
+
+def resolve_device(args):
+    """dv2plex: --device auto picks CUDA when available; CPU inference always runs in fp32"""
+    if args.backend == 'onnx':  # CPU execution provider only
+        device = torch.device('cpu')
+    elif args.device == 'auto':
+        device = torch.device('cuda' if torch.cuda.is_available() else 'cpu')
+    else:
+        device = torch.device(args.device)
+    if device.type == 'cpu':
+        args.fp32 = True  # half precision is unsupported or emulated (slow) on CPU
+    return device
+
+
+def num_workers(args, device):
+    """dv2plex: --num_process, otherwise one process per GPU slot or per cpu_threads physical cores"""
+    if args.num_process > 0:
+        return args.num_process
+    if device.type == 'cuda':
+        return torch.cuda.device_count() * args.num_process_per_gpu
+    return max(1, physical_cores() // max(1, args.cpu_threads))
+
+
+def pin_cpu_threads(num_threads):
+    """dv2plex: limit torch and OpenCV threads so N worker processes don't oversubscribe the cores"""
+    torch.set_num_threads(num_threads)
+    try:
+        torch.set_num_interop_threads(1)
+    except RuntimeError:  # only allowed before the first parallel op
+        pass
+    cv2.setNumThreads(num_threads)
 
 
 class Reader:
@@ -63,18 +135,35 @@ class Reader:
         self.paths = []  # for image&folder type
         self.audio = None
         self.input_fps = None
+        self.start_frame = 0  # dv2plex: first source frame of this worker's chunk
         if self.input_type.startswith('video'):
-            video_path = get_sub_video(args, total_workers, worker_idx)
-            self.stream_reader = (
-                ffmpeg.input(video_path).output('pipe:', format='rawvideo', pix_fmt='bgr24',
-                                                loglevel='error').run_async(
-                                                    pipe_stdin=True, pipe_stdout=True, cmd=args.ffmpeg_bin))
-            meta = get_video_meta_info(video_path)
+            meta = get_video_meta_info(args.input)
             self.width = meta['width']
             self.height = meta['height']
             self.input_fps = meta['fps']
             self.audio = meta['audio']
             self.nb_frames = meta['nb_frames']
+            input_kwargs, output_kwargs = {}, {}
+            if total_workers > 1:
+                # dv2plex: each worker decodes only its frame range of the source. -ss before -i seeks
+                # to the preceding keyframe and decodes from there, so the chunk starts exactly at
+                # frame `start` (half a frame earlier to be safe against timestamp rounding).
+                start, count = frame_ranges(meta['nb_frames'], total_workers)[worker_idx]
+                if start:
+                    input_kwargs['ss'] = f'{(start - 0.5) / meta["fps"]:.6f}'
+                output_kwargs['vframes'] = count
+                self.start_frame = start
+                self.nb_frames = count
+                self.audio = None  # run() takes the audio of the whole source when concatenating
+            if args.crop:
+                # dv2plex: only the visible picture (no side bars / head-switching lines) reaches the model
+                crop_w, crop_h, crop_x, crop_y = (int(v) for v in args.crop.split(':'))
+                output_kwargs['vf'] = f'crop={crop_w}:{crop_h}:{crop_x}:{crop_y}'
+                self.width, self.height = crop_w, crop_h
+            self.stream_reader = (
+                ffmpeg.input(args.input, **input_kwargs).output(
+                    'pipe:', format='rawvideo', pix_fmt='bgr24', loglevel='error', **output_kwargs).run_async(
+                        pipe_stdin=True, pipe_stdout=True, cmd=args.ffmpeg_bin))
 
         else:
             if self.input_type.startswith('image'):
@@ -128,8 +217,10 @@ class Reader:
         else:
             return self.get_frame_from_list()
 
-    def close(self):
+    def close(self, abort=False):
         if self.input_type.startswith('video'):
+            if abort:  # dv2plex: stdout wird nicht mehr gelesen, ffmpeg würde sonst blockieren
+                self.stream_reader.kill()
             self.stream_reader.stdin.close()
             self.stream_reader.wait()
 
@@ -142,24 +233,24 @@ class Writer:
             print('You are generating video that is larger than 4K, which will be very slow due to IO speed.',
                   'We highly recommend to decrease the outscale(aka, -s).')
 
+        # dv2plex: with --final_size the model output is scaled and encoded in this one ffmpeg,
+        # so no intermediate video has to be written, decoded and scaled again
+        output_kwargs = dict(pix_fmt='yuv420p', vcodec=args.vcodec, loglevel='error')
+        if args.final_size:
+            final_width, final_height = args.final_size.lower().split('x')
+            output_kwargs['vf'] = f'scale={final_width}:{final_height}:flags=lanczos,setsar=1'
+        output_kwargs.update(parse_encoder_options(args.encoder_options))
+        video_input = ffmpeg.input('pipe:', format='rawvideo', pix_fmt='bgr24', s=f'{out_width}x{out_height}',
+                                   framerate=fps)
+
         if audio is not None:
             self.stream_writer = (
-                ffmpeg.input('pipe:', format='rawvideo', pix_fmt='bgr24', s=f'{out_width}x{out_height}',
-                             framerate=fps).output(
-                                 audio,
-                                 video_save_path,
-                                 pix_fmt='yuv420p',
-                                 vcodec='libx264',
-                                 loglevel='error',
-                                 acodec='copy').overwrite_output().run_async(
-                                     pipe_stdin=True, pipe_stdout=True, cmd=args.ffmpeg_bin))
+                video_input.output(audio, video_save_path, acodec='copy', **output_kwargs).overwrite_output().run_async(
+                    pipe_stdin=True, pipe_stdout=True, cmd=args.ffmpeg_bin))
         else:
             self.stream_writer = (
-                ffmpeg.input('pipe:', format='rawvideo', pix_fmt='bgr24', s=f'{out_width}x{out_height}',
-                             framerate=fps).output(
-                                 video_save_path, pix_fmt='yuv420p', vcodec='libx264',
-                                 loglevel='error').overwrite_output().run_async(
-                                     pipe_stdin=True, pipe_stdout=True, cmd=args.ffmpeg_bin))
+                video_input.output(video_save_path, **output_kwargs).overwrite_output().run_async(
+                    pipe_stdin=True, pipe_stdout=True, cmd=args.ffmpeg_bin))
 
     def write_frame(self, frame):
         frame = frame.astype(np.uint8).tobytes()
@@ -170,7 +261,8 @@ class Writer:
         self.stream_writer.wait()
 
 
-def inference_video(args, video_save_path, device=None, total_workers=1, worker_idx=0):
+def resolve_model(args):
+    """dv2plex: network architecture and weight files (downloaded on first use)"""
     # ---------------------- determine models according to model names ---------------------- #
     args.model_name = args.model_name.split('.pth')[0]
     if args.model_name == 'RealESRGAN_x4plus':  # x4 RRDBNet model
@@ -216,19 +308,37 @@ def inference_video(args, video_save_path, device=None, total_workers=1, worker_
         wdn_model_path = model_path.replace('realesr-general-x4v3', 'realesr-general-wdn-x4v3')
         model_path = [model_path, wdn_model_path]
         dni_weight = [args.denoise_strength, 1 - args.denoise_strength]
+    return model, netscale, model_path, dni_weight
+
+
+def prepare_model_files(args):
+    """dv2plex: download the weights (and export the ONNX model) once, before chunk processes race for them"""
+    model, netscale, model_path, dni_weight = resolve_model(args)
+    if args.backend == 'onnx':
+        from onnx_backend import prepare_onnx_model
+        prepare_onnx_model(args, model, netscale, model_path, dni_weight)
+
+
+def build_upsampler(args, device=None):
+    """dv2plex: model construction split out so a long-lived worker can keep it loaded"""
+    model, netscale, model_path, dni_weight = resolve_model(args)
 
     # restorer
-    upsampler = RealESRGANer(
-        scale=netscale,
-        model_path=model_path,
-        dni_weight=dni_weight,
-        model=model,
-        tile=args.tile,
-        tile_pad=args.tile_pad,
-        pre_pad=args.pre_pad,
-        half=not args.fp32,
-        device=device,
-    )
+    if args.backend == 'onnx':  # dv2plex: same pre/post-processing, network runs in ONNX Runtime
+        from onnx_backend import build_onnx_upsampler
+        upsampler = build_onnx_upsampler(args, model, netscale, model_path, dni_weight)
+    else:
+        upsampler = RealESRGANer(
+            scale=netscale,
+            model_path=model_path,
+            dni_weight=dni_weight,
+            model=model,
+            tile=args.tile,
+            tile_pad=args.tile_pad,
+            pre_pad=args.pre_pad,
+            half=not args.fp32,
+            device=device,
+        )
 
     if 'anime' in args.model_name and args.face_enhance:
         print('face_enhance is not supported in anime models, we turned this option off for you. '
@@ -245,6 +355,134 @@ def inference_video(args, video_save_path, device=None, total_workers=1, worker_
             bg_upsampler=upsampler)  # TODO support custom device
     else:
         face_enhancer = None
+    return upsampler, face_enhancer
+
+
+class DuplicateGate:
+    """
+    dv2plex: skip the network for frames (or tiles) that match the last processed input
+
+    Compares an 8x downscaled copy (area average, so tape noise mostly cancels out) by mean absolute
+    difference (0-255), taken per block of CELL x CELL downscaled pixels; the largest block decides,
+    so a small moving object can't hide in the mean of a mostly static frame. The reference is the
+    input that produced the current output, not simply the previous frame, so slow fades can't drift
+    unnoticed.
+    """
+
+    DOWNSCALE = 8
+    # 4 downscaled pixels = 32x32 input pixels per block
+    CELL = 4
+    # above this share of changed tiles one full-frame pass is cheaper than many padded tiles
+    MAX_TILE_SHARE = 0.5
+
+    def __init__(self, threshold, tile_size=0, tile_pad=10, outscale=4):
+        self.threshold = threshold
+        # tiles need an integer output scale to paste exactly; grid in downscaled pixels
+        self.tile_cells = tile_size // self.DOWNSCALE if float(outscale).is_integer() else 0
+        self.tile_pad = tile_pad
+        self.outscale = int(outscale)
+        self.reference = None
+        self.output = None
+        self.frames = self.skipped_frames = self.tiles = self.skipped_tiles = 0
+
+    def small(self, img):
+        height, width = img.shape[:2]
+        size = (max(1, width // self.DOWNSCALE), max(1, height // self.DOWNSCALE))
+        return cv2.resize(img, size, interpolation=cv2.INTER_AREA).astype(np.int16)
+
+    def process(self, img, enhance):
+        self.frames += 1
+        small = self.small(img)
+        if self.output is None or small.shape != self.reference.shape:
+            return self.full(img, small, enhance)
+        diff = np.abs(small - self.reference)
+        if not self.tile_cells:
+            if self.motion(diff) < self.threshold:
+                self.skipped_frames += 1
+                return self.output
+            return self.full(img, small, enhance)
+
+        cells = self.tile_cells
+        grid = [(y, x) for y in range(0, small.shape[0], cells) for x in range(0, small.shape[1], cells)]
+        changed = [(y, x) for y, x in grid if self.motion(diff[y:y + cells, x:x + cells]) >= self.threshold]
+        self.tiles += len(grid)
+        if not changed:
+            self.skipped_frames += 1
+            self.skipped_tiles += len(grid)
+            return self.output
+        if len(changed) > len(grid) * self.MAX_TILE_SHARE:
+            return self.full(img, small, enhance, count_tiles=False)
+        self.skipped_tiles += len(grid) - len(changed)
+        height, width = img.shape[:2]
+        scale, pad = self.outscale, self.tile_pad
+        for y, x in changed:
+            y0, x0 = y * self.DOWNSCALE, x * self.DOWNSCALE
+            # the last row/column of cells extends to the image border
+            y1 = height if y + cells >= small.shape[0] else (y + cells) * self.DOWNSCALE
+            x1 = width if x + cells >= small.shape[1] else (x + cells) * self.DOWNSCALE
+            py0, px0 = max(0, y0 - pad), max(0, x0 - pad)
+            py1, px1 = min(height, y1 + pad), min(width, x1 + pad)
+            patch = enhance(img[py0:py1, px0:px1])
+            oy, ox = (y0 - py0) * scale, (x0 - px0) * scale
+            self.output[y0 * scale:y1 * scale, x0 * scale:x1 * scale] = \
+                patch[oy:oy + (y1 - y0) * scale, ox:ox + (x1 - x0) * scale]
+            self.reference[y:y + cells, x:x + cells] = small[y:y + cells, x:x + cells]
+        return self.output
+
+    def motion(self, diff):
+        """largest per-channel mean difference over the CELL x CELL blocks of diff"""
+        height, width = diff.shape[:2]
+        if height <= self.CELL and width <= self.CELL:
+            return diff.mean(axis=(0, 1)).max()
+        size = (-(-width // self.CELL), -(-height // self.CELL))
+        return cv2.resize(diff.astype(np.float32), size, interpolation=cv2.INTER_AREA).max()
+
+    def full(self, img, small, enhance, count_tiles=True):
+        if count_tiles and self.tile_cells:
+            self.tiles += len(range(0, small.shape[0], self.tile_cells)) * len(range(0, small.shape[1], self.tile_cells))
+        # own copy: tiles are pasted into it later
+        self.output = np.array(enhance(img), copy=True)
+        self.reference = small
+        return self.output
+
+    def stats(self):
+        return {
+            'frames': self.frames,
+            'skipped_frames': self.skipped_frames,
+            'tiles': self.tiles,
+            'skipped_tiles': self.skipped_tiles,
+        }
+
+
+def parse_time_ranges(value):
+    """dv2plex: "12.5-40,3600-3720" -> [(12.5, 40.0), (3600.0, 3720.0)] (seconds of the source)"""
+    ranges = []
+    for item in (value or '').split(','):
+        if item.strip():
+            start, end = item.split('-')
+            ranges.append((float(start), float(end)))
+    return ranges
+
+
+def format_skip_stats(stats):
+    """dv2plex: one summary line, also parsed by the dv2plex UpscaleEngine"""
+    frames = max(1, stats['frames'])
+    line = f'skipped {stats["skipped_frames"]}/{stats["frames"]} frames ({100 * stats["skipped_frames"] / frames:.1f}%)'
+    if stats['tiles']:
+        line += f', {stats["skipped_tiles"]}/{stats["tiles"]} tiles ({100 * stats["skipped_tiles"] / stats["tiles"]:.1f}%)'
+    if stats.get('passthrough_frames'):
+        line += f', {stats["passthrough_frames"]} frames passthrough (lanczos)'
+    return line
+
+
+def inference_video(args, video_save_path, device=None, total_workers=1, worker_idx=0, models=None,
+                    progress_callback=None):
+    """
+    models: (upsampler, face_enhancer) from build_upsampler (dv2plex worker), otherwise built here
+    progress_callback: called with (done, total) frames instead of the tqdm bar
+    returns the duplicate-gate statistics (see DuplicateGate.stats)
+    """
+    upsampler, face_enhancer = models if models is not None else build_upsampler(args, device)
 
     reader = Reader(args, total_workers, worker_idx)
     audio = reader.get_audio()
@@ -252,33 +490,119 @@ def inference_video(args, video_save_path, device=None, total_workers=1, worker_
     fps = reader.get_fps()
     writer = Writer(args, audio, height, width, video_save_path, fps)
 
-    pbar = tqdm(total=len(reader), unit='frame', desc='inference')
-    while True:
-        img = reader.get_frame()
-        if img is None:
-            break
-
-        try:
-            if args.face_enhance:
-                _, _, output = face_enhancer.enhance(img, has_aligned=False, only_center_face=False, paste_back=True)
-            else:
-                output, _ = upsampler.enhance(img, outscale=args.outscale)
-        except RuntimeError as error:
-            print('Error', error)
-            print('If you encounter CUDA out of memory, try to set --tile with a smaller number.')
+    def enhance(image):
+        if args.face_enhance:
+            _, _, output = face_enhancer.enhance(image, has_aligned=False, only_center_face=False, paste_back=True)
         else:
-            writer.write_frame(output)
+            output, _ = upsampler.enhance(image, outscale=args.outscale)
+        return output
+
+    # dv2plex: static shots and freeze frames reuse the previous output (face detection needs whole frames)
+    gate = None
+    if args.skip_threshold > 0:
+        gate = DuplicateGate(
+            args.skip_threshold, 0 if args.face_enhance else args.skip_tile_size, args.tile_pad, args.outscale)
+
+    # dv2plex: dead segments (blue screen, black, snow) only get a cheap Lanczos scale
+    passthrough = parse_time_ranges(args.passthrough_ranges)
+    passthrough_frames = 0
+    source_fps = reader.input_fps or fps
+
+    pbar = tqdm(total=len(reader), unit='frame', desc='inference', disable=progress_callback is not None)
+    finished = False
+    try:
+        while True:
+            img = reader.get_frame()
+            if img is None:
+                break
+
+            frame_time = (reader.start_frame + pbar.n) / source_fps
+            try:
+                if passthrough and any(start <= frame_time < end for start, end in passthrough):
+                    output = cv2.resize(
+                        img, (int(width * args.outscale), int(height * args.outscale)),
+                        interpolation=cv2.INTER_LANCZOS4)
+                    passthrough_frames += 1
+                else:
+                    output = gate.process(img, enhance) if gate is not None else enhance(img)
+            except RuntimeError as error:
+                print('Error', error)
+                print('If you encounter CUDA out of memory, try to set --tile with a smaller number.')
+            else:
+                writer.write_frame(output)
+
+            if upsampler.device.type == 'cuda':
+                torch.cuda.synchronize(upsampler.device)
+            pbar.update(1)
+            if progress_callback is not None:
+                progress_callback(pbar.n, len(reader))
+        finished = True
+    finally:
+        reader.close(abort=not finished)
+        writer.close()
+    stats = gate.stats() if gate is not None else {'skipped_frames': 0, 'tiles': 0, 'skipped_tiles': 0}
+    stats['frames'] = pbar.n
+    stats['passthrough_frames'] = passthrough_frames
+    if (gate is not None or passthrough) and progress_callback is None:
+        print(format_skip_stats(stats))
+    return stats
+
+
+def model_key(args):
+    """dv2plex: settings that need a different upsampler instance"""
+    return (args.model_name.split('.pth')[0], args.tile, args.tile_pad, args.pre_pad, args.fp32, args.face_enhance,
+            args.outscale, args.denoise_strength, args.backend, args.int8)
+
+
+# dv2plex: upsampler of a ChunkPool process, kept between jobs (one model per process)
+_process_models = {}
+
+
+def inference_worker(args, video_save_path, device, total_workers, worker_idx, frame_queue, keep_models=False):
+    """dv2plex: pool process for one chunk, reports every finished frame through frame_queue"""
+    if device.type == 'cpu':
+        pin_cpu_threads(args.cpu_threads)
+    models = None
+    if keep_models:
+        key = model_key(args) + (str(device),)
+        if key not in _process_models:
+            _process_models.clear()
+            _process_models[key] = build_upsampler(args, device)
+        models = _process_models[key]
+    return inference_video(args, video_save_path, device, total_workers, worker_idx, models=models,
+                           progress_callback=lambda done, total: frame_queue.put(1))
+
+
+class ChunkPool:
+    """
+    dv2plex: spawn pool whose processes keep torch, basicsr and their upsampler loaded between jobs
 
-        torch.cuda.synchronize(device)
-        pbar.update(1)
+    Owned by upscale_server (one pool per model and process count); run() without a pool creates a
+    throwaway one. A cancelled or failed job leaves chunks running, so the pool is closed then.
+    """
+
+    def __init__(self, num_process):
+        ctx = torch.multiprocessing.get_context('spawn')
+        self.num_process = num_process
+        self.manager = ctx.Manager()
+        self.frame_queue = self.manager.Queue()
+        self.pool = ctx.Pool(num_process)
+        self.closed = False
 
-    reader.close()
-    writer.close()
+    def close(self):
+        if self.closed:
+            return
+        self.closed = True
+        self.pool.terminate()
+        self.manager.shutdown()
 
 
-def run(args):
+def run(args, progress_callback=None, chunk_pool=None):
+    """
+    chunk_pool: persistent ChunkPool of the dv2plex worker (models stay loaded), otherwise one per call
+    """
     args.video_name = osp.splitext(os.path.basename(args.input))[0]
-    video_save_path = osp.join(args.output, f'{args.video_name}_{args.suffix}.mp4')
+    video_save_path = args.save_path or osp.join(args.output, f'{args.video_name}_{args.suffix}.mp4')
 
     if args.extract_frame_first:
         tmp_frames_folder = osp.join(args.output, f'{args.video_name}_inp_tmp_frames')
@@ -286,48 +610,74 @@ def run(args):
         os.system(f'ffmpeg -i {args.input} -qscale:v 1 -qmin 1 -qmax 1 -vsync 0  {tmp_frames_folder}/frame%08d.png')
         args.input = tmp_frames_folder
 
+    device = resolve_device(args)
+    is_video = (mimetypes.guess_type(args.input)[0] or '').startswith('video')
+    if is_video:
+        nb_frames = get_video_meta_info(args.input)['nb_frames']
+    else:
+        nb_frames = len(glob.glob(os.path.join(args.input, '*'))) if osp.isdir(args.input) else 1
+    num_process = min(chunk_pool.num_process if chunk_pool else num_workers(args, device), nb_frames)
+    if num_process <= 1:
+        return inference_video(args, video_save_path, device, progress_callback=progress_callback)
+    # dv2plex: weights and ONNX export once here, not concurrently in every pool process
+    prepare_model_files(args)
+
     num_gpus = torch.cuda.device_count()
-    num_process = num_gpus * args.num_process_per_gpu
-    if num_process == 1:
-        inference_video(args, video_save_path)
-        return
-
-    ctx = torch.multiprocessing.get_context('spawn')
-    pool = ctx.Pool(num_process)
-    os.makedirs(osp.join(args.output, f'{args.video_name}_out_tmp_videos'), exist_ok=True)
-    pbar = tqdm(total=num_process, unit='sub_video', desc='inference')
-    for i in range(num_process):
-        sub_video_save_path = osp.join(args.output, f'{args.video_name}_out_tmp_videos', f'{i:03d}.mp4')
-        pool.apply_async(
-            inference_video,
-            args=(args, sub_video_save_path, torch.device(i % num_gpus), num_process, i),
-            callback=lambda arg: pbar.update(1))
-    pool.close()
-    pool.join()
-
-    # combine sub videos
-    # prepare vidlist.txt
-    with open(f'{args.output}/{args.video_name}_vidlist.txt', 'w') as f:
+    owned = chunk_pool is None
+    if owned:
+        chunk_pool = ChunkPool(num_process)
+    frame_queue = chunk_pool.frame_queue
+    finished = False
+    tmp_dir = osp.join(args.output, f'{args.video_name}_out_tmp_videos')
+    os.makedirs(tmp_dir, exist_ok=True)
+    print(f'{num_process} processes on {device.type}'
+          + (f', {args.cpu_threads} threads each' if device.type == 'cpu' else ''))
+    pbar = tqdm(total=nb_frames, unit='frame', desc='inference', disable=progress_callback is not None)
+    try:
+        jobs = []
         for i in range(num_process):
-            f.write(f'file \'{args.video_name}_out_tmp_videos/{i:03d}.mp4\'\n')
-
-    cmd = [
-        args.ffmpeg_bin, '-f', 'concat', '-safe', '0', '-i', f'{args.output}/{args.video_name}_vidlist.txt', '-c',
-        'copy', f'{video_save_path}'
-    ]
-    print(' '.join(cmd))
-    subprocess.call(cmd)
-    shutil.rmtree(osp.join(args.output, f'{args.video_name}_out_tmp_videos'))
-    if osp.exists(osp.join(args.output, f'{args.video_name}_inp_tmp_videos')):
-        shutil.rmtree(osp.join(args.output, f'{args.video_name}_inp_tmp_videos'))
-    os.remove(f'{args.output}/{args.video_name}_vidlist.txt')
-
-
-def main():
-    """Inference demo for Real-ESRGAN.
-    It mainly for restoring anime videos.
-
-    """
+            worker_device = torch.device('cuda', i % num_gpus) if device.type == 'cuda' else device
+            jobs.append(
+                chunk_pool.pool.apply_async(
+                    inference_worker,
+                    args=(args, osp.join(tmp_dir, f'{i:03d}.mp4'), worker_device, num_process, i, frame_queue,
+                          not owned)))
+        while not all(job.ready() for job in jobs) or not frame_queue.empty():
+            try:
+                pbar.update(frame_queue.get(timeout=0.5))
+            except queue.Empty:
+                continue
+            if progress_callback is not None:
+                progress_callback(pbar.n, nb_frames)
+        stats = {}
+        for job in jobs:
+            for key, value in job.get().items():  # re-raises errors of the worker processes
+                stats[key] = stats.get(key, 0) + value
+        pbar.close()
+        if (args.skip_threshold > 0 or args.passthrough_ranges) and progress_callback is None:
+            print(format_skip_stats(stats))
+
+        # combine the chunks in order; the audio comes from the untouched source
+        list_path = osp.join(tmp_dir, 'vidlist.txt')
+        with open(list_path, 'w') as f:
+            for i in range(num_process):
+                f.write(f'file \'{i:03d}.mp4\'\n')
+        cmd = [args.ffmpeg_bin, '-y', '-loglevel', 'error', '-f', 'concat', '-safe', '0', '-i', list_path]
+        if is_video and get_video_meta_info(args.input)['audio'] is not None:
+            cmd += ['-i', args.input, '-map', '0:v', '-map', '1:a']
+        cmd += ['-c', 'copy', video_save_path]
+        print(' '.join(cmd))
+        if subprocess.call(cmd) != 0:
+            raise RuntimeError('ffmpeg concat of the chunks failed')
+        finished = True
+        return stats
+    finally:
+        if owned or not finished:
+            chunk_pool.close()
+        shutil.rmtree(tmp_dir, ignore_errors=True)
+
+
+def build_parser():
     parser = argparse.ArgumentParser()
     parser.add_argument('-i', '--input', type=str, default='inputs', help='Input video, image or folder')
     parser.add_argument(
@@ -358,6 +708,28 @@ def main():
     parser.add_argument('--ffmpeg_bin', type=str, default='ffmpeg', help='The path to ffmpeg')
     parser.add_argument('--extract_frame_first', action='store_true')
     parser.add_argument('--num_process_per_gpu', type=int, default=1)
+    # dv2plex: CPU execution
+    parser.add_argument('--device', type=str, default='auto', help='auto | cpu | cuda')
+    parser.add_argument(
+        '--num_process', type=int, default=0,
+        help='Worker processes, 0 = GPUs * num_process_per_gpu or physical cores / cpu_threads on CPU')
+    parser.add_argument('--cpu_threads', type=int, default=2, help='Intra-op threads per CPU worker process')
+    parser.add_argument('--backend', type=str, default='torch', help='torch | onnx (ONNX Runtime, CPU)')
+    parser.add_argument('--int8', action='store_true', help='ONNX backend: use the int8-quantized model')
+    parser.add_argument(
+        '--skip_threshold', type=float, default=0,
+        help='Reuse the previous output when no 32x32 block of the frame differs by this mean (0-255) or more, 0 = off')
+    parser.add_argument(
+        '--passthrough_ranges', type=str, default='',
+        help='Source time ranges (s) scaled with Lanczos instead of the model, e.g. 3600-3720,4000-4100')
+    parser.add_argument(
+        '--skip_tile_size', type=int, default=0, help='Compare and recompute in tiles of this many input pixels, 0 = whole frames')
+    # dv2plex: fused model -> final encode
+    parser.add_argument('--save_path', type=str, default=None, help='Output video file (default: <output>/<name>_<suffix>.mp4)')
+    parser.add_argument('--final_size', type=str, default=None, help='Scale model output to WxH (lanczos) while encoding')
+    parser.add_argument('--crop', type=str, default='', help='Crop the input to W:H:X:Y before the model')
+    parser.add_argument('--vcodec', type=str, default='libx264', help='Video encoder of the output')
+    parser.add_argument('--encoder_options', type=str, default='', help='Encoder options, e.g. crf=18,preset=veryfast')
 
     parser.add_argument(
         '--alpha_upsampler',
@@ -369,6 +741,15 @@ def main():
         type=str,
         default='auto',
         help='Image extension. Options: auto | jpg | png, auto means using the same extension as inputs')
+    return parser
+
+
+def main():
+    """Inference demo for Real-ESRGAN.
+    It mainly for restoring anime videos.
+
+    """
+    parser = build_parser()
     args = parser.parse_args()
 
     args.input = args.input.rstrip('/').rstrip('\\')
@@ -0,0 +1,151 @@
+"""
+dv2plex: ONNX Runtime backend for the video inference script (--backend onnx)
+
+The selected model (including the denoise DNI blend of realesr-general-x4v3) is exported once to
+weights/onnx/ and then run with the CPU execution provider. With several chunk processes the parent
+exports before the pool starts (prepare_onnx_model via run()); temp files carry the pid, so even
+independent runs never write into the same file. Pre-/post-processing and tiling stay
+those of RealESRGANer; only the network call goes through the InferenceSession, so both backends
+produce frames the same way. --int8 uses a statically quantized (QDQ) copy calibrated on the
+bundled sample images in inputs/.
+"""
+
+import glob
+import os
+from os import path as osp
+
+import cv2
+import numpy as np
+import torch
+
+from realesrgan import RealESRGANer
+
+ROOT_DIR = osp.dirname(osp.abspath(__file__))
+ONNX_DIR = osp.join(ROOT_DIR, 'weights', 'onnx')
+ONNX_OPSET = 17
+CALIBRATION_TILE = 64
+CALIBRATION_TILES_PER_IMAGE = 4
+
+
+def onnx_model_path(args, int8=False):
+    name = args.model_name
+    if args.model_name == 'realesr-general-x4v3' and args.denoise_strength != 1:
+        name += f'_dn{int(round(args.denoise_strength * 100)):03d}'
+    return osp.join(ONNX_DIR, f'{name}_{"int8" if int8 else "fp32"}.onnx')
+
+
+def export_onnx(network, onnx_path):
+    """Export with dynamic height/width (tiles at the border are smaller)"""
+    os.makedirs(osp.dirname(onnx_path), exist_ok=True)
+    tmp_path = f'{onnx_path}.{os.getpid()}.tmp'
+    dummy = torch.rand(1, 3, CALIBRATION_TILE, CALIBRATION_TILE)
+    with torch.no_grad():
+        torch.onnx.export(
+            network.cpu().eval(),
+            dummy,
+            tmp_path,
+            opset_version=ONNX_OPSET,
+            input_names=['input'],
+            output_names=['output'],
+            dynamic_axes={'input': {2: 'height', 3: 'width'}, 'output': {2: 'height', 3: 'width'}})
+    os.replace(tmp_path, onnx_path)
+
+
+class CalibrationReader:
+    """Feeds RGB tiles of the bundled sample images to the int8 calibration"""
+
+    def __init__(self, input_name):
+        self.input_name = input_name
+        self.tiles = []
+        for image_path in sorted(glob.glob(osp.join(ROOT_DIR, 'inputs', '*'))):
+            img = cv2.imread(image_path, cv2.IMREAD_COLOR)
+            if img is None:
+                continue
+            img = cv2.cvtColor(img, cv2.COLOR_BGR2RGB).astype(np.float32) / 255.
+            height, width = img.shape[:2]
+            if height < CALIBRATION_TILE or width < CALIBRATION_TILE:
+                continue
+            for i in range(CALIBRATION_TILES_PER_IMAGE):
+                y = (height - CALIBRATION_TILE) * i // CALIBRATION_TILES_PER_IMAGE
+                x = (width - CALIBRATION_TILE) * (CALIBRATION_TILES_PER_IMAGE - 1 - i) // CALIBRATION_TILES_PER_IMAGE
+                tile = img[y:y + CALIBRATION_TILE, x:x + CALIBRATION_TILE]
+                self.tiles.append(np.ascontiguousarray(tile.transpose(2, 0, 1)[None]))
+        assert self.tiles, 'no calibration images in inputs/'
+
+    def get_next(self):
+        if not self.tiles:
+            return None
+        return {self.input_name: self.tiles.pop()}
+
+
+def quantize_int8(fp32_path, int8_path):
+    from onnxruntime.quantization import QuantFormat, QuantType, quantize_static
+
+    tmp_path = f'{int8_path}.{os.getpid()}.tmp'
+    quantize_static(
+        fp32_path,
+        tmp_path,
+        CalibrationReader('input'),
+        quant_format=QuantFormat.QDQ,
+        per_channel=True,
+        activation_type=QuantType.QUInt8,
+        weight_type=QuantType.QInt8)
+    os.replace(tmp_path, int8_path)
+
+
+class OnnxNetwork:
+    """Callable like the torch network: NCHW float tensor in, NCHW float tensor out"""
+
+    def __init__(self, onnx_path, num_threads):
+        import onnxruntime as ort
+
+        options = ort.SessionOptions()
+        options.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+        options.execution_mode = ort.ExecutionMode.ORT_SEQUENTIAL
+        options.intra_op_num_threads = num_threads
+        options.inter_op_num_threads = 1
+        self.session = ort.InferenceSession(onnx_path, options, providers=['CPUExecutionProvider'])
+        self.input_name = self.session.get_inputs()[0].name
+
+    def __call__(self, img):
+        output = self.session.run(None, {self.input_name: img.numpy()})[0]
+        return torch.from_numpy(output)
+
+
+class OnnxRealESRGANer(RealESRGANer):
+    """RealESRGANer whose network call runs in ONNX Runtime"""
+
+    def __init__(self, scale, network, tile=0, tile_pad=10, pre_pad=10):
+        self.scale = scale
+        self.tile_size = tile
+        self.tile_pad = tile_pad
+        self.pre_pad = pre_pad
+        self.mod_scale = None
+        self.half = False
+        self.device = torch.device('cpu')
+        self.model = network
+
+
+def prepare_onnx_model(args, model, netscale, model_path, dni_weight):
+    """Export and quantize on first use; returns the path of the model to load"""
+    fp32_path = onnx_model_path(args)
+    if not osp.isfile(fp32_path):
+        print(f'exporting {args.model_name} to {fp32_path}')
+        loaded = RealESRGANer(
+            scale=netscale, model_path=model_path, dni_weight=dni_weight, model=model, half=False,
+            device=torch.device('cpu'))
+        export_onnx(loaded.model, fp32_path)
+    if not args.int8:
+        return fp32_path
+    int8_path = onnx_model_path(args, int8=True)
+    if not osp.isfile(int8_path):
+        print(f'quantizing {fp32_path} to int8')
+        quantize_int8(fp32_path, int8_path)
+    return int8_path
+
+
+def build_onnx_upsampler(args, model, netscale, model_path, dni_weight):
+    """Load the ONNX model (exported first if missing); threads follow torch's intra-op setting"""
+    onnx_path = prepare_onnx_model(args, model, netscale, model_path, dni_weight)
+    network = OnnxNetwork(onnx_path, torch.get_num_threads())
+    return OnnxRealESRGANer(netscale, network, tile=args.tile, tile_pad=args.tile_pad, pre_pad=args.pre_pad)
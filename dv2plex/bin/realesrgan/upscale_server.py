@@ -0,0 +1,149 @@
+"""
+dv2plex: long-lived Real-ESRGAN worker
+
+Started by dv2plex.upscale_worker and reached over a multiprocessing connection (Unix socket,
+named pipe on Windows). torch, basicsr and the RealESRGANer instances stay loaded between jobs,
+so only the first job of a batch pays for imports and weight loading. Multi-process jobs (CPU host)
+reuse a ChunkPool whose processes keep their own model, across jobs and upscale chunks alike.
+One job per connection:
+
+    client -> {"type": "job", "argv": [...]}     same arguments as inference_realesrgan_video.py
+    server -> {"type": "status", "message": ...}
+    server -> {"type": "progress", "done": n, "total": m}
+    server -> {"type": "done", "ok": bool, "error": str}
+
+Closing the connection cancels the running job. The worker exits after --idle_timeout seconds
+without a job or when its parent process is gone.
+"""
+
+import argparse
+import os
+import sys
+import threading
+import time
+from collections import OrderedDict
+from multiprocessing.connection import Listener
+from os import path as osp
+
+import torch
+
+import inference_realesrgan_video as irv
+
+AUTHKEY_ENV = 'DV2PLEX_UPSCALE_AUTHKEY'
+MAX_CACHED_MODELS = 2
+PROGRESS_INTERVAL = 0.5
+
+
+class Server:
+
+    def __init__(self, address, idle_timeout, parent_pid):
+        self.listener = Listener(address, authkey=bytes.fromhex(os.environ.pop(AUTHKEY_ENV)))
+        self.idle_timeout = idle_timeout
+        self.parent_pid = parent_pid
+        self.models = OrderedDict()  # model_key -> (upsampler, face_enhancer), least recently used first
+        self.chunk_pool = None  # (key, irv.ChunkPool) of the last multi-process job
+        self.busy = False
+        self.last_activity = time.time()
+
+    def watchdog(self):
+        while True:
+            time.sleep(5)
+            parent_gone = self.parent_pid and os.getppid() != self.parent_pid
+            idle = not self.busy and time.time() - self.last_activity > self.idle_timeout
+            if parent_gone or idle:
+                self.listener.close()
+                if self.chunk_pool:
+                    self.chunk_pool[1].close()
+                os._exit(0)
+
+    def get_models(self, args, device):
+        key = irv.model_key(args) + (str(device),)
+        models = self.models.pop(key, None)
+        cached = models is not None
+        if models is None:
+            while len(self.models) >= MAX_CACHED_MODELS:
+                self.models.popitem(last=False)
+                if torch.cuda.is_available():
+                    torch.cuda.empty_cache()
+            models = irv.build_upsampler(args, device)
+        self.models[key] = models
+        return models, cached
+
+    def get_chunk_pool(self, args, device, num_process):
+        """Pool for multi-process jobs; a different model or process count replaces it (memory)"""
+        key = irv.model_key(args) + (str(device), num_process, args.cpu_threads)
+        if self.chunk_pool and (self.chunk_pool[0] != key or self.chunk_pool[1].closed):
+            self.chunk_pool[1].close()
+            self.chunk_pool = None
+        cached = self.chunk_pool is not None
+        if not cached:
+            self.chunk_pool = (key, irv.ChunkPool(num_process))
+        return self.chunk_pool[1], cached
+
+    def handle(self, conn):
+        request = conn.recv()
+        if request.get('type') == 'ping':
+            conn.send({'type': 'pong', 'models': len(self.models)})
+            return
+        args = irv.build_parser().parse_args(request['argv'])
+        args.input = args.input.rstrip('/').rstrip('\\')
+        os.makedirs(args.output, exist_ok=True)
+        args.video_name = osp.splitext(os.path.basename(args.input))[0]
+        video_save_path = args.save_path or osp.join(args.output, f'{args.video_name}_{args.suffix}.mp4')
+        device = irv.resolve_device(args)
+
+        last_sent = [0.0]
+
+        def progress(done, total):
+            now = time.time()
+            if done == total or now - last_sent[0] >= PROGRESS_INTERVAL:
+                last_sent[0] = now
+                conn.send({'type': 'progress', 'done': done, 'total': total})
+
+        num_process = irv.num_workers(args, device)
+        if num_process > 1:
+            # several chunk processes (CPU host): the pool processes keep their model between jobs
+            chunk_pool, cached = self.get_chunk_pool(args, device, num_process)
+            state = 'Modelle aus dem Speicher' if cached else 'Modelle werden geladen'
+            conn.send({'type': 'status', 'message': f'{num_process} Prozesse auf {device.type}, {state}'})
+            stats = irv.run(args, progress_callback=progress, chunk_pool=chunk_pool)
+        else:
+            models, cached = self.get_models(args, device)
+            conn.send({'type': 'status', 'message': 'Modell aus dem Speicher' if cached else 'Modell geladen'})
+            stats = irv.inference_video(args, video_save_path, device, models=models, progress_callback=progress)
+        if args.skip_threshold > 0 or args.passthrough_ranges:
+            conn.send({'type': 'status', 'message': irv.format_skip_stats(stats)})
+        conn.send({'type': 'done', 'ok': True, 'error': ''})
+
+    def serve(self):
+        threading.Thread(target=self.watchdog, daemon=True).start()
+        while True:
+            conn = self.listener.accept()
+            self.busy = True
+            try:
+                self.handle(conn)
+            except (EOFError, BrokenPipeError, ConnectionResetError):
+                print('client disconnected, job cancelled', file=sys.stderr)
+            except Exception as error:  # noqa: BLE001 - report every job error to the client
+                print(f'job failed: {error!r}', file=sys.stderr)
+                try:
+                    conn.send({'type': 'done', 'ok': False, 'error': str(error)})
+                except OSError:
+                    pass
+            finally:
+                conn.close()
+                self.busy = False
+                self.last_activity = time.time()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--address', required=True)
+    parser.add_argument('--idle_timeout', type=float, default=600)
+    parser.add_argument('--parent_pid', type=int, default=0)
+    opts = parser.parse_args()
+    Server(opts.address, opts.idle_timeout, opts.parent_pid).serve()
+
+
+if __name__ == '__main__':
+    main()
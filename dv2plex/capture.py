@@ -10,6 +10,7 @@ import subprocess
 import threading
 import time
 import shutil
+import uuid
 import urllib.request
 import urllib.error
 from datetime import datetime, timezone
@@ -18,6 +19,23 @@ from typing import Optional, Callable, IO
 from queue import Queue, Empty
 
 from .merge import MergeEngine
+from .merge_scheduler import MergeScheduler
+from .job_control import JobControl
+from .job_store import JobStore, KIND_MERGE, MAX_ATTEMPTS
+from .pipeline import (
+    RESOURCE_CPU,
+    STAGE_CAPTURE,
+    STAGE_MERGE,
+    STATE_COMPLETED,
+    STATE_FAILED,
+    shared_resources,
+)
+from .incremental_merge import IncrementalMerger
+from .split_watcher import SplitWatcher, EVENT_COMPLETED, EVENT_CREATED, SPLIT_PATTERNS
+from .split_manifest import SplitManifest
+from .tee_capture import TeeCapture
+from .dv_dif import DV_FRAME_SIZE_PAL, iter_dv_frames
+from .mjpeg_reader import MJPEGFrameExtractor
 
 from typing import Union
 
@@ -36,6 +54,20 @@ class MergeJob:
         self.started_at: Optional[float] = None
         self.completed_at: Optional[float] = None
         self.result_path: Optional[Path] = None
+        # Inkrementeller Merge: bereits während der Aufnahme kodierte Segmente
+        self.merger: Optional[IncrementalMerger] = None
+        # Split-Manifest der Aufnahme (Worker trägt evtl. noch die letzten Splits ein)
+        self.manifest: Optional[SplitManifest] = None
+        # Aufnahmezeit-Einblendung: "burn", "soft" oder "off"
+        self.timestamp_mode = "burn"
+        self.timestamp_duration = 4
+        # Parallele x264-Prozesse beim Re-Encode (0 = automatisch)
+        self.merge_workers = 0
+        # Scheduler: Kennung, Priorität (höher = früher) und ausführender Worker
+        self.job_id = uuid.uuid4().hex[:8]
+        self.priority = 0
+        self.sequence = 0
+        self.worker: Optional[int] = None
 
 
 class CaptureEngine:
@@ -48,6 +80,7 @@ class CaptureEngine:
         dvgrab_path: str = "dvgrab",
         log_callback: Optional[Callable[[str], None]] = None,
         state_callback: Optional[Callable[[str], None]] = None,
+        job_store: Optional[JobStore] = None,
     ):
         self.ffmpeg_path = ffmpeg_path
         self.device_path = device_path
@@ -73,27 +106,51 @@ class CaptureEngine:
         # Recording-Prozess (non-interaktiv)
         self.recording_dvgrab_process: Optional[subprocess.Popen] = None  # Non-interaktiver dvgrab für Aufnahme
         self.splits_dir: Optional[Path] = None  # Pfad zu LowRes/splits/
+        # Ereignisbasierte Überwachung des splits-Ordners (inotify, Fallback Polling)
+        self.split_watcher: Optional[SplitWatcher] = None
+        self.split_manifest: Optional[SplitManifest] = None
+        # Capture-Modus: "autosplit" (dvgrab schreibt Dateien) oder "tee" (dvgrab -> stdout -> TeeCapture)
+        self.capture_mode: str = "autosplit"
+        self.tee_capture: Optional[TeeCapture] = None
+        self.preview_stderr_thread: Optional[threading.Thread] = None
         # Preview-Queue-System
         self.preview_queue: Queue = Queue()  # Queue für Preview-Dateien
         self.preview_worker_thread: Optional[threading.Thread] = None  # Thread der Queue abarbeitet
         self.preview_monitor_thread: Optional[threading.Thread] = None  # Thread der neue Dateien zur Queue hinzufügt
         self.preview_file_process: Optional[subprocess.Popen] = None  # ffmpeg für Preview aus Datei
+        # Persistenter Preview-Decoder (autosplit): Splits werden nacheinander in einen ffmpeg-stdin geschrieben
+        self.preview_decoder_restarts: int = 0
+        self.preview_decoder_max_restarts: int = 3
+        # Zuletzt funktionierende Variante für Preview aus Datei (Fallback), wird nicht erneut geprobt
+        self.preview_file_variant: Optional[str] = None
         # Kompatibilität
         self.interactive_process: Optional[subprocess.Popen] = None  # Alias für interactive_dvgrab_process
         self.autosplit_dvgrab_process: Optional[subprocess.Popen] = None  # Alias für recording_dvgrab_process
         # sudo-Keepalive, damit Rechte während langer Läufe nicht ablaufen
         self.sudo_keepalive_thread: Optional[threading.Thread] = None
         self.sudo_keepalive_stop: Optional[threading.Event] = None
-        # Background-Merge-System
-        self.merge_queue: Queue = Queue()  # Queue für Merge-Jobs
+        # Background-Merge-System: Scheduler mit mehreren Workern, drosselt während Aufnahmen
         self.merge_jobs: list[MergeJob] = []  # Liste aller Jobs (für Status-Abfrage)
-        self.merge_worker_thread: Optional[threading.Thread] = None
-        self.merge_stop_event: Optional[threading.Event] = None
-        self.current_merge_job: Optional[MergeJob] = None
+        # Persistenter Job-Speicher: Merge-Jobs überstehen einen Neustart (siehe resume_merge_jobs)
+        self.job_store = job_store
+        self.merge_scheduler = MergeScheduler(
+            self._run_merge_job,
+            lambda: self.is_capturing,
+            log_callback=self.log,
+        )
         self.merge_progress_callback: Optional[Callable[[MergeJob], None]] = None
+        # Pipeline: Meldung fertiger Stufen (project_dir, stage, state, result); Kante Aufnahme → Merge
+        self.stage_callback: Optional[Callable[[Path, str, str, dict], None]] = None
+        self.auto_merge: bool = True
         # Aktueller Capture-Titel/Jahr für Merge-Jobs
         self.current_capture_title: str = ""
         self.current_capture_year: str = ""
+        # Inkrementeller Merge während der Aufnahme ("incremental") oder klassisch nach dem Stopp ("batch")
+        self.merge_mode: str = "batch"
+        self.timestamp_mode: str = "burn"
+        self.timestamp_duration: int = 4
+        self.merge_workers: int = 0
+        self.incremental_merger: Optional[IncrementalMerger] = None
         # Laufzeit-Tracking und verzögerte Benachrichtigung
         self.capture_start_time: Optional[float] = None
         self.capture_duration_thread: Optional[threading.Thread] = None
@@ -107,7 +164,7 @@ class CaptureEngine:
         self.last_dvgrab_command: Optional[list[str]] = None
         self.last_dvgrab_error: Optional[str] = None
         # Starte Background-Merge-Worker
-        self._start_merge_worker()
+        self.merge_scheduler.start()
 
     def _notify_state(self, state: str):
         """Optionaler Callback für Zustandsänderungen (z.B. stopped)"""
@@ -117,122 +174,298 @@ class CaptureEngine:
             except Exception:
                 pass
 
-    def _start_merge_worker(self):
-        """Startet den Background-Worker für Merge-Jobs"""
-        if self.merge_worker_thread and self.merge_worker_thread.is_alive():
-            return
+    def configure_merge_scheduler(self, max_jobs: int = 1, capture_policy: str = "nice", capture_jobs: int = 1):
+        """
+        Setzt die Limits des Merge-Schedulers
         
-        self.merge_stop_event = threading.Event()
-        self.merge_worker_thread = threading.Thread(
-            target=self._merge_worker_loop,
-            daemon=True,
-            name="MergeWorker"
+        Args:
+            max_jobs: Gleichzeitige Merge-Jobs
+            capture_policy: Während einer Aufnahme "nice" (drosseln), "pause" (anhalten) oder "off"
+            capture_jobs: Gleichzeitige Merge-Jobs während einer Aufnahme (Policy "nice")
+        """
+        self.merge_scheduler.configure(
+            max_workers=max_jobs, capture_policy=capture_policy, capture_workers=capture_jobs
         )
-        self.merge_worker_thread.start()
-        self.log("Background-Merge-Worker gestartet")
 
-    def _merge_worker_loop(self):
-        """Worker-Loop für Background-Merge"""
-        while not self.merge_stop_event.is_set():
+    def _report_stage(self, project_dir: Path, stage: str, state: str, result: Optional[dict] = None):
+        if self.stage_callback:
             try:
-                # Warte auf Job (mit Timeout für graceful shutdown)
-                try:
-                    job = self.merge_queue.get(timeout=1.0)
-                except Empty:
-                    continue
-                
-                # Verarbeite Job
-                self.current_merge_job = job
-                job.status = "running"
-                job.started_at = time.time()
-                job.message = "Merge gestartet..."
+                self.stage_callback(project_dir, stage, state, result or {})
+            except Exception as e:
+                self.log(f"Pipeline-Callback Fehler: {e}")
+
+    def _run_merge_job(self, job: MergeJob):
+        """Führt einen Merge-Job aus (im Worker-Thread des Schedulers, mit Slot aus dem CPU-Budget)"""
+        job.message = "Wartet auf freien CPU-Slot..."
+        self._notify_merge_progress(job)
+        with shared_resources().acquire(RESOURCE_CPU, f"Merge {job.title}"):
+            self._execute_merge_job(job)
+        self._report_stage(
+            job.splits_dir.parent.parent,
+            STAGE_MERGE,
+            STATE_COMPLETED if job.status == "completed" else STATE_FAILED,
+            {"path": str(job.result_path)} if job.result_path else {},
+        )
+
+    def _execute_merge_job(self, job: MergeJob):
+        job.status = "running"
+        job.started_at = time.time()
+        job.message = "Merge gestartet..."
+        if self.job_store:
+            attempt = self.job_store.start(job.job_id)
+            if attempt > 1:
+                job.message = f"Merge fortgesetzt (Versuch {attempt}/{MAX_ATTEMPTS})..."
+        self._notify_merge_progress(job)
+        
+        try:
+            self.log(f"Background-Merge: Starte {job.title} ({job.year})")
+            
+            def _on_progress(percent: int, message: str):
+                job.progress = percent
+                job.message = message
                 self._notify_merge_progress(job)
+
+            # Führe Merge durch (ffmpeg meldet Prozent/ETA über _on_progress)
+            merge_engine = MergeEngine(
+                self.ffmpeg_path,
+                log_callback=self.log,
+                timestamp_mode=job.timestamp_mode,
+                timestamp_duration=job.timestamp_duration,
+                encode_workers=job.merge_workers,
+                progress_callback=_on_progress,
+            )
+            if job.manifest:
+                job.manifest.stop(wait=True)
+                self._checkpoint_merge_job(job, "manifest", {"splits": len(job.manifest.entries)})
+            if (
+                job.merger is None
+                and job.output_path.suffix.lower() == ".mp4"
+                and IncrementalMerger.has_segments(job.splits_dir)
+            ):
+                # Segmente aus einem abgebrochenen Lauf weiterverwenden
+                self.log("Background-Merge: Setze inkrementellen Merge mit vorhandenen Segmenten fort")
+                job.merger = IncrementalMerger(
+                    self.ffmpeg_path,
+                    job.splits_dir,
+                    log_callback=self.log,
+                    timestamp_duration=job.timestamp_duration,
+                    timestamp_mode=job.timestamp_mode,
+                )
+
+            merged_file = None
+            if job.merger:
+                merged_file = job.merger.finish(
+                    job.output_path, progress_callback=_on_progress, manifest=job.manifest
+                )
+                if not merged_file:
+                    self.log("Background-Merge: Inkrementeller Merge fehlgeschlagen, verwende klassischen Merge")
+            if not merged_file:
+                merged_file = merge_engine.merge_splits(job.splits_dir, job.output_path, manifest=job.manifest)
+            
+            if merged_file and merged_file.exists():
+                job.status = "completed"
+                job.progress = 100
+                job.result_path = merged_file
+                job.message = f"Merge abgeschlossen: {merged_file.name}"
+                job.completed_at = time.time()
+                self._checkpoint_merge_job(job, "merged", {"path": str(merged_file)})
+                self.log(f"Background-Merge erfolgreich: {merged_file}")
                 
-                try:
-                    self.log(f"Background-Merge: Starte {job.title} ({job.year})")
-                    
-                    # Führe Merge durch
-                    merge_engine = MergeEngine(self.ffmpeg_path, log_callback=self.log)
-                    merged_file = merge_engine.merge_splits(job.splits_dir, job.output_path)
-                    
-                    if merged_file and merged_file.exists():
-                        job.status = "completed"
-                        job.progress = 100
-                        job.result_path = merged_file
-                        job.message = f"Merge abgeschlossen: {merged_file.name}"
-                        job.completed_at = time.time()
-                        self.log(f"Background-Merge erfolgreich: {merged_file}")
-                        
-                        # Sende Benachrichtigung
-                        self._notify_completion(f"Merge abgeschlossen: {job.title} ({job.year})")
-                    else:
-                        job.status = "failed"
-                        job.message = "Merge fehlgeschlagen"
-                        job.completed_at = time.time()
-                        self.log(f"Background-Merge fehlgeschlagen: {job.title}")
-                        self._notify_completion(f"Merge fehlgeschlagen: {job.title} ({job.year})")
-                    
-                except Exception as e:
-                    job.status = "failed"
-                    job.message = f"Fehler: {e}"
-                    job.completed_at = time.time()
-                    self.log(f"Background-Merge Fehler: {e}")
-                    self._notify_completion(f"Merge Fehler: {job.title} - {e}")
-                
-                finally:
-                    self._notify_merge_progress(job)
-                    self.current_merge_job = None
-                    self.merge_queue.task_done()
-                
-            except Exception as e:
-                self.log(f"Merge-Worker Fehler: {e}")
+                # Sende Benachrichtigung
+                self._notify_completion(f"Merge abgeschlossen: {job.title} ({job.year})")
+            else:
+                job.status = "failed"
+                job.message = "Merge fehlgeschlagen"
+                job.completed_at = time.time()
+                self.log(f"Background-Merge fehlgeschlagen: {job.title}")
+                self._notify_completion(f"Merge fehlgeschlagen: {job.title} ({job.year})")
+            
+        except Exception as e:
+            job.status = "failed"
+            job.message = f"Fehler: {e}"
+            job.completed_at = time.time()
+            self.log(f"Background-Merge Fehler: {e}")
+            self._notify_completion(f"Merge Fehler: {job.title} - {e}")
         
-        self.log("Background-Merge-Worker beendet")
+        finally:
+            if job.merger and job.merger.control:
+                self.merge_scheduler.unregister_control(job.merger.control)
+            if self.job_store:
+                self.job_store.finish(
+                    job.job_id,
+                    job.status == "completed",
+                    job.message,
+                    str(job.result_path) if job.result_path else None,
+                )
+            self._notify_merge_progress(job)
+
+    def _checkpoint_merge_job(self, job: MergeJob, stage: str, data: Optional[dict] = None):
+        if self.job_store:
+            self.job_store.checkpoint(job.job_id, stage, data)
 
     def _notify_merge_progress(self, job: MergeJob):
         """Benachrichtigt über Merge-Progress"""
+        if self.job_store and job.status == "running":
+            self.job_store.update(job.job_id, progress=job.progress, message=job.message)
         if self.merge_progress_callback:
             try:
                 self.merge_progress_callback(job)
             except Exception as e:
                 self.log(f"Merge-Progress-Callback Fehler: {e}")
 
-    def queue_merge_job(self, splits_dir: Path, output_path: Path, title: str = "", year: str = "") -> MergeJob:
-        """Fügt einen Merge-Job zur Queue hinzu"""
+    def queue_merge_job(
+        self,
+        splits_dir: Path,
+        output_path: Path,
+        title: str = "",
+        year: str = "",
+        merger: Optional[IncrementalMerger] = None,
+        manifest: Optional[SplitManifest] = None,
+        priority: int = 0,
+    ) -> MergeJob:
+        """Fügt einen Merge-Job zur Queue hinzu (höhere Priorität wird zuerst gestartet)"""
         job = MergeJob(splits_dir, output_path, title, year)
+        job.merger = merger
+        job.manifest = manifest
+        job.timestamp_mode = self.timestamp_mode
+        job.timestamp_duration = self.timestamp_duration
+        job.merge_workers = self.merge_workers
+        if self.job_store:
+            self.job_store.add(KIND_MERGE, self._merge_job_params(job), priority, job_id=job.job_id)
         self.merge_jobs.append(job)
-        self.merge_queue.put(job)
+        self.merge_scheduler.submit(job, priority)
         self.log(f"Merge-Job zur Queue hinzugefügt: {title} ({year})")
         return job
 
+    @staticmethod
+    def _merge_job_params(job: MergeJob) -> dict:
+        return {
+            "splits_dir": str(job.splits_dir),
+            "output_path": str(job.output_path),
+            "title": job.title,
+            "year": job.year,
+            "timestamp_mode": job.timestamp_mode,
+            "timestamp_duration": job.timestamp_duration,
+            "merge_workers": job.merge_workers,
+        }
+
+    def resume_merge_jobs(self) -> int:
+        """
+        Reiht nach einem Neustart die offenen Merge-Jobs aus dem Job-Speicher wieder ein.
+        
+        Jobs mit fertigem Merge-Ergebnis werden nur abgeschlossen. Alle anderen starten neu und
+        setzen über die vorhandenen Segmente (segments.json) bzw. das Split-Manifest nach der
+        letzten fertigen Stufe fort.
+        
+        Returns:
+            Anzahl wieder eingereihter Jobs
+        """
+        if not self.job_store:
+            return 0
+        resumed = 0
+        for record in self.job_store.recover(KIND_MERGE):
+            params = record["params"]
+            merged = record["checkpoints"].get("merged", {}).get("path")
+            if merged and Path(merged).exists():
+                self.job_store.finish(record["id"], True, f"Merge abgeschlossen: {Path(merged).name}", merged)
+                continue
+            splits_dir = Path(params.get("splits_dir", ""))
+            if not splits_dir.is_dir():
+                self.job_store.finish(record["id"], False, f"Split-Ordner fehlt: {splits_dir}")
+                continue
+            job = MergeJob(splits_dir, Path(params["output_path"]), params.get("title", ""), params.get("year", ""))
+            job.job_id = record["id"]
+            job.timestamp_mode = params.get("timestamp_mode", self.timestamp_mode)
+            job.timestamp_duration = params.get("timestamp_duration", self.timestamp_duration)
+            job.merge_workers = params.get("merge_workers", self.merge_workers)
+            job.progress = record["progress"]
+            job.message = record["message"]
+            self.merge_jobs.append(job)
+            self.merge_scheduler.submit(job, record["priority"])
+            resumed += 1
+            self.log(f"Merge-Job nach Neustart wieder eingereiht: {job.title} ({job.year})")
+        return resumed
+
+    @staticmethod
+    def _merge_job_info(job: MergeJob) -> dict:
+        return {
+            "id": job.job_id,
+            "title": job.title,
+            "year": job.year,
+            "status": job.status,
+            "progress": job.progress,
+            "message": job.message,
+            "priority": job.priority,
+            "worker": job.worker,
+        }
+
     def get_merge_queue_status(self) -> dict:
-        """Gibt den Status der Merge-Queue zurück"""
-        pending = [j for j in self.merge_jobs if j.status == "pending"]
-        running = self.current_merge_job
+        """Gibt den Status der Merge-Queue zurück (laufende Jobs je Worker, wartende nach Priorität)"""
+        scheduler = self.merge_scheduler
+        workers = scheduler.worker_states()
+        waiting = scheduler.pending_jobs()
+        running = [w["job"] for w in workers if w["job"] is not None]
         completed = [j for j in self.merge_jobs if j.status in ("completed", "failed")]
         
         return {
-            "pending_count": len(pending),
-            "current_job": {
-                "title": running.title,
-                "year": running.year,
-                "progress": running.progress,
-                "message": running.message,
-                "status": running.status
-            } if running else None,
-            "completed_count": len(completed),
-            "jobs": [
+            "max_workers": scheduler.max_workers,
+            "capture_active": scheduler.capture_active,
+            "capture_policy": scheduler.capture_policy,
+            "workers": [
                 {
-                    "title": j.title,
-                    "year": j.year,
-                    "status": j.status,
-                    "progress": j.progress,
-                    "message": j.message
+                    "worker": w["worker"],
+                    "state": w["state"],
+                    "job": self._merge_job_info(w["job"]) if w["job"] is not None else None,
                 }
-                for j in self.merge_jobs[-10:]  # Letzte 10 Jobs
-            ]
+                for w in workers
+            ],
+            "waiting": [self._merge_job_info(j) for j in waiting],
+            "pending_count": len(waiting),
+            "running_count": len(running),
+            "current_job": self._merge_job_info(running[0]) if running else None,
+            "completed_count": len(completed),
+            "jobs": self._recent_merge_jobs(),  # Letzte 10 Jobs
         }
 
+    def _recent_merge_jobs(self, limit: int = 10) -> list[dict]:
+        """Letzte Jobs, aus dem Job-Speicher (inkl. Jobs vor einem Neustart)"""
+        if not self.job_store:
+            return [self._merge_job_info(j) for j in self.merge_jobs[-limit:]]
+        live = {j.job_id: j for j in self.merge_jobs}
+        jobs = []
+        for record in reversed(self.job_store.list(KIND_MERGE, limit=limit)):
+            job = live.get(record["id"])
+            if job is not None:
+                jobs.append(self._merge_job_info(job))
+                continue
+            params = record["params"]
+            jobs.append({
+                "id": record["id"],
+                "title": params.get("title", ""),
+                "year": params.get("year", ""),
+                "status": record["status"],
+                "progress": record["progress"],
+                "message": record["message"],
+                "priority": record["priority"],
+                "worker": None,
+            })
+        return jobs
+
+    def set_merge_job_priority(self, job_id: str, priority: int) -> bool:
+        """Ändert die Priorität eines wartenden Merge-Jobs"""
+        for job in self.merge_jobs:
+            if job.job_id == job_id:
+                if not self.merge_scheduler.set_priority(job, priority):
+                    return False
+                if self.job_store:
+                    self.job_store.update(job_id, priority=priority)
+                return True
+        return False
+
+    def has_active_merge(self) -> bool:
+        """True, solange ein Merge-Job läuft oder wartet"""
+        return self.merge_scheduler.has_work()
+
     def clear_completed_merge_jobs(self):
         """Entfernt abgeschlossene Jobs aus der Liste"""
         self.merge_jobs = [j for j in self.merge_jobs if j.status in ("pending", "running")]
@@ -458,13 +691,16 @@ class CaptureEngine:
             self.interactive_dvgrab_process = None
             return False
 
-    def _start_recording_dvgrab(self, device: str, splits_dir: Path, use_rewind: bool = True) -> bool:
+    def _start_recording_dvgrab(
+        self, device: str, splits_dir: Path, use_rewind: bool = True, to_stdout: bool = False
+    ) -> bool:
         """
         Startet non-interaktiven dvgrab für Aufnahme mit autosplit
         
         Args:
             device: FireWire-Gerät
             splits_dir: Ausgabeordner für Split-Dateien
+            to_stdout: Roh-DV nach stdout statt Dateien (Tee-Modus, Splits schreibt TeeCapture)
         
         Returns:
             True wenn erfolgreich gestartet
@@ -487,12 +723,18 @@ class CaptureEngine:
             base_cmd = [self.dvgrab_path] + self._format_device_for_dvgrab(device)
             if use_rewind:
                 base_cmd.append("-rewind")  # Automatisches Rewind (optional)
-            base_cmd += [
-                "-autosplit",  # Autosplit bei Szenenänderungen
-                "-t",  # Timestamp im Dateinamen
-                "-f", "dv1",  # DV Type 1 Format
-                output_prefix,  # Ausgabe-Präfix (dvgrab fügt Timestamp hinzu)
-            ]
+            if to_stdout:
+                base_cmd += [
+                    "-f", "raw",  # Roher DIF-Stream
+                    "-",  # Ausgabe nach stdout
+                ]
+            else:
+                base_cmd += [
+                    "-autosplit",  # Autosplit bei Szenenänderungen
+                    "-t",  # Timestamp im Dateinamen
+                    "-f", "dv1",  # DV Type 1 Format
+                    output_prefix,  # Ausgabe-Präfix (dvgrab fügt Timestamp hinzu)
+                ]
             dvgrab_cmd = base_cmd
             
             # Wenn nicht root, versuche mit sudo
@@ -517,12 +759,18 @@ class CaptureEngine:
                 text=False,
                 bufsize=0,
             )
+            # Tee-Modus: stdout sofort lesen, sonst staut sich die Pipe während der Startpause
+            if to_stdout:
+                self._start_tee_capture()
             
             # Warte kurz, damit der Prozess startet
             time.sleep(1)
             
             if self.recording_dvgrab_process.poll() is None:
-                self.log("Recording dvgrab gestartet (non-interaktiv mit autosplit)")
+                self.log(
+                    "Recording dvgrab gestartet (non-interaktiv, "
+                    + ("Roh-DV nach stdout)" if to_stdout else "mit autosplit)")
+                )
                 # Setze auch autosplit_dvgrab_process für Kompatibilität
                 self.autosplit_dvgrab_process = self.recording_dvgrab_process
                 return True
@@ -549,6 +797,7 @@ class CaptureEngine:
                         f"dvgrab-Start fehlgeschlagen (Code {self.recording_dvgrab_process.returncode})."
                     )
                 
+                self._stop_tee_capture()
                 self.recording_dvgrab_process = None
                 return False
                 
@@ -581,7 +830,7 @@ class CaptureEngine:
                 self.log(f"Preview: Datei zu klein ({file_path.name}, {file_size} bytes) – überspringe.")
                 return None
             
-            def launch(cmd_desc, cmd_list):
+            def launch(cmd_desc, cmd_list, probe: bool = True):
                 # Knapp loggen, um Spam zu vermeiden
                 self.log(f"Preview: ffmpeg {cmd_desc} startet für {file_path.name}")
                 proc = subprocess.Popen(
@@ -591,6 +840,8 @@ class CaptureEngine:
                     text=False,
                     bufsize=0,
                 )
+                if not probe:
+                    return proc
                 time.sleep(0.3)
                 poll = proc.poll()
                 if poll is not None:
@@ -598,58 +849,62 @@ class CaptureEngine:
                     return None
                 return proc
 
-            # Variante 1: Standard lesen (AVI / DV im Container)
-            avi_cmd = [
-                str(self.ffmpeg_path),
-                "-hide_banner",
-                "-loglevel", "error",
-                "-fflags", "+genpts+igndts",
-                "-analyzeduration", "10000000",
-                "-probesize", "10000000",
-                "-i", str(file_path),
-                "-vf", f"yadif,fps={fps},scale=640:-1",
-                "-vcodec", "mjpeg",
-                "-f", "image2pipe",
-                "-q:v", "5",
-                "-",
-            ]
-            process = launch("avi", avi_cmd)
-            if process:
-                return process
-
-            # Variante 2: Roh-DV erzwingen (wenn Index fehlt / .dv)
-            raw_dv_cmd = [
-                str(self.ffmpeg_path),
-                "-hide_banner",
-                "-loglevel", "error",
-                "-f", "dv",
-                "-i", str(file_path),
-                "-vf", f"yadif,fps={fps},scale=640:-1",
-                "-vcodec", "mjpeg",
-                "-f", "image2pipe",
-                "-q:v", "5",
-                "-",
-            ]
-            process = launch("raw-dv", raw_dv_cmd)
-            if process:
-                return process
-
-            # Variante 3: Fehler ignorieren (Fallback)
-            fallback_cmd = [
-                str(self.ffmpeg_path),
-                "-hide_banner",
-                "-loglevel", "warning",
-                "-err_detect", "ignore_err",
-                "-fflags", "+genpts+discardcorrupt",
-                "-i", str(file_path),
-                "-vf", f"yadif,fps={fps},scale=640:-1",
-                "-vcodec", "mjpeg",
-                "-f", "image2pipe",
-                "-q:v", "7",
-                "-",
-            ]
-            process = launch("fallback", fallback_cmd)
-            return process
+            variants = {
+                # Variante 1: Standard lesen (AVI / DV im Container)
+                "avi": [
+                    str(self.ffmpeg_path),
+                    "-hide_banner",
+                    "-loglevel", "error",
+                    "-fflags", "+genpts+igndts",
+                    "-analyzeduration", "10000000",
+                    "-probesize", "10000000",
+                    "-i", str(file_path),
+                    "-vf", f"yadif,fps={fps},scale=640:-1",
+                    "-vcodec", "mjpeg",
+                    "-f", "image2pipe",
+                    "-q:v", "5",
+                    "-",
+                ],
+                # Variante 2: Roh-DV erzwingen (wenn Index fehlt / .dv)
+                "raw-dv": [
+                    str(self.ffmpeg_path),
+                    "-hide_banner",
+                    "-loglevel", "error",
+                    "-f", "dv",
+                    "-i", str(file_path),
+                    "-vf", f"yadif,fps={fps},scale=640:-1",
+                    "-vcodec", "mjpeg",
+                    "-f", "image2pipe",
+                    "-q:v", "5",
+                    "-",
+                ],
+                # Variante 3: Fehler ignorieren (Fallback)
+                "fallback": [
+                    str(self.ffmpeg_path),
+                    "-hide_banner",
+                    "-loglevel", "warning",
+                    "-err_detect", "ignore_err",
+                    "-fflags", "+genpts+discardcorrupt",
+                    "-i", str(file_path),
+                    "-vf", f"yadif,fps={fps},scale=640:-1",
+                    "-vcodec", "mjpeg",
+                    "-f", "image2pipe",
+                    "-q:v", "7",
+                    "-",
+                ],
+            }
+
+            # Bereits bewährte Variante direkt und ohne erneuten Health-Check starten
+            known = self.preview_file_variant
+            if known in variants:
+                return launch(known, variants[known], probe=False)
+
+            for name, cmd_list in variants.items():
+                process = launch(name, cmd_list)
+                if process:
+                    self.preview_file_variant = name
+                    return process
+            return None
             
         except Exception as e:
             self.log(f"Fehler beim Starten von Preview-ffmpeg aus Datei {file_path.name}: {e}")
@@ -657,7 +912,7 @@ class CaptureEngine:
 
     def _wait_for_file_complete(self, file_path: Path, max_wait: float = 5.0) -> bool:
         """
-        Wartet bis eine Datei vollständig geschrieben ist (nicht mehr wächst)
+        Wartet bis eine Datei vollständig geschrieben ist (über den Split-Watcher)
         
         Args:
             file_path: Pfad zur Datei
@@ -666,85 +921,155 @@ class CaptureEngine:
         Returns:
             True wenn Datei vollständig ist
         """
-        if not file_path.exists():
-            return False
-        
-        waited = 0.0
-        check_interval = 0.5
-        
-        while waited < max_wait:
-            size1 = file_path.stat().st_size
-            time.sleep(check_interval)
-            waited += check_interval
-            
-            if not file_path.exists():
-                return False
-            
-            size2 = file_path.stat().st_size
-            if size1 == size2 and size1 > 0:
-                return True
-        
-        # Timeout erreicht, aber Datei existiert und hat Größe > 0
+        if self.split_watcher:
+            return self.split_watcher.wait_for_file(file_path, timeout=max_wait)
         return file_path.exists() and file_path.stat().st_size > 0
 
+    def _start_split_watcher(self, splits_dir: Path):
+        """Startet den gemeinsamen Split-Watcher für den splits-Ordner"""
+        self._stop_split_watcher()
+        self.split_watcher = SplitWatcher(splits_dir, log_callback=self.log)
+        self.split_watcher.start()
+
+    def _stop_split_watcher(self):
+        """Beendet den Split-Watcher (falls aktiv)"""
+        if self.split_watcher:
+            self.split_watcher.stop()
+        self.split_watcher = None
+
+    def _wait_for_splits_stable(self, max_wait: float = 10.0) -> list[Path]:
+        """
+        Wartet nach dem Stoppen von dvgrab, bis alle Split-Dateien fertig geschrieben sind,
+        und beendet anschließend den Split-Watcher.
+        
+        Returns:
+            Liste der bekannten Split-Dateien (ohne Watcher: Inhalt des splits-Ordners)
+        """
+        self.log("Warte auf vollständiges Schreiben der Split-Dateien...")
+        split_files: list[Path] = []
+        if self.split_watcher and self.splits_dir and self.splits_dir.exists():
+            if self.split_watcher.wait_until_idle(timeout=max_wait):
+                self.log(f"Split-Dateien vollständig ({len(self.split_watcher.completed_files())} Dateien)")
+            split_files = self.split_watcher.known_files()
+        else:
+            time.sleep(2)
+            if self.splits_dir and self.splits_dir.exists():
+                split_files = sorted({p for pattern in SPLIT_PATTERNS for p in self.splits_dir.glob(pattern)})
+        self._stop_split_watcher()
+        return split_files
+
+    def _start_split_manifest(self):
+        """Trägt jeden fertigen Split ins Manifest (splits.json) ein, solange die Aufnahme läuft"""
+        self._stop_split_manifest()
+        watcher = self.split_watcher
+        if not watcher or not self.splits_dir:
+            return
+        manifest = SplitManifest(self.splits_dir, log_callback=self.log)
+        manifest.start()
+        watcher.subscribe(lambda _event, path: manifest.add_split(path), events={EVENT_COMPLETED})
+        self.split_manifest = manifest
+
+    def _take_split_manifest(self) -> Optional[SplitManifest]:
+        """Übergibt das Manifest an den Merge-Job (der Job wartet auf die letzten Einträge)"""
+        manifest, self.split_manifest = self.split_manifest, None
+        return manifest
+
+    def _stop_split_manifest(self):
+        manifest = self._take_split_manifest()
+        if manifest:
+            manifest.stop(wait=False)
+
+    def _start_incremental_merger(self):
+        """Kodiert jeden fertigen Split sofort zu einem Segment (nur für MP4-Ausgabe)"""
+        watcher = self.split_watcher
+        if not watcher or not self.splits_dir or not self.current_output_path:
+            return
+        if self.current_output_path.suffix.lower() != ".mp4":
+            return
+        # Kodiert während der Aufnahme: unterliegt der Capture-Policy des Merge-Schedulers
+        control = JobControl("Inkrementeller Merge")
+        self.merge_scheduler.register_control(control)
+        merger = IncrementalMerger(
+            self.ffmpeg_path,
+            self.splits_dir,
+            log_callback=self.log,
+            timestamp_duration=self.timestamp_duration,
+            timestamp_mode=self.timestamp_mode,
+            control=control,
+            split_manifest=self.split_manifest,
+        )
+        merger.start()
+        watcher.subscribe(lambda _event, path: merger.add_split(path), events={EVENT_COMPLETED})
+        self.incremental_merger = merger
+
+    def _take_incremental_merger(self) -> Optional[IncrementalMerger]:
+        """Übergibt den Merger an den Merge-Job (der Job wartet auf die letzten Segmente)"""
+        merger, self.incremental_merger = self.incremental_merger, None
+        return merger
+
+    def _stop_incremental_merger(self):
+        merger = self._take_incremental_merger()
+        if merger:
+            merger.stop()
+            if merger.control:
+                self.merge_scheduler.unregister_control(merger.control)
+
     def _monitor_splits_queue(self):
         """
-        Thread-Funktion: Überwacht splits-Ordner und fügt neue Dateien zur Queue hinzu
+        Thread-Funktion: Abonniert den Split-Watcher und fügt fertige Dateien zur Preview-Queue hinzu
         """
-        if not self.splits_dir:
-            self.log("Preview-Queue-Monitor: splits_dir nicht gesetzt")
+        if not self.splits_dir or not self.split_watcher:
+            self.log("Preview-Queue-Monitor: splits_dir/Split-Watcher nicht gesetzt")
             return
         
         self.log("Preview-Queue-Monitor: Starte Überwachung...")
-        known_files = set()
+        completed: Queue = Queue()
+        token = self.split_watcher.subscribe(
+            lambda _event, path: completed.put(path),
+            events={EVENT_COMPLETED},
+        )
         
         try:
             while (
                 self.is_capturing
                 and (not self.preview_stop_event or not self.preview_stop_event.is_set())
             ):
-                # Finde neue Dateien (dvgrab*.avi oder .dv – dvgrab schreibt ohne Bindestrich)
-                current_files = set(self.splits_dir.glob("dvgrab*.avi")) | set(self.splits_dir.glob("dvgrab*.dv"))
-                new_files = current_files - known_files
-                
-                for file_path in new_files:
-                    # Warte bis Datei vollständig geschrieben ist
-                    if self._wait_for_file_complete(file_path):
-                        self.preview_queue.put(file_path)
-                        known_files.add(file_path)
-                        self.last_split_time = time.time()
-                        self.log(f"Preview-Queue: Neue Datei hinzugefügt: {file_path.name}")
-                
-                time.sleep(0.5)  # Prüfe alle 0.5 Sekunden
+                try:
+                    file_path = completed.get(timeout=0.5)
+                except Empty:
+                    continue
+                self.preview_queue.put(file_path)
+                self.last_split_time = time.time()
+                self.log(f"Preview-Queue: Neue Datei hinzugefügt: {file_path.name}")
                 
         except Exception as e:
             self.log(f"Preview-Queue-Monitor: Fehler: {e}")
         finally:
+            watcher = self.split_watcher
+            if watcher:
+                watcher.unsubscribe(token)
             self.log("Preview-Queue-Monitor: Beendet")
 
     def _monitor_split_inactivity(self, timeout_seconds: int = 600):
         """
         Überwacht, ob neue Splits eintreffen. Stoppt NICHT mehr automatisch, nur Log-Hinweise.
         """
-        if not self.splits_dir:
+        watcher = self.split_watcher
+        if not self.splits_dir or not watcher:
             return
         
-        known_files = set(self.splits_dir.glob("dvgrab*.avi")) | set(self.splits_dir.glob("dvgrab*.dv"))
-        if known_files:
+        def _on_split(_event: str, _path: Path):
+            self.last_split_time = time.time()
+        
+        if watcher.known_files():
             self.last_split_time = time.time()
+        token = watcher.subscribe(_on_split, events={EVENT_CREATED})
         
         self.log("Inaktivitätsmonitor: gestartet")
         
         try:
             while self.is_capturing:
                 now = time.time()
-                
-                current_files = set(self.splits_dir.glob("dvgrab*.avi")) | set(self.splits_dir.glob("dvgrab*.dv"))
-                new_files = current_files - known_files
-                if new_files:
-                    self.last_split_time = now
-                    known_files |= new_files
-                
                 if self.last_split_time and (now - self.last_split_time) >= timeout_seconds:
                     # Nur informieren, nicht stoppen
                     minutes = timeout_seconds / 60
@@ -756,6 +1081,7 @@ class CaptureEngine:
         except Exception as e:
             self.log(f"Inaktivitätsmonitor: Fehler: {e}")
         finally:
+            watcher.unsubscribe(token)
             self.log("Inaktivitätsmonitor: beendet")
 
     def _play_file_for_preview(self, file_path: Path):
@@ -817,9 +1143,99 @@ class CaptureEngine:
                     except:
                         pass
 
+    def _ensure_preview_decoder(self) -> bool:
+        """
+        Stellt sicher, dass der persistente Preview-ffmpeg (DV über stdin -> MJPEG) läuft.
+
+        Returns:
+            False, wenn der Decoder nicht (mehr) verfügbar ist – dann Preview pro Datei
+        """
+        if self.preview_process and self.preview_process.poll() is None:
+            return True
+        if self.preview_decoder_restarts > self.preview_decoder_max_restarts:
+            return False
+        if self.preview_process:
+            self.log("Preview-Decoder: Prozess beendet, starte neu...")
+            self._stop_preview_decoder()
+        self.preview_decoder_restarts += 1
+        if not self._start_preview_ffmpeg(getattr(self, 'preview_fps', 10)):
+            self.log("Preview-Decoder: Start fehlgeschlagen - verwende Preview pro Datei")
+            self.preview_decoder_restarts = self.preview_decoder_max_restarts + 1
+            return False
+        self.preview_reader_thread = threading.Thread(target=self._read_preview_stream, daemon=True)
+        self.preview_reader_thread.start()
+        self.preview_stderr_thread = threading.Thread(target=self._read_preview_stderr, daemon=True)
+        self.preview_stderr_thread.start()
+        return True
+
+    def _stop_preview_decoder(self):
+        """Beendet den persistenten Preview-ffmpeg (ohne das Stop-Event der Preview zu setzen)"""
+        process = self.preview_process
+        self.preview_process = None
+        if process:
+            try:
+                if process.stdin and not process.stdin.closed:
+                    process.stdin.close()
+                process.terminate()
+                process.wait(timeout=2)
+            except Exception:
+                try:
+                    process.kill()
+                except Exception:
+                    pass
+        for thread in (self.preview_reader_thread, self.preview_stderr_thread):
+            if thread and thread.is_alive():
+                thread.join(timeout=1)
+        self.preview_reader_thread = None
+        self.preview_stderr_thread = None
+
+    def _feed_split_to_preview_decoder(self, file_path: Path, paced: bool) -> bool:
+        """
+        Schreibt die DV-Frames einer Split-Datei in den stdin des persistenten Preview-Decoders.
+
+        Args:
+            file_path: Fertige Split-Datei (AVI oder Roh-DV)
+            paced: In Echtzeit einspeisen (sonst so schnell wie möglich, um Rückstand aufzuholen)
+
+        Returns:
+            False, wenn der Decoder während des Schreibens weggefallen ist
+        """
+        process = self.preview_process
+        if not process or not process.stdin:
+            return False
+
+        frames = 0
+        next_due = time.monotonic()
+        try:
+            for frame in iter_dv_frames(file_path):
+                if self.preview_stop_event and self.preview_stop_event.is_set():
+                    break
+                if paced:
+                    # PAL 25 fps, NTSC 29.97 fps
+                    interval = 0.04 if len(frame) == DV_FRAME_SIZE_PAL else 1001 / 30000
+                    delay = next_due - time.monotonic()
+                    if delay > 0:
+                        time.sleep(delay)
+                    next_due = max(next_due + interval, time.monotonic() - interval)
+                    # Neue Datei in der Queue: Rest ohne Pacing durchschieben
+                    if not self.preview_queue.empty():
+                        paced = False
+                written = 0
+                while written < len(frame):
+                    written += process.stdin.write(frame[written:]) or 0
+                frames += 1
+        except (BrokenPipeError, ValueError, OSError) as e:
+            self.log(f"Preview-Decoder: Schreiben fehlgeschlagen bei {file_path.name}: {e}")
+            return False
+
+        if frames == 0:
+            self.log(f"Preview: Keine DV-Frames in {file_path.name} gefunden")
+        return True
+
     def _process_preview_queue(self):
         """
-        Thread-Funktion: Arbeitet Preview-Queue ab - spielt jede Datei bis zum Ende
+        Thread-Funktion: Arbeitet Preview-Queue ab - speist jede Datei in den persistenten
+        Preview-Decoder ein (Fallback: eigener ffmpeg pro Datei)
         """
         self.log("Preview-Queue-Worker: Starte...")
         
@@ -840,7 +1256,13 @@ class CaptureEngine:
                     continue
                 
                 # Spiele Datei vollständig ab
-                self._play_file_for_preview(file_path)
+                fed = False
+                if self._ensure_preview_decoder():
+                    fed = self._feed_split_to_preview_decoder(file_path, paced=self.preview_queue.empty())
+                    if not fed and self._ensure_preview_decoder():
+                        fed = self._feed_split_to_preview_decoder(file_path, paced=False)
+                if not fed:
+                    self._play_file_for_preview(file_path)
                 self.preview_queue.task_done()
                 
             except Exception as e:
@@ -861,14 +1283,20 @@ class CaptureEngine:
             self.log(f"Preview: Kein Prozess/stdout/callback für {file_path.name}")
             return
         
-        buffer = bytearray()
-        jpeg_start = b"\xff\xd8"
-        jpeg_end = b"\xff\xd9"
-        frame_count = 0
-        last_frame_time = 0
         preview_fps = getattr(self, 'preview_fps', 10)
-        target_frame_interval = 1.0 / max(preview_fps, 5)
-        bytes_read = 0
+
+        def on_frame(jpeg_data: bytes):
+            if not self.preview_callback:
+                return
+            try:
+                # Sende immer rohe JPEG-Bytes
+                self.preview_callback(jpeg_data)
+                if extractor.frames_emitted == 1:
+                    self.log(f"Preview: Erstes Frame (Bytes) von {file_path.name}")
+            except Exception as e:
+                self.log(f"Preview: Fehler bei Frame-Callback: {e}")
+
+        extractor = MJPEGFrameExtractor(on_frame, max_fps=max(preview_fps, 5))
         
         self.log(f"Preview: Starte Frame-Lesen von {file_path.name}")
         
@@ -887,62 +1315,19 @@ class CaptureEngine:
             return
         
         try:
-            while (
-                (not self.preview_stop_event or not self.preview_stop_event.is_set())
-                and process
-                and process.poll() is None
-            ):
-                try:
-                    chunk = process.stdout.read(8192)
-                    
-                    if not chunk:
-                        if process.poll() is not None:
-                            self.log(f"Preview: Prozess beendet, {bytes_read} bytes gelesen, {frame_count} frames")
-                            break
-                        time.sleep(0.01)
-                        continue
-                    
-                    bytes_read += len(chunk)
-                    buffer.extend(chunk)
-                    
-                    # Suche nach vollständigen JPEGs
-                    while True:
-                        start_idx = buffer.find(jpeg_start)
-                        if start_idx == -1:
-                            if len(buffer) > 500000:
-                                buffer = bytearray()
-                            break
-                        if start_idx > 0:
-                            buffer = buffer[start_idx:]
-                        end_idx = buffer.find(jpeg_end, 2)
-                        if end_idx == -1:
-                            break
-                        
-                        jpeg_data = bytes(buffer[: end_idx + 2])
-                        buffer = buffer[end_idx + 2 :]
-                        
-                        if self.preview_callback:
-                            try:
-                                current_time = time.time()
-                                if current_time - last_frame_time >= target_frame_interval:
-                                    # Sende immer rohe JPEG-Bytes (Browser-Websocket erwartet Base64)
-                                    self.preview_callback(jpeg_data)
-                                    frame_count += 1
-                                    last_frame_time = current_time
-                                    if frame_count == 1:
-                                        self.log(f"Preview: Erstes Frame (Bytes) von {file_path.name}")
-                            except Exception as e:
-                                self.log(f"Preview: Fehler bei Frame-Callback: {e}")
-                
-                except Exception as e:
-                    self.log(f"Preview: Fehler beim Lesen: {e}")
-                    time.sleep(0.1)
-                    continue
-        
+            # Liest bis EOF (ffmpeg hat die Datei komplett ausgegeben) oder Stop
+            extractor.run(
+                process.stdout,
+                lambda: not self.preview_stop_event or not self.preview_stop_event.is_set(),
+            )
         except Exception as e:
             self.log(f"Preview: Fehler: {e}")
         finally:
-            self.log(f"Preview: Beendet - {bytes_read} bytes gelesen, {frame_count} frames gesendet")
+            frame_count = extractor.frames_emitted
+            self.log(
+                f"Preview: Beendet - {extractor.bytes_read} bytes gelesen, {frame_count} frames gesendet "
+                f"({extractor.frames_skipped} gedrosselt)"
+            )
             # Wenn keine Frames gefunden wurden, logge Stderr für Diagnose
             if frame_count == 0 and process:
                 try:
@@ -1033,6 +1418,45 @@ class CaptureEngine:
             self.preview_process = None
             return False
 
+    def _start_tee_capture(self):
+        """Startet TeeCapture auf dvgrab-stdout (Split-Writer, Preview-ffmpeg-stdin, DIF-Analyse)"""
+        process = self.recording_dvgrab_process
+        if not process or not process.stdout:
+            return
+        preview_sink = None
+        if self.preview_process and self.preview_process.stdin:
+            preview_sink = self.preview_process.stdin
+            self.preview_reader_thread = threading.Thread(target=self._read_preview_stream, daemon=True)
+            self.preview_reader_thread.start()
+            self.preview_stderr_thread = threading.Thread(target=self._read_preview_stderr, daemon=True)
+            self.preview_stderr_thread.start()
+        self.tee_capture = TeeCapture(
+            process.stdout,
+            self.splits_dir,
+            preview_sink=preview_sink,
+            log_callback=self.log,
+        )
+        self.tee_capture.start()
+        self.log("Tee-Capture gestartet (dvgrab-stdout -> Splits, Live-Preview, DIF-Analyse)")
+
+    def _stop_tee_capture(self):
+        """Wartet auf das Stream-Ende nach dvgrab-Stopp und schließt die letzte Split-Datei"""
+        if not self.tee_capture:
+            return
+        if not self.tee_capture.stop(timeout=10):
+            self.log("WARNUNG: Tee-Capture wurde nicht sauber beendet")
+        stats = self.tee_capture.stats()
+        preview = stats["consumers"].get("preview")
+        self.log(
+            f"Tee-Capture: {stats['frames']} Frames, {stats['files']} Split-Dateien"
+            + (f", Preview verworfen: {preview['dropped']}" if preview else "")
+        )
+        self.tee_capture = None
+
+    def get_tee_stats(self) -> Optional[dict]:
+        """Live-Statistik des Tee-Modus (Frames, Timecode, Aufnahmezeit) oder None"""
+        return self.tee_capture.stats() if self.tee_capture else None
+
     # Recording-ffmpeg wurde entfernt - dvgrab schreibt jetzt direkt Dateien mit autosplit
     
     def _send_interactive_command(self, command: str) -> bool:
@@ -1135,6 +1559,9 @@ class CaptureEngine:
             except Exception:
                 pass
             self.recording_dvgrab_process = None
+
+        # Tee-Modus: dvgrab ist beendet, Stream läuft bis EOF aus
+        self._stop_tee_capture()
         
         # Stoppe interaktiven dvgrab (nur Steuerung)
         if self.interactive_dvgrab_process:
@@ -1227,6 +1654,11 @@ class CaptureEngine:
         auto_rewind_play: bool = True,
         title: str = "",
         year: str = "",
+        capture_mode: str = "autosplit",
+        merge_mode: str = "batch",
+        timestamp_mode: str = "burn",
+        timestamp_duration: int = 4,
+        merge_workers: int = 0,
     ) -> bool:
         """
         Startet DV-Aufnahme mit dvgrab autosplit
@@ -1239,10 +1671,20 @@ class CaptureEngine:
             auto_rewind_play: Setzt -rewind (automatisches Rewind vor Aufnahme)
             title: Titel des Films (für Merge-Queue)
             year: Jahr des Films (für Merge-Queue)
+            capture_mode: "autosplit" (dvgrab schreibt Splits, Preview liest sie nach) oder
+                "tee" (dvgrab -> stdout, ein Leser verteilt an Split-Writer, Live-Preview und DIF-Analyse)
+            merge_mode: "batch" (Merge nach dem Stopp, Standard) oder "incremental" (Splits werden
+                während der Aufnahme kodiert, opt-in)
+            timestamp_mode: Aufnahmezeit "burn" (eingebrannt), "soft" (Untertitelspur) oder "off"
+            timestamp_duration: Anzeigedauer der Aufnahmezeit je Split in Sekunden
+            merge_workers: Parallele x264-Prozesse beim Merge-Encode (0 = automatisch, 1 = ein Prozess)
         """
         # Speichere Titel und Jahr für Merge-Jobs
         self.current_capture_title = title
         self.current_capture_year = year
+        self.timestamp_mode = timestamp_mode
+        self.timestamp_duration = timestamp_duration
+        self.merge_workers = merge_workers
         try:
             if self.is_capturing:
                 self.log("Aufnahme läuft bereits!")
@@ -1269,6 +1711,9 @@ class CaptureEngine:
             self.splits_dir.mkdir(parents=True, exist_ok=True)
             self.last_split_time = time.time()
             self.auto_stop_inactivity_triggered = False
+            # Split-Watcher vor dvgrab starten, damit keine Datei verpasst wird
+            self._start_split_watcher(self.splits_dir)
+            self._start_split_manifest()
             
             # Setze Ausgabepfad für Merge (wird nach dem Stoppen erstellt)
             # Standard jetzt MP4
@@ -1279,6 +1724,8 @@ class CaptureEngine:
             preview_fps = max(5, min(preview_fps, 15))
             self.preview_fps = preview_fps
             enable_preview = preview_callback is not None
+            self.capture_mode = "tee" if capture_mode == "tee" else "autosplit"
+            tee_mode = self.capture_mode == "tee"
 
             # 1. Beende interaktiven Modus falls aktiv (wird durch non-interaktiven ersetzt)
             if self.interactive_dvgrab_process and self.interactive_dvgrab_process.poll() is None:
@@ -1301,22 +1748,39 @@ class CaptureEngine:
                 self.interactive_dvgrab_process = None
                 self.interactive_process = None
             
+            # 1b. Tee-Modus: Preview-ffmpeg vor dvgrab starten, damit stdout sofort gelesen werden kann
+            if tee_mode and enable_preview:
+                self.preview_stop_event = threading.Event()
+                if not self._start_preview_ffmpeg(preview_fps):
+                    self.log("WARNUNG: Preview-ffmpeg konnte nicht gestartet werden - Aufnahme läuft ohne Preview")
+
             # 2. Starte non-interaktiven dvgrab für Aufnahme
             self.log("=== Starte non-interaktiven dvgrab für Aufnahme ===")
-            if not self._start_recording_dvgrab(device, self.splits_dir, use_rewind=auto_rewind_play):
+            if not self._start_recording_dvgrab(
+                device, self.splits_dir, use_rewind=auto_rewind_play, to_stdout=tee_mode
+            ):
                 self.log("FEHLER: Recording dvgrab konnte nicht gestartet werden")
+                self._stop_preview()
+                self._stop_split_watcher()
+                self._stop_incremental_merger()
+                self._stop_split_manifest()
                 return False
             
             # 3. Markiere als aktiv (vor Preview-Threads, sonst stoppen sie sofort)
             self.is_capturing = True
             self.process = self.recording_dvgrab_process  # Für Kompatibilität
+            # 3a. Inkrementeller Merge: fertige Splits sofort im Hintergrund kodieren
+            self.merge_mode = "incremental" if merge_mode == "incremental" and self.auto_merge else "batch"
+            if self.merge_mode == "incremental":
+                self._start_incremental_merger()
             # 3b. Starte Laufzeit-Logger
             self._start_capture_duration_logger()
             
-            # 4. Starte Preview-Queue-System (falls aktiviert)
-            if enable_preview:
+            # 4. Starte Preview-Queue-System (falls aktiviert, im Tee-Modus läuft die Preview live)
+            if enable_preview and not tee_mode:
                 self.log("=== Starte Preview-Queue-System ===")
                 self.preview_stop_event = threading.Event()
+                self.preview_decoder_restarts = 0
                 
                 # Monitor-Thread: Fügt neue Dateien zur Queue hinzu
                 self.preview_monitor_thread = threading.Thread(
@@ -1358,6 +1822,9 @@ class CaptureEngine:
             self._stop_preview()
             self._stop_capture_duration_logger()
             self._stop_all_processes()
+            self._stop_split_watcher()
+            self._stop_incremental_merger()
+            self._stop_split_manifest()
             return False
 
     # Alte _start_preview() Methode entfernt - wird durch _start_preview_ffmpeg() ersetzt
@@ -1404,29 +1871,7 @@ class CaptureEngine:
             self.log("Aufnahme gestoppt.")
 
             # Warte, damit alle Dateien vollständig geschrieben sind
-            self.log("Warte auf vollständiges Schreiben der Split-Dateien...")
-            if self.splits_dir and self.splits_dir.exists():
-                max_wait = 10  # Maximal 10 Sekunden warten
-                waited = 0
-                while waited < max_wait:
-                    files = list(self.splits_dir.glob("dvgrab-*.avi"))
-                    if files:
-                        # Prüfe ob alle Dateien stabil sind
-                        all_stable = True
-                        for f in files:
-                            size1 = f.stat().st_size
-                            time.sleep(0.5)
-                            if f.exists():
-                                size2 = f.stat().st_size
-                                if size1 != size2:
-                                    all_stable = False
-                                    break
-                        if all_stable:
-                            break
-                    waited += 0.5
-                    time.sleep(0.5)
-            else:
-                time.sleep(2)
+            split_files = self._wait_for_splits_stable(max_wait=10)
 
             # SOFORT: Rewind durchführen (damit Benutzer weitermachen kann)
             self.log("Spule Kamera zurück...")
@@ -1439,18 +1884,7 @@ class CaptureEngine:
             )
             
             # HINTERGRUND: Merge-Job zur Queue hinzufügen (nicht blockierend)
-            if self.splits_dir and self.splits_dir.exists():
-                split_files = list(self.splits_dir.glob("dvgrab*.avi")) + list(self.splits_dir.glob("dvgrab*.dv"))
-                self.log(f"Gefunden: {len(split_files)} Split-Dateien - Merge wird im Hintergrund durchgeführt")
-
-                self.queue_merge_job(
-                    splits_dir=self.splits_dir,
-                    output_path=self.current_output_path,
-                    title=self.current_capture_title,
-                    year=self.current_capture_year
-                )
-            else:
-                self.log(f"WARNUNG: splits-Ordner nicht gefunden: {self.splits_dir}")
+            self._finish_capture_stage(split_files)
 
             # sudo-Keepalive beenden (falls gestartet)
             self._stop_sudo_keepalive()
@@ -1466,6 +1900,9 @@ class CaptureEngine:
             self.is_capturing = False
             self._stop_preview()
             self._stop_all_processes()
+            self._stop_split_watcher()
+            self._stop_incremental_merger()
+            self._stop_split_manifest()
             self._stop_sudo_keepalive()
             return False
 
@@ -1602,6 +2039,9 @@ class CaptureEngine:
             self.is_capturing = False
             self._stop_preview()
             self._stop_all_processes()
+            self._stop_split_watcher()
+            self._stop_incremental_merger()
+            self._stop_split_manifest()
 
     def _finalize_capture_after_dvgrab_end(self):
         """
@@ -1612,30 +2052,7 @@ class CaptureEngine:
             self.log("dvgrab wurde automatisch beendet - starte Finalisierung...")
             
             # Warte kurz, damit alle Dateien vollständig geschrieben sind
-            self.log("Warte auf vollständiges Schreiben der Split-Dateien...")
-            if self.splits_dir and self.splits_dir.exists():
-                max_wait = 10  # Maximal 10 Sekunden warten
-                waited = 0
-                while waited < max_wait:
-                    files = list(self.splits_dir.glob("dvgrab-*.avi")) + list(self.splits_dir.glob("dvgrab*.avi"))
-                    if files:
-                        # Prüfe ob alle Dateien stabil sind
-                        all_stable = True
-                        for f in files:
-                            if f.exists():
-                                size1 = f.stat().st_size
-                                time.sleep(0.5)
-                                if f.exists():
-                                    size2 = f.stat().st_size
-                                    if size1 != size2:
-                                        all_stable = False
-                                        break
-                        if all_stable:
-                            break
-                    waited += 0.5
-                    time.sleep(0.5)
-            else:
-                time.sleep(2)
+            split_files = self._wait_for_splits_stable(max_wait=10)
             
             # SOFORT: Rewind durchführen (damit Benutzer weitermachen kann)
             self.log("Spule Kamera zurück...")
@@ -1648,18 +2065,7 @@ class CaptureEngine:
             )
             
             # HINTERGRUND: Merge-Job zur Queue hinzufügen (nicht blockierend)
-            if self.splits_dir and self.splits_dir.exists():
-                split_files = list(self.splits_dir.glob("dvgrab*.avi")) + list(self.splits_dir.glob("dvgrab*.dv"))
-                self.log(f"Gefunden: {len(split_files)} Split-Dateien - Merge wird im Hintergrund durchgeführt")
-                
-                self.queue_merge_job(
-                    splits_dir=self.splits_dir,
-                    output_path=self.current_output_path,
-                    title=self.current_capture_title,
-                    year=self.current_capture_year
-                )
-            else:
-                self.log(f"WARNUNG: splits-Ordner nicht gefunden: {self.splits_dir}")
+            self._finish_capture_stage(split_files)
             
             # sudo-Keepalive beenden (falls gestartet)
             self._stop_sudo_keepalive()
@@ -1668,6 +2074,28 @@ class CaptureEngine:
             self.log(f"Fehler bei Finalisierung nach dvgrab-Ende: {e}")
             self._notify_completion(f"Aufnahme beendet mit Fehler: {e}")
 
+    def _finish_capture_stage(self, split_files: list[Path]):
+        """Meldet die fertige Aufnahme an die Pipeline und reiht den Merge ein (Kante Aufnahme → Merge)"""
+        if not (self.splits_dir and self.splits_dir.exists()):
+            self.log(f"WARNUNG: splits-Ordner nicht gefunden: {self.splits_dir}")
+            return
+        project_dir = self.splits_dir.parent.parent
+        self._report_stage(project_dir, STAGE_CAPTURE, STATE_COMPLETED, {"splits": len(split_files)})
+        if not self.auto_merge:
+            self.log(f"Auto-Merge deaktiviert: {len(split_files)} Split-Dateien bleiben in {self.splits_dir}")
+            self._stop_incremental_merger()
+            self._stop_split_manifest()
+            return
+        self.log(f"Gefunden: {len(split_files)} Split-Dateien - Merge wird im Hintergrund durchgeführt")
+        self.queue_merge_job(
+            splits_dir=self.splits_dir,
+            output_path=self.current_output_path,
+            title=self.current_capture_title,
+            year=self.current_capture_year,
+            merger=self._take_incremental_merger(),
+            manifest=self._take_split_manifest(),
+        )
+
     def _read_stderr(self):
         """Liest stderr in einem separaten Thread"""
         try:
@@ -1915,105 +2343,66 @@ class CaptureEngine:
             return
 
         self.log("Preview-Stream: Starte Lesen...")
-        buffer = bytearray()
-        jpeg_start = b"\xff\xd8"
-        jpeg_end = b"\xff\xd9"
-        frame_count = 0
-        last_frame_time = 0
+        process = self.preview_process
         preview_fps = getattr(self, 'preview_fps', 10)
-        target_frame_interval = 1.0 / max(preview_fps, 5)
+
+        def on_frame(jpeg_data: bytes):
+            if not self.preview_callback:
+                return
+            try:
+                # Sende rohe JPEG-Bytes (kein Qt/QImage)
+                self.preview_callback(jpeg_data)
+                if extractor.frames_emitted == 1:
+                    self.log("Preview-Stream: Erstes Frame empfangen")
+            except Exception:
+                pass
+
+        extractor = MJPEGFrameExtractor(on_frame, max_fps=max(preview_fps, 5))
 
         try:
             while (
                 self.preview_stop_event
                 and not self.preview_stop_event.is_set()
-                and self.preview_process
-                and self.preview_process.poll() is None
+                and self.preview_process is process
             ):
                 try:
-                    chunk = self.preview_process.stdout.read(8192)
-
-                    if not chunk:
-                        # Prüfe, ob der Prozess beendet wurde
-                        if self.preview_process.poll() is not None:
-                            # Prozess beendet - lese stderr für Fehler
-                            try:
-                                if self.preview_process.stderr:
-                                    # Warte kurz, damit stderr vollständig geschrieben wird
-                                    time.sleep(0.2)
-                                    # Lese alle verfügbaren Daten in mehreren Chunks
-                                    stderr_data = b""
-                                    while True:
-                                        chunk = self.preview_process.stderr.read(4096)
-                                        if not chunk:
-                                            break
-                                        if isinstance(chunk, bytes):
-                                            stderr_data += chunk
-                                        else:
-                                            stderr_data += chunk.encode('utf-8', errors='ignore')
-                                    
-                                    if stderr_data:
-                                        if isinstance(stderr_data, bytes):
-                                            stderr_text = stderr_data.decode('utf-8', errors='ignore')
-                                        else:
-                                            stderr_text = str(stderr_data)
-                                        if "Permission denied" in stderr_text or "Cannot open" in stderr_text:
-                                            self.log("Preview-Fehler: Keine Berechtigung für FireWire-Gerät")
-                                            self.log("HINWEIS: dvgrab benötigt root-Rechte. Starten Sie die Anwendung mit sudo.")
-                                        elif "No such file" in stderr_text or "Device" in stderr_text:
-                                            self.log(f"Preview-Fehler: Gerät nicht gefunden: {stderr_text[:200]}")
-                                        else:
-                                            self.log(f"Preview-Fehler: {stderr_text[:300]}")
-                            except:
-                                pass
-                        current_time = time.time()
-                        if current_time - last_frame_time < target_frame_interval:
-                            time.sleep(0.01)
+                    if extractor.read_from(process.stdout):
                         continue
-
-                    buffer.extend(chunk)
-
-                    # Suche nach vollständigen JPEGs
-                    while True:
-                        start_idx = buffer.find(jpeg_start)
-                        if start_idx == -1:
-                            if len(buffer) > 500000:
-                                buffer = bytearray()
-                            break
-                        if start_idx > 0:
-                            buffer = buffer[start_idx:]
-                        end_idx = buffer.find(jpeg_end, 2)
-                        if end_idx == -1:
-                            break
-
-                        jpeg_data = bytes(buffer[: end_idx + 2])
-                        buffer = buffer[end_idx + 2 :]
-
-                        if self.preview_callback:
-                            try:
-                                current_time = time.time()
-                                if current_time - last_frame_time >= target_frame_interval:
-                                    # Sende rohe JPEG-Bytes (kein Qt/QImage)
-                                    self.preview_callback(jpeg_data)
-                                    frame_count += 1
-                                    last_frame_time = current_time
-                                    if frame_count == 1:
-                                        self.log("Preview-Stream: Erstes Frame empfangen")
-                            except Exception:
-                                pass
-
                 except Exception as e:
                     self.log(f"Preview-Stream: Fehler beim Lesen: {e}")
                     time.sleep(0.1)
                     continue
 
+                # EOF: ffmpeg wurde beendet - lese stderr für Fehler
+                try:
+                    process.wait(timeout=1)
+                    if process.stderr and (not self.preview_stop_event or not self.preview_stop_event.is_set()):
+                        # Lese alle verfügbaren Daten in mehreren Chunks
+                        stderr_data = b""
+                        while True:
+                            chunk = process.stderr.read(4096)
+                            if not chunk:
+                                break
+                            stderr_data += chunk
+                        stderr_text = stderr_data.decode('utf-8', errors='ignore')
+                        if "Permission denied" in stderr_text or "Cannot open" in stderr_text:
+                            self.log("Preview-Fehler: Keine Berechtigung für FireWire-Gerät")
+                            self.log("HINWEIS: dvgrab benötigt root-Rechte. Starten Sie die Anwendung mit sudo.")
+                        elif "No such file" in stderr_text or "Device" in stderr_text:
+                            self.log(f"Preview-Fehler: Gerät nicht gefunden: {stderr_text[:200]}")
+                        elif stderr_text:
+                            self.log(f"Preview-Fehler: {stderr_text[:300]}")
+                except Exception:
+                    pass
+                break
+
         except Exception as e:
             self.log(f"Preview-Stream: Fehler: {e}")
         finally:
-            self.log(f"Preview-Stream: Beendet (Frames empfangen: {frame_count})")
+            self.log(f"Preview-Stream: Beendet (Frames empfangen: {extractor.frames_emitted})")
             try:
-                if self.preview_process and self.preview_process.stdout:
-                    self.preview_process.stdout.close()
+                if process and process.stdout:
+                    process.stdout.close()
             except Exception:
                 pass
 
@@ -0,0 +1,258 @@
+"""
+Fortsetzbares Upscaling in Abschnitten (Chunks)
+
+Ein 90-Minuten-Band läuft mit einem großen Modell viele Stunden. Statt eines einzigen
+UpscaleEngine.upscale()-Laufs, dessen Temp-Ordner bei jedem Abbruch verloren ist, wird die
+Eingabe per Stream-Copy (segment-Muxer, Schnitt an Keyframes) in Abschnitte fester Länge geteilt.
+Jeder Abschnitt wird einzeln hochskaliert; ein Manifest (chunks.json) im Arbeitsordner unter
+HighRes/ hält fest, welche fertig sind. Ein neu gestarteter Job überspringt diese.
+
+Am Ende werden die hochskalierten Abschnitte per Stream-Copy (concat) zusammengefügt und mit dem
+Ton des Originals gemuxt. Ändern sich Eingabe, Profil, Crop oder Passthrough-Bereiche, passt die
+Signatur nicht mehr und der Arbeitsordner wird verworfen.
+"""
+
+import csv
+import hashlib
+import json
+import os
+import shutil
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+from .crop_detect import CropArea
+from .ffmpeg_runner import percent_callback, run_ffmpeg
+from .upscale import UpscaleEngine
+
+
+MANIFEST_NAME = "chunks.json"
+MANIFEST_VERSION = 1
+SEGMENT_LIST = "sources.csv"
+DEFAULT_CHUNK_SECONDS = 300
+
+
+def chunk_ranges(
+    ranges: Optional[List[Tuple[float, float]]], start: float, end: float
+) -> List[Tuple[float, float]]:
+    """Zeitbereiche (Quelle) auf einen Abschnitt [start, end) beschränkt, relativ zu seinem Anfang"""
+    result = []
+    for range_start, range_end in ranges or []:
+        clipped_start, clipped_end = max(range_start, start), min(range_end, end)
+        if clipped_end > clipped_start:
+            result.append((round(clipped_start - start, 3), round(clipped_end - start, 3)))
+    return result
+
+
+class ChunkedUpscaler:
+    """
+    Skaliert ein Video abschnittsweise mit einer UpscaleEngine hoch
+
+    Args:
+        engine: UpscaleEngine (auch mit warmem Worker: das Modell bleibt zwischen Abschnitten geladen)
+        ffmpeg_path: Pfad zu ffmpeg
+        work_dir: Arbeitsordner für Abschnitte und Manifest (z.B. HighRes/.<Film>_chunks)
+        chunk_seconds: Ziel-Länge eines Abschnitts (geschnitten wird am nächsten Keyframe)
+    """
+
+    def __init__(
+        self,
+        engine: UpscaleEngine,
+        ffmpeg_path: Optional[Path],
+        work_dir: Path,
+        log_callback: Optional[Callable[[str], None]] = None,
+        chunk_seconds: float = DEFAULT_CHUNK_SECONDS,
+    ):
+        self.engine = engine
+        self.ffmpeg_path = ffmpeg_path
+        self.work_dir = Path(work_dir)
+        self.log_callback = log_callback
+        self.chunk_seconds = chunk_seconds
+
+    @property
+    def manifest_path(self) -> Path:
+        return self.work_dir / MANIFEST_NAME
+
+    def _signature(
+        self,
+        input_path: Path,
+        profile: Dict[str, Any],
+        passthrough_ranges: Optional[List[Tuple[float, float]]],
+        crop: Optional[CropArea],
+    ) -> str:
+        stat = input_path.stat()
+        settings = {
+            "input": [input_path.name, stat.st_size, stat.st_mtime],
+            "profile": profile,
+            "passthrough": passthrough_ranges or [],
+            "crop": crop.to_dict() if crop else None,
+            "chunk_seconds": self.chunk_seconds,
+        }
+        return hashlib.sha1(json.dumps(settings, sort_keys=True, default=str).encode("utf-8")).hexdigest()
+
+    def _load_manifest(self, signature: str) -> Optional[Dict[str, Any]]:
+        try:
+            data = json.loads(self.manifest_path.read_text(encoding="utf-8"))
+        except (OSError, ValueError):
+            return None
+        if data.get("version") != MANIFEST_VERSION or data.get("signature") != signature:
+            self.log("Chunk-Upscale: Arbeitsordner mit anderen Einstellungen, beginne neu")
+            return None
+        return data
+
+    def _save_manifest(self, data: Dict[str, Any]):
+        tmp = self.manifest_path.with_suffix(".json.tmp")
+        tmp.write_text(json.dumps(data, indent=2), encoding="utf-8")
+        os.replace(tmp, self.manifest_path)
+
+    def _split(self, input_path: Path) -> Optional[List[Dict[str, Any]]]:
+        """Teilt das Bild (ohne Ton) per Stream-Copy an Keyframes in Abschnitte"""
+        ffmpeg = str(self.ffmpeg_path) if self.ffmpeg_path else "ffmpeg"
+        cmd = [
+            ffmpeg, "-hide_banner", "-nostdin", "-y",
+            "-i", str(input_path),
+            "-map", "0:v:0", "-an", "-c", "copy",
+            "-f", "segment", "-segment_time", str(self.chunk_seconds),
+            "-segment_list", str(self.work_dir / SEGMENT_LIST), "-segment_list_type", "csv",
+            "-reset_timestamps", "1",
+            str(self.work_dir / "source_%04d.mkv"),
+        ]
+        self.log(f"Chunk-Upscale: teile {input_path.name} in Abschnitte zu {self.chunk_seconds:.0f} s")
+        result = run_ffmpeg(cmd)
+        if result.returncode != 0:
+            self.log(f"Chunk-Upscale: Teilen fehlgeschlagen: {result.stderr[-500:]}")
+            return None
+        chunks = []
+        try:
+            with open(self.work_dir / SEGMENT_LIST, newline="", encoding="utf-8") as f:
+                for index, (name, start, end) in enumerate(csv.reader(f)):
+                    chunks.append({
+                        "source": name,
+                        "output": f"upscaled_{index:04d}.mp4",
+                        "start": float(start),
+                        "end": float(end),
+                        "done": False,
+                    })
+        except (OSError, ValueError) as e:
+            self.log(f"Chunk-Upscale: Segmentliste unlesbar: {e}")
+            return None
+        return chunks or None
+
+    def upscale(
+        self,
+        input_path: Path,
+        output_path: Path,
+        profile: Dict[str, Any],
+        progress_hook: Optional[Callable[[int], None]] = None,
+        status_hook: Optional[Callable[[str], None]] = None,
+        passthrough_ranges: Optional[List[Tuple[float, float]]] = None,
+        crop: Optional[CropArea] = None,
+    ) -> bool:
+        """
+        Wie UpscaleEngine.upscale, aber abschnittsweise und fortsetzbar
+
+        Bei Fehlern bleibt der Arbeitsordner erhalten; der nächste Aufruf mit denselben
+        Einstellungen macht beim ersten unfertigen Abschnitt weiter.
+        """
+        signature = self._signature(input_path, profile, passthrough_ranges, crop)
+        manifest = self._load_manifest(signature)
+        if manifest is None:
+            shutil.rmtree(self.work_dir, ignore_errors=True)
+            self.work_dir.mkdir(parents=True, exist_ok=True)
+            chunks = self._split(input_path)
+            if chunks is None:
+                return False
+            manifest = {"version": MANIFEST_VERSION, "signature": signature, "chunks": chunks}
+            self._save_manifest(manifest)
+
+        chunks = manifest["chunks"]
+        for chunk in chunks:
+            # Nur als fertig werten, was auch noch auf der Platte liegt
+            chunk["done"] = chunk["done"] and (self.work_dir / chunk["output"]).is_file()
+        total = sum(chunk["end"] - chunk["start"] for chunk in chunks) or 1.0
+        finished = [chunk for chunk in chunks if chunk["done"]]
+        if finished:
+            self.log(f"Chunk-Upscale: {len(finished)} von {len(chunks)} Abschnitten aus früherem Lauf übernommen")
+
+        done_seconds = sum(chunk["end"] - chunk["start"] for chunk in finished)
+        for index, chunk in enumerate(chunks):
+            if chunk["done"]:
+                continue
+            length = chunk["end"] - chunk["start"]
+            offset = done_seconds
+
+            def chunk_progress(pct: int, offset=offset, length=length):
+                if progress_hook:
+                    progress_hook(min(99, int((offset + length * pct / 100) * 100 / total)))
+
+            def chunk_status(text: str, index=index):
+                if status_hook:
+                    status_hook(f"Abschnitt {index + 1}/{len(chunks)} · {text}")
+
+            self.log(f"Chunk-Upscale: Abschnitt {index + 1}/{len(chunks)} ({chunk['start']:.0f}-{chunk['end']:.0f} s)")
+            if not self.engine.upscale(
+                self.work_dir / chunk["source"],
+                self.work_dir / chunk["output"],
+                profile,
+                progress_hook=chunk_progress,
+                status_hook=chunk_status,
+                passthrough_ranges=chunk_ranges(passthrough_ranges, chunk["start"], chunk["end"]) or None,
+                crop=crop,
+            ):
+                self.log(f"Chunk-Upscale: Abschnitt {index + 1} fehlgeschlagen, fertige Abschnitte bleiben erhalten")
+                return False
+            chunk["done"] = True
+            self._save_manifest(manifest)
+            done_seconds += length
+
+        if not self._concat(input_path, output_path, chunks, status_hook):
+            return False
+        shutil.rmtree(self.work_dir, ignore_errors=True)
+        if progress_hook:
+            progress_hook(100)
+        return True
+
+    def _concat(
+        self,
+        input_path: Path,
+        output_path: Path,
+        chunks: List[Dict[str, Any]],
+        status_hook: Optional[Callable[[str], None]],
+    ) -> bool:
+        """Hochskalierte Abschnitte per Stream-Copy zusammenfügen, Ton aus dem Original"""
+        list_file = self.work_dir / "concat_list.txt"
+        with open(list_file, "w", encoding="utf-8") as f:
+            for chunk in chunks:
+                escaped = str((self.work_dir / chunk["output"]).resolve()).replace("'", "'\\''")
+                f.write(f"file '{escaped}'\n")
+
+        ffmpeg = str(self.ffmpeg_path) if self.ffmpeg_path else "ffmpeg"
+        partial_path = output_path.with_name(f"{output_path.stem}.part{output_path.suffix}")
+        cmd = [
+            ffmpeg, "-hide_banner", "-nostdin", "-y",
+            "-f", "concat", "-safe", "0", "-i", str(list_file),
+            "-i", str(input_path),
+            "-map", "0:v:0", "-map", "1:a?",
+            "-c", "copy",
+            "-movflags", "+faststart",
+            str(partial_path),
+        ]
+        self.log(f"Chunk-Upscale: füge {len(chunks)} Abschnitte zusammen (Stream-Copy) -> {output_path.name}")
+        duration = sum(chunk["end"] - chunk["start"] for chunk in chunks)
+        result = run_ffmpeg(
+            cmd,
+            duration=duration,
+            progress_callback=percent_callback(
+                (lambda pct, text: status_hook(f"Zusammenfügen {text}")) if status_hook else None
+            ),
+        )
+        if result.returncode != 0 or not partial_path.exists():
+            self.log(f"Chunk-Upscale: Zusammenfügen fehlgeschlagen: {result.stderr[-500:]}")
+            partial_path.unlink(missing_ok=True)
+            return False
+        partial_path.replace(output_path)
+        self.log(f"Video erfolgreich erstellt ({len(chunks)} Abschnitte): {output_path}")
+        return True
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
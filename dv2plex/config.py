@@ -55,6 +55,15 @@ class Config:
             },
             "upscaling": {
                 "default_profile": "realesrgan_2x",
+                "warm_worker": True,  # Real-ESRGAN-Modelle bleiben zwischen Jobs geladen
+                "worker_idle_timeout": 600,  # Sekunden ohne Job, danach gibt der Worker den VRAM frei
+                "device": "auto",  # auto | cpu | cuda
+                "cpu_processes": 0,  # Parallele Modell-Prozesse ohne GPU, 0 = physische Kerne / cpu_threads
+                "cpu_threads": 2,  # Rechen-Threads je CPU-Prozess
+                "dead_segments": "passthrough",  # Bluescreen/Schwarzbild/Rauschen: passthrough (nur Lanczos) | trim (zusätzlich am Anfang/Ende herausschneiden) | off
+                "dead_segment_min_seconds": 5,  # Kürzere tote Abschnitte bleiben unangetastet
+                "crop_detect": True,  # Schwarze Ränder/Kopfumschaltung abschneiden (crop.json im Filmordner)
+                "chunk_seconds": 300,  # Upscale in Abschnitten, fortsetzbar nach Abbruch (0 = in einem Stück)
                 "profiles": {
                     "realesrgan_4x_hq": {
                         "backend": "realesrgan",
@@ -112,6 +121,71 @@ class Config:
                             "tune": "film"
                         }
                     },
+                    "realesr_general_4x": {
+                        "backend": "realesrgan",  # SRVGGNetCompact: ein Bruchteil der RRDBNet-Rechenzeit
+                        "scale_factor": 4,
+                        "model": "realesr-general-x4v3",
+                        "denoise_strength": 0.5,  # 0 = Bandrauschen behalten, 1 = stark entrauschen
+                        "model_scale": 4,  # Modell liefert volle 4x, danach Lanczos auf 3840x2160
+                        "tile_size": 0,
+                        "tile_pad": 10,
+                        "encoder": "libx264",
+                        "encoder_options": {
+                            "crf": 18,
+                            "preset": "veryfast",
+                            "tune": "film"
+                        }
+                    },
+                    "realesr_animevideo_4x": {
+                        "backend": "realesrgan",
+                        "scale_factor": 4,
+                        "model": "realesr-animevideov3",  # kleinstes Modell, am schnellsten
+                        "model_scale": 4,
+                        "tile_size": 0,
+                        "tile_pad": 10,
+                        "encoder": "libx264",
+                        "encoder_options": {
+                            "crf": 18,
+                            "preset": "veryfast",
+                            "tune": "film"
+                        }
+                    },
+                    "auto": {
+                        "backend": "auto",  # Probelauf auf dem Band, bestes Profil im Zeitbudget
+                        "candidates": ["realesrgan_4x_balanced", "realesr_general_4x", "realesr_animevideo_4x", "ffmpeg_fast"],
+                        "time_budget_hours": 12,
+                        "sample_seconds": 10
+                    },
+                    "onnx_4x_cpu": {
+                        "backend": "onnx",  # ONNX Runtime auf der CPU, Modell wird einmal exportiert
+                        "scale_factor": 4,
+                        "model": "RealESRGAN_x4plus",
+                        "quantize": None,  # "int8": statisch quantisiertes Modell
+                        "threads": 2,  # Threads je Prozess (Prozesse: upscaling.cpu_processes)
+                        "tile_size": 400,
+                        "tile_pad": 10,
+                        "encoder": "libx264",
+                        "encoder_options": {
+                            "crf": 18,
+                            "preset": "veryfast",
+                            "tune": "film"
+                        }
+                    },
+                    "onnx_4x_cpu_int8": {
+                        "backend": "onnx",
+                        "scale_factor": 4,
+                        "model": "RealESRGAN_x4plus",
+                        "quantize": "int8",
+                        "threads": 2,
+                        "tile_size": 400,
+                        "tile_pad": 10,
+                        "encoder": "libx264",
+                        "encoder_options": {
+                            "crf": 18,
+                            "preset": "veryfast",
+                            "tune": "film"
+                        }
+                    },
                     "ffmpeg_fast": {
                         "backend": "ffmpeg",
                         "scale_factor": 4,
@@ -127,11 +201,22 @@ class Config:
             "capture": {
                 "auto_merge": True,
                 "auto_upscale": True,
+                "auto_poster": False,
                 "auto_export": False,
                 "auto_postprocess": False,
                 "auto_rewind_play": True,
                 "timestamp_overlay": True,
-                "timestamp_duration": 4
+                "timestamp_overlay_mode": "burn",
+                "timestamp_duration": 4,
+                "capture_mode": "autosplit",
+                "merge_mode": "batch",
+                "merge_workers": 0,
+                "merge_concurrency": 2,
+                "merge_capture_policy": "nice",
+                "merge_capture_jobs": 1
+            },
+            "pipeline": {
+                "budgets": {"cpu": 2, "io": 1, "model": 1}
             },
             "ui": {
                 "window_width": 1280,
@@ -0,0 +1,310 @@
+"""
+Bildausschnitt (Crop) und Seitenverhältnis für das Upscaling
+
+DV-Frames (720x576 bzw. 720x480) enthalten mehr als das sichtbare Bild: schwarze Ränder links und
+rechts (analoge Austastlücke, 704 statt 720 Pixel) und bei überspielten VHS/Hi8-Bändern die
+Kopfumschaltstörung in den untersten Zeilen. Beides würde sonst in voller Auflösung durch das Modell
+laufen. Außerdem sind DV-Pixel nicht quadratisch (SAR 16:15 bzw. 64:45 bei PAL 4:3/16:9), das
+Ergebnis darf also nicht stur auf 3840x2160 gezogen werden.
+
+CropDetector schneidet einige kurze Proben über das Band verteilt und wertet pro Probe aus:
+- cropdetect (schwarze Ränder, über die Probe akkumuliert)
+- signalstats YDIF (zeitliche Luma-Änderung) in 4-Zeilen-Bändern am unteren Rand gegenüber einem
+  Referenzstreifen darüber: die Kopfumschaltung flackert von Frame zu Frame viel stärker als das Bild
+
+Pro Kante zählt ein unteres Quartil der Proben (dunkle Szenen schneiden sonst zu viel weg, ein
+Bluescreen gar nichts). Das Ergebnis liegt pro Projekt als crop.json im Filmordner; mit
+"manual": true wird es nicht mehr überschrieben (Crop von Hand festlegen).
+"""
+
+import json
+import shutil
+import statistics
+import subprocess
+import tempfile
+from dataclasses import dataclass
+from fractions import Fraction
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Tuple
+
+from .ffmpeg_runner import ffprobe_for, probe_duration, run_ffmpeg
+
+
+CROP_VERSION = 1
+SAMPLE_COUNT = 12
+SAMPLE_SECONDS = 2.0
+# cropdetect: Ränder bis zu diesem Luma-Wert (0-255) gelten als schwarz
+CROP_LIMIT = 24
+# Kopfumschaltung: untere Zeilen in Bändern zu je HEAD_SWITCH_BAND, höchstens HEAD_SWITCH_BANDS Bänder
+HEAD_SWITCH_BAND = 4
+HEAD_SWITCH_BANDS = 4
+HEAD_SWITCH_RATIO = 2.5
+HEAD_SWITCH_MIN_DIFF = 6.0
+# Referenzstreifen: REFERENCE_LINES Zeilen oberhalb der untersuchten Bänder
+REFERENCE_LINES = 16
+# Mehr als ein Viertel pro Seite wegzuschneiden ist kein Rand mehr, sondern eine Fehlmessung
+MAX_CROP_SHARE = 0.25
+# DV ohne SAR-Angabe: volles Frame ist 4:3
+DEFAULT_DISPLAY_ASPECT = Fraction(4, 3)
+
+
+@dataclass
+class CropArea:
+    """Sichtbarer Bildbereich in Quellpixeln plus Pixel-Seitenverhältnis der Quelle"""
+    x: int
+    y: int
+    width: int
+    height: int
+    source_width: int
+    source_height: int
+    sar: Fraction
+    manual: bool = False
+
+    @property
+    def is_cropped(self) -> bool:
+        return (self.width, self.height) != (self.source_width, self.source_height)
+
+    @property
+    def filter(self) -> str:
+        return f"crop={self.width}:{self.height}:{self.x}:{self.y}"
+
+    @property
+    def display_aspect(self) -> float:
+        return float(self.width * self.sar / self.height)
+
+    def output_size(self, max_width: int = 3840, max_height: int = 2160) -> Tuple[int, int]:
+        """Größte Ausgabe mit quadratischen Pixeln und dem Seitenverhältnis des Ausschnitts"""
+        aspect = self.display_aspect
+        if aspect >= max_width / max_height:
+            width, height = max_width, max_width / aspect
+        else:
+            width, height = max_height * aspect, max_height
+        return _even(width), _even(height)
+
+    def uncropped(self) -> "CropArea":
+        return CropArea(0, 0, self.source_width, self.source_height, self.source_width, self.source_height, self.sar)
+
+    def to_dict(self) -> dict:
+        return {
+            "x": self.x, "y": self.y, "width": self.width, "height": self.height,
+            "source_width": self.source_width, "source_height": self.source_height,
+            "sar": f"{self.sar.numerator}/{self.sar.denominator}", "manual": self.manual,
+        }
+
+    @classmethod
+    def from_dict(cls, data: dict) -> "CropArea":
+        return cls(
+            x=int(data["x"]), y=int(data["y"]), width=int(data["width"]), height=int(data["height"]),
+            source_width=int(data["source_width"]), source_height=int(data["source_height"]),
+            sar=Fraction(data["sar"]), manual=bool(data.get("manual", False)),
+        )
+
+
+def _even(value: float) -> int:
+    return max(2, int(round(value / 2)) * 2)
+
+
+def head_switching_lines(band_diffs: List[float], reference_diff: float) -> int:
+    """
+    Anzahl gestörter Zeilen am unteren Rand
+
+    Args:
+        band_diffs: mittleres YDIF je Band, unterstes Band zuerst
+        reference_diff: mittleres YDIF des Referenzstreifens
+    """
+    limit = max(reference_diff * HEAD_SWITCH_RATIO, reference_diff + HEAD_SWITCH_MIN_DIFF)
+    lines = 0
+    for diff in band_diffs:
+        if diff < limit:
+            break
+        lines += HEAD_SWITCH_BAND
+    return lines
+
+
+def combine_samples(
+    samples: List[Tuple[int, int, int, int]],
+    source_width: int,
+    source_height: int,
+) -> Tuple[int, int, int, int]:
+    """
+    Fasst die Ränder (links, oben, rechts, unten) der Proben zusammen
+
+    Pro Kante das untere Quartil: schneidet nur, was in mindestens drei Vierteln der Proben Rand ist.
+    Returns:
+        (x, y, width, height), gerade Werte
+    """
+    if not samples:
+        return 0, 0, source_width, source_height
+    edges = []
+    for index, size in enumerate((source_width, source_height, source_width, source_height)):
+        values = sorted(sample[index] for sample in samples)
+        value = values[(len(values) - 1) // 4]
+        value = min(value, int(size * MAX_CROP_SHARE))
+        edges.append(value - value % 2)
+    left, top, right, bottom = edges
+    return left, top, source_width - left - right, source_height - top - bottom
+
+
+def probe_geometry(video_path: Path, ffmpeg_path: Optional[Path] = None) -> Optional[Tuple[int, int, Fraction]]:
+    """(Breite, Höhe, SAR) des ersten Videostreams"""
+    try:
+        result = subprocess.run(
+            [
+                ffprobe_for(ffmpeg_path or "ffmpeg"), "-v", "error", "-select_streams", "v:0",
+                "-show_entries", "stream=width,height,sample_aspect_ratio", "-of", "json", str(video_path),
+            ],
+            stdout=subprocess.PIPE,
+            stderr=subprocess.DEVNULL,
+            text=True,
+            timeout=30,
+        )
+        stream = json.loads(result.stdout)["streams"][0]
+        width, height = int(stream["width"]), int(stream["height"])
+    except (OSError, ValueError, KeyError, IndexError, subprocess.SubprocessError):
+        return None
+    try:
+        sar = Fraction(stream.get("sample_aspect_ratio", "").replace(":", "/"))
+    except (ValueError, ZeroDivisionError):
+        sar = Fraction(0)
+    if sar <= 0:
+        sar = DEFAULT_DISPLAY_ASPECT * height / width
+    return width, height, sar
+
+
+def _read_metadata(path: Path) -> List[Dict[str, float]]:
+    """Frames aus einer metadata=mode=print:file=...-Ausgabe"""
+    frames: List[Dict[str, float]] = []
+    try:
+        lines = path.read_text(encoding="utf-8", errors="replace").splitlines()
+    except OSError:
+        return frames
+    for line in lines:
+        if line.startswith("frame:"):
+            frames.append({})
+        elif frames and "=" in line:
+            key, _, value = line.partition("=")
+            try:
+                frames[-1][key.rsplit(".", 1)[-1]] = float(value)
+            except ValueError:
+                pass
+    return frames
+
+
+class CropDetector:
+    """Ermittelt den sichtbaren Bildbereich eines Videos (Proben über das Band verteilt)"""
+
+    def __init__(
+        self,
+        ffmpeg_path: Optional[Path] = None,
+        log_callback: Optional[Callable[[str], None]] = None,
+    ):
+        self.ffmpeg_path = ffmpeg_path
+        self.log_callback = log_callback
+
+    def load_or_detect(self, video_path: Path, store_path: Path, detect: bool = True) -> Optional[CropArea]:
+        """
+        Gespeicherten Crop des Projekts laden oder neu ermitteln
+
+        Args:
+            detect: False = kein Crop, nur das Seitenverhältnis der Quelle
+        """
+        geometry = probe_geometry(video_path, self.ffmpeg_path)
+        if geometry is None:
+            self.log(f"Bildgeometrie von {video_path.name} unbekannt, kein Crop")
+            return None
+        width, height, sar = geometry
+        if not detect:
+            return CropArea(0, 0, width, height, width, height, sar)
+
+        key = {"version": CROP_VERSION, "width": width, "height": height, "size": video_path.stat().st_size}
+        try:
+            data = json.loads(store_path.read_text(encoding="utf-8"))
+            crop = CropArea.from_dict(data["crop"])
+            if crop.manual or data.get("key") == key:
+                return crop
+        except (OSError, ValueError, KeyError, TypeError):
+            pass
+
+        crop = self.detect(video_path, width, height, sar)
+        try:
+            store_path.write_text(json.dumps({"key": key, "crop": crop.to_dict()}, indent=2), encoding="utf-8")
+        except OSError as e:
+            self.log(f"crop.json konnte nicht geschrieben werden: {e}")
+        return crop
+
+    def detect(self, video_path: Path, width: int, height: int, sar: Fraction) -> CropArea:
+        duration = probe_duration(video_path, ffmpeg_path=self.ffmpeg_path) or 0.0
+        count = max(1, min(SAMPLE_COUNT, int(duration // (SAMPLE_SECONDS * 2))))
+        self.log(f"Ermittle Bildausschnitt von {video_path.name} ({count} Proben)...")
+        samples = []
+        work_dir = Path(tempfile.mkdtemp(prefix="dv2plex_crop_"))
+        try:
+            for index in range(count):
+                # Proben zwischen 5% und 95% (Vorlauf/Nachlauf sind oft Bluescreen)
+                start = duration * (0.05 + 0.9 * (index + 0.5) / count) if duration else 0.0
+                sample = self._measure(video_path, start, width, height, work_dir)
+                if sample is not None:
+                    samples.append(sample)
+        finally:
+            shutil.rmtree(work_dir, ignore_errors=True)
+
+        x, y, crop_width, crop_height = combine_samples(samples, width, height)
+        crop = CropArea(x, y, crop_width, crop_height, width, height, sar)
+        output_width, output_height = crop.output_size()
+        self.log(
+            f"Bildausschnitt {crop_width}x{crop_height}+{x}+{y} von {width}x{height} "
+            f"(SAR {sar.numerator}:{sar.denominator}, {len(samples)}/{count} Proben) -> {output_width}x{output_height}"
+        )
+        return crop
+
+    def _measure(
+        self, video_path: Path, start: float, width: int, height: int, work_dir: Path
+    ) -> Optional[Tuple[int, int, int, int]]:
+        """Ränder (links, oben, rechts, unten) einer Probe, None wenn sie nichts aussagt (z.B. schwarz)"""
+        ffmpeg = str(self.ffmpeg_path) if self.ffmpeg_path else "ffmpeg"
+        bands = HEAD_SWITCH_BANDS
+        # Metadaten in Dateien (relativ zum Arbeitsordner, Windows-Pfade wären im Filter zu escapen)
+        graph = [f"[0:v]split={bands + 2}[c][r]" + "".join(f"[b{i}]" for i in range(bands))]
+        graph.append(f"[c]cropdetect=limit={CROP_LIMIT}:round=2:reset=0,metadata=mode=print:file=crop.txt[out]")
+        graph.append(
+            f"[r]crop=iw:{REFERENCE_LINES}:0:ih-{bands * HEAD_SWITCH_BAND + REFERENCE_LINES},signalstats,"
+            f"metadata=mode=print:key=lavfi.signalstats.YDIF:file=ref.txt,nullsink"
+        )
+        for i in range(bands):
+            graph.append(
+                f"[b{i}]crop=iw:{HEAD_SWITCH_BAND}:0:ih-{(i + 1) * HEAD_SWITCH_BAND},signalstats,"
+                f"metadata=mode=print:key=lavfi.signalstats.YDIF:file=band{i}.txt,nullsink"
+            )
+        cmd = [
+            ffmpeg, "-hide_banner", "-nostdin", "-y",
+            "-ss", f"{start:.3f}", "-i", str(video_path.resolve()), "-t", f"{SAMPLE_SECONDS:.3f}",
+            "-filter_complex", ";".join(graph), "-map", "[out]", "-f", "null", "-",
+        ]
+        result = run_ffmpeg(cmd, cwd=str(work_dir))
+        if result.returncode != 0:
+            self.log(f"Crop-Probe bei {start:.0f} s fehlgeschlagen: {result.stderr[-300:]}")
+            return None
+
+        crops = _read_metadata(work_dir / "crop.txt")
+        if not crops or "w" not in crops[-1]:
+            return None
+        last = crops[-1]
+        crop_x, crop_y, crop_w, crop_h = (int(last.get(key, 0)) for key in ("x", "y", "w", "h"))
+        if crop_w < width / 2 or crop_h < height / 2:
+            return None  # (fast) schwarze Probe
+        left, top = crop_x, crop_y
+        right, bottom = width - crop_x - crop_w, height - crop_y - crop_h
+
+        def median_diff(name: str) -> Optional[float]:
+            values = [frame["YDIF"] for frame in _read_metadata(work_dir / name) if "YDIF" in frame]
+            return statistics.median(values) if values else None
+
+        reference = median_diff("ref.txt")
+        band_diffs = [median_diff(f"band{i}.txt") for i in range(bands)]
+        if reference is not None and None not in band_diffs:
+            bottom = max(bottom, head_switching_lines(band_diffs, reference))
+        return left, top, right, bottom
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
@@ -0,0 +1,384 @@
+"""
+Erkennung toter Abschnitte (Bluescreen, Schwarzbild, Bandrauschen) im gemergten LowRes-Film
+
+MiniDV-Bänder enden oft mit Minuten Bluescreen oder Schwarzbild nach der letzten Aufnahme, und
+dvgrab zeichnet das treu mit auf. Ein einziger ffmpeg-Decode über den LowRes-Film liefert pro Frame
+signalstats (Luma-/Chroma-Verteilung, zeitliche Differenz) und den scdet-Szenenwert, für den Ton
+silencedetect. Tot ist ein Abschnitt, wenn das Bild mindestens `min_seconds` lang einfarbig
+(schwarz, blau, grau) oder Rauschen ist und der Ton dabei still ist (ohne Tonspur zählt nur das Bild).
+
+Herausgeschnitten ("trim") werden nur Abschnitte am Anfang oder Ende der Datei; mitten im Band
+kann auch eine stille dunkle Einstellung so aussehen, dort wird nur auf das Modell verzichtet.
+
+Das Ergebnis wird neben dem Video als <name>.analysis.json gecacht (Größe/mtime als Schlüssel).
+Die Szenenwerte aus demselben Decode verwendet auch MergeEngine._detect_scene_changes.
+"""
+
+import json
+import re
+from collections import Counter
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Tuple
+
+from .ffmpeg_runner import FFmpegProgress, format_duration, probe_duration, run_ffmpeg
+
+
+ANALYSIS_VERSION = 1
+# Analyse auf verkleinerten Frames (1/16 der Pixel, Statistik bleibt aussagekräftig)
+ANALYSIS_SIZE = "180:144"
+# Einfarbig: 10.-90. Perzentil von Luma bzw. Chroma liegen eng beieinander
+FLAT_LUMA_SPREAD = 12
+FLAT_CHROMA_SPREAD = 8
+BLACK_MAX_LUMA = 40
+# Cb eines Bluescreens (PAL-Kameras: Y~41, Cb~240)
+BLUE_MIN_CB = 160
+# Bandrauschen: starke Änderung von Frame zu Frame, ungesättigt, volle Luma-Streuung
+SNOW_MIN_LUMA_DIFF = 20
+SNOW_MAX_SATURATION = 12
+SNOW_MIN_LUMA_SPREAD = 40
+# scdet-Werte (0-100) darunter werden nicht gespeichert
+MIN_SCENE_SCORE = 5.0
+SILENCE_NOISE_DB = -50
+SILENCE_MIN_SECONDS = 0.5
+# Kurze Ausreißer (Dropouts im Rauschen) unterbrechen einen toten Abschnitt nicht
+MAX_GAP_SECONDS = 0.2
+# Puffer zu lebendem Material, damit Übergänge nicht abgeschnitten werden
+EDGE_MARGIN_SECONDS = 0.5
+DEFAULT_MIN_DEAD_SECONDS = 5.0
+
+MODE_OFF = "off"
+MODE_TRIM = "trim"
+MODE_PASSTHROUGH = "passthrough"
+
+KIND_LABELS = {"black": "Schwarzbild", "blue": "Bluescreen", "flat": "einfarbig", "snow": "Rauschen"}
+
+_FRAME_RE = re.compile(r"frame:\s*\d+\s+pts:\s*\S+\s+pts_time:\s*([-\d.]+)")
+_META_RE = re.compile(r"lavfi\.(?:signalstats\.(\w+)|scd\.(score))=([-\d.]+)")
+_SILENCE_START_RE = re.compile(r"silence_start:\s*([-\d.]+)")
+_SILENCE_END_RE = re.compile(r"silence_end:\s*([-\d.]+)")
+_AUDIO_STREAM_RE = re.compile(r"Stream #0:\d+.*: Audio:")
+
+
+@dataclass
+class DeadSegment:
+    start: float
+    end: float
+    kind: str  # black, blue, flat, snow
+
+    @property
+    def duration(self) -> float:
+        return self.end - self.start
+
+
+@dataclass
+class VideoAnalysis:
+    duration: float
+    has_audio: bool
+    dead_segments: List[DeadSegment] = field(default_factory=list)
+    # (Zeit, scdet-Wert 0-100) aller Frames ab MIN_SCENE_SCORE
+    scene_scores: List[Tuple[float, float]] = field(default_factory=list)
+
+    @property
+    def dead_seconds(self) -> float:
+        return sum(segment.duration for segment in self.dead_segments)
+
+    def scene_changes(self, threshold: float = 0.3) -> List[float]:
+        """Szenenwechsel wie select='gt(scene,threshold)' (threshold 0.0-1.0)"""
+        return [time for time, score in self.scene_scores if score > threshold * 100]
+
+    def edge_segments(self) -> List[DeadSegment]:
+        """Tote Abschnitte am Anfang oder Ende der Datei (nur die schneidet der Modus "trim" heraus)"""
+        return [
+            segment for segment in self.dead_segments
+            if segment.start < EDGE_MARGIN_SECONDS or segment.end >= self.duration
+        ]
+
+    def inner_ranges_after_trim(self) -> List[Tuple[float, float]]:
+        """Tote Abschnitte mitten im Band, in der Zeitachse der Datei ohne die Rand-Abschnitte"""
+        cut = self.edge_segments()
+        ranges = []
+        for segment in self.dead_segments:
+            if segment in cut:
+                continue
+            shift = sum(edge.duration for edge in cut if edge.end <= segment.start)
+            ranges.append((round(segment.start - shift, 3), round(segment.end - shift, 3)))
+        return ranges
+
+    def live_ranges(self, segments: Optional[List[DeadSegment]] = None) -> List[Tuple[float, float]]:
+        """Alles außer den toten Abschnitten (bzw. außer `segments`)"""
+        ranges, position = [], 0.0
+        for segment in self.dead_segments if segments is None else segments:
+            if segment.start > position:
+                ranges.append((position, segment.start))
+            position = max(position, segment.end)
+        if position < self.duration:
+            ranges.append((position, self.duration))
+        return ranges
+
+    def to_dict(self) -> dict:
+        return asdict(self)
+
+    @classmethod
+    def from_dict(cls, data: dict) -> "VideoAnalysis":
+        return cls(
+            duration=data["duration"],
+            has_audio=data["has_audio"],
+            dead_segments=[DeadSegment(**segment) for segment in data["dead_segments"]],
+            scene_scores=[tuple(item) for item in data["scene_scores"]],
+        )
+
+
+def classify_frame(stats: Dict[str, float]) -> Optional[str]:
+    """Ordnet die signalstats eines Frames ein: black/blue/flat/snow oder None (lebendes Bild)"""
+    try:
+        luma_spread = stats["YHIGH"] - stats["YLOW"]
+        chroma_spread = max(stats["UHIGH"] - stats["ULOW"], stats["VHIGH"] - stats["VLOW"])
+        if luma_spread <= FLAT_LUMA_SPREAD and chroma_spread <= FLAT_CHROMA_SPREAD:
+            if stats["YAVG"] <= BLACK_MAX_LUMA:
+                return "black"
+            if stats["UAVG"] >= BLUE_MIN_CB:
+                return "blue"
+            return "flat"
+        if (
+            stats.get("YDIF", 0) >= SNOW_MIN_LUMA_DIFF
+            and stats["SATAVG"] <= SNOW_MAX_SATURATION
+            and luma_spread >= SNOW_MIN_LUMA_SPREAD
+        ):
+            return "snow"
+    except KeyError:
+        pass
+    return None
+
+
+def find_dead_segments(
+    frames: List[Tuple[float, Optional[str]]],
+    silences: Optional[List[Tuple[float, float]]],
+    duration: float,
+    min_seconds: float = DEFAULT_MIN_DEAD_SECONDS,
+) -> List[DeadSegment]:
+    """
+    Fasst tote Frames zu Abschnitten zusammen
+
+    Args:
+        frames: (Zeit, Art) je Frame in Zeitreihenfolge, Art None = lebendes Bild
+        silences: stille Intervalle des Tons, None = keine Tonspur
+        duration: Länge des Videos
+        min_seconds: kürzere Abschnitte bleiben erhalten
+    """
+    if not frames:
+        return []
+    frame_duration = (frames[-1][0] - frames[0][0]) / (len(frames) - 1) if len(frames) > 1 else 0.04
+
+    # 1. Läufe toter Frames (kurze Lücken überbrücken)
+    runs: List[Tuple[float, float, Counter]] = []
+    for time, kind in frames:
+        if kind is None:
+            continue
+        end = time + frame_duration
+        if runs and time - runs[-1][1] <= MAX_GAP_SECONDS:
+            start, _, kinds = runs[-1]
+            kinds[kind] += 1
+            runs[-1] = (start, end, kinds)
+        else:
+            runs.append((time, end, Counter({kind: 1})))
+
+    # 2. Nur wo der Ton still ist
+    pieces: List[Tuple[float, float, Counter]] = []
+    for start, end, kinds in runs:
+        if silences is None:
+            pieces.append((start, end, kinds))
+            continue
+        for silence_start, silence_end in silences:
+            overlap_start, overlap_end = max(start, silence_start), min(end, silence_end)
+            if overlap_end > overlap_start:
+                pieces.append((overlap_start, overlap_end, kinds))
+
+    # 3. Mindestlänge, Puffer zu lebendem Material (nicht am Datei-Anfang/-Ende)
+    segments = []
+    for start, end, kinds in pieces:
+        if end - start < min_seconds:
+            continue
+        if start > frame_duration:
+            start += EDGE_MARGIN_SECONDS
+        if end < duration - frame_duration:
+            end -= EDGE_MARGIN_SECONDS
+        else:
+            end = duration
+        if end > start:
+            segments.append(DeadSegment(round(start, 3), round(end, 3), kinds.most_common(1)[0][0]))
+    return segments
+
+
+class VideoAnalyzer:
+    """Ein Decode-Durchlauf: tote Abschnitte und Szenenwerte"""
+
+    def __init__(
+        self,
+        ffmpeg_path: Optional[Path] = None,
+        log_callback: Optional[Callable[[str], None]] = None,
+        min_dead_seconds: float = DEFAULT_MIN_DEAD_SECONDS,
+    ):
+        self.ffmpeg_path = ffmpeg_path
+        self.log_callback = log_callback
+        self.min_dead_seconds = min_dead_seconds
+
+    @staticmethod
+    def cache_path(video_path: Path) -> Path:
+        return video_path.with_name(video_path.name + ".analysis.json")
+
+    def _cache_key(self, video_path: Path) -> dict:
+        stat = video_path.stat()
+        return {
+            "version": ANALYSIS_VERSION,
+            "size": stat.st_size,
+            "mtime": stat.st_mtime,
+            "min_dead_seconds": self.min_dead_seconds,
+        }
+
+    def load_cached(self, video_path: Path) -> Optional[VideoAnalysis]:
+        try:
+            data = json.loads(self.cache_path(video_path).read_text(encoding="utf-8"))
+            if data.get("key") == self._cache_key(video_path):
+                return VideoAnalysis.from_dict(data["analysis"])
+        except (OSError, ValueError, KeyError, TypeError):
+            pass
+        return None
+
+    def analyze(
+        self,
+        video_path: Path,
+        progress_callback: Optional[Callable[[FFmpegProgress], None]] = None,
+    ) -> Optional[VideoAnalysis]:
+        """Analysiert das Video (oder liefert das gecachte Ergebnis); None bei Fehler"""
+        cached = self.load_cached(video_path)
+        if cached is not None:
+            return cached
+
+        ffmpeg = str(self.ffmpeg_path) if self.ffmpeg_path else "ffmpeg"
+        duration = probe_duration(video_path, ffmpeg_path=self.ffmpeg_path)
+        frames: List[Tuple[float, Optional[str]]] = []
+        scene_scores: List[Tuple[float, float]] = []
+        silences: List[Tuple[float, float]] = []
+        state = {"time": None, "stats": {}, "silence_start": None, "has_audio": False}
+
+        def finish_frame():
+            if state["time"] is not None:
+                frames.append((state["time"], classify_frame(state["stats"])))
+                score = state["stats"].get("score")
+                if score is not None and score >= MIN_SCENE_SCORE:
+                    scene_scores.append((state["time"], score))
+            state["stats"] = {}
+
+        def on_line(line: str):
+            match = _META_RE.search(line)
+            if match:
+                state["stats"][match.group(1) or match.group(2)] = float(match.group(3))
+                return
+            match = _FRAME_RE.search(line)
+            if match:
+                finish_frame()
+                state["time"] = float(match.group(1))
+                return
+            match = _SILENCE_START_RE.search(line)
+            if match:
+                state["silence_start"] = max(0.0, float(match.group(1)))
+                return
+            match = _SILENCE_END_RE.search(line)
+            if match and state["silence_start"] is not None:
+                silences.append((state["silence_start"], float(match.group(1))))
+                state["silence_start"] = None
+                return
+            if _AUDIO_STREAM_RE.search(line):
+                state["has_audio"] = True
+
+        cmd = [
+            ffmpeg, "-hide_banner", "-nostdin",
+            "-i", str(video_path),
+            "-map", "0:v:0", "-map", "0:a:0?",
+            # scdet mit Schwelle 100 markiert nichts, schreibt aber den Wert jedes Frames
+            "-vf", f"scale={ANALYSIS_SIZE},signalstats,scdet=threshold=100,metadata=mode=print",
+            "-af", f"silencedetect=noise={SILENCE_NOISE_DB}dB:d={SILENCE_MIN_SECONDS}",
+            "-f", "null", "-",
+        ]
+        self.log(f"Analysiere {video_path.name} (Bluescreen/Schwarzbild/Rauschen, Szenen)...")
+        result = run_ffmpeg(cmd, duration=duration, progress_callback=progress_callback, line_callback=on_line)
+        finish_frame()
+        if result.returncode != 0 or not frames:
+            self.log(f"Analyse fehlgeschlagen (Code {result.returncode}): {result.stderr[-500:]}")
+            return None
+
+        duration = duration or frames[-1][0]
+        if state["silence_start"] is not None:
+            silences.append((state["silence_start"], duration))
+        analysis = VideoAnalysis(
+            duration=duration,
+            has_audio=state["has_audio"],
+            dead_segments=find_dead_segments(
+                frames, silences if state["has_audio"] else None, duration, self.min_dead_seconds
+            ),
+            scene_scores=scene_scores,
+        )
+        for segment in analysis.dead_segments:
+            self.log(
+                f"Toter Abschnitt ({segment.kind}): {format_duration(segment.start)} - "
+                f"{format_duration(segment.end)} ({segment.duration:.0f} s)"
+            )
+        try:
+            self.cache_path(video_path).write_text(
+                json.dumps({"key": self._cache_key(video_path), "analysis": analysis.to_dict()}),
+                encoding="utf-8",
+            )
+        except OSError as e:
+            self.log(f"Analyse-Cache konnte nicht geschrieben werden: {e}")
+        return analysis
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
+
+
+def describe_segments(segments: List[DeadSegment]) -> str:
+    """z.B. "1:28:03-1:31:00 Bluescreen" für Log und Job-Ergebnis"""
+    return ", ".join(
+        f"{format_duration(segment.start)}-{format_duration(segment.end)} {KIND_LABELS.get(segment.kind, segment.kind)}"
+        for segment in segments
+    )
+
+
+def write_live_ranges(
+    input_path: Path,
+    output_path: Path,
+    analysis: VideoAnalysis,
+    ffmpeg_path: Optional[Path] = None,
+    progress_callback: Optional[Callable[[FFmpegProgress], None]] = None,
+) -> bool:
+    """
+    Schreibt die Upscale-Eingabe ohne die toten Abschnitte am Anfang und Ende der Datei
+    (FFV1 verlustfrei, Ton AAC, .mkv); tote Abschnitte mitten im Band bleiben drin
+
+    Das Bild wird danach ohnehin neu kodiert, daher verlustfrei statt Stream-Copy (der bei
+    H.264 nur an Keyframes schneiden könnte). Geschrieben wird über eine .part-Datei, eine
+    vorhandene Ausgabe ist also immer vollständig.
+    """
+    ranges = analysis.live_ranges(analysis.edge_segments())
+    expr = "+".join(f"between(t,{start:.3f},{end:.3f})" for start, end in ranges)
+    ffmpeg = str(ffmpeg_path) if ffmpeg_path else "ffmpeg"
+    cmd = [
+        ffmpeg, "-hide_banner", "-nostdin", "-y",
+        "-i", str(input_path),
+        "-map", "0:v:0", "-map", "0:a:0?",
+        "-vf", f"select='{expr}',setpts=N/FRAME_RATE/TB",
+        "-c:v", "ffv1", "-level", "3", "-slices", "12",
+    ]
+    if analysis.has_audio:
+        cmd += ["-af", f"aselect='{expr}',asetpts=N/SR/TB", "-c:a", "aac", "-b:a", "192k"]
+    partial_path = output_path.with_name(f"{output_path.stem}.part{output_path.suffix}")
+    cmd.append(str(partial_path))
+    live_duration = sum(end - start for start, end in ranges)
+    result = run_ffmpeg(cmd, duration=live_duration, progress_callback=progress_callback)
+    if result.returncode != 0 or not partial_path.exists():
+        partial_path.unlink(missing_ok=True)
+        return False
+    partial_path.replace(output_path)
+    return True
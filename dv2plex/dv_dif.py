@@ -0,0 +1,233 @@
+"""
+DV-DIF-Hilfsfunktionen: Frame-Erkennung und Metadaten (Timecode, Aufnahmedatum/-zeit)
+
+Layout eines DV-Frames (IEC 61834 / SMPTE 314M):
+  10 (NTSC) bzw. 12 (PAL) DIF-Sequenzen à 150 Blöcke à 80 Bytes.
+  Block 0: Header, Block 1-2: Subcode, Block 3-5: VAUX, danach Audio/Video.
+  Jeder Block beginnt mit 3 ID-Bytes; SCT (Section Type) = Byte0 >> 5.
+"""
+
+from __future__ import annotations
+
+from dataclasses import dataclass
+from datetime import datetime
+from typing import Iterator, Optional, Tuple
+
+
+DIF_BLOCK_SIZE = 80
+DIF_BLOCKS_PER_SEQUENCE = 150
+DIF_SEQUENCE_SIZE = DIF_BLOCK_SIZE * DIF_BLOCKS_PER_SEQUENCE  # 12000
+DV_FRAME_SIZE_NTSC = 10 * DIF_SEQUENCE_SIZE  # 120000
+DV_FRAME_SIZE_PAL = 12 * DIF_SEQUENCE_SIZE  # 144000
+
+# Section Types
+SCT_HEADER = 0
+SCT_SUBCODE = 1
+SCT_VAUX = 2
+SCT_AUDIO = 3
+SCT_VIDEO = 4
+
+# Pack-IDs
+PACK_TIMECODE = 0x13
+PACK_AAUX_SOURCE = 0x50
+PACK_AAUX_SOURCE_CONTROL = 0x51
+PACK_VAUX_SOURCE = 0x60
+PACK_VAUX_SOURCE_CONTROL = 0x61
+PACK_REC_DATE = 0x62
+PACK_REC_TIME = 0x63
+
+
+@dataclass
+class DVFrameInfo:
+    """Metadaten eines einzelnen DV-Frames"""
+
+    pal: bool
+    timecode: Optional[Tuple[int, int, int, int]] = None  # (h, m, s, f)
+    rec_date: Optional[Tuple[int, int, int]] = None  # (Jahr, Monat, Tag)
+    rec_time: Optional[Tuple[int, int, int]] = None  # (h, m, s)
+
+    @property
+    def recorded_at(self) -> Optional[datetime]:
+        """Aufnahmezeitpunkt (naiv, Kamerazeit) oder None"""
+        if not (self.rec_date and self.rec_time):
+            return None
+        try:
+            return datetime(*self.rec_date, *self.rec_time)
+        except ValueError:
+            return None
+
+    def timecode_str(self) -> Optional[str]:
+        if not self.timecode:
+            return None
+        h, m, s, f = self.timecode
+        return f"{h:02d}:{m:02d}:{s:02d}:{f:02d}"
+
+
+def bcd(value: int, mask: int = 0xFF) -> int:
+    """Dekodiert ein BCD-Byte (unter Berücksichtigung einer Maske); -1 bei ungültigen Ziffern."""
+    v = value & mask
+    hi, lo = (v >> 4) & 0x0F, v & 0x0F
+    if hi > 9 or lo > 9:
+        return -1
+    return hi * 10 + lo
+
+
+def is_header_block(buf, offset: int = 0) -> bool:
+    """Prüft, ob an offset ein Header-Block der ersten DIF-Sequenz beginnt."""
+    if offset + 2 * DIF_BLOCK_SIZE > len(buf):
+        return False
+    return (
+        (buf[offset] >> 5) == SCT_HEADER
+        and (buf[offset + 1] >> 4) == 0
+        and buf[offset + 2] == 0
+        and (buf[offset + DIF_BLOCK_SIZE] >> 5) == SCT_SUBCODE
+    )
+
+
+def frame_size_from_header(buf, offset: int = 0) -> Optional[int]:
+    """Ermittelt die Frame-Größe aus dem DSF-Bit des Header-Blocks (1 = PAL/625-50)."""
+    if not is_header_block(buf, offset):
+        return None
+    return DV_FRAME_SIZE_PAL if buf[offset + 3] & 0x80 else DV_FRAME_SIZE_NTSC
+
+
+def parse_timecode_pack(pack) -> Optional[Tuple[int, int, int, int]]:
+    """Pack 0x13: Frames (Byte1), Sekunden (Byte2), Minuten (Byte3), Stunden (Byte4) – BCD."""
+    if pack[0] != PACK_TIMECODE:
+        return None
+    frames = bcd(pack[1], 0x3F)
+    seconds = bcd(pack[2], 0x7F)
+    minutes = bcd(pack[3], 0x7F)
+    hours = bcd(pack[4], 0x3F)
+    if not (0 <= hours <= 23 and 0 <= minutes <= 59 and 0 <= seconds <= 59 and 0 <= frames <= 29):
+        return None
+    return hours, minutes, seconds, frames
+
+
+def parse_rec_date_pack(pack) -> Optional[Tuple[int, int, int]]:
+    """Pack 0x62: Tag (Byte2), Monat (Byte3), Jahr zweistellig (Byte4) – BCD."""
+    if pack[0] != PACK_REC_DATE:
+        return None
+    day = bcd(pack[2], 0x3F)
+    month = bcd(pack[3], 0x1F)
+    year_2d = bcd(pack[4])
+    if not (1 <= month <= 12 and 1 <= day <= 31 and year_2d >= 0):
+        return None
+    year = 2000 + year_2d if year_2d < 70 else 1900 + year_2d
+    return year, month, day
+
+
+def parse_rec_time_pack(pack) -> Optional[Tuple[int, int, int]]:
+    """Pack 0x63: Sekunden (Byte2), Minuten (Byte3), Stunden (Byte4) – BCD."""
+    if pack[0] != PACK_REC_TIME:
+        return None
+    seconds = bcd(pack[2], 0x7F)
+    minutes = bcd(pack[3], 0x7F)
+    hours = bcd(pack[4], 0x3F)
+    if not (0 <= hours <= 23 and 0 <= minutes <= 59 and 0 <= seconds <= 59):
+        return None
+    return hours, minutes, seconds
+
+
+def _apply_pack(info: DVFrameInfo, pack):
+    pid = pack[0]
+    if pid == PACK_TIMECODE and info.timecode is None:
+        info.timecode = parse_timecode_pack(pack)
+    elif pid == PACK_REC_DATE and info.rec_date is None:
+        info.rec_date = parse_rec_date_pack(pack)
+    elif pid == PACK_REC_TIME and info.rec_time is None:
+        info.rec_time = parse_rec_time_pack(pack)
+
+
+def parse_frame_info(frame) -> DVFrameInfo:
+    """
+    Liest Timecode und Aufnahmedatum/-zeit aus einem DV-Frame.
+
+    Es werden nur Subcode- und VAUX-Blöcke der ersten DIF-Sequenz gelesen (Blöcke 1-5),
+    das ist pro Frame billig genug für die Live-Analyse während der Aufnahme.
+
+    Args:
+        frame: bytes/bytearray/memoryview mit mindestens einer DIF-Sequenz
+    """
+    pal = bool(frame[3] & 0x80) if len(frame) > 3 else False
+    info = DVFrameInfo(pal=pal)
+
+    # Subcode: 2 Blöcke à 6 SSYB (je 8 Bytes: ID0, ID1, 0xFF, 5-Byte-Pack)
+    for block in (1, 2):
+        base = block * DIF_BLOCK_SIZE + 3
+        for ssyb in range(6):
+            off = base + ssyb * 8 + 3
+            _apply_pack(info, frame[off: off + 5])
+
+    # VAUX: 3 Blöcke à 15 Packs
+    for block in (3, 4, 5):
+        base = block * DIF_BLOCK_SIZE + 3
+        for p in range(15):
+            off = base + p * 5
+            _apply_pack(info, frame[off: off + 5])
+        if info.rec_date and info.rec_time:
+            break
+
+    return info
+
+
+def iter_dv_frames(path) -> Iterator[memoryview]:
+    """
+    Liefert die DV-Frames einer Split-Datei nacheinander (Roh-DV oder AVI Typ 1/2).
+
+    Bei AVI werden die Video-Chunks ('00__', '00dc', '00db') aus dem RIFF-Container gelöst,
+    so dass die Frames direkt in einen "-f dv"-Decoder geschrieben werden können.
+    Der gelieferte memoryview wird beim nächsten Schritt überschrieben.
+    """
+    buf = bytearray(DV_FRAME_SIZE_PAL)
+    view = memoryview(buf)
+    with open(path, "rb", buffering=0) as f:
+        head = f.read(12)
+        if len(head) == 12 and head[:4] == b"RIFF" and head[8:12] == b"AVI ":
+            yield from _iter_avi_frames(f, view)
+            return
+
+        # Roh-DV: Frame-Größe aus dem ersten Header ableiten
+        view[: len(head)] = head
+        filled = len(head) + _read_full(f, view[len(head): 480])
+        frame_size = frame_size_from_header(view[:filled])
+        if frame_size is None:
+            return
+        frame = view[:frame_size]
+        filled += _read_full(f, frame[filled:])
+        while filled == frame_size:
+            yield frame
+            filled = _read_full(f, frame)
+
+
+def _read_full(f, view: memoryview) -> int:
+    filled = 0
+    while filled < len(view):
+        n = f.readinto(view[filled:])
+        if not n:
+            break
+        filled += n
+    return filled
+
+
+def _iter_avi_frames(f, view: memoryview) -> Iterator[memoryview]:
+    # Listen (RIFF/LIST) werden flach durchlaufen: ihr Inhalt besteht wieder aus Chunks,
+    # alles außer DV-Video-Chunks wird übersprungen (hdrl, idx1, JUNK, Audio bei Typ 2).
+    header = bytearray(8)
+    while _read_full(f, memoryview(header)) == 8:
+        chunk_id = bytes(header[:4])
+        size = int.from_bytes(header[4:8], "little")
+        if chunk_id in (b"RIFF", b"LIST"):
+            if len(f.read(4)) < 4:
+                return
+            continue
+        padded = size + (size & 1)
+        if chunk_id[2:] in (b"__", b"dc", b"db") and size in (DV_FRAME_SIZE_NTSC, DV_FRAME_SIZE_PAL):
+            frame = view[:size]
+            if _read_full(f, frame) < size:
+                return
+            yield frame
+            if padded != size:
+                f.seek(padded - size, 1)
+        else:
+            f.seek(padded, 1)
@@ -0,0 +1,320 @@
+"""
+DV-Index: Metadaten aller Frames einer Split-Datei in einem Durchlauf
+
+Die Datei wird per mmap eingeblendet (keine Kopie), die Frame-Offsets werden über die
+Header-Blöcke (Roh-DV) bzw. die Chunk-Header (AVI Typ 1/2) bestimmt. Danach werden pro
+Frame Timecode, Aufnahmedatum/-zeit und AAUX/VAUX-Flags aus der ersten DIF-Sequenz gelesen:
+mit numpy vektorisiert über alle Frames auf einmal, ohne numpy mit einer reinen
+Python-Schleife, die nur passende Packs als Slice anfasst.
+
+Beide Varianten liefern identische Ergebnisse (erstes gültiges Pack je Typ, in derselben
+Reihenfolge wie dv_dif.parse_frame_info: Subcode-Blöcke 1-2, dann VAUX-Blöcke 3-5).
+"""
+
+from __future__ import annotations
+
+import mmap
+from dataclasses import dataclass, field
+from datetime import datetime
+from pathlib import Path
+from typing import List, Optional
+
+from .dv_dif import (
+    DIF_BLOCK_SIZE,
+    DV_FRAME_SIZE_NTSC,
+    DV_FRAME_SIZE_PAL,
+    DVFrameInfo,
+    PACK_AAUX_SOURCE,
+    PACK_REC_DATE,
+    PACK_REC_TIME,
+    PACK_TIMECODE,
+    PACK_VAUX_SOURCE,
+    frame_size_from_header,
+    parse_rec_date_pack,
+    parse_rec_time_pack,
+    parse_timecode_pack,
+)
+
+try:
+    import numpy as np
+except ImportError:  # pragma: no cover - numpy ist optional
+    np = None
+
+
+# Flags pro Frame
+FLAG_PAL = 0x01
+FLAG_AAUX = 0x02  # AAUX-Source-Pack (0x50) in den Audio-Blöcken vorhanden
+FLAG_VAUX = 0x04  # VAUX-Source-Pack (0x60) in den VAUX-Blöcken vorhanden
+
+# Pack-Positionen relativ zum Frame-Anfang (erste DIF-Sequenz)
+# Subcode: Blöcke 1-2 à 6 SSYB (ID0, ID1, 0xFF, 5-Byte-Pack)
+SUBCODE_PACK_OFFSETS = tuple(b * DIF_BLOCK_SIZE + 3 + s * 8 + 3 for b in (1, 2) for s in range(6))
+# VAUX: Blöcke 3-5 à 15 Packs
+VAUX_PACK_OFFSETS = tuple(b * DIF_BLOCK_SIZE + 3 + p * 5 for b in (3, 4, 5) for p in range(15))
+# Audio: jeder 16. Block ab Block 6, AAUX-Pack direkt nach den ID-Bytes
+AAUX_PACK_OFFSETS = tuple((6 + 16 * k) * DIF_BLOCK_SIZE + 3 for k in range(9))
+META_PACK_OFFSETS = SUBCODE_PACK_OFFSETS + VAUX_PACK_OFFSETS
+
+# Nur so viel vom Frame wird gelesen
+SCAN_SPAN = AAUX_PACK_OFFSETS[-1] + 5
+
+# Nicht-DV-Dateien schnell erkennen: erster Header muss in diesem Bereich liegen
+MAX_LEADING_GARBAGE = DV_FRAME_SIZE_PAL
+
+# Frames pro numpy-Durchgang (begrenzt die Größe der Zwischen-Arrays)
+NUMPY_BATCH_FRAMES = 4096
+
+HEADER_ID = b"\x1f\x07\x00"
+
+
+@dataclass
+class DVIndex:
+    """
+    Metadaten-Index einer DV-Datei, eine Zeile pro Frame.
+
+    Werte sind als Ganzzahlen gepackt, -1 = nicht vorhanden:
+        timecodes: HHMMSSFF, rec_dates: YYYYMMDD, rec_times: HHMMSS
+    """
+
+    path: Optional[Path] = None
+    backend: str = "python"
+    offsets: List[int] = field(default_factory=list)
+    flags: List[int] = field(default_factory=list)
+    timecodes: List[int] = field(default_factory=list)
+    rec_dates: List[int] = field(default_factory=list)
+    rec_times: List[int] = field(default_factory=list)
+
+    def __len__(self) -> int:
+        return len(self.offsets)
+
+    def frame_info(self, i: int) -> DVFrameInfo:
+        tc, date, time_ = self.timecodes[i], self.rec_dates[i], self.rec_times[i]
+        return DVFrameInfo(
+            pal=bool(self.flags[i] & FLAG_PAL),
+            timecode=(tc // 1000000, tc // 10000 % 100, tc // 100 % 100, tc % 100) if tc >= 0 else None,
+            rec_date=(date // 10000, date // 100 % 100, date % 100) if date >= 0 else None,
+            rec_time=(time_ // 10000, time_ // 100 % 100, time_ % 100) if time_ >= 0 else None,
+        )
+
+    def recorded_at(self, i: int) -> Optional[datetime]:
+        if self.rec_dates[i] < 0 or self.rec_times[i] < 0:
+            return None
+        return self.frame_info(i).recorded_at
+
+    def first_recorded_at(self) -> Optional[datetime]:
+        """Aufnahmezeitpunkt des ersten Frames mit gültigem Datum und Uhrzeit"""
+        for i in range(len(self)):
+            recorded_at = self.recorded_at(i)
+            if recorded_at:
+                return recorded_at
+        return None
+
+    def _extend(self, other: "DVIndex"):
+        self.offsets.extend(other.offsets)
+        self.flags.extend(other.flags)
+        self.timecodes.extend(other.timecodes)
+        self.rec_dates.extend(other.rec_dates)
+        self.rec_times.extend(other.rec_times)
+
+
+def scan_dv_file(path, max_frames: Optional[int] = None, use_numpy: Optional[bool] = None) -> DVIndex:
+    """
+    Erstellt den Frame-Index einer Split-Datei (Roh-DV oder AVI Typ 1/2).
+
+    Args:
+        path: Pfad zur Datei
+        max_frames: Nur die ersten N Frames indizieren (None = alle)
+        use_numpy: None = numpy verwenden, falls installiert
+    """
+    path = Path(path)
+    with open(path, "rb") as f:
+        try:
+            mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        except ValueError:  # leere Datei
+            return DVIndex(path=path)
+    try:
+        if hasattr(mm, "madvise") and hasattr(mmap, "MADV_SEQUENTIAL"):
+            mm.madvise(mmap.MADV_SEQUENTIAL)
+        index = scan_dv_buffer(mm, max_frames=max_frames, use_numpy=use_numpy)
+        index.path = path
+        return index
+    finally:
+        mm.close()
+
+
+def scan_dv_buffer(buf, max_frames: Optional[int] = None, use_numpy: Optional[bool] = None) -> DVIndex:
+    """Wie scan_dv_file, aber für bytes/bytearray/mmap im Speicher."""
+    if use_numpy is None:
+        use_numpy = np is not None
+    elif use_numpy and np is None:
+        raise RuntimeError("numpy ist nicht installiert")
+
+    offsets = find_frame_offsets(buf, max_frames)
+    if use_numpy:
+        return _scan_numpy(buf, offsets)
+    return _scan_python(buf, offsets)
+
+
+# --- Frame-Offsets -------------------------------------------------------------
+
+
+def find_frame_offsets(buf, max_frames: Optional[int] = None) -> List[int]:
+    """Offsets aller vollständigen DV-Frames (Roh-DV mit Resync oder AVI-Chunks)."""
+    if len(buf) >= 12 and buf[0:4] == b"RIFF" and buf[8:12] == b"AVI ":
+        return _avi_frame_offsets(buf, max_frames)
+    return _raw_frame_offsets(buf, max_frames)
+
+
+def _raw_frame_offsets(buf, max_frames: Optional[int]) -> List[int]:
+    offsets: List[int] = []
+    size = len(buf)
+    pos = 0
+    limit = MAX_LEADING_GARBAGE
+    while max_frames is None or len(offsets) < max_frames:
+        frame_size = frame_size_from_header(buf, pos)
+        if frame_size is None:
+            # Resync: nächsten Header-Block suchen (vor dem ersten Frame nur kurz)
+            pos = buf.find(HEADER_ID, pos + 1, size if limit is None else min(size, limit))
+            if pos < 0:
+                break
+            continue
+        if pos + frame_size > size:
+            break
+        offsets.append(pos)
+        pos += frame_size
+        limit = None
+    return offsets
+
+
+def _avi_frame_offsets(buf, max_frames: Optional[int]) -> List[int]:
+    # Listen (RIFF/LIST) flach durchlaufen, siehe dv_dif._iter_avi_frames
+    offsets: List[int] = []
+    size = len(buf)
+    pos = 0
+    while pos + 8 <= size and (max_frames is None or len(offsets) < max_frames):
+        chunk_id = bytes(buf[pos: pos + 4])
+        chunk_size = int.from_bytes(buf[pos + 4: pos + 8], "little")
+        if chunk_id in (b"RIFF", b"LIST"):
+            pos += 12
+            continue
+        data = pos + 8
+        if (
+            chunk_id[2:] in (b"__", b"dc", b"db")
+            and chunk_size in (DV_FRAME_SIZE_NTSC, DV_FRAME_SIZE_PAL)
+            and data + chunk_size <= size
+        ):
+            offsets.append(data)
+        pos = data + chunk_size + (chunk_size & 1)
+    return offsets
+
+
+# --- Python-Fallback -----------------------------------------------------------
+
+
+def _scan_python(buf, offsets: List[int]) -> DVIndex:
+    index = DVIndex(backend="python")
+    for o in offsets:
+        flags = FLAG_PAL if buf[o + 3] & 0x80 else 0
+        timecode = rec_date = rec_time = None
+        for rel in META_PACK_OFFSETS:
+            p = o + rel
+            pid = buf[p]
+            if pid == PACK_TIMECODE:
+                if timecode is None:
+                    timecode = parse_timecode_pack(buf[p: p + 5])
+            elif pid == PACK_REC_DATE:
+                if rec_date is None:
+                    rec_date = parse_rec_date_pack(buf[p: p + 5])
+            elif pid == PACK_REC_TIME:
+                if rec_time is None:
+                    rec_time = parse_rec_time_pack(buf[p: p + 5])
+            elif pid == PACK_VAUX_SOURCE and rel in VAUX_PACK_OFFSETS:
+                flags |= FLAG_VAUX
+        for rel in AAUX_PACK_OFFSETS:
+            if buf[o + rel] == PACK_AAUX_SOURCE:
+                flags |= FLAG_AAUX
+                break
+
+        index.offsets.append(o)
+        index.flags.append(flags)
+        index.timecodes.append(
+            timecode[0] * 1000000 + timecode[1] * 10000 + timecode[2] * 100 + timecode[3] if timecode else -1
+        )
+        index.rec_dates.append(rec_date[0] * 10000 + rec_date[1] * 100 + rec_date[2] if rec_date else -1)
+        index.rec_times.append(rec_time[0] * 10000 + rec_time[1] * 100 + rec_time[2] if rec_time else -1)
+    return index
+
+
+# --- numpy ---------------------------------------------------------------------
+
+
+def _scan_numpy(buf, offsets: List[int]) -> DVIndex:
+    index = DVIndex(backend="numpy")
+    if not offsets:
+        return index
+    data = np.frombuffer(buf, dtype=np.uint8)
+    meta_rel = np.asarray(META_PACK_OFFSETS, dtype=np.int64)
+    vaux_cols = np.isin(meta_rel, VAUX_PACK_OFFSETS)
+    aaux_rel = np.asarray(AAUX_PACK_OFFSETS, dtype=np.int64)
+    all_offsets = np.asarray(offsets, dtype=np.int64)
+
+    for start in range(0, len(all_offsets), NUMPY_BATCH_FRAMES):
+        frame_offsets = all_offsets[start: start + NUMPY_BATCH_FRAMES]
+        index._extend(_scan_numpy_batch(data, frame_offsets, meta_rel, vaux_cols, aaux_rel))
+    del data  # Export auf den mmap freigeben, bevor er geschlossen wird
+    return index
+
+
+def _bcd_np(values, mask: int):
+    """Vektorisiertes dv_dif.bcd: -1 bei ungültigen Ziffern."""
+    v = values & mask
+    hi, lo = v >> 4, v & 0x0F
+    return np.where((hi <= 9) & (lo <= 9), hi * 10 + lo, -1)
+
+
+def _first_valid(pack_ids, pack_id: int, valid, value):
+    """Wert des ersten Packs mit passender ID und gültigem Inhalt je Frame, sonst -1."""
+    hit = (pack_ids == pack_id) & valid
+    col = hit.argmax(axis=1)
+    rows = np.arange(len(hit))
+    return np.where(hit[rows, col], value[rows, col], -1)
+
+
+def _scan_numpy_batch(data, frame_offsets, meta_rel, vaux_cols, aaux_rel) -> DVIndex:
+    # (Frames x Packs)-Matrix der Pack-Positionen, daraus ID und Nutzbytes 1-4
+    pos = frame_offsets[:, None] + meta_rel[None, :]
+    pack_ids = data[pos]
+    b1, b2, b3, b4 = (data[pos + k].astype(np.int32) for k in range(1, 5))
+
+    # Timecode (0x13): FF SS MM HH
+    tc_f, tc_s, tc_m, tc_h = _bcd_np(b1, 0x3F), _bcd_np(b2, 0x7F), _bcd_np(b3, 0x7F), _bcd_np(b4, 0x3F)
+    tc_valid = (
+        (tc_h >= 0) & (tc_h <= 23) & (tc_m >= 0) & (tc_m <= 59)
+        & (tc_s >= 0) & (tc_s <= 59) & (tc_f >= 0) & (tc_f <= 29)
+    )
+    timecodes = _first_valid(pack_ids, PACK_TIMECODE, tc_valid, tc_h * 1000000 + tc_m * 10000 + tc_s * 100 + tc_f)
+
+    # Datum (0x62): -- TT MM JJ
+    day, month, year_2d = _bcd_np(b2, 0x3F), _bcd_np(b3, 0x1F), _bcd_np(b4, 0xFF)
+    date_valid = (month >= 1) & (month <= 12) & (day >= 1) & (day <= 31) & (year_2d >= 0)
+    year = np.where(year_2d < 70, 2000 + year_2d, 1900 + year_2d)
+    rec_dates = _first_valid(pack_ids, PACK_REC_DATE, date_valid, year * 10000 + month * 100 + day)
+
+    # Uhrzeit (0x63): -- SS MM HH
+    sec, minute, hour = _bcd_np(b2, 0x7F), _bcd_np(b3, 0x7F), _bcd_np(b4, 0x3F)
+    time_valid = (hour >= 0) & (hour <= 23) & (minute >= 0) & (minute <= 59) & (sec >= 0) & (sec <= 59)
+    rec_times = _first_valid(pack_ids, PACK_REC_TIME, time_valid, hour * 10000 + minute * 100 + sec)
+
+    flags = np.where(data[frame_offsets + 3] & 0x80, FLAG_PAL, 0)
+    flags |= np.where((pack_ids[:, vaux_cols] == PACK_VAUX_SOURCE).any(axis=1), FLAG_VAUX, 0)
+    aaux_ids = data[frame_offsets[:, None] + aaux_rel[None, :]]
+    flags |= np.where((aaux_ids == PACK_AAUX_SOURCE).any(axis=1), FLAG_AAUX, 0)
+
+    return DVIndex(
+        backend="numpy",
+        offsets=frame_offsets.tolist(),
+        flags=flags.tolist(),
+        timecodes=timecodes.tolist(),
+        rec_dates=rec_dates.tolist(),
+        rec_times=rec_times.tolist(),
+    )
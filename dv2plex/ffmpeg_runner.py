@@ -0,0 +1,277 @@
+"""
+Gemeinsamer ffmpeg-Aufruf mit strukturiertem Fortschritt
+
+run_ffmpeg() ergänzt "-progress pipe:2 -nostats": ffmpeg schreibt dann alle ~0,5 s einen Block
+key=value-Zeilen (frame, fps, out_time_us, speed, bitrate, ..., progress=continue|end) auf stderr.
+Daraus entstehen Prozent und ETA (über die bekannte Eingangsdauer bzw. Frame-Anzahl), die an einen
+Callback gehen. Von den übrigen stderr-Zeilen wird nur ein begrenztes Ende behalten, statt die
+gesamte Ausgabe eines stundenlangen Encodes im Speicher zu puffern.
+
+Der Prozess wird wie bei job_control.run() beim JobControl des aktuellen Threads angemeldet
+(Drosseln/Anhalten während einer Aufnahme).
+"""
+
+import re
+import shutil
+import subprocess
+import threading
+import time
+from collections import deque
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Callable, List, Optional
+
+from . import job_control
+
+
+STDERR_TAIL_LINES = 200
+
+_PROGRESS_LINE = re.compile(r"^([a-z_0-9]+)=\s*(\S*)\s*$")
+_PROGRESS_KEYS = {
+    "frame", "fps", "stream_0_0_q", "bitrate", "total_size", "out_time_us", "out_time_ms",
+    "out_time", "dup_frames", "drop_frames", "speed", "progress",
+}
+
+
+@dataclass
+class FFmpegProgress:
+    """Letzter Fortschrittsblock eines ffmpeg-Laufs"""
+    frame: int = 0
+    fps: float = 0.0
+    out_time: float = 0.0  # Sekunden Ausgabe
+    speed: float = 0.0  # Vielfaches der Echtzeit
+    bitrate: str = ""
+    total_size: int = 0
+    dup_frames: int = 0
+    drop_frames: int = 0
+    percent: Optional[float] = None
+    eta: Optional[float] = None  # Sekunden
+    elapsed: float = 0.0
+    updates: int = 0  # Anzahl empfangener Blöcke (0 = ffmpeg hat keinen Fortschritt gemeldet)
+    finished: bool = False
+
+    def describe(self) -> str:
+        """Kurzform für Logs und Statusmeldungen, z.B. "42% · 87 fps · 3.5x · noch 2:15\""""
+        parts = []
+        if self.percent is not None:
+            parts.append(f"{self.percent:.0f}%")
+        else:
+            parts.append(f"{self.frame} Frames")
+        if self.fps:
+            parts.append(f"{self.fps:.0f} fps")
+        if self.speed:
+            parts.append(f"{self.speed:.1f}x")
+        if self.eta is not None:
+            parts.append(f"noch {format_duration(self.eta)}")
+        return " · ".join(parts)
+
+
+class FFmpegResult(subprocess.CompletedProcess):
+    """CompletedProcess mit stderr-Ende (str) und letztem Fortschritt"""
+
+    def __init__(self, args, returncode, stdout, stderr, progress: FFmpegProgress):
+        super().__init__(args, returncode, stdout, stderr)
+        self.progress = progress
+
+
+def format_duration(seconds: float) -> str:
+    seconds = max(0, int(round(seconds)))
+    hours, rest = divmod(seconds, 3600)
+    minutes, secs = divmod(rest, 60)
+    return f"{hours}:{minutes:02d}:{secs:02d}" if hours else f"{minutes}:{secs:02d}"
+
+
+def with_progress_args(cmd: List[str]) -> List[str]:
+    """Fügt -progress pipe:2 -nostats direkt nach dem Programm ein (globale Optionen)"""
+    cmd = [str(part) for part in cmd]
+    if "-progress" in cmd:
+        return cmd
+    cmd = [arg for arg in cmd if arg != "-stats"]
+    return [cmd[0], "-progress", "pipe:2", "-nostats", *cmd[1:]]
+
+
+def ffprobe_for(ffmpeg_path) -> str:
+    """ffprobe neben ffmpeg, sonst aus dem PATH"""
+    sibling = Path(str(ffmpeg_path)).with_name("ffprobe")
+    if sibling.exists():
+        return str(sibling)
+    return shutil.which("ffprobe") or "ffprobe"
+
+
+def probe_duration(path: Path, ffprobe_path=None, ffmpeg_path=None) -> Optional[float]:
+    """Dauer einer Mediendatei in Sekunden (ffprobe, Container-Header)"""
+    ffprobe = str(ffprobe_path) if ffprobe_path else ffprobe_for(ffmpeg_path or "ffmpeg")
+    try:
+        result = subprocess.run(
+            [ffprobe, "-v", "error", "-show_entries", "format=duration", "-of", "csv=p=0", str(path)],
+            stdout=subprocess.PIPE,
+            stderr=subprocess.DEVNULL,
+            text=True,
+            timeout=30,
+        )
+        duration = float(result.stdout.strip().splitlines()[0])
+        return duration if duration > 0 else None
+    except Exception:
+        return None
+
+
+class ProgressParser:
+    """Sammelt key=value-Zeilen und schließt bei "progress=" einen Block ab"""
+
+    def __init__(self, duration: Optional[float] = None, total_frames: Optional[int] = None):
+        self.duration = duration if duration and duration > 0 else None
+        self.total_frames = total_frames if total_frames and total_frames > 0 else None
+        self.progress = FFmpegProgress()
+        self._started = time.monotonic()
+
+    def feed(self, line: str) -> Optional[bool]:
+        """
+        Verarbeitet eine stderr-Zeile.
+
+        Returns:
+            None = keine Fortschrittszeile, False = Teil eines Blocks, True = Block abgeschlossen
+        """
+        match = _PROGRESS_LINE.match(line)
+        if not match or match.group(1) not in _PROGRESS_KEYS:
+            return None
+        key, value = match.groups()
+        p = self.progress
+        try:
+            if key == "frame":
+                p.frame = int(value)
+            elif key == "fps":
+                p.fps = float(value)
+            elif key == "out_time_us" or key == "out_time_ms":  # beide in Mikrosekunden
+                p.out_time = max(0.0, int(value) / 1_000_000)
+            elif key == "speed":
+                p.speed = float(value.rstrip("x")) if value not in ("N/A", "") else 0.0
+            elif key == "bitrate":
+                p.bitrate = value
+            elif key == "total_size":
+                p.total_size = int(value)
+            elif key == "dup_frames":
+                p.dup_frames = int(value)
+            elif key == "drop_frames":
+                p.drop_frames = int(value)
+        except ValueError:
+            pass
+        if key != "progress":
+            return False
+        p.updates += 1
+        p.finished = value == "end"
+        self._update_estimate()
+        return True
+
+    def finish(self) -> FFmpegProgress:
+        self.progress.finished = True
+        self._update_estimate()
+        return self.progress
+
+    def _update_estimate(self):
+        p = self.progress
+        p.elapsed = time.monotonic() - self._started
+        fraction = None
+        if self.duration and p.out_time:
+            fraction = p.out_time / self.duration
+        elif self.total_frames and p.frame:
+            fraction = p.frame / self.total_frames
+        if fraction is None:
+            p.percent = None
+            p.eta = None
+            return
+        fraction = min(1.0, max(0.0, fraction))
+        p.percent = 100.0 if p.finished else fraction * 100
+        if p.finished or fraction >= 1.0:
+            p.eta = 0.0
+        elif self.duration and p.speed > 0:
+            p.eta = (self.duration - p.out_time) / p.speed
+        elif fraction > 0:
+            p.eta = p.elapsed * (1 - fraction) / fraction
+        else:
+            p.eta = None
+
+
+def run_ffmpeg(
+    cmd: List[str],
+    duration: Optional[float] = None,
+    total_frames: Optional[int] = None,
+    progress_callback: Optional[Callable[[FFmpegProgress], None]] = None,
+    stdout=subprocess.DEVNULL,
+    stdin=subprocess.DEVNULL,
+    tail_lines: int = STDERR_TAIL_LINES,
+    on_start: Optional[Callable[[subprocess.Popen], None]] = None,
+    line_callback: Optional[Callable[[str], None]] = None,
+    **popen_kwargs,
+) -> FFmpegResult:
+    """
+    Führt ffmpeg mit strukturiertem Fortschritt aus.
+
+    Args:
+        cmd: ffmpeg-Befehl (Programm zuerst)
+        duration: Dauer der Ausgabe in Sekunden (für Prozent/ETA über out_time)
+        total_frames: alternativ erwartete Frame-Anzahl
+        progress_callback: erhält nach jedem Fortschrittsblock das FFmpegProgress
+        stdout: wie bei subprocess (PIPE liefert die Bytes in result.stdout)
+        on_start: erhält den gestarteten Prozess (z.B. zum Abbrechen)
+        line_callback: erhält jede stderr-Zeile außer den Fortschrittszeilen (z.B. Filter-Ausgaben)
+
+    Returns:
+        FFmpegResult mit den letzten tail_lines stderr-Zeilen (ohne Fortschrittszeilen)
+    """
+    cmd = with_progress_args(cmd)
+    parser = ProgressParser(duration, total_frames)
+    tail: deque = deque(maxlen=tail_lines)
+    control = job_control.current_control()
+
+    with subprocess.Popen(cmd, stdin=stdin, stdout=stdout, stderr=subprocess.PIPE, **popen_kwargs) as process:
+        if control:
+            control.attach(process)
+        if on_start:
+            on_start(process)
+        captured: List[bytes] = []
+        reader = None
+        if stdout == subprocess.PIPE:
+            reader = threading.Thread(target=lambda: captured.append(process.stdout.read()), daemon=True)
+            reader.start()
+        try:
+            for raw in iter(process.stderr.readline, b""):
+                line = raw.decode("utf-8", errors="replace").rstrip("\r\n")
+                done = parser.feed(line)
+                if done is None:
+                    if line.strip():
+                        tail.append(line)
+                        if line_callback:
+                            line_callback(line)
+                elif done and progress_callback:
+                    try:
+                        progress_callback(parser.progress)
+                    except Exception:
+                        pass
+            process.wait()
+            if reader:
+                reader.join()
+        except BaseException:
+            process.kill()
+            raise
+        finally:
+            if control:
+                control.detach(process)
+
+    return FFmpegResult(cmd, process.returncode, b"".join(captured) if reader else None, "\n".join(tail), parser.finish())
+
+
+def percent_callback(
+    callback: Optional[Callable[[int, str], None]],
+    start: int = 0,
+    end: int = 100,
+) -> Optional[Callable[[FFmpegProgress], None]]:
+    """Bildet den ffmpeg-Fortschritt auf (Prozent in [start, end], Beschreibung) ab"""
+    if callback is None:
+        return None
+
+    def on_progress(progress: FFmpegProgress):
+        if progress.percent is None:
+            return
+        callback(int(start + (end - start) * progress.percent / 100), progress.describe())
+
+    return on_progress
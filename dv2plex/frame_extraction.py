@@ -9,6 +9,8 @@ from pathlib import Path
 from typing import List, Optional, Callable
 import logging
 
+from .ffmpeg_runner import run_ffmpeg
+
 
 class FrameExtractionEngine:
     """Verwaltet die Extraktion von Frames aus Videos"""
@@ -87,15 +89,13 @@ class FrameExtractionEngine:
                 except Exception:
                     pass
 
-            # Fallback: ffmpeg-Parsing (falls ffprobe nicht verfügbar ist)
+            # Fallback: ffmpeg-Parsing (falls ffprobe nicht verfügbar ist); ohne Ausgabe liest
+            # ffmpeg nur den Header und dekodiert nicht das ganze Video
             cmd2 = [
                 str(self.ffmpeg_path),
+                "-hide_banner",
                 "-i",
                 str(video_path),
-                "-hide_banner",
-                "-f",
-                "null",
-                "-",
             ]
 
             result2 = subprocess.run(
@@ -189,18 +189,13 @@ class FrameExtractionEngine:
                     str(output_file)
                 ]
                 
-                result = subprocess.run(
-                    cmd,
-                    stdout=subprocess.PIPE,
-                    stderr=subprocess.STDOUT,
-                    text=True
-                )
+                result = run_ffmpeg(cmd)
                 
                 if result.returncode == 0 and output_file.exists():
                     extracted_frames.append(output_file)
                     self.log(f"Frame extrahiert: {output_file.name} (bei {time_point:.2f}s)")
                 else:
-                    self.log(f"Fehler beim Extrahieren von Frame bei {time_point:.2f}s: {result.stdout}")
+                    self.log(f"Fehler beim Extrahieren von Frame bei {time_point:.2f}s: {result.stderr}")
             
             return extracted_frames
             
@@ -0,0 +1,431 @@
+"""
+Inkrementeller Merge: Split-Dateien werden schon während der Aufnahme einzeln kodiert
+
+Jeder fertige Split wird sofort zu einem MP4-Segment (libx264, nur Bild, Timestamp-Overlay der
+ersten Sekunden direkt eingebrannt bzw. im Modus "soft" als Untertitelspur beim concat)
+in LowRes/segments/ kodiert. Nach dem Stopp muss nur
+noch der letzte Split kodiert und alles per Stream-Copy (concat) zusammengefügt werden.
+
+Der Ton wird erst beim Abschluss in einem Stück aus allen Splits kodiert (wie in
+parallel_encode): AAC je Segment brächte an jeder Naht Priming-/Padding-Samples mit, über
+hunderte Splits hörbare Lücken und wachsenden Versatz zum Bild.
+
+Ein Manifest (segments.json) hält fest, welche Splits bereits fertig kodiert sind; nach
+einem Absturz werden nur fehlende Segmente neu erzeugt.
+"""
+
+import json
+import os
+import shutil
+import threading
+from datetime import datetime
+from pathlib import Path
+from queue import Queue, Empty
+from typing import Callable, Dict, List, Optional
+
+from . import job_control
+from .ffmpeg_runner import FFmpegProgress, percent_callback, run_ffmpeg
+from .job_control import JobControl
+from .merge import MergeEngine
+from .split_manifest import SplitManifest, recorded_at_of
+from .timestamp_overlay import MODE_BURN, MODE_SOFT, cues_from_splits, normalize_mode, soft_subtitle_args, write_ass
+
+
+MANIFEST_NAME = "segments.json"
+MANIFEST_VERSION = 1
+SPLIT_PATTERNS = ("*.avi", "*.dv", "*.AVI", "*.DV")
+
+
+class IncrementalMerger:
+    """
+    Kodiert Splits im Hintergrund zu Segmenten und fügt sie am Ende per Stream-Copy zusammen.
+
+    Args:
+        ffmpeg_path: Pfad zu ffmpeg
+        splits_dir: LowRes/splits/
+        segments_dir: Zielordner für Segmente (Standard: LowRes/segments/)
+        timestamp_duration: Sekunden, die der Aufnahme-Timestamp am Segmentanfang sichtbar ist
+        timestamp_mode: "burn" (je Segment ein drawtext), "soft" (mov_text-Spur beim concat) oder "off"
+        control: JobControl für die Hintergrund-Kodierung (Drosselung durch den Merge-Scheduler)
+        split_manifest: Split-Manifest der laufenden Aufnahme (Aufnahmezeit für das Overlay)
+    """
+
+    def __init__(
+        self,
+        ffmpeg_path: Path,
+        splits_dir: Path,
+        segments_dir: Optional[Path] = None,
+        log_callback: Optional[Callable[[str], None]] = None,
+        timestamp_duration: int = 4,
+        timestamp_mode: str = MODE_BURN,
+        control: Optional[JobControl] = None,
+        split_manifest: Optional[SplitManifest] = None,
+    ):
+        self.ffmpeg_path = ffmpeg_path
+        self.control = control
+        self.split_manifest = split_manifest
+        self.splits_dir = Path(splits_dir)
+        self.segments_dir = Path(segments_dir) if segments_dir else self.default_segments_dir(self.splits_dir)
+        self.log_callback = log_callback
+        self.timestamp_duration = timestamp_duration
+        self.timestamp_mode = normalize_mode(timestamp_mode)
+        self.merge_engine = MergeEngine(
+            ffmpeg_path,
+            log_callback=log_callback,
+            timestamp_mode=self.timestamp_mode,
+            timestamp_duration=timestamp_duration,
+        )
+        self._queue: Queue = Queue()
+        self._queued: set = set()
+        self._lock = threading.Lock()
+        self._stop_event = threading.Event()
+        self._worker: Optional[threading.Thread] = None
+        self._manifest: Dict[str, dict] = {}
+        self.failed: List[str] = []
+        self._load_manifest()
+
+    # --- Manifest ----------------------------------------------------------
+
+    @staticmethod
+    def default_segments_dir(splits_dir: Path) -> Path:
+        return Path(splits_dir).parent / "segments"
+
+    @classmethod
+    def has_segments(cls, splits_dir: Path) -> bool:
+        """True, wenn für diesen splits-Ordner bereits Segmente (z.B. vor einem Absturz) existieren."""
+        return (cls.default_segments_dir(splits_dir) / MANIFEST_NAME).exists()
+
+    def _settings_signature(self) -> str:
+        overlay = f"ts{self.timestamp_duration}" if self.timestamp_mode == MODE_BURN else "nots"
+        return f"libx264-medium-crf20-yuv420p-noaudio-{overlay}"
+
+    @property
+    def manifest_path(self) -> Path:
+        return self.segments_dir / MANIFEST_NAME
+
+    def _load_manifest(self):
+        if not self.manifest_path.exists():
+            return
+        try:
+            data = json.loads(self.manifest_path.read_text(encoding="utf-8"))
+        except Exception as e:
+            self.log(f"Inkrementeller Merge: Manifest unlesbar, beginne neu ({e})")
+            return
+        if data.get("version") != MANIFEST_VERSION or data.get("settings") != self._settings_signature():
+            self.log("Inkrementeller Merge: Manifest mit anderen Einstellungen, Segmente werden neu kodiert")
+            return
+        segments = data.get("segments", {})
+        # Nur Einträge übernehmen, deren Segment existiert und deren Split unverändert ist
+        for split_name, entry in segments.items():
+            split = self.splits_dir / split_name
+            segment = self.segments_dir / entry.get("segment", "")
+            try:
+                if segment.is_file() and split.is_file() and split.stat().st_size == entry.get("split_size"):
+                    self._manifest[split_name] = entry
+            except OSError:
+                continue
+        if self._manifest:
+            self.log(f"Inkrementeller Merge: {len(self._manifest)} Segmente aus früherem Lauf übernommen")
+
+    def _save_manifest(self):
+        data = {
+            "version": MANIFEST_VERSION,
+            "settings": self._settings_signature(),
+            "segments": self._manifest,
+        }
+        tmp = self.manifest_path.with_suffix(".json.tmp")
+        tmp.write_text(json.dumps(data, indent=2), encoding="utf-8")
+        os.replace(tmp, self.manifest_path)
+
+    def is_encoded(self, split: Path) -> bool:
+        with self._lock:
+            return Path(split).name in self._manifest
+
+    # --- Hintergrund-Worker ------------------------------------------------
+
+    def start(self):
+        if self._worker and self._worker.is_alive():
+            return
+        self.segments_dir.mkdir(parents=True, exist_ok=True)
+        self._stop_event.clear()
+        self._worker = threading.Thread(target=self._worker_loop, daemon=True, name="IncrementalMerge")
+        self._worker.start()
+        self.log(f"Inkrementeller Merge: gestartet ({self.segments_dir})")
+
+    def add_split(self, split: Path):
+        """Meldet einen vollständig geschriebenen Split zur Kodierung an."""
+        split = Path(split)
+        with self._lock:
+            if split.name in self._manifest or split.name in self._queued:
+                return
+            self._queued.add(split.name)
+        self._queue.put(split)
+
+    def pending_count(self) -> int:
+        return self._queue.unfinished_tasks
+
+    def stop(self):
+        """Bricht den Worker ab (laufende Kodierung wird noch beendet)."""
+        self._stop_event.set()
+        if self._worker and self._worker.is_alive():
+            self._worker.join(timeout=1)
+
+    def _worker_loop(self):
+        job_control.bind_control(self.control)
+        while not self._stop_event.is_set():
+            try:
+                split = self._queue.get(timeout=0.5)
+            except Empty:
+                continue
+            try:
+                entry = self.split_manifest.ensure([split]).get(split.name) if self.split_manifest else None
+                self._encode_segment(split, entry)
+            finally:
+                with self._lock:
+                    self._queued.discard(split.name)
+                self._queue.task_done()
+
+    # --- Kodierung ---------------------------------------------------------
+
+    def _split_timestamp(self, split: Path) -> Optional[datetime]:
+        return self.merge_engine._parse_timestamp_from_filename(split.name)
+
+    def _encode_segment(
+        self,
+        split: Path,
+        entry: Optional[dict] = None,
+        progress_callback: Optional[Callable[[FFmpegProgress], None]] = None,
+    ) -> bool:
+        if self.is_encoded(split):
+            return True
+        if not split.exists() or split.stat().st_size == 0:
+            return False
+
+        segment = self.segments_dir / f"seg_{split.stem}.mp4"
+        partial = self.segments_dir / f"seg_{split.stem}.part.mp4"
+        # Wie bei "soft" und im Batch-Merge: Aufnahmezeit aus den DV-Daten, sonst aus dem Dateinamen
+        timestamp = recorded_at_of(entry) or self._split_timestamp(split)
+
+        cmd = [
+            str(self.ffmpeg_path),
+            "-hide_banner",
+            "-loglevel", "error",
+            "-nostdin",
+            "-i", str(split),
+        ]
+        if timestamp and self.timestamp_mode == MODE_BURN:
+            text = self.merge_engine._escape_drawtext_text(timestamp.strftime("%Y-%m-%d %H:%M:%S"))
+            cmd += [
+                "-vf",
+                f"drawtext=text='{text}'"
+                f":fontsize=24"
+                f":x=10"
+                f":y=h-th-10"
+                f":fontcolor=white"
+                f":box=1"
+                f":boxcolor=black@0.5"
+                f":enable='between(t,0,{self.timestamp_duration})'",
+            ]
+        cmd += [
+            "-c:v", "libx264",
+            "-pix_fmt", "yuv420p",
+            "-preset", "medium",
+            "-crf", "20",
+            "-an",
+            "-y",
+            str(partial),
+        ]
+
+        self.log(f"Inkrementeller Merge: kodiere {split.name}...")
+        result = run_ffmpeg(cmd, duration=(entry or {}).get("duration"), progress_callback=progress_callback)
+        if result.returncode != 0 or not partial.exists():
+            self.log(f"Inkrementeller Merge: Fehler bei {split.name}: {result.stderr[-500:]}")
+            with self._lock:
+                self.failed.append(split.name)
+            try:
+                partial.unlink()
+            except OSError:
+                pass
+            return False
+
+        os.replace(partial, segment)
+        with self._lock:
+            self._manifest[split.name] = {
+                "segment": segment.name,
+                "split_size": split.stat().st_size,
+                "timestamp": timestamp.isoformat() if timestamp else None,
+            }
+            self._save_manifest()
+        return True
+
+    # --- Abschluss ---------------------------------------------------------
+
+    def _sorted_splits(self, manifest: Optional[SplitManifest] = None) -> List[Path]:
+        splits = set()
+        for pattern in SPLIT_PATTERNS:
+            splits.update(p for p in self.splits_dir.glob(pattern) if p.stat().st_size > 0)
+        if manifest is None:
+            manifest = SplitManifest(self.splits_dir, log_callback=self.log_callback)
+        return manifest.ordered(splits)
+
+    def finish(
+        self,
+        output_path: Path,
+        progress_callback: Optional[Callable[[int, str], None]] = None,
+        manifest: Optional[SplitManifest] = None,
+    ) -> Optional[Path]:
+        """
+        Wartet auf laufende Kodierungen, kodiert fehlende Splits, kodiert den Ton in einem Stück
+        und fügt alle Segmente per Stream-Copy zusammen (Reihenfolge aus dem Split-Manifest).
+
+        Returns:
+            Pfad zur fertigen Datei oder None (dann Fallback auf den klassischen Merge)
+        """
+        if self._worker and self._worker.is_alive():
+            self._queue.join()
+        self.stop()
+        # Nicht mehr abgearbeitete Anmeldungen verwerfen, fehlende Splits werden unten kodiert
+        while True:
+            try:
+                self._queue.get_nowait()
+                self._queue.task_done()
+            except Empty:
+                break
+
+        if manifest is None:
+            manifest = SplitManifest(self.splits_dir, log_callback=self.log_callback)
+        splits = self._sorted_splits(manifest)
+        if not splits:
+            self.log("Inkrementeller Merge: Keine Split-Dateien gefunden!")
+            return None
+
+        self.segments_dir.mkdir(parents=True, exist_ok=True)
+        missing = [s for s in splits if not self.is_encoded(s)]
+        if missing:
+            self.log(f"Inkrementeller Merge: {len(missing)} von {len(splits)} Splits noch zu kodieren")
+        entries = manifest.ensure(missing)
+        for index, split in enumerate(missing):
+            # Anteil dieses Splits an den ersten 85 %, darin der ffmpeg-Fortschritt
+            done = len(splits) - len(missing) + index
+            start, end = done * 85 // len(splits), (done + 1) * 85 // len(splits)
+            if progress_callback:
+                progress_callback(start, f"Kodiere {split.name}")
+            segment_progress = percent_callback(
+                (lambda percent, text, name=split.name: progress_callback(percent, f"Kodiere {name}: {text}"))
+                if progress_callback else None,
+                start,
+                end,
+            )
+            if not self._encode_segment(split, entries.get(split.name), segment_progress):
+                return None
+
+        audio_path = self._encode_audio(splits, manifest, progress_callback)
+        if audio_path is None:
+            return None
+
+        if progress_callback:
+            progress_callback(95, "Füge Segmente zusammen (Stream-Copy)...")
+
+        output_path = Path(output_path)
+        output_path.parent.mkdir(parents=True, exist_ok=True)
+        list_file = self.segments_dir / "concat_list.txt"
+        _write_concat_list(
+            list_file, [self.segments_dir / self._manifest[split.name]["segment"] for split in splits]
+        )
+
+        # Modus "soft": Aufnahmezeit als Untertitelspur, weiterhin ohne Re-Encode
+        subtitle_input: List[str] = []
+        subtitle_args: List[str] = []
+        if self.timestamp_mode == MODE_SOFT:
+            entries = manifest.ensure(splits)
+            timestamps = [recorded_at_of(entries.get(s.name)) or self._split_timestamp(s) for s in splits]
+            durations = [(entries.get(s.name) or {}).get("duration") or 0.0 for s in splits]
+            cues = cues_from_splits(timestamps, durations, self.timestamp_duration)
+            if cues:
+                ass_path = write_ass(cues, self.segments_dir / "timestamps.ass")
+                subtitle_input = ["-i", str(ass_path)]
+                subtitle_args = soft_subtitle_args(2, audio_input_index=1)
+        if not subtitle_args:
+            subtitle_args = ["-map", "0:v", "-map", "1:a?"]
+
+        cmd = [
+            str(self.ffmpeg_path),
+            "-hide_banner",
+            "-loglevel", "error",
+            "-nostdin",
+            "-f", "concat",
+            "-safe", "0",
+            "-i", str(list_file),
+            "-i", str(audio_path),
+            *subtitle_input,
+            "-c", "copy",
+            *subtitle_args,
+            "-movflags", "+faststart",
+            "-y",
+            str(output_path),
+        ]
+        self.log(f"Inkrementeller Merge: Stream-Copy von {len(splits)} Segmenten nach {output_path.name}")
+        result = run_ffmpeg(cmd)
+        if result.returncode != 0 or not output_path.exists():
+            self.log(f"Inkrementeller Merge: concat fehlgeschlagen: {result.stderr[-500:]}")
+            return None
+
+        # Segmente werden nach erfolgreichem Merge nicht mehr gebraucht (Splits bleiben erhalten)
+        shutil.rmtree(self.segments_dir, ignore_errors=True)
+        if progress_callback:
+            progress_callback(100, f"Merge abgeschlossen: {output_path.name}")
+        self.log(f"Inkrementeller Merge erfolgreich: {output_path}")
+        return output_path
+
+    def _encode_audio(
+        self,
+        splits: List[Path],
+        manifest: SplitManifest,
+        progress_callback: Optional[Callable[[int, str], None]],
+    ) -> Optional[Path]:
+        """Ton aller Splits als eine durchgehende AAC-Spur (ohne Nähte zwischen Segmenten)"""
+        list_file = self.segments_dir / "splits_list.txt"
+        _write_concat_list(list_file, splits)
+        audio_path = self.segments_dir / "audio.m4a"
+        entries = manifest.ensure(splits)
+        duration = sum((entries.get(s.name) or {}).get("duration") or 0.0 for s in splits) or None
+        if progress_callback:
+            progress_callback(85, "Kodiere Ton...")
+        cmd = [
+            str(self.ffmpeg_path),
+            "-hide_banner",
+            "-loglevel", "error",
+            "-nostdin",
+            "-f", "concat",
+            "-safe", "0",
+            "-i", str(list_file),
+            "-vn",
+            "-c:a", "aac",
+            "-y",
+            str(audio_path),
+        ]
+        self.log(f"Inkrementeller Merge: kodiere Ton von {len(splits)} Splits in einem Stück")
+        result = run_ffmpeg(
+            cmd,
+            duration=duration,
+            progress_callback=percent_callback(
+                (lambda percent, text: progress_callback(percent, f"Kodiere Ton: {text}")) if progress_callback else None,
+                85,
+                95,
+            ),
+        )
+        if result.returncode != 0 or not audio_path.exists():
+            self.log(f"Inkrementeller Merge: Ton-Kodierung fehlgeschlagen: {result.stderr[-500:]}")
+            return None
+        return audio_path
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
+
+
+def _write_concat_list(list_file: Path, paths: List[Path]):
+    with open(list_file, "w", encoding="utf-8") as f:
+        for path in paths:
+            escaped = str(Path(path).resolve()).replace("'", "'\\''")
+            f.write(f"file '{escaped}'\n")
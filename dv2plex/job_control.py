@@ -0,0 +1,192 @@
+"""
+Steuerung der Kindprozesse eines Hintergrund-Jobs (Merge, inkrementeller Merge)
+
+Jeder Job bekommt ein JobControl, das an den ausführenden Thread gebunden wird. ffmpeg-Aufrufe
+laufen über run() statt subprocess.run() und melden ihren Prozess dort an. So kann der
+Merge-Scheduler während einer Aufnahme alle Prozesse eines Jobs drosseln (nice 19, ionice idle)
+oder anhalten (SIGSTOP/SIGCONT), auch solche, die bereits laufen.
+
+Unter Linux gelten nice und ionice je Thread: gesetzt wird jeder Thread aus /proc/<pid>/task,
+refresh() erfasst später gestartete Encoder-Threads. Das Zurücksetzen auf nice 0 braucht
+CAP_SYS_NICE; schlägt es fehl, bleibt der Job als gedrosselt markiert.
+"""
+
+import os
+import shutil
+import signal
+import subprocess
+import threading
+from typing import Dict, List, Optional, Set
+
+
+NICE_NORMAL = 0
+NICE_THROTTLED = 19
+
+_local = threading.local()
+
+
+class JobControl:
+    """Prozesse eines Jobs: Priorität und Pause gelten auch für später gestartete Prozesse"""
+
+    def __init__(self, name: str = ""):
+        self.name = name
+        self.niceness = NICE_NORMAL
+        self.paused = False
+        self._processes: Set[subprocess.Popen] = set()
+        # Threads je Prozess, die die aktuelle Priorität schon haben
+        self._threads: Dict[int, Set[int]] = {}
+        self._lock = threading.Lock()
+
+    def attach(self, process: subprocess.Popen):
+        with self._lock:
+            self._processes.add(process)
+            if self.niceness != NICE_NORMAL:
+                self._apply(process)
+            if self.paused:
+                _signal(process, signal.SIGSTOP)
+
+    def detach(self, process: subprocess.Popen):
+        with self._lock:
+            self._processes.discard(process)
+            self._threads.pop(process.pid, None)
+
+    def process_count(self) -> int:
+        with self._lock:
+            return len(self._processes)
+
+    def set_niceness(self, niceness: int) -> bool:
+        """
+        Setzt die Priorität aller Threads aller Prozesse
+
+        Returns:
+            False, wenn der Kernel die Änderung verweigert hat; beim Zurücksetzen bleibt
+            self.niceness dann auf dem alten Wert (der Job läuft weiter gedrosselt)
+        """
+        with self._lock:
+            if niceness == self.niceness:
+                return True
+            previous = self.niceness
+            self.niceness = niceness
+            self._threads.clear()
+            results = [self._apply(process) for process in self._processes]
+            if all(results):
+                return True
+            if niceness < previous:
+                self.niceness = previous
+                self._threads.clear()
+            return False
+
+    def refresh(self):
+        """Drosselung auf Threads anwenden, die seit dem letzten Aufruf gestartet wurden"""
+        with self._lock:
+            if self.niceness == NICE_NORMAL:
+                return
+            for process in self._processes:
+                if process.poll() is None:
+                    self._apply(process)
+
+    def _apply(self, process: subprocess.Popen) -> bool:
+        """Priorität auf noch nicht erfasste Threads eines Prozesses anwenden (mit gehaltenem Lock)"""
+        applied = self._threads.setdefault(process.pid, set())
+        tids = [tid for tid in _thread_ids(process.pid) if tid not in applied]
+        if not tids:
+            return True
+        applied.update(tids)
+        return _apply_priority(tids, self.niceness)
+
+    def pause(self):
+        with self._lock:
+            if self.paused:
+                return
+            self.paused = True
+            for process in self._processes:
+                _signal(process, signal.SIGSTOP)
+
+    def resume(self):
+        with self._lock:
+            if not self.paused:
+                return
+            self.paused = False
+            for process in self._processes:
+                _signal(process, signal.SIGCONT)
+
+
+def bind_control(control: Optional[JobControl]):
+    """Bindet ein JobControl an den aktuellen Thread (None = keine Steuerung)"""
+    _local.control = control
+
+
+def current_control() -> Optional[JobControl]:
+    return getattr(_local, "control", None)
+
+
+def run(cmd: List[str], check: bool = False, **kwargs) -> subprocess.CompletedProcess:
+    """
+    Wie subprocess.run(), meldet den Prozess aber beim JobControl des aktuellen Threads an.
+    Ohne gebundenes JobControl wird direkt subprocess.run() verwendet.
+    """
+    control = current_control()
+    if control is None:
+        return subprocess.run(cmd, check=check, **kwargs)
+    with subprocess.Popen(cmd, **kwargs) as process:
+        control.attach(process)
+        try:
+            stdout, stderr = process.communicate()
+        except BaseException:
+            process.kill()
+            raise
+        finally:
+            control.detach(process)
+    result = subprocess.CompletedProcess(cmd, process.returncode, stdout, stderr)
+    if check:
+        result.check_returncode()
+    return result
+
+
+def _thread_ids(pid: int) -> List[int]:
+    """Thread-IDs eines Prozesses (ohne /proc nur die PID selbst)"""
+    try:
+        return [int(name) for name in os.listdir(f"/proc/{pid}/task")]
+    except (OSError, ValueError):
+        return [pid]
+
+
+def _apply_priority(tids: List[int], niceness: int) -> bool:
+    """
+    nice und I/O-Klasse von Threads setzen
+
+    Returns:
+        False, wenn nice verweigert wurde (Absenken ohne CAP_SYS_NICE); beendete Threads
+        oder fehlendes ionice zählen nicht als Fehler
+    """
+    ok = True
+    for tid in tids:
+        try:
+            os.setpriority(os.PRIO_PROCESS, tid, niceness)
+        except PermissionError:
+            ok = False
+        except (OSError, AttributeError):
+            pass
+    ionice = shutil.which("ionice")
+    if not ionice:
+        return ok
+    io_class = ["-c", "3"] if niceness >= NICE_THROTTLED else ["-c", "2", "-n", "4"]
+    try:
+        subprocess.run(
+            [ionice, *io_class, "-p", *(str(tid) for tid in tids)],
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+            timeout=2,
+        )
+    except Exception:
+        pass
+    return ok
+
+
+def _signal(process: subprocess.Popen, sig: int):
+    if process.poll() is not None:
+        return
+    try:
+        process.send_signal(sig)
+    except (OSError, ValueError):
+        pass
@@ -0,0 +1,210 @@
+"""
+Persistenter Job-Speicher (SQLite im Config-Ordner) für Merge-, Postprocessing- und Poster-Jobs
+
+Jeder Job wird mit Art, Parametern, Status, Priorität, Versuchszähler und Checkpoints je
+abgeschlossener Stufe gespeichert. Nach einem Neustart des Dienstes (z.B. Auto-Update) holen
+sich die Worker mit recover() alle offenen Jobs zurück: unterbrochene ("running") Jobs werden
+wieder eingereiht und setzen nach der letzten abgeschlossenen Stufe fort. Jobs, die schon
+MAX_ATTEMPTS-mal gestartet wurden, gelten als fehlgeschlagen (kein Absturz-Kreislauf).
+"""
+
+import json
+import sqlite3
+import threading
+import time
+import uuid
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional
+
+
+DB_NAME = "jobs.sqlite3"
+MAX_ATTEMPTS = 3
+
+KIND_MERGE = "merge"
+KIND_POSTPROCESS = "postprocess"
+KIND_POSTER = "poster"
+
+STATUS_PENDING = "pending"
+STATUS_RUNNING = "running"
+STATUS_COMPLETED = "completed"
+STATUS_FAILED = "failed"
+OPEN_STATUSES = (STATUS_PENDING, STATUS_RUNNING)
+
+_SCHEMA = """
+CREATE TABLE IF NOT EXISTS jobs (
+    id TEXT PRIMARY KEY,
+    kind TEXT NOT NULL,
+    status TEXT NOT NULL,
+    priority INTEGER NOT NULL DEFAULT 0,
+    params TEXT NOT NULL,
+    stage TEXT,
+    checkpoints TEXT NOT NULL DEFAULT '{}',
+    attempts INTEGER NOT NULL DEFAULT 0,
+    progress INTEGER NOT NULL DEFAULT 0,
+    message TEXT NOT NULL DEFAULT '',
+    result TEXT,
+    created_at REAL NOT NULL,
+    updated_at REAL NOT NULL,
+    started_at REAL,
+    completed_at REAL
+);
+CREATE INDEX IF NOT EXISTS jobs_kind_status ON jobs (kind, status);
+"""
+
+_stores: Dict[Path, "JobStore"] = {}
+_stores_lock = threading.Lock()
+
+
+def open_job_store(config_dir: Path) -> "JobStore":
+    """Gemeinsame Instanz je Datenbank (alle Services teilen sich eine Verbindung)"""
+    path = (Path(config_dir) / DB_NAME).resolve()
+    with _stores_lock:
+        if path not in _stores:
+            _stores[path] = JobStore(path)
+        return _stores[path]
+
+
+class JobStore:
+    """SQLite-Tabelle jobs; alle Methoden sind threadsicher"""
+
+    def __init__(self, path: Path):
+        self.path = Path(path)
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        self._lock = threading.Lock()
+        self._db = sqlite3.connect(str(self.path), check_same_thread=False, isolation_level=None)
+        self._db.row_factory = sqlite3.Row
+        self._db.execute("PRAGMA journal_mode=WAL")
+        self._db.execute("PRAGMA synchronous=NORMAL")
+        self._db.executescript(_SCHEMA)
+
+    # --- Schreiben ---------------------------------------------------------------
+
+    def add(self, kind: str, params: dict, priority: int = 0, job_id: Optional[str] = None) -> str:
+        job_id = job_id or uuid.uuid4().hex[:8]
+        now = time.time()
+        with self._lock:
+            self._db.execute(
+                "INSERT OR REPLACE INTO jobs (id, kind, status, priority, params, created_at, updated_at) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?)",
+                (job_id, kind, STATUS_PENDING, priority, json.dumps(params, default=str), now, now),
+            )
+        return job_id
+
+    def update(self, job_id: str, **fields):
+        """Setzt status, priority, progress, message und/oder result"""
+        allowed = {"status", "priority", "progress", "message", "result"}
+        columns = {k: v for k, v in fields.items() if k in allowed}
+        if not columns:
+            return
+        columns["updated_at"] = time.time()
+        if columns.get("status") in (STATUS_COMPLETED, STATUS_FAILED):
+            columns["completed_at"] = columns["updated_at"]
+        assignments = ", ".join(f"{k} = ?" for k in columns)
+        with self._lock:
+            self._db.execute(f"UPDATE jobs SET {assignments} WHERE id = ?", (*columns.values(), job_id))
+
+    def start(self, job_id: str) -> int:
+        """Markiert einen Job als laufend und zählt den Versuch; liefert die Versuchsnummer"""
+        now = time.time()
+        with self._lock:
+            self._db.execute(
+                "UPDATE jobs SET status = ?, attempts = attempts + 1, started_at = ?, updated_at = ? WHERE id = ?",
+                (STATUS_RUNNING, now, now, job_id),
+            )
+            row = self._db.execute("SELECT attempts FROM jobs WHERE id = ?", (job_id,)).fetchone()
+        return row["attempts"] if row else 0
+
+    def checkpoint(self, job_id: str, stage: str, data: Optional[dict] = None):
+        """Hält eine abgeschlossene Stufe fest (data wird beim Fortsetzen zurückgegeben)"""
+        with self._lock:
+            row = self._db.execute("SELECT checkpoints FROM jobs WHERE id = ?", (job_id,)).fetchone()
+            if not row:
+                return
+            checkpoints = json.loads(row["checkpoints"] or "{}")
+            checkpoints[stage] = data or {}
+            self._db.execute(
+                "UPDATE jobs SET stage = ?, checkpoints = ?, updated_at = ? WHERE id = ?",
+                (stage, json.dumps(checkpoints, default=str), time.time(), job_id),
+            )
+
+    def finish(self, job_id: str, success: bool, message: str = "", result: Optional[str] = None):
+        fields = {"status": STATUS_COMPLETED if success else STATUS_FAILED, "message": message, "result": result}
+        if success:
+            fields["progress"] = 100
+        self.update(job_id, **fields)
+
+    def prune(self, keep: int = 200):
+        """Löscht alte abgeschlossene Jobs (die neuesten `keep` je Art bleiben)"""
+        with self._lock:
+            self._db.execute(
+                "DELETE FROM jobs WHERE status IN (?, ?) AND id NOT IN ("
+                "  SELECT id FROM jobs AS j WHERE j.kind = jobs.kind AND j.status IN (?, ?)"
+                "  ORDER BY j.updated_at DESC LIMIT ?)",
+                (STATUS_COMPLETED, STATUS_FAILED, STATUS_COMPLETED, STATUS_FAILED, keep),
+            )
+
+    # --- Lesen ---------------------------------------------------------------------
+
+    def get(self, job_id: str) -> Optional[dict]:
+        with self._lock:
+            row = self._db.execute("SELECT * FROM jobs WHERE id = ?", (job_id,)).fetchone()
+        return _to_dict(row) if row else None
+
+    def list(
+        self,
+        kind: Optional[str] = None,
+        statuses: Optional[Iterable[str]] = None,
+        limit: Optional[int] = None,
+    ) -> List[dict]:
+        """Jobs, neueste zuerst"""
+        query = "SELECT * FROM jobs"
+        conditions, args = [], []
+        if kind:
+            conditions.append("kind = ?")
+            args.append(kind)
+        if statuses:
+            statuses = list(statuses)
+            conditions.append(f"status IN ({', '.join('?' for _ in statuses)})")
+            args.extend(statuses)
+        if conditions:
+            query += " WHERE " + " AND ".join(conditions)
+        query += " ORDER BY created_at DESC"
+        if limit:
+            query += " LIMIT ?"
+            args.append(limit)
+        with self._lock:
+            rows = self._db.execute(query, args).fetchall()
+        return [_to_dict(row) for row in rows]
+
+    def recover(self, kind: str) -> List[dict]:
+        """
+        Offene Jobs nach einem Neustart: unterbrochene werden wieder "pending" (bzw. "failed",
+        wenn die Versuche aufgebraucht sind). Reihenfolge: Priorität, dann Einreihung.
+        """
+        now = time.time()
+        with self._lock:
+            self._db.execute(
+                "UPDATE jobs SET status = ?, message = ?, updated_at = ?, completed_at = ? "
+                "WHERE kind = ? AND status = ? AND attempts >= ?",
+                (STATUS_FAILED, f"Abgebrochen nach {MAX_ATTEMPTS} Versuchen", now, now, kind, STATUS_RUNNING, MAX_ATTEMPTS),
+            )
+            self._db.execute(
+                "UPDATE jobs SET status = ?, message = ?, updated_at = ? WHERE kind = ? AND status = ?",
+                (STATUS_PENDING, "Nach Neustart fortgesetzt", now, kind, STATUS_RUNNING),
+            )
+            rows = self._db.execute(
+                "SELECT * FROM jobs WHERE kind = ? AND status = ? ORDER BY priority DESC, created_at",
+                (kind, STATUS_PENDING),
+            ).fetchall()
+        return [_to_dict(row) for row in rows]
+
+    def close(self):
+        with self._lock:
+            self._db.close()
+
+
+def _to_dict(row: sqlite3.Row) -> dict:
+    job = dict(row)
+    job["params"] = json.loads(job.get("params") or "{}")
+    job["checkpoints"] = json.loads(job.get("checkpoints") or "{}")
+    return job
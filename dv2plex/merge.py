@@ -9,23 +9,62 @@ from pathlib import Path
 from typing import List, Optional, Callable, Tuple
 import logging
 
+from . import job_control
+from .dv_index import scan_dv_file
+from .dead_segments import VideoAnalyzer
+from .ffmpeg_runner import FFmpegResult, percent_callback, probe_duration, run_ffmpeg
+from .parallel_encode import ParallelEncoder, resolve_workers
+from .split_manifest import SplitManifest, recorded_at_of
+from .timestamp_overlay import (
+    MODE_BURN,
+    MODE_OFF,
+    MODE_SOFT,
+    TimestampCue,
+    burn_filter,
+    cues_from_offsets,
+    cues_from_splits,
+    normalize_mode,
+    sidecar_path,
+    soft_subtitle_args,
+    write_ass,
+)
+
+
+# Frames, in denen der DV-Datecode gesucht wird (10 s PAL)
+DATECODE_SCAN_FRAMES = 250
+
 
 class MergeEngine:
     """Verwaltet das Zusammenfügen mehrerer DV-Parts zu einem Film"""
     
-    def __init__(self, ffmpeg_path: Path, log_callback: Optional[Callable] = None):
+    def __init__(
+        self,
+        ffmpeg_path: Path,
+        log_callback: Optional[Callable] = None,
+        timestamp_mode: str = MODE_BURN,
+        timestamp_duration: int = 4,
+        encode_workers: int = 1,
+        progress_callback: Optional[Callable[[int, str], None]] = None,
+    ):
         """
         Initialisiert die Merge-Engine
         
         Args:
             ffmpeg_path: Pfad zu ffmpeg
             log_callback: Optionaler Callback für Log-Nachrichten
+            timestamp_mode: Aufnahmezeit "burn" (eingebrannt), "soft" (Untertitelspur/Sidecar) oder "off"
+            timestamp_duration: Anzeigedauer der Aufnahmezeit in Sekunden
+            encode_workers: Parallele x264-Prozesse für Re-Encodes (1 = ein Prozess, 0 = automatisch)
+            progress_callback: Optionaler Callback (Prozent, Beschreibung) während ffmpeg-Encodes
         """
         self.ffmpeg_path = ffmpeg_path
         self.log_callback = log_callback
+        self.timestamp_mode = normalize_mode(timestamp_mode)
+        self.timestamp_duration = timestamp_duration
+        self.encode_workers = resolve_workers(encode_workers)
+        self.progress_callback = progress_callback
         self.logger = logging.getLogger(__name__)
         self._ffprobe_path: Optional[Path] = None
-        self._is_dv_cache: dict[Path, bool] = {}
 
     def _get_ffprobe_path(self) -> Path:
         """
@@ -45,139 +84,43 @@ class MergeEngine:
         self._ffprobe_path = Path("ffprobe")
         return self._ffprobe_path
 
-    def _is_dv_stream(self, video_path: Path) -> bool:
-        """
-        Prüft per ffprobe, ob der Videostream DV (dvvideo) ist.
-        Ergebnis wird gecached, um Mehrfach-Aufrufe zu vermeiden.
-        """
-        cached = self._is_dv_cache.get(video_path)
-        if cached is not None:
-            return cached
-
-        ffprobe_path = self._get_ffprobe_path()
-        cmd = [
-            str(ffprobe_path),
-            "-v",
-            "error",
-            "-select_streams",
-            "v:0",
-            "-show_entries",
-            "stream=codec_name",
-            "-of",
-            "default=nk=1:nw=1",
-            str(video_path),
-        ]
-        try:
-            result = subprocess.run(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True,
-                check=False,
-            )
-            codec = result.stdout.strip().lower()
-            is_dv = codec == "dvvideo"
-            self._is_dv_cache[video_path] = is_dv
-            return is_dv
-        except Exception:
-            self._is_dv_cache[video_path] = False
-            return False
-
-    def _bcd(self, value: int, mask: int = 0xFF) -> int:
-        """Dekodiert ein BCD-basiertes Byte (unter Berücksichtigung einer Maske)."""
-        v = value & mask
-        return ((v >> 4) & 0x0F) * 10 + (v & 0x0F)
+    def _run_ffmpeg(self, cmd: List[str], duration: Optional[float] = None) -> FFmpegResult:
+        """ffmpeg-Encode mit Fortschritt (Prozent/ETA über die Eingangsdauer) an progress_callback"""
+        return run_ffmpeg(cmd, duration=duration, progress_callback=percent_callback(self.progress_callback))
 
-    def _parse_dv_date_pack(self, pack: bytes) -> Optional[Tuple[int, int, int]]:
-        """
-        Parst den DV-Datecode (Aufnahmedatum) aus Pack-ID 0x13.
-        Layout: BCD-JJ (Byte1), BCD-MM (Byte2), BCD-TT (Byte3).
-        """
-        if len(pack) != 5 or pack[0] != 0x13:
-            return None
-        year_2d = self._bcd(pack[1])
-        month = self._bcd(pack[2] & 0x1F)  # obere Bits sind Flags
-        day = self._bcd(pack[3] & 0x3F)
-
-        if not (1 <= month <= 12 and 1 <= day <= 31):
-            return None
-
-        year = 2000 + year_2d if year_2d < 70 else 1900 + year_2d
-        return year, month, day
-
-    def _parse_dv_time_pack(self, pack: bytes) -> Optional[Tuple[int, int, int]]:
-        """
-        Parst die DV-Aufnahmezeit aus Pack-ID 0x62.
-        Layout (BCD): HH (Byte1), MM (Byte2), SS (Byte3).
-        """
-        if len(pack) != 5 or pack[0] != 0x62:
-            return None
-        hour = self._bcd(pack[1] & 0x3F)
-        minute = self._bcd(pack[2] & 0x7F)
-        second = self._bcd(pack[3] & 0x7F)
-
-        if not (0 <= hour <= 23 and 0 <= minute <= 59 and 0 <= second <= 59):
+    def _input_duration(self, paths: List[Path]) -> Optional[float]:
+        """Summierte Dauer der Eingaben laut ffprobe (None, wenn eine unbekannt ist)"""
+        if not self.progress_callback:
             return None
-        return hour, minute, second
+        total = 0.0
+        for path in paths:
+            duration = probe_duration(path, ffprobe_path=self._get_ffprobe_path())
+            if duration is None:
+                return None
+            total += duration
+        return total
 
     def _extract_dv_datecode(self, video_path: Path) -> Optional[float]:
         """
-        Versucht, DV-Datecode (Aufnahme-Datum/Uhrzeit) direkt aus DV-Stream zu lesen.
-        Nur sinnvoll, wenn der Videostream dvvideo ist.
+        Liest den DV-Datecode (Aufnahme-Datum/Uhrzeit, Packs 0x62/0x63) direkt aus dem DV-Stream.
+        Funktioniert für Roh-DV und DV-AVI; andere Container liefern keinen DV-Frame und damit None.
         """
-        if not self._is_dv_stream(video_path):
-            return None
-
-        block_size = 80  # DIF-Block-Größe
-        max_bytes = 8 * 1024 * 1024  # genug für etliche Frames
-        date_parts: Optional[Tuple[int, int, int]] = None
-        time_parts: Optional[Tuple[int, int, int]] = None
-
         try:
-            with open(video_path, "rb") as f:
-                data = f.read(max_bytes)
+            index = scan_dv_file(video_path, max_frames=DATECODE_SCAN_FRAMES)
         except Exception as e:
             self.log(f"DV-Datecode: konnte Datei nicht lesen: {e}")
             return None
 
-        data_len = len(data)
-        if data_len < block_size:
+        if not len(index):
             return None
-
-        for i in range(0, data_len - block_size + 1, block_size):
-            block = data[i : i + block_size]
-            if block[0] != 0x1F:
-                continue
-            block_type = block[1] >> 5  # 0=subcode, 1=VAUX
-            if block_type not in (0, 1):
-                continue
-            payload = block[3:]
-            for p in range(0, len(payload) - 4, 5):
-                pack = payload[p : p + 5]
-                pid = pack[0]
-                if pid == 0x13 and date_parts is None:
-                    date_parts = self._parse_dv_date_pack(pack)
-                elif pid == 0x62 and time_parts is None:
-                    time_parts = self._parse_dv_time_pack(pack)
-                if date_parts and time_parts:
-                    break
-            if date_parts and time_parts:
-                break
-
-        if not (date_parts and time_parts):
-            self.log("DV-Datecode nicht gefunden (kein 0x13/0x62 Pack im Stream)")
+        recorded_at = index.first_recorded_at()
+        if not recorded_at:
+            self.log("DV-Datecode nicht gefunden (kein 0x62/0x63 Pack im Stream)")
             return None
 
-        try:
-            year, month, day = date_parts
-            hour, minute, second = time_parts
-            dt = datetime(year, month, day, hour, minute, second, tzinfo=timezone.utc)
-            ts = dt.timestamp()
-            self.log(f"DV-Datecode gefunden: {dt.isoformat()}")
-            return ts
-        except Exception as e:
-            self.log(f"DV-Datecode konnte nicht geparst werden: {e}")
-            return None
+        dt = recorded_at.replace(tzinfo=timezone.utc)
+        self.log(f"DV-Datecode gefunden: {dt.isoformat()}")
+        return dt.timestamp()
 
     def _parse_creation_datetime(self, value: str) -> Optional[datetime]:
         """Parst einen Datums-String aus den Metadaten zu datetime"""
@@ -222,7 +165,7 @@ class MergeEngine:
                     "default=noprint_wrappers=1:nokey=1",
                     str(video_path),
                 ]
-                result = subprocess.run(
+                result = job_control.run(
                     cmd,
                     stdout=subprocess.PIPE,
                     stderr=subprocess.PIPE,
@@ -271,7 +214,8 @@ class MergeEngine:
         try:
             # Pattern für dvgrab-YYYY.MM.DD_HH-MM-SS.avi oder dvgrabYYYY.MM.DD_HH-MM-SS.avi
             # Unterstützt beide Varianten (mit und ohne Bindestrich nach "dvgrab")
-            pattern = r'dvgrab-?(\d{4})\.(\d{2})\.(\d{2})_(\d{2})-(\d{2})-(\d{2})\.avi'
+            # sowie Roh-DV aus dem Tee-Modus (dvgrab-YYYY.MM.DD_HH-MM-SS[-NN].dv)
+            pattern = r'dvgrab-?(\d{4})\.(\d{2})\.(\d{2})_(\d{2})-(\d{2})-(\d{2})(?:-\d+)?\.(?:avi|dv)'
             match = re.search(pattern, filename)
             
             if match:
@@ -295,58 +239,6 @@ class MergeEngine:
             self.log(f"Fehler beim Parsen von Timestamp aus {filename}: {e}")
             return None
     
-    def _parse_timecode_from_filename(self, filename: str) -> Optional[Tuple[int, int, int, int]]:
-        """
-        Parst Timecode aus dvgrab-Dateinamen (Legacy-Methode für Kompatibilität)
-        
-        Format: capture-001-00.00.00.000.avi oder ähnlich
-        Gibt zurück: (hours, minutes, seconds, frames) oder None
-        
-        Args:
-            filename: Dateiname (z.B. "capture-001-00.00.00.000.avi")
-        
-        Returns:
-            Tuple (hours, minutes, seconds, frames) oder None
-        """
-        try:
-            # Suche nach Timecode-Pattern: HH.MM.SS.FFF oder HH:MM:SS:FFF
-            # dvgrab verwendet normalerweise Format: capture-XXX-HH.MM.SS.FFF.avi
-            patterns = [
-                r'(\d{2})\.(\d{2})\.(\d{2})\.(\d{3})',  # 00.00.00.000
-                r'(\d{2}):(\d{2}):(\d{2}):(\d{3})',      # 00:00:00:000
-                r'(\d{2})\.(\d{2})\.(\d{2})',            # 00.00.00 (ohne Frames)
-            ]
-            
-            for pattern in patterns:
-                match = re.search(pattern, filename)
-                if match:
-                    groups = match.groups()
-                    hours = int(groups[0])
-                    minutes = int(groups[1])
-                    seconds = int(groups[2])
-                    frames = int(groups[3]) if len(groups) > 3 else 0
-                    
-                    # Validiere Werte
-                    if 0 <= hours < 24 and 0 <= minutes < 60 and 0 <= seconds < 60:
-                        return (hours, minutes, seconds, frames)
-            
-            return None
-        except Exception:
-            return None
-    
-    def _timecode_to_seconds(self, timecode: Tuple[int, int, int, int]) -> float:
-        """
-        Konvertiert Timecode zu Sekunden (für Sortierung)
-        
-        Args:
-            timecode: (hours, minutes, seconds, frames)
-        
-        Returns:
-            Sekunden als float
-        """
-        hours, minutes, seconds, frames = timecode
-        return hours * 3600 + minutes * 60 + seconds + frames / 30.0  # DV hat 30 FPS
-
     def _escape_drawtext_text(self, text: str) -> str:
         """
         Escaped Text für ffmpeg drawtext (Doppelpunkt, Backslash, Prozent, Quotes)
@@ -358,136 +250,19 @@ class MergeEngine:
             .replace("%", "\\%")
         )
     
-    def _render_timestamps_to_video(
+    def merge_splits(
         self,
-        input_path: Path,
+        splits_dir: Path,
         output_path: Path,
-        split_files: List[Path],
-        timestamps: List[Optional[datetime]]
+        manifest: Optional[SplitManifest] = None,
     ) -> Optional[Path]:
         """
-        Rendert Timestamps aus Dateinamen ins finale Video
-        
-        Args:
-            input_path: Eingabe-Video (gemerged)
-            output_path: Ausgabe-Video mit Timestamps
-            split_files: Liste der Split-Dateien (sortiert)
-            timestamps: Liste der Timestamps (parallel zu split_files)
-        
-        Returns:
-            Pfad zur Ausgabedatei oder None
-        """
-        if not input_path.exists():
-            self.log(f"Eingabedatei nicht gefunden: {input_path}")
-            return None
-        
-        try:
-            # Berechne Start-Zeitpunkte für jeden Split im finalen Video
-            # Verwende ffprobe um Dauer jedes Splits zu ermitteln
-            split_start_times = []  # Liste von (time_in_video, timestamp)
-            current_time = 0.0
-            
-            for i, (split_file, timestamp) in enumerate(zip(split_files, timestamps)):
-                if timestamp:
-                    # Ermittle Dauer des Splits
-                    try:
-                        ffprobe_cmd = [
-                            str(self._get_ffprobe_path()),
-                            "-v", "error",
-                            "-show_entries", "format=duration",
-                            "-of", "default=noprint_wrappers=1:nokey=1",
-                            str(split_file)
-                        ]
-                        result = subprocess.run(
-                            ffprobe_cmd,
-                            stdout=subprocess.PIPE,
-                            stderr=subprocess.PIPE,
-                            text=True,
-                            timeout=5
-                        )
-                        if result.returncode == 0:
-                            duration = float(result.stdout.strip())
-                            split_start_times.append((current_time, timestamp))
-                            current_time += duration
-                    except Exception as e:
-                        self.log(f"Fehler beim Ermitteln der Dauer von {split_file.name}: {e}")
-                        # Schätze 30 Sekunden pro Split
-                        split_start_times.append((current_time, timestamp))
-                        current_time += 30.0
-            
-            if not split_start_times:
-                self.log("Keine Timestamps zum Rendern gefunden")
-                return None
-            
-            self.log(f"Rendere {len(split_start_times)} Timestamps ins Video...")
-            
-            # Erstelle drawtext-Filter für jeden Timestamp
-            # Zeige Timestamp für 4 Sekunden nach Start jedes Splits
-            duration = 4  # Sekunden
-            
-            # Mehrere Timestamps: wende alle drawtext-Filter parallel an
-            filter_parts = []
-            for start_time, timestamp in split_start_times:
-                end_time = start_time + duration
-                timestamp_str = self._escape_drawtext_text(
-                    timestamp.strftime("%Y-%m-%d %H:%M:%S")
-                )
-                filter_parts.append(
-                    f"drawtext=text='{timestamp_str}'"
-                    f":fontsize=24"
-                    f":x=10"
-                    f":y=10"
-                    f":fontcolor=white"
-                    f":bordercolor=black"
-                    f":borderw=2"
-                    f":box=1"
-                    f":boxcolor=black@0.5"
-                    f":enable='between(t,{start_time},{end_time})'"
-                )
-            
-            # Kombiniere alle Filter mit Komma (parallel)
-            vf_filter = ",".join(filter_parts)
-            
-            # Wende Filter an
-            cmd = [
-                str(self.ffmpeg_path),
-                "-i", str(input_path),
-                "-vf", vf_filter,
-                "-c:v", "libx264",
-                "-pix_fmt", "yuv420p",
-                "-preset", "medium",
-                "-crf", "20",
-                "-c:a", "copy",  # Audio kopieren
-                "-y",
-                str(output_path)
-            ]
-            
-            self.log(f"Wende Timestamp-Overlays an...")
-            result = subprocess.run(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True
-            )
-            
-            if result.returncode == 0:
-                self.log(f"Timestamps erfolgreich gerendert: {output_path}")
-                return output_path
-            else:
-                self.log(f"Fehler beim Rendern von Timestamps: {result.stderr[-500:]}")
-                return None
-                
-        except Exception as e:
-            self.log(f"Fehler beim Rendern von Timestamps: {e}")
-            return None
-    
-    def merge_splits(self, splits_dir: Path, output_path: Path) -> Optional[Path]:
-        """
-        Fügt alle Split-Dateien nach Timecode zusammen
+        Fügt alle Split-Dateien in Aufnahme-Reihenfolge zusammen
         
         Args:
             splits_dir: Pfad zu LowRes/splits/
             output_path: Ausgabepfad für zusammengefügtes Video
+            manifest: Split-Manifest der Aufnahme (sonst wird splits.json geladen)
         
         Returns:
             Pfad zur zusammengefügten Datei oder None
@@ -549,12 +324,7 @@ class MergeEngine:
                             "-y",
                             str(output_path)
                         ]
-                    result = subprocess.run(
-                        cmd,
-                        stdout=subprocess.PIPE,
-                        stderr=subprocess.PIPE,
-                        text=True
-                    )
+                    result = self._run_ffmpeg(cmd, self._input_duration(split_files))
                     if result.returncode != 0:
                         self.log(f"Konvertierungs-Fehler: {result.stderr[-500:]}")
                         return None
@@ -565,35 +335,33 @@ class MergeEngine:
                 self.log(f"Fehler beim Kopieren: {e}")
                 return None
         
-        # Sortiere nach Timestamp (aus Dateinamen)
-        files_with_timestamp = []
-        for file_path in split_files:
-            # Versuche zuerst neues Format: dvgrab-YYYY.MM.DD_HH-MM-SS.avi oder dvgrabYYYY.MM.DD_HH-MM-SS.avi
-            timestamp = self._parse_timestamp_from_filename(file_path.name)
+        # Reihenfolge, Dauer und Aufnahmezeit aus dem Split-Manifest (fehlende Einträge werden
+        # im Prozess nachgetragen, kein ffprobe pro Datei)
+        if manifest is None:
+            manifest = SplitManifest(splits_dir, log_callback=self.log)
+        sorted_files = manifest.ordered(split_files)
+        entries = manifest.ensure(sorted_files)
+        sorted_timestamps: List[Optional[datetime]] = []  # Für Timestamp-Rendering
+        sorted_durations: List[float] = []
+        sorted_frames: List[int] = []  # Für den parallelen Encode (Chunk-Grenzen, Nahtstellen-Prüfung)
+        for file_path in sorted_files:
+            entry = entries.get(file_path.name, {})
+            timestamp = recorded_at_of(entry) or self._parse_timestamp_from_filename(file_path.name)
+            sorted_timestamps.append(timestamp)
+            sorted_durations.append(entry.get("duration") or 0.0)
+            sorted_frames.append(entry.get("frames") or 0)
             if timestamp:
-                # Konvertiere zu Sekunden seit Epoch für Sortierung
-                seconds = timestamp.timestamp()
-                files_with_timestamp.append((seconds, file_path, timestamp))
                 self.log(f"  {file_path.name} -> Timestamp: {timestamp.strftime('%Y-%m-%d %H:%M:%S')}")
             else:
-                # Fallback: Versuche altes Timecode-Format
-                timecode = self._parse_timecode_from_filename(file_path.name)
-                if timecode:
-                    seconds = self._timecode_to_seconds(timecode)
-                    files_with_timestamp.append((seconds, file_path, None))
-                    self.log(f"  {file_path.name} -> Timecode: {timecode[0]:02d}:{timecode[1]:02d}:{timecode[2]:02d}.{timecode[3]:03d} (kein Timestamp gefunden)")
-                else:
-                    # Fallback: Verwende mtime für Sortierung
-                    mtime = file_path.stat().st_mtime
-                    files_with_timestamp.append((mtime, file_path, None))
-                    self.log(f"  {file_path.name} -> Kein Timestamp/Timecode, verwende mtime: {mtime}")
-        
-        # Sortiere nach Timestamp/Sekunden
-        files_with_timestamp.sort(key=lambda x: x[0])
-        sorted_files = [f[1] for f in files_with_timestamp]
-        sorted_timestamps = [f[2] for f in files_with_timestamp]  # Für Timestamp-Rendering
-        
-        self.log(f"Sortiere {len(sorted_files)} Dateien nach Timecode...")
+                self.log(f"  {file_path.name} -> Kein Timestamp gefunden")
+
+        total_duration = sum(sorted_durations) if all(sorted_durations) else None
+        self.log(f"Sortiere {len(sorted_files)} Dateien in Aufnahme-Reihenfolge...")
+        # Timestamps als ASS-Untertitel: eingebrannt direkt im Merge-Encode (ein subtitles-Filter,
+        # ein Decode aus DV, ein Encode) oder als weiche Spur/Sidecar ohne Encode
+        cues = self._timestamp_cues(sorted_timestamps, sorted_durations)
+        ass_path = self._write_timestamp_subtitles(cues, output_path)
+        fps = 25.0 if entries.get(sorted_files[0].name, {}).get("pal", True) else 30000 / 1001
         
         # Erstelle concat-Liste
         output_path.parent.mkdir(parents=True, exist_ok=True)
@@ -625,15 +393,31 @@ class MergeEngine:
                     output_format = "mp4"
                     output_path = output_path.with_suffix(".mp4")
             
+            # Mehrere Kerne: Chunks aus ganzen Splits parallel kodieren (sonst ein Prozess)
+            if output_format == "mp4":
+                merged = self._encode_splits_parallel(
+                    sorted_files, sorted_frames, fps, output_path, cues, ass_path, output_format
+                )
+                if merged:
+                    try:
+                        list_file.unlink()
+                    except OSError:
+                        pass
+                    self._finish_timestamp_subtitles(ass_path, merged, embedded=True)
+                    return merged
+            
             # ffmpeg concat-Befehl
             if output_format == "mp4":
-                # Für MP4 direkt re-encoden (DV-Streams sind nicht MP4-kompatibel)
+                # Für MP4 direkt re-encoden (DV-Streams sind nicht MP4-kompatibel),
+                # Timestamps im selben Durchgang
                 cmd = [
                     str(self.ffmpeg_path),
                     "-f", "concat",
                     "-safe", "0",
                     "-i", str(list_file),
+                    *self._timestamp_encode_args(ass_path, "mp4"),
                     "-c:v", "libx264",
+                    "-pix_fmt", "yuv420p",
                     "-c:a", "aac",
                     "-preset", "medium",
                     "-crf", "20",
@@ -656,12 +440,7 @@ class MergeEngine:
             self.log(f"Befehl: {' '.join(cmd)}")
             
             # Führe ffmpeg aus
-            result = subprocess.run(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True
-            )
+            result = self._run_ffmpeg(cmd, total_duration)
             
             if result.returncode == 0:
                 self.log(f"Merge erfolgreich: {output_path}")
@@ -673,11 +452,15 @@ class MergeEngine:
                 except:
                     pass
                 
-                # Rendere Timestamps ins finale Video
-                if sorted_timestamps and any(ts for ts in sorted_timestamps):
+                # Timestamps: im Encode enthalten, sonst (Stream-Copy) nachträglich bzw. als Sidecar
+                embedded = output_format == "mp4"
+                if ass_path and not embedded and self.timestamp_mode == MODE_BURN:
                     self.log("Rendere Timestamps ins finale Video...")
                     output_with_timestamps = output_path.parent / f"{output_path.stem}_with_timestamps{output_path.suffix}"
-                    result_ts = self._render_timestamps_to_video(output_path, output_with_timestamps, sorted_files, sorted_timestamps)
+                    boundaries = [sum(sorted_durations[:i]) for i in range(1, len(sorted_durations))]
+                    result_ts = self._render_timestamps_to_video(
+                        output_path, output_with_timestamps, ass_path, cues=cues, boundaries=boundaries
+                    )
                     if result_ts and result_ts.exists():
                         # Ersetze Original mit Version mit Timestamps
                         try:
@@ -686,9 +469,10 @@ class MergeEngine:
                             self.log(f"Timestamps erfolgreich gerendert: {output_path}")
                         except Exception as e:
                             self.log(f"WARNUNG: Konnte Datei nicht ersetzen: {e}")
+                            self._finish_timestamp_subtitles(ass_path, result_ts, embedded=True)
                             return result_ts  # Gebe Version mit Timestamps zurück
-                else:
-                    self.log(f"Keine Timestamps zum Rendern gefunden (sorted_timestamps: {sorted_timestamps})")
+                    embedded = True
+                self._finish_timestamp_subtitles(ass_path, output_path, embedded)
                 
                 return output_path
             else:
@@ -699,15 +483,33 @@ class MergeEngine:
                     # Dateien sind möglicherweise beschädigt oder unvollständig
                     self.log(f"WARNUNG: Dateien scheinen beschädigt oder unvollständig zu sein")
                     self.log(f"Fehler: {error_msg}")
+                    self._finish_timestamp_subtitles(ass_path, None, embedded=True)
                     return None
                 
-                # Versuche Re-Encoding als Fallback (immer mp4/mp2 passt)
+                # Versuche Re-Encoding als Fallback (immer mp4/mp2 passt), Timestamps im selben Durchgang
+                embedded = self.timestamp_mode == MODE_BURN or output_format == "mp4"
+                merged = None
+                if output_format != "mp4":  # MP4 wurde oben schon parallel versucht
+                    merged = self._encode_splits_parallel(
+                        sorted_files, sorted_frames, fps, output_path, cues, ass_path, output_format
+                    )
+                if merged:
+                    self.log(f"Merge erfolgreich (Re-Encoded, parallel): {merged}")
+                    try:
+                        list_file.unlink()
+                    except OSError:
+                        pass
+                    self._finish_timestamp_subtitles(ass_path, merged, embedded)
+                    return merged
+                
                 cmd_reencode = [
                     str(self.ffmpeg_path),
                     "-f", "concat",
                     "-safe", "0",
                     "-i", str(list_file),
+                    *self._timestamp_encode_args(ass_path, output_format),
                     "-c:v", "libx264",
+                    "-pix_fmt", "yuv420p",
                     "-c:a", "aac",
                     "-preset", "medium",
                     "-crf", "20",
@@ -716,12 +518,7 @@ class MergeEngine:
                 ]
                 
                 self.log(f"Re-Encoding-Befehl: {' '.join(cmd_reencode)}")
-                result2 = subprocess.run(
-                    cmd_reencode,
-                    stdout=subprocess.PIPE,
-                    stderr=subprocess.PIPE,
-                    text=True
-                )
+                result2 = self._run_ffmpeg(cmd_reencode, total_duration)
                 
                 if result2.returncode == 0:
                     self.log(f"Merge erfolgreich (Re-Encoded): {output_path}")
@@ -733,21 +530,7 @@ class MergeEngine:
                     except:
                         pass
                     
-                    # Rendere Timestamps ins finale Video
-                    if sorted_timestamps and any(ts for ts in sorted_timestamps):
-                        self.log("Rendere Timestamps ins finale Video...")
-                        output_with_timestamps = output_path.parent / f"{output_path.stem}_with_timestamps{output_path.suffix}"
-                        result_ts = self._render_timestamps_to_video(output_path, output_with_timestamps, sorted_files, sorted_timestamps)
-                        if result_ts and result_ts.exists():
-                            try:
-                                output_path.unlink()
-                                result_ts.rename(output_path)
-                                self.log(f"Timestamps erfolgreich gerendert: {output_path}")
-                            except Exception as e:
-                                self.log(f"WARNUNG: Konnte Datei nicht ersetzen: {e}")
-                                return result_ts
-                    else:
-                        self.log(f"Keine Timestamps zum Rendern gefunden (sorted_timestamps: {sorted_timestamps})")
+                    self._finish_timestamp_subtitles(ass_path, output_path, embedded)
                     
                     return output_path
                 else:
@@ -758,6 +541,7 @@ class MergeEngine:
                             list_file.unlink()
                     except:
                         pass
+                    self._finish_timestamp_subtitles(ass_path, None, embedded=True)
                     return None
                 
         except Exception as e:
@@ -768,23 +552,135 @@ class MergeEngine:
                     list_file.unlink()
             except:
                 pass
+            self._finish_timestamp_subtitles(ass_path, None, embedded=True)
+            return None
+    
+    def _timestamp_cues(
+        self,
+        timestamps: List[Optional[datetime]],
+        durations: List[float],
+    ) -> List[TimestampCue]:
+        """
+        Einblendungen der Aufnahme-Timestamps der Splits
+        
+        Args:
+            timestamps: Timestamps der Splits in Merge-Reihenfolge (None = keine Einblendung)
+            durations: Dauer der Splits in Sekunden (parallel zu timestamps)
+        
+        Returns:
+            Einblendungen (leer bei timestamp_mode "off")
+        """
+        if self.timestamp_mode == MODE_OFF:
+            return []
+        return cues_from_splits(timestamps, durations, self.timestamp_duration)
+    
+    def _write_timestamp_subtitles(self, cues: List[TimestampCue], output_path: Path) -> Optional[Path]:
+        """
+        Schreibt die Einblendungen als ASS-Datei neben die Ausgabe
+        
+        Args:
+            cues: Einblendungen aus _timestamp_cues
+            output_path: Ausgabe-Video (die ASS-Datei bekommt denselben Namen)
+        
+        Returns:
+            Pfad zur ASS-Datei oder None (keine Timestamps oder timestamp_mode "off")
+        """
+        if self.timestamp_mode == MODE_OFF:
+            return None
+        if not cues:
+            self.log("Keine Timestamps zum Rendern gefunden")
+            return None
+        ass_path = write_ass(cues, output_path.parent / f"{output_path.stem}_timestamps.ass")
+        self.log(f"Timestamp-Untertitel mit {len(cues)} Einblendungen ({self.timestamp_mode})")
+        return ass_path
+    
+    def _timestamp_encode_args(self, ass_path: Optional[Path], container: str) -> List[str]:
+        """
+        ffmpeg-Argumente (zusätzlicher Input + Output-Optionen), die die Timestamps in einen
+        ohnehin laufenden Encode einbauen: ein subtitles-Filter bzw. eine mov_text-Spur (MP4)
+        """
+        if not ass_path:
+            return []
+        if self.timestamp_mode == MODE_BURN:
+            return ["-vf", burn_filter(ass_path)]
+        if self.timestamp_mode == MODE_SOFT and container == "mp4":
+            return ["-i", str(ass_path), *soft_subtitle_args(1)]
+        return []
+    
+    def _parallel_encoder(self, output_path: Path) -> Optional[ParallelEncoder]:
+        """Chunk-Encoder neben der Ausgabe oder None (nur ein Worker konfiguriert)"""
+        if self.encode_workers <= 1:
+            return None
+        return ParallelEncoder(
+            self.ffmpeg_path,
+            self.encode_workers,
+            output_path.parent / f".{output_path.stem}_chunks",
+            log_callback=self.log,
+            progress_callback=self.progress_callback,
+        )
+    
+    def _encode_splits_parallel(
+        self,
+        sorted_files: List[Path],
+        frames: List[int],
+        fps: float,
+        output_path: Path,
+        cues: List[TimestampCue],
+        ass_path: Optional[Path],
+        container: str,
+    ) -> Optional[Path]:
+        """
+        Merge-Encode in parallelen Chunks aus ganzen Splits (Timestamps eingebrannt bzw. als
+        mov_text-Spur wie beim Encode in einem Prozess)
+        
+        Returns:
+            Pfad zur Ausgabe oder None (dann Encode in einem Prozess)
+        """
+        encoder = self._parallel_encoder(output_path)
+        if not encoder:
             return None
+        soft_track = ass_path if self.timestamp_mode == MODE_SOFT and container == "mp4" else None
+        return encoder.encode_splits(
+            sorted_files,
+            frames,
+            fps,
+            output_path,
+            burn_cues=cues if ass_path and self.timestamp_mode == MODE_BURN else None,
+            subtitle_path=soft_track,
+        )
+    
+    def _finish_timestamp_subtitles(self, ass_path: Optional[Path], video_path: Optional[Path], embedded: bool):
+        """Entfernt die ASS-Datei bzw. legt sie als Sidecar neben das Video (weich, nicht gemuxt)"""
+        if not ass_path or not ass_path.exists():
+            return
+        try:
+            if not embedded and video_path and self.timestamp_mode == MODE_SOFT:
+                target = sidecar_path(video_path)
+                ass_path.replace(target)
+                self.log(f"Timestamp-Untertitel als Sidecar: {target.name}")
+            else:
+                ass_path.unlink()
+        except OSError as e:
+            self.log(f"WARNUNG: Timestamp-Untertitel konnte nicht abgelegt werden: {e}")
     
     def _render_timestamps_to_video(
         self,
         input_path: Path,
         output_path: Path,
-        split_files: List[Path],
-        timestamps: List[Optional[datetime]]
+        ass_path: Path,
+        cues: Optional[List[TimestampCue]] = None,
+        boundaries: Optional[List[float]] = None,
     ) -> Optional[Path]:
         """
-        Rendert Timestamps aus Dateinamen ins finale Video
+        Brennt die Timestamp-Untertitel nachträglich ins gemergte Video ein
+        (nur nötig, wenn der Merge selbst nicht kodiert hat, z.B. AVI per Stream-Copy)
         
         Args:
             input_path: Eingabe-Video (gemerged)
             output_path: Ausgabe-Video mit Timestamps
-            split_files: Liste der Split-Dateien (sortiert)
-            timestamps: Liste der Timestamps (parallel zu split_files)
+            ass_path: ASS-Datei aus _write_timestamp_subtitles
+            cues: Einblendungen der ASS-Datei (für den parallelen Encode)
+            boundaries: Split-Grenzen in Sekunden, an denen parallel kodiert werden darf
         
         Returns:
             Pfad zur Ausgabedatei oder None
@@ -793,117 +689,17 @@ class MergeEngine:
             self.log(f"Eingabedatei nicht gefunden: {input_path}")
             return None
         
+        encoder = self._parallel_encoder(output_path) if cues and boundaries else None
+        if encoder and encoder.encode_range(
+            input_path, output_path, boundaries, burn_cues=cues, ffprobe_path=self._get_ffprobe_path()
+        ):
+            return output_path
+        
         try:
-            # Berechne Start-Zeitpunkte für jeden Split im finalen Video
-            # Verwende ffprobe um Dauer jedes Splits zu ermitteln
-            split_start_times = []  # Liste von (time_in_video, timestamp)
-            current_time = 0.0
-            
-            for i, (split_file, timestamp) in enumerate(zip(split_files, timestamps)):
-                if timestamp:
-                    # Ermittle Dauer des Splits
-                    try:
-                        ffprobe_cmd = [
-                            str(self._get_ffprobe_path()),
-                            "-v", "error",
-                            "-show_entries", "format=duration",
-                            "-of", "default=noprint_wrappers=1:nokey=1",
-                            str(split_file)
-                        ]
-                        result = subprocess.run(
-                            ffprobe_cmd,
-                            stdout=subprocess.PIPE,
-                            stderr=subprocess.PIPE,
-                            text=True,
-                            timeout=5
-                        )
-                        if result.returncode == 0:
-                            duration = float(result.stdout.strip())
-                            split_start_times.append((current_time, timestamp))
-                            current_time += duration
-                    except Exception as e:
-                        self.log(f"Fehler beim Ermitteln der Dauer von {split_file.name}: {e}")
-                        # Schätze 30 Sekunden pro Split
-                        split_start_times.append((current_time, timestamp))
-                        current_time += 30.0
-            
-            if not split_start_times:
-                self.log("Keine Timestamps zum Rendern gefunden")
-                return None
-            
-            self.log(f"Rendere {len(split_start_times)} Timestamps ins Video...")
-            
-            # Erstelle drawtext-Filter für jeden Timestamp
-            # Zeige Timestamp für 4 Sekunden nach Start jedes Splits
-            duration = 4  # Sekunden
-            
-            if len(split_start_times) == 1:
-                # Einzelner Filter
-                start_time, timestamp = split_start_times[0]
-                end_time = start_time + duration
-                timestamp_str = self._escape_drawtext_text(
-                    timestamp.strftime("%Y-%m-%d %H:%M:%S")
-                )
-                vf_filter = (
-                    f"drawtext=text='{timestamp_str}'"
-                    f":fontsize=24"
-                    f":x=10"
-                    f":y=h-th-10"
-                    f":fontcolor=white"
-                    f":box=1"
-                    f":boxcolor=black@0.5"
-                    f":enable='between(t,{start_time},{end_time})'"
-                )
-            else:
-                # Mehrere Filter: Verwende Filterkette mit [in] und [out]
-                # Jeder Filter nimmt den vorherigen Output als Input
-                filter_chain = []
-                current_input = "[0:v]"
-                
-                for i, (start_time, timestamp) in enumerate(split_start_times):
-                    end_time = start_time + duration
-                    timestamp_str = self._escape_drawtext_text(
-                        timestamp.strftime("%Y-%m-%d %H:%M:%S")
-                    )
-                    
-                    if i < len(split_start_times) - 1:
-                        # Nicht der letzte Filter: hat Output-Label
-                        output_label = f"[out{i}]"
-                        filter_expr = (
-                            f"{current_input}drawtext=text='{timestamp_str}'"
-                            f":fontsize=24"
-                            f":x=10"
-                            f":y=h-th-10"
-                            f":fontcolor=white"
-                            f":box=1"
-                            f":boxcolor=black@0.5"
-                            f":enable='between(t,{start_time},{end_time})'"
-                            f"{output_label}"
-                        )
-                        current_input = output_label
-                    else:
-                        # Letzter Filter: kein Output-Label (ist automatisch Output)
-                        filter_expr = (
-                            f"{current_input}drawtext=text='{timestamp_str}'"
-                            f":fontsize=24"
-                            f":x=10"
-                            f":y=h-th-10"
-                            f":fontcolor=white"
-                            f":box=1"
-                            f":boxcolor=black@0.5"
-                            f":enable='between(t,{start_time},{end_time})'"
-                        )
-                    
-                    filter_chain.append(filter_expr)
-                
-                # Kombiniere alle Filter mit Semikolon
-                vf_filter = ";".join(filter_chain)
-            
-            # Wende Filter an
             cmd = [
                 str(self.ffmpeg_path),
                 "-i", str(input_path),
-                "-vf", vf_filter,
+                "-vf", burn_filter(ass_path),
                 "-c:v", "libx264",
                 "-pix_fmt", "yuv420p",
                 "-preset", "medium",
@@ -914,12 +710,7 @@ class MergeEngine:
             ]
             
             self.log(f"Wende Timestamp-Overlays an...")
-            result = subprocess.run(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True
-            )
+            result = self._run_ffmpeg(cmd, self._input_duration([input_path]))
             
             if result.returncode == 0:
                 self.log(f"Timestamps erfolgreich gerendert: {output_path}")
@@ -1020,12 +811,7 @@ class MergeEngine:
             self.log(f"Befehl: {' '.join(cmd)}")
             
             # Führe ffmpeg aus
-            result = subprocess.run(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True
-            )
+            result = self._run_ffmpeg(cmd, self._input_duration(parts))
             
             # Lösche temporäre Liste
             try:
@@ -1116,12 +902,7 @@ class MergeEngine:
             self.log(f"Befehl: {' '.join(cmd)}")
             
             # Führe ffmpeg aus
-            result = subprocess.run(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True
-            )
+            result = self._run_ffmpeg(cmd, self._input_duration(video_paths))
             
             # Lösche temporäre Liste
             try:
@@ -1201,64 +982,63 @@ class MergeEngine:
                 else:
                     self.log("Keine DV/Metadaten-Startzeit gefunden, nutze 00:00:00 ab Video-Start")
 
-            # Timestamp-Format: Bei Metadaten volle Datums-/Zeitangabe, sonst Laufzeit
-            if base_timestamp:
-                base_seconds = int(base_timestamp)
-                timestamp_template = (
-                    f"%{{pts\\:gmtime\\:{base_seconds}\\:%Y\\-%m\\-%d\\ %H\\:%M\\:%S}}"
-                )
-            else:
-                timestamp_template = "%{pts\\:gmtime\\:0\\:%H\\:%M\\:%S}"
+            # Einblendung: Metadaten-Zeit + Offset (falls vorhanden), sonst Laufzeit
+            base = datetime.fromtimestamp(base_timestamp, tz=timezone.utc) if base_timestamp else None
+            cues = cues_from_offsets(base, scene_changes, duration)
             
-            # Schritt 2: Erstelle drawtext-Filter für jede Szenenänderung
-            # Format: drawtext für 4 Sekunden nach jeder Szenenänderung
-            filter_parts = []
-            
-            for scene_time in scene_changes:
-                # Timestamp-Text: Metadaten-Zeit (falls vorhanden) sonst Laufzeit
-                # Verwende enable-Filter um nur für bestimmte Zeit zu zeigen
-                end_time = scene_time + duration
-                filter_expr = (
-                    f"drawtext=text='{timestamp_template}'"
-                    f":fontsize=24"
-                    f":x=10"
-                    f":y=10"
-                    f":fontcolor=white"
-                    f":box=1"
-                    f":boxcolor=black@0.5"
-                    f":enable='between(t,{scene_time},{end_time})'"
-                )
-                filter_parts.append(filter_expr)
+            # Schritt 2: Alle Einblendungen in eine ASS-Datei (ein Filter statt einer drawtext-Kette)
+            ass_path = write_ass(cues, output_path.parent / f"{output_path.stem}_timestamps.ass")
             
-            # Kombiniere alle Filter
-            if len(filter_parts) == 1:
-                vf_filter = filter_parts[0]
+            # Schritt 3: Einbrennen (ein subtitles-Filter) oder weich ohne Re-Encode
+            soft = self.timestamp_mode == MODE_SOFT
+            embedded = not soft or output_path.suffix.lower() == ".mp4"
+            encoder = None if soft else self._parallel_encoder(output_path)
+            if encoder and encoder.encode_range(
+                input_path, output_path, scene_changes, burn_cues=cues, ffprobe_path=self._get_ffprobe_path()
+            ):
+                # Chunks an Szenenwechseln, parallel kodiert
+                self._finish_timestamp_subtitles(ass_path, output_path, embedded)
+                self.log(f"Timestamp-Overlays erfolgreich hinzugefügt: {output_path}")
+                return output_path
+            if not soft:
+                cmd = [
+                    str(self.ffmpeg_path),
+                    "-i", str(input_path),
+                    "-vf", burn_filter(ass_path),
+                    "-c:a", "copy",  # Audio kopieren
+                    "-y",
+                    str(output_path)
+                ]
+            elif embedded:
+                cmd = [
+                    str(self.ffmpeg_path),
+                    "-i", str(input_path),
+                    "-i", str(ass_path),
+                    *soft_subtitle_args(1),
+                    "-c:v", "copy",
+                    "-c:a", "copy",
+                    "-y",
+                    str(output_path)
+                ]
             else:
-                # Mehrere Filter mit Komma verbinden
-                vf_filter = ",".join(filter_parts)
-            
-            # Schritt 3: Wende Filter an
-            cmd = [
-                str(self.ffmpeg_path),
-                "-i", str(input_path),
-                "-vf", vf_filter,
-                "-c:a", "copy",  # Audio kopieren
-                "-y",
-                str(output_path)
-            ]
+                # Container ohne Textspur: Video unverändert, Untertitel als Sidecar
+                cmd = [
+                    str(self.ffmpeg_path),
+                    "-i", str(input_path),
+                    "-c", "copy",
+                    "-y",
+                    str(output_path)
+                ]
             
             self.log(f"Wende Timestamp-Overlays an...")
-            result = subprocess.run(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True
-            )
+            result = self._run_ffmpeg(cmd, self._input_duration([input_path]))
             
             if result.returncode == 0:
+                self._finish_timestamp_subtitles(ass_path, output_path, embedded)
                 self.log(f"Timestamp-Overlays erfolgreich hinzugefügt: {output_path}")
                 return output_path
             else:
+                self._finish_timestamp_subtitles(ass_path, None, embedded=True)
                 self.log(f"Fehler beim Hinzufügen von Timestamps: {result.stderr[-500:]}")
                 return None
                 
@@ -1277,8 +1057,12 @@ class MergeEngine:
         Returns:
             Liste von Zeitpunkten (in Sekunden) wo Szenenänderungen auftreten
         """
+        # Gemeinsamer Decode mit der Tote-Abschnitte-Analyse vor dem Upscale (gecacht)
+        analysis = VideoAnalyzer(self.ffmpeg_path, log_callback=self.log_callback).analyze(video_path)
+        if analysis is not None:
+            return analysis.scene_changes(threshold)
         try:
-            # Verwende ffmpeg's scene-Filter
+            # Fallback: ffmpeg's scene-Filter
             cmd = [
                 str(self.ffmpeg_path),
                 "-i", str(video_path),
@@ -1287,7 +1071,7 @@ class MergeEngine:
                 "-"
             ]
             
-            result = subprocess.run(
+            result = job_control.run(
                 cmd,
                 stdout=subprocess.PIPE,
                 stderr=subprocess.PIPE,
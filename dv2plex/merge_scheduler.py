@@ -0,0 +1,282 @@
+"""
+Merge-Scheduler: mehrere Merge-Worker mit Prioritäten und Rücksicht auf laufende Aufnahmen
+
+Jobs warten in einer Prioritätsliste (höhere Priorität zuerst, bei Gleichstand in
+Einreihungs-Reihenfolge) und werden von bis zu max_workers Worker-Threads abgearbeitet.
+Solange eine Aufnahme läuft, gilt die Capture-Policy, damit dvgrab keine Frames verliert:
+
+- "nice":  laufende und neue ffmpeg-Prozesse mit nice 19 / ionice idle (jeder Thread, auch
+           später gestartete), höchstens capture_workers Jobs gleichzeitig
+- "pause": laufende ffmpeg-Prozesse werden angehalten (SIGSTOP), keine neuen Jobs
+- "off":   keine Einschränkung
+
+Nach der Aufnahme laufen alle Prozesse normal weiter (SIGCONT, nice 0). Ohne CAP_SYS_NICE lässt
+der Kernel nice 0 nicht zu; das wird geloggt und der Job bleibt als gedrosselt sichtbar.
+"""
+
+import itertools
+import threading
+from typing import Callable, List, Optional, Set
+
+from .job_control import NICE_NORMAL, NICE_THROTTLED, JobControl, bind_control
+
+
+POLICY_NICE = "nice"
+POLICY_PAUSE = "pause"
+POLICY_OFF = "off"
+POLICIES = (POLICY_NICE, POLICY_PAUSE, POLICY_OFF)
+
+STATE_IDLE = "idle"
+STATE_RUNNING = "running"
+STATE_THROTTLED = "throttled"
+STATE_PAUSED = "paused"
+
+
+class _WorkerSlot:
+    def __init__(self, index: int):
+        self.index = index
+        self.thread: Optional[threading.Thread] = None
+        self.job = None
+        self.control: Optional[JobControl] = None
+
+
+class MergeScheduler:
+    """
+    Verteilt Merge-Jobs auf mehrere Worker.
+
+    Args:
+        run_job: führt einen Job aus (im Worker-Thread, JobControl ist gebunden)
+        is_capturing: liefert True, solange eine Aufnahme läuft
+        max_workers: gleichzeitige Jobs ohne Aufnahme
+        capture_policy: "nice", "pause" oder "off" (siehe Moduldoku)
+        capture_workers: gleichzeitige Jobs während einer Aufnahme (Policy "nice")
+    """
+
+    def __init__(
+        self,
+        run_job: Callable[[object], None],
+        is_capturing: Callable[[], bool],
+        log_callback: Optional[Callable[[str], None]] = None,
+        max_workers: int = 1,
+        capture_policy: str = POLICY_NICE,
+        capture_workers: int = 1,
+        poll_interval: float = 1.0,
+    ):
+        self.run_job = run_job
+        self.is_capturing = is_capturing
+        self.log_callback = log_callback
+        self.max_workers = max(1, int(max_workers))
+        self.capture_policy = capture_policy if capture_policy in POLICIES else POLICY_NICE
+        self.capture_workers = max(0, int(capture_workers))
+        self.poll_interval = poll_interval
+        self._cond = threading.Condition()
+        self._pending: List[object] = []
+        self._slots: List[_WorkerSlot] = []
+        self._controls: Set[JobControl] = set()  # zusätzlich gesteuerte Jobs (inkrementeller Merge)
+        self._sequence = itertools.count()
+        self._capture_active = False
+        self._stop_event = threading.Event()
+        self._monitor: Optional[threading.Thread] = None
+
+    # --- Lebenszyklus ----------------------------------------------------------
+
+    def start(self):
+        with self._cond:
+            self._stop_event.clear()
+            self._ensure_workers()
+        if not (self._monitor and self._monitor.is_alive()):
+            self._monitor = threading.Thread(target=self._monitor_loop, daemon=True, name="MergeScheduler")
+            self._monitor.start()
+        self.log(f"Merge-Scheduler gestartet ({self.max_workers} Worker, Aufnahme-Policy: {self.capture_policy})")
+
+    def stop(self):
+        self._stop_event.set()
+        with self._cond:
+            self._cond.notify_all()
+
+    def configure(
+        self,
+        max_workers: Optional[int] = None,
+        capture_policy: Optional[str] = None,
+        capture_workers: Optional[int] = None,
+    ):
+        """Ändert Limits zur Laufzeit; überzählige Worker beenden sich nach ihrem aktuellen Job."""
+        with self._cond:
+            if max_workers is not None:
+                self.max_workers = max(1, int(max_workers))
+            if capture_policy in POLICIES:
+                self.capture_policy = capture_policy
+            if capture_workers is not None:
+                self.capture_workers = max(0, int(capture_workers))
+            if not self._stop_event.is_set():
+                self._ensure_workers()
+            controls = self._all_controls()
+            self._cond.notify_all()
+        for control in controls:
+            self._apply_policy(control)
+
+    # --- Jobs ----------------------------------------------------------------------
+
+    def submit(self, job, priority: int = 0):
+        with self._cond:
+            job.priority = priority
+            job.sequence = next(self._sequence)
+            self._pending.append(job)
+            self._cond.notify_all()
+
+    def set_priority(self, job, priority: int) -> bool:
+        """Ändert die Priorität eines wartenden Jobs"""
+        with self._cond:
+            if job not in self._pending:
+                return False
+            job.priority = priority
+            self._cond.notify_all()
+            return True
+
+    def pending_jobs(self) -> list:
+        with self._cond:
+            return sorted(self._pending, key=self._order)
+
+    def running_jobs(self) -> list:
+        with self._cond:
+            return [slot.job for slot in self._slots if slot.job is not None]
+
+    def has_work(self) -> bool:
+        with self._cond:
+            return bool(self._pending) or any(slot.job is not None for slot in self._slots)
+
+    def worker_states(self) -> List[dict]:
+        """Zustand je Worker: {"worker", "state", "job"}"""
+        with self._cond:
+            result = []
+            for slot in self._slots:
+                if slot.job is None:
+                    state = STATE_IDLE
+                elif slot.control and slot.control.paused:
+                    state = STATE_PAUSED
+                elif slot.control and slot.control.niceness >= NICE_THROTTLED:
+                    state = STATE_THROTTLED
+                else:
+                    state = STATE_RUNNING
+                result.append({"worker": slot.index, "state": state, "job": slot.job})
+            return result
+
+    @property
+    def capture_active(self) -> bool:
+        return self._capture_active
+
+    # --- Fremde Jobs (z.B. inkrementeller Merge während der Aufnahme) ----------------
+
+    def register_control(self, control: JobControl):
+        with self._cond:
+            self._controls.add(control)
+        self._apply_policy(control)
+
+    def unregister_control(self, control: JobControl):
+        with self._cond:
+            self._controls.discard(control)
+
+    # --- Intern ----------------------------------------------------------------------
+
+    @staticmethod
+    def _order(job):
+        return (-job.priority, job.sequence)
+
+    def _ensure_workers(self):
+        """Startet fehlende Worker bis max_workers (mit gehaltenem Lock aufrufen)"""
+        self._slots = [slot for slot in self._slots if slot.thread and slot.thread.is_alive()]
+        used = {slot.index for slot in self._slots}
+        for index in range(self.max_workers):
+            if index in used:
+                continue
+            slot = _WorkerSlot(index)
+            slot.thread = threading.Thread(
+                target=self._worker_loop, args=(slot,), daemon=True, name=f"MergeWorker-{index}"
+            )
+            self._slots.append(slot)
+            slot.thread.start()
+        self._slots.sort(key=lambda s: s.index)
+
+    def _admission_limit(self) -> int:
+        if not self._capture_active or self.capture_policy == POLICY_OFF:
+            return self.max_workers
+        if self.capture_policy == POLICY_PAUSE:
+            return 0
+        return min(self.max_workers, self.capture_workers)
+
+    def _can_start(self) -> bool:
+        running = sum(1 for slot in self._slots if slot.job is not None)
+        return bool(self._pending) and running < self._admission_limit()
+
+    def _worker_loop(self, slot: _WorkerSlot):
+        while True:
+            with self._cond:
+                while not self._stop_event.is_set() and slot.index < self.max_workers and not self._can_start():
+                    self._cond.wait(timeout=self.poll_interval)
+                if self._stop_event.is_set() or slot.index >= self.max_workers:
+                    return
+                job = min(self._pending, key=self._order)
+                self._pending.remove(job)
+                job.worker = slot.index
+                slot.job = job
+                slot.control = JobControl(getattr(job, "title", ""))
+                control = slot.control
+            self._apply_policy(control)
+            bind_control(control)
+            try:
+                self.run_job(job)
+            except Exception as e:
+                self.log(f"Merge-Worker {slot.index}: Fehler: {e}")
+            finally:
+                bind_control(None)
+                with self._cond:
+                    slot.job = None
+                    slot.control = None
+                    self._cond.notify_all()
+
+    def _all_controls(self) -> List[JobControl]:
+        controls = [slot.control for slot in self._slots if slot.control is not None]
+        return controls + list(self._controls)
+
+    def _apply_policy(self, control: JobControl) -> bool:
+        """Returns False, wenn die Priorität nicht gesetzt werden konnte"""
+        if self._capture_active and self.capture_policy == POLICY_PAUSE:
+            control.pause()
+        else:
+            control.resume()
+        throttle = self._capture_active and self.capture_policy == POLICY_NICE
+        return control.set_niceness(NICE_THROTTLED if throttle else NICE_NORMAL)
+
+    def _monitor_loop(self):
+        while not self._stop_event.wait(self.poll_interval):
+            try:
+                active = bool(self.is_capturing())
+            except Exception:
+                active = False
+            if active == self._capture_active:
+                # Neue Encoder-Threads gedrosselter Jobs nachziehen
+                with self._cond:
+                    controls = self._all_controls()
+                for control in controls:
+                    control.refresh()
+                continue
+            with self._cond:
+                self._capture_active = active
+                controls = self._all_controls()
+                self._cond.notify_all()
+            failed = [control for control in controls if not self._apply_policy(control)]
+            if active and self.capture_policy != POLICY_OFF:
+                action = "angehalten" if self.capture_policy == POLICY_PAUSE else "gedrosselt"
+                self.log(f"Merge-Scheduler: Aufnahme läuft, {len(controls)} Hintergrund-Jobs {action}")
+            elif not active and failed:
+                names = ", ".join(control.name or "?" for control in failed)
+                self.log(
+                    f"Merge-Scheduler: Aufnahme beendet, Priorität von {names} nicht zurückgesetzt "
+                    "(nice 0 braucht CAP_SYS_NICE), diese Jobs laufen gedrosselt weiter"
+                )
+            elif not active and self.capture_policy != POLICY_OFF:
+                self.log("Merge-Scheduler: Aufnahme beendet, Hintergrund-Jobs laufen normal weiter")
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
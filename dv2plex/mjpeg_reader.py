@@ -0,0 +1,148 @@
+"""
+MJPEG-Frame-Extraktor für Preview-Streams (ffmpeg -f mjpeg / image2pipe auf stdout)
+
+Liest mit readinto in einen festen Puffer und sucht SOI (FFD8) / EOI (FFD9) inkrementell:
+bereits geprüfte Bytes werden nie erneut durchsucht. Nur ausgegebene Frames werden zu
+bytes materialisiert, Frames, die der FPS-Begrenzer verwirft, werden nur übersprungen.
+Am Pufferende wird lediglich das angefangene Frame an den Anfang verschoben.
+"""
+
+import time
+from typing import BinaryIO, Callable, Optional
+
+
+JPEG_SOI = b"\xff\xd8"
+JPEG_EOI = b"\xff\xd9"
+
+
+class MJPEGFrameExtractor:
+    """
+    Zerlegt einen MJPEG-Bytestrom in einzelne JPEG-Frames.
+
+    Args:
+        on_frame: Callback für jedes ausgegebene Frame (rohe JPEG-Bytes)
+        max_fps: Obergrenze für ausgegebene Frames pro Sekunde (None = alle)
+        buffer_size: Größe des festen Lesepuffers (muss ein komplettes Frame fassen)
+        read_size: Maximale Bytes pro readinto
+    """
+
+    def __init__(
+        self,
+        on_frame: Callable[[bytes], None],
+        max_fps: Optional[float] = None,
+        buffer_size: int = 2 * 1024 * 1024,
+        read_size: int = 64 * 1024,
+        clock: Callable[[], float] = time.monotonic,
+    ):
+        if buffer_size < 2 * read_size:
+            raise ValueError("buffer_size muss mindestens 2 * read_size sein")
+        self.on_frame = on_frame
+        self.min_interval = 1.0 / max_fps if max_fps else 0.0
+        self.read_size = read_size
+        self.clock = clock
+        self._buffer = bytearray(buffer_size)
+        self._view = memoryview(self._buffer)
+        self._end = 0  # Ende der gültigen Daten
+        self._scan = 0  # ab hier wurde noch nicht gesucht
+        self._frame_start = -1  # Position des SOI des aktuellen Frames, -1 = suche SOI
+        self._last_emit: Optional[float] = None
+        # Statistik
+        self.bytes_read = 0
+        self.frames_seen = 0
+        self.frames_emitted = 0
+        self.frames_skipped = 0
+        self.overflows = 0
+
+    # --- Eingabe -----------------------------------------------------------
+
+    def read_from(self, stream: BinaryIO) -> int:
+        """Liest einmal aus dem Stream und verarbeitet die neuen Bytes. 0 = EOF."""
+        self._make_room()
+        target = self._view[self._end: self._end + self.read_size]
+        readinto = getattr(stream, "readinto", None)
+        if readinto is not None:
+            n = readinto(target) or 0
+        else:
+            data = stream.read(len(target))
+            n = len(data) if data else 0
+            target[:n] = data[:n] if n else b""
+        if n:
+            self._end += n
+            self.bytes_read += n
+            self._process()
+        return n
+
+    def feed(self, data) -> None:
+        """Verarbeitet bereits gelesene Bytes (z.B. für Tests)."""
+        data = memoryview(data)
+        while data:
+            self._make_room()
+            n = min(len(data), self.read_size)
+            self._view[self._end: self._end + n] = data[:n]
+            self._end += n
+            self.bytes_read += n
+            data = data[n:]
+            self._process()
+
+    def run(self, stream: BinaryIO, should_continue: Optional[Callable[[], bool]] = None) -> None:
+        """Liest bis EOF (oder bis should_continue() False liefert)."""
+        while should_continue is None or should_continue():
+            if not self.read_from(stream):
+                break
+
+    def reset(self) -> None:
+        """Verwirft angefangene Daten (z.B. beim Wechsel des Quellprozesses)."""
+        self._end = 0
+        self._scan = 0
+        self._frame_start = -1
+
+    # --- Intern ------------------------------------------------------------
+
+    def _make_room(self) -> None:
+        if len(self._buffer) - self._end >= self.read_size:
+            return
+        keep_from = self._frame_start if self._frame_start >= 0 else self._scan
+        keep = self._end - keep_from
+        if keep > len(self._buffer) - self.read_size:
+            # Frame größer als der Puffer – verwerfen und neu synchronisieren
+            self.overflows += 1
+            self.reset()
+            return
+        if keep:
+            self._view[:keep] = self._view[keep_from: self._end]
+        self._end = keep
+        self._scan -= keep_from
+        if self._frame_start >= 0:
+            self._frame_start -= keep_from
+
+    def _process(self) -> None:
+        buf = self._buffer
+        end = self._end
+        while True:
+            if self._frame_start < 0:
+                soi = buf.find(JPEG_SOI, self._scan, end)
+                if soi < 0:
+                    # Letztes Byte behalten, falls der Marker über zwei Reads verteilt ist
+                    self._scan = max(self._scan, end - 1)
+                    return
+                self._frame_start = soi
+                self._scan = soi + 2
+            eoi = buf.find(JPEG_EOI, self._scan, end)
+            if eoi < 0:
+                self._scan = max(self._scan, end - 1)
+                return
+            frame_start, frame_end = self._frame_start, eoi + 2
+            self._frame_start = -1
+            self._scan = frame_end
+            self._emit(frame_start, frame_end)
+
+    def _emit(self, start: int, end: int) -> None:
+        self.frames_seen += 1
+        if self.min_interval:
+            now = self.clock()
+            if self._last_emit is not None and now - self._last_emit < self.min_interval:
+                self.frames_skipped += 1
+                return
+            self._last_emit = now
+        self.frames_emitted += 1
+        self.on_frame(bytes(self._view[start:end]))
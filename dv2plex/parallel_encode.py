@@ -0,0 +1,468 @@
+"""
+Chunk-paralleler Re-Encode für den Merge
+
+libx264 (preset medium) lastet bei SD-Material nur einen Teil der Kerne aus. Der Encode wird
+deshalb an Split- bzw. Szenengrenzen in Chunks geteilt, die ein begrenzter Worker-Pool
+gleichzeitig kodiert (nur Video). Audio wird in einem Stück kodiert bzw. aus der Quelle kopiert
+(keine AAC-Priming-Lücken an den Nahtstellen); danach werden die Chunks per Stream-Copy
+(concat) zusammengefügt.
+
+Nahtstellen-Prüfung: ffmpeg meldet je Chunk (über -progress) die geschriebenen Frames samt dup/drop. Jeder Chunk
+muss genau die erwartete Frame-Anzahl haben, das concat-Ergebnis die Summe. Andernfalls liefert
+der Encoder None und der Aufrufer kodiert wie bisher in einem Prozess.
+"""
+
+import os
+import re
+import shutil
+import subprocess
+import threading
+from dataclasses import dataclass
+from pathlib import Path
+from queue import Queue, Empty
+from typing import Callable, List, Optional, Sequence, Tuple
+
+from . import job_control
+from .dv_index import FLAG_PAL, scan_dv_file
+from .ffmpeg_runner import FFmpegProgress, FFmpegResult, format_duration, run_ffmpeg
+from .timestamp_overlay import TimestampCue, burn_filter, soft_subtitle_args, window_cues, write_ass
+
+
+VIDEO_ENCODE_ARGS = ["-c:v", "libx264", "-pix_fmt", "yuv420p", "-preset", "medium", "-crf", "20"]
+MIN_CHUNK_SECONDS = 30.0
+# Mehr Chunks als Worker, damit ungleich lange Chunks den Pool nicht leer laufen lassen
+CHUNKS_PER_WORKER = 2
+MAX_AUTO_WORKERS = 8
+FPS_PAL = 25.0
+FPS_NTSC = 30000 / 1001
+
+_FRAME_RE = re.compile(r"frame=\s*(\d+)")
+_DUP_RE = re.compile(r"dup=\s*(\d+)")
+_DROP_RE = re.compile(r"drop=\s*(\d+)")
+
+
+def resolve_workers(workers: Optional[int]) -> int:
+    """Worker-Anzahl; 0/None = automatisch (ein Worker je 4 Kerne, höchstens MAX_AUTO_WORKERS)"""
+    if workers and workers > 0:
+        return int(workers)
+    return max(1, min(MAX_AUTO_WORKERS, (os.cpu_count() or 1) // 4))
+
+
+def plan_chunks(lengths: Sequence[int], workers: int, min_length: int = 1) -> List[Tuple[int, int]]:
+    """
+    Teilt aufeinanderfolgende Abschnitte (Frames je Split bzw. je Szene) in zusammenhängende
+    Chunks [erster, letzter + 1) möglichst gleicher Länge. Geschnitten wird nur an
+    Abschnittsgrenzen, kein Chunk ist (außer bei zu wenig Material) kürzer als min_length.
+    """
+    total = sum(lengths)
+    if not lengths or total <= 0:
+        return []
+    count = max(1, min(workers * CHUNKS_PER_WORKER, total // max(1, min_length), len(lengths)))
+    target = total / count
+    chunks: List[Tuple[int, int]] = []
+    start = 0
+    done = 0
+    for i, length in enumerate(lengths[:-1]):
+        done += length
+        if done >= target * (len(chunks) + 1) and total - done >= min_length:
+            chunks.append((start, i + 1))
+            start = i + 1
+    chunks.append((start, len(lengths)))
+    return chunks
+
+
+def sections_from_boundaries(boundaries: Sequence[float], fps: float, total_frames: int) -> List[int]:
+    """Frame-Anzahl je Abschnitt zwischen Grenzen in Sekunden (auf das Frame-Raster gerundet)"""
+    cuts = sorted({int(round(t * fps)) for t in boundaries if 0 < round(t * fps) < total_frames})
+    edges = [0] + cuts + [total_frames]
+    return [b - a for a, b in zip(edges, edges[1:])]
+
+
+def parse_frame_stats(output: str) -> Tuple[Optional[int], int, int]:
+    """Letzte ffmpeg-Statuszeile: (Frames, dup, drop)"""
+    frames = _FRAME_RE.findall(output)
+    dup = _DUP_RE.findall(output)
+    drop = _DROP_RE.findall(output)
+    return (
+        int(frames[-1]) if frames else None,
+        int(dup[-1]) if dup else 0,
+        int(drop[-1]) if drop else 0,
+    )
+
+
+def frame_stats(result: FFmpegResult) -> Tuple[Optional[int], int, int]:
+    """(Frames, dup, drop) aus dem -progress-Block, sonst aus der letzten Statuszeile"""
+    progress = result.progress
+    if progress.updates:
+        return progress.frame, progress.dup_frames, progress.drop_frames
+    return parse_frame_stats(result.stderr)
+
+
+def _concat_line(path: Path) -> str:
+    escaped = str(Path(path).resolve()).replace("'", "'\\''")
+    return f"file '{escaped}'\n"
+
+
+@dataclass
+class _Job:
+    """Ein ffmpeg-Aufruf im Pool: Video-Chunk (frames > 0) oder die durchgehende Audiospur"""
+
+    name: str
+    cmd: List[str]
+    output: Path
+    frames: int = 0
+    result_frames: Optional[int] = None
+    dup: int = 0
+    drop: int = 0
+    error: str = ""
+
+
+class ParallelEncoder:
+    """
+    Kodiert ein Video in parallelen Chunks und fügt sie verlustfrei zusammen.
+
+    Args:
+        ffmpeg_path: Pfad zu ffmpeg
+        workers: gleichzeitige x264-Prozesse (jeder bekommt cpu_count / workers Threads)
+        work_dir: Arbeitsordner für Chunks (wird danach gelöscht)
+        min_chunk_seconds: Mindestlänge eines Chunks
+        progress_callback: erhält (Prozent, Beschreibung) über alle Chunks zusammen
+    """
+
+    def __init__(
+        self,
+        ffmpeg_path: Path,
+        workers: int,
+        work_dir: Path,
+        log_callback: Optional[Callable[[str], None]] = None,
+        min_chunk_seconds: float = MIN_CHUNK_SECONDS,
+        progress_callback: Optional[Callable[[int, str], None]] = None,
+    ):
+        self.ffmpeg_path = ffmpeg_path
+        self.workers = max(1, int(workers))
+        self.work_dir = Path(work_dir)
+        self.log_callback = log_callback
+        self.min_chunk_seconds = min_chunk_seconds
+        self.threads_per_worker = max(1, (os.cpu_count() or 1) // self.workers)
+        self.progress_callback = progress_callback
+        self._chunk_frames: dict = {}
+        self._chunk_fps: dict = {}
+        self._progress_lock = threading.Lock()
+
+    # --- Einstiegspunkte -------------------------------------------------------
+
+    def encode_splits(
+        self,
+        splits: Sequence[Path],
+        frames: Sequence[int],
+        fps: float,
+        output_path: Path,
+        burn_cues: Optional[List[TimestampCue]] = None,
+        subtitle_path: Optional[Path] = None,
+    ) -> Optional[Path]:
+        """
+        Kodiert Splits (Merge-Reihenfolge) in Chunks aus ganzen Splits.
+
+        Args:
+            frames: Frame-Anzahl je Split (aus dem Split-Manifest)
+            burn_cues: Timestamp-Einblendungen, die eingebrannt werden
+            subtitle_path: ASS-Datei, die als weiche Spur gemuxt wird (nur MP4)
+
+        Returns:
+            output_path oder None (nicht parallelisierbar oder Prüfung fehlgeschlagen)
+        """
+        if not splits or any(not n or n <= 0 for n in frames):
+            self.log("Paralleler Encode: Frame-Anzahl nicht für alle Splits bekannt, kodiere in einem Prozess")
+            return None
+        plan = plan_chunks(frames, self.workers, int(self.min_chunk_seconds * fps))
+        if len(plan) < 2:
+            return None
+
+        self._prepare_work_dir()
+        full_list = self.work_dir / "all.txt"
+        full_list.write_text("".join(_concat_line(s) for s in splits), encoding="utf-8")
+        audio_path = self.work_dir / "audio.m4a"
+        jobs = [
+            _Job(
+                "Audio",
+                [
+                    *self._ffmpeg_base(),
+                    "-f", "concat", "-safe", "0", "-i", str(full_list),
+                    "-vn", "-c:a", "aac",
+                    "-y", str(audio_path),
+                ],
+                audio_path,
+            )
+        ]
+        for index, (first, last) in enumerate(plan):
+            list_file = self.work_dir / f"chunk_{index:03d}.txt"
+            list_file.write_text("".join(_concat_line(s) for s in splits[first:last]), encoding="utf-8")
+            start = sum(frames[:first]) / fps
+            jobs.append(
+                self._chunk_job(
+                    index,
+                    ["-f", "concat", "-safe", "0", "-i", str(list_file)],
+                    sum(frames[first:last]),
+                    start,
+                    fps,
+                    burn_cues,
+                    limit_frames=False,
+                )
+            )
+        return self._run(jobs, ["-i", str(audio_path)], output_path, sum(frames), subtitle_path)
+
+    def encode_range(
+        self,
+        input_path: Path,
+        output_path: Path,
+        boundaries: Sequence[float],
+        burn_cues: Optional[List[TimestampCue]] = None,
+        subtitle_path: Optional[Path] = None,
+        ffprobe_path: Optional[Path] = None,
+    ) -> Optional[Path]:
+        """
+        Kodiert eine einzelne Datei in Chunks, geschnitten an den angegebenen Grenzen
+        (Split- bzw. Szenenwechsel in Sekunden). Audio wird aus der Quelle kopiert.
+        """
+        probed = self.probe_frames(input_path, ffprobe_path)
+        if not probed:
+            self.log("Paralleler Encode: Frame-Anzahl der Quelle unbekannt, kodiere in einem Prozess")
+            return None
+        total, fps = probed
+        sections = sections_from_boundaries(boundaries, fps, total)
+        plan = plan_chunks(sections, self.workers, int(self.min_chunk_seconds * fps))
+        if len(plan) < 2:
+            return None
+
+        self._prepare_work_dir()
+        jobs = []
+        for index, (first, last) in enumerate(plan):
+            start_frame = sum(sections[:first])
+            input_args = ["-i", str(input_path)]
+            if start_frame:
+                # Halber Frame vor dem Ziel: genaues Seeking verwirft alles davor, Rundung
+                # kann den ersten Frame nicht abschneiden
+                input_args = ["-ss", f"{(start_frame - 0.5) / fps:.6f}", *input_args]
+            jobs.append(
+                self._chunk_job(
+                    index,
+                    input_args,
+                    sum(sections[first:last]),
+                    start_frame / fps,
+                    fps,
+                    burn_cues,
+                    limit_frames=True,
+                )
+            )
+        return self._run(jobs, ["-i", str(input_path)], output_path, total, subtitle_path)
+
+    # --- Hilfsfunktionen -------------------------------------------------------
+
+    def probe_frames(self, path: Path, ffprobe_path: Optional[Path] = None) -> Optional[Tuple[int, float]]:
+        """(Frames, fps) einer Datei: DV direkt aus dem Index, sonst ffprobe (Pakete zählen, kein Decode)"""
+        try:
+            index = scan_dv_file(path)
+            if len(index):
+                return len(index), FPS_PAL if index.flags[0] & FLAG_PAL else FPS_NTSC
+        except Exception:
+            pass
+        cmd = [
+            str(ffprobe_path or Path(self.ffmpeg_path).with_name("ffprobe")),
+            "-v", "error",
+            "-select_streams", "v:0",
+            "-count_packets",
+            "-show_entries", "stream=r_frame_rate,nb_read_packets",
+            "-of", "csv=p=0",
+            str(path),
+        ]
+        try:
+            result = job_control.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+            rate, packets = result.stdout.strip().splitlines()[0].split(",")[:2]
+            num, _, den = rate.partition("/")
+            fps = float(num) / float(den or 1)
+            return (int(packets), fps) if fps > 0 and int(packets) > 0 else None
+        except Exception:
+            return None
+
+    def _ffmpeg_base(self) -> List[str]:
+        return [str(self.ffmpeg_path), "-hide_banner", "-nostdin"]
+
+    def _prepare_work_dir(self):
+        shutil.rmtree(self.work_dir, ignore_errors=True)
+        self.work_dir.mkdir(parents=True, exist_ok=True)
+
+    def _chunk_job(
+        self,
+        index: int,
+        input_args: List[str],
+        frames: int,
+        start: float,
+        fps: float,
+        burn_cues: Optional[List[TimestampCue]],
+        limit_frames: bool,
+    ) -> _Job:
+        output = self.work_dir / f"chunk_{index:03d}.mkv"
+        filter_args: List[str] = []
+        if burn_cues:
+            cues = window_cues(burn_cues, start, start + frames / fps)
+            if cues:
+                ass_path = write_ass(cues, self.work_dir / f"chunk_{index:03d}.ass")
+                filter_args = ["-vf", burn_filter(ass_path)]
+        cmd = [
+            *self._ffmpeg_base(),
+            *input_args,
+            "-map", "0:v:0",
+            "-an",
+            *filter_args,
+            *VIDEO_ENCODE_ARGS,
+            "-threads", str(self.threads_per_worker),
+        ]
+        if limit_frames:
+            cmd += ["-frames:v", str(frames)]
+        cmd += ["-y", str(output)]
+        return _Job(f"Chunk {index + 1}", cmd, output, frames=frames)
+
+    def _run(
+        self,
+        jobs: List[_Job],
+        audio_input: List[str],
+        output_path: Path,
+        total_frames: int,
+        subtitle_path: Optional[Path],
+    ) -> Optional[Path]:
+        chunks = [job for job in jobs if job.frames]
+        self.log(
+            f"Paralleler Encode: {len(chunks)} Chunks, {self.workers} Worker "
+            f"à {self.threads_per_worker} Threads"
+        )
+        try:
+            if not self._run_pool(jobs):
+                return None
+            if not self._verify_chunks(chunks):
+                return None
+            return self._concat(chunks, audio_input, output_path, total_frames, subtitle_path)
+        finally:
+            shutil.rmtree(self.work_dir, ignore_errors=True)
+
+    def _run_pool(self, jobs: List[_Job]) -> bool:
+        queue: Queue = Queue()
+        for job in jobs:
+            queue.put(job)
+        failed = threading.Event()
+        lock = threading.Lock()
+        finished = [0]
+        # Chunk-Prozesse gehören zum Job des aufrufenden Threads (Drosselung während der Aufnahme)
+        control = job_control.current_control()
+        self._chunk_frames = {}
+        self._chunk_fps = {}
+
+        def worker():
+            job_control.bind_control(control)
+            while not failed.is_set():
+                try:
+                    job = queue.get_nowait()
+                except Empty:
+                    return
+                try:
+                    result = run_ffmpeg(
+                        job.cmd,
+                        total_frames=job.frames or None,
+                        progress_callback=lambda progress, job=job: self._chunk_progress(job, progress, jobs),
+                    )
+                    job.result_frames, job.dup, job.drop = frame_stats(result)
+                    if result.returncode != 0 or not job.output.exists():
+                        job.error = result.stderr[-500:]
+                        failed.set()
+                        continue
+                    with lock:
+                        finished[0] += 1
+                        self.log(f"Paralleler Encode: {job.name} fertig ({finished[0]}/{len(jobs)})")
+                except Exception as e:
+                    job.error = str(e)
+                    failed.set()
+
+        threads = [
+            threading.Thread(target=worker, daemon=True, name=f"ParallelEncode-{i}")
+            for i in range(min(self.workers, len(jobs)))
+        ]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        for job in jobs:
+            if job.error:
+                self.log(f"Paralleler Encode: {job.name} fehlgeschlagen: {job.error}")
+        return not failed.is_set()
+
+    def _chunk_progress(self, job: _Job, progress: FFmpegProgress, jobs: List[_Job]):
+        """Fortschritt aller Chunks zusammen: kodierte Frames / Frames gesamt, fps als Summe"""
+        if not self.progress_callback or not job.frames:
+            return
+        total = sum(j.frames for j in jobs)
+        with self._progress_lock:
+            self._chunk_frames[job.name] = min(progress.frame, job.frames)
+            self._chunk_fps[job.name] = 0.0 if progress.finished else progress.fps
+            done = sum(self._chunk_frames.values())
+            fps = sum(self._chunk_fps.values())
+        message = f"{done}/{total} Frames"
+        if fps:
+            message += f" · {fps:.0f} fps · noch {format_duration((total - done) / fps)}"
+        self.progress_callback(int(done * 100 / total) if total else 0, message)
+
+    def _verify_chunks(self, chunks: List[_Job]) -> bool:
+        ok = True
+        for job in chunks:
+            if job.result_frames != job.frames or job.dup or job.drop:
+                self.log(
+                    f"Paralleler Encode: {job.name} hat {job.result_frames} statt {job.frames} Frames "
+                    f"(dup={job.dup}, drop={job.drop})"
+                )
+                ok = False
+        return ok
+
+    def _concat(
+        self,
+        chunks: List[_Job],
+        audio_input: List[str],
+        output_path: Path,
+        total_frames: int,
+        subtitle_path: Optional[Path],
+    ) -> Optional[Path]:
+        list_file = self.work_dir / "chunks.txt"
+        list_file.write_text("".join(_concat_line(job.output) for job in chunks), encoding="utf-8")
+        container = output_path.suffix.lower()
+
+        cmd = [
+            *self._ffmpeg_base(),
+            "-f", "concat", "-safe", "0", "-i", str(list_file),
+            *audio_input,
+        ]
+        if subtitle_path:
+            cmd += ["-i", str(subtitle_path), "-c:v", "copy", "-c:a", "copy", *soft_subtitle_args(2, audio_input_index=1)]
+        else:
+            cmd += ["-map", "0:v", "-map", "1:a?", "-c:v", "copy", "-c:a", "copy"]
+        if container == ".avi":
+            cmd += ["-bsf:v", "h264_mp4toannexb"]
+        elif container in (".mp4", ".mov", ".m4v"):
+            cmd += ["-movflags", "+faststart"]
+        cmd += ["-y", str(output_path)]
+
+        result = run_ffmpeg(cmd, total_frames=total_frames)
+        if result.returncode != 0 or not output_path.exists():
+            self.log(f"Paralleler Encode: concat fehlgeschlagen: {result.stderr[-500:]}")
+            return None
+        frames, _, _ = frame_stats(result)
+        if frames != total_frames:
+            self.log(f"Paralleler Encode: Ergebnis hat {frames} statt {total_frames} Frames")
+            try:
+                output_path.unlink()
+            except OSError:
+                pass
+            return None
+        self.log(f"Paralleler Encode: {total_frames} Frames ohne Verlust an den Nahtstellen")
+        return output_path
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
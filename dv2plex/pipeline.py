@@ -0,0 +1,336 @@
+"""
+Pipeline-Scheduler: jedes Projekt ist ein DAG aus Stufen (Aufnahme → Merge → Upscale → Poster → Export)
+
+Jede Stufenart gehört zu einer Ressourcenklasse mit globalem Budget, damit CPU-, I/O- und
+speicherhungrige Modell-Stufen sich nicht gegenseitig ausbremsen (z.B. nie zwei Upscales und
+eine Poster-Serie gleichzeitig):
+
+- "cpu":   Merge/Re-Encode
+- "io":    Export nach Plex
+- "model": Real-ESRGAN-Upscale und Poster-Generierung (rembg, Chromium)
+
+Die Worker der Services (Merge-Scheduler, Postprocessing- und Poster-Queue) holen sich vor der
+eigentlichen Arbeit einen Slot aus shared_resources() und melden Start und Ende ihrer Stufe an
+PipelineScheduler.on_stage(). Ist eine Stufe fertig, reiht der Scheduler die nachfolgenden Stufen
+ein, sofern deren Schalter (capture.auto_merge, auto_upscale, auto_poster, auto_export) an ist
+und alle aktiven Vorgänger abgeschlossen sind. Stufen ohne eigene Queue (Export, Film-Merge,
+Export-All, Vorschau, Cover) laufen über run_task(): die Aufgabe wartet in der Warteschlange ihrer
+Ressourcenklasse und bekommt erst mit dem Slot einen eigenen Thread.
+"""
+
+import threading
+from collections import deque
+from contextlib import contextmanager
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Callable, Deque, Dict, List, Optional, Tuple
+
+
+RESOURCE_CPU = "cpu"
+RESOURCE_IO = "io"
+RESOURCE_MODEL = "model"
+DEFAULT_BUDGETS = {RESOURCE_CPU: 2, RESOURCE_IO: 1, RESOURCE_MODEL: 1}
+
+STAGE_CAPTURE = "capture"
+STAGE_MERGE = "merge"
+STAGE_UPSCALE = "upscale"
+STAGE_POSTER = "poster"
+STAGE_EXPORT = "export"
+
+STATE_QUEUED = "queued"
+STATE_RUNNING = "running"
+STATE_COMPLETED = "completed"
+STATE_FAILED = "failed"
+
+
+@dataclass(frozen=True)
+class StageType:
+    name: str
+    resource: Optional[str]
+    upstream: Tuple[str, ...] = ()
+    switch: Optional[str] = None  # Config-Schalter der eingehenden Kante
+    switch_default: bool = True
+    optional: bool = False  # Fehlschlag blockiert nachfolgende Stufen nicht
+
+
+# In Abhängigkeitsreihenfolge
+STAGE_TYPES: Dict[str, StageType] = {
+    stage.name: stage
+    for stage in (
+        StageType(STAGE_CAPTURE, None),
+        StageType(STAGE_MERGE, RESOURCE_CPU, (STAGE_CAPTURE,), "capture.auto_merge"),
+        StageType(STAGE_UPSCALE, RESOURCE_MODEL, (STAGE_MERGE,), "capture.auto_upscale"),
+        StageType(STAGE_POSTER, RESOURCE_MODEL, (STAGE_UPSCALE,), "capture.auto_poster", False, optional=True),
+        StageType(STAGE_EXPORT, RESOURCE_IO, (STAGE_UPSCALE, STAGE_POSTER), "capture.auto_export", False),
+    )
+}
+
+
+def stage_enabled(config, stage: str) -> bool:
+    """Ist die automatische Kante zu dieser Stufe eingeschaltet?"""
+    stage_type = STAGE_TYPES[stage]
+    if not stage_type.switch:
+        return True
+    return bool(config.get(stage_type.switch, stage_type.switch_default))
+
+
+def project_dir_of(path: Path) -> Path:
+    """Projektordner (DV_Import/<Titel (Jahr)>) zu einer Datei oder einem Ordner in LowRes/HighRes"""
+    path = Path(path)
+    for candidate in (path, *path.parents):
+        if candidate.name in ("LowRes", "HighRes"):
+            return candidate.parent
+    return path if path.is_dir() else path.parent
+
+
+@dataclass
+class _Waiter:
+    label: str
+    start: Optional[Callable[[], None]] = None  # None = blockierender acquire()-Aufrufer
+    granted: bool = False
+
+
+class ResourceBudget:
+    """
+    Globale Slots je Ressourcenklasse, vergeben in Ankunftsreihenfolge
+
+    acquire() blockiert den aufrufenden Thread, bis er an der Reihe ist. submit() reiht nur ein:
+    der Start-Callback läuft, sobald ein Slot frei wird, der Slot wird mit release() zurückgegeben.
+    """
+
+    def __init__(self, budgets: Optional[Dict[str, int]] = None):
+        self._cond = threading.Condition()
+        self._limits = dict(DEFAULT_BUDGETS)
+        self._holders: Dict[str, List[str]] = {resource: [] for resource in self._limits}
+        self._queues: Dict[str, Deque[_Waiter]] = {resource: deque() for resource in self._limits}
+        if budgets:
+            self.configure(budgets)
+
+    def configure(self, budgets: Dict[str, int]):
+        started = []
+        with self._cond:
+            for resource, limit in budgets.items():
+                self._limits[resource] = max(1, int(limit))
+                self._holders.setdefault(resource, [])
+                self._queues.setdefault(resource, deque())
+                started += self._grant(resource)
+        self._start(started)
+
+    @contextmanager
+    def acquire(self, resource: Optional[str], label: str = ""):
+        if resource is None:
+            yield
+            return
+        waiter = _Waiter(label)
+        with self._cond:
+            self._queues[resource].append(waiter)
+            started = self._grant(resource)
+            try:
+                while not waiter.granted:
+                    self._cond.wait()
+            except BaseException:
+                if waiter.granted:
+                    self._holders[resource].remove(label)
+                    started += self._grant(resource)
+                else:
+                    self._queues[resource].remove(waiter)
+                self._start(started)
+                raise
+        self._start(started)
+        try:
+            yield
+        finally:
+            self.release(resource, label)
+
+    def submit(self, resource: Optional[str], label: str, start: Callable[[], None]):
+        """start() wird aufgerufen, sobald der Slot vergeben ist (ohne Ressource sofort)"""
+        if resource is None:
+            start()
+            return
+        with self._cond:
+            self._queues[resource].append(_Waiter(label, start))
+            started = self._grant(resource)
+        self._start(started)
+
+    def release(self, resource: Optional[str], label: str):
+        if resource is None:
+            return
+        with self._cond:
+            self._holders[resource].remove(label)
+            started = self._grant(resource)
+            self._cond.notify_all()
+        self._start(started)
+
+    def _grant(self, resource: str) -> List[Callable[[], None]]:
+        """Freie Slots an die Wartenden vergeben (mit gehaltenem Lock); Rückgabe: auszuführende Starts"""
+        started = []
+        queue = self._queues[resource]
+        while queue and len(self._holders[resource]) < self._limits[resource]:
+            waiter = queue.popleft()
+            waiter.granted = True
+            self._holders[resource].append(waiter.label)
+            if waiter.start:
+                started.append(waiter.start)
+            else:
+                self._cond.notify_all()
+        return started
+
+    @staticmethod
+    def _start(started: List[Callable[[], None]]):
+        # Außerhalb des Locks: ein Start-Callback darf selbst wieder Slots anfordern
+        for start in started:
+            start()
+
+    def status(self) -> Dict[str, dict]:
+        with self._cond:
+            return {
+                resource: {
+                    "limit": self._limits[resource],
+                    "in_use": len(self._holders[resource]),
+                    "holders": list(self._holders[resource]),
+                    "waiting": len(self._queues[resource]),
+                }
+                for resource in self._limits
+            }
+
+
+_shared_resources = ResourceBudget()
+
+
+def shared_resources() -> ResourceBudget:
+    """Gemeinsames Budget aller Worker im Prozess"""
+    return _shared_resources
+
+
+# Executor: reiht eine Stufe für ein Projekt ein (Rückgabe False = nicht möglich)
+Executor = Callable[[Path, dict], bool]
+
+
+class PipelineScheduler:
+    """
+    Verbindet die Stufen-Worker zu einem DAG je Projekt.
+
+    Args:
+        config: Config (Schalter der Kanten, Budgets unter "pipeline.budgets")
+        resources: Ressourcen-Budget (Standard: shared_resources())
+    """
+
+    def __init__(
+        self,
+        config,
+        log_callback: Optional[Callable[[str], None]] = None,
+        resources: Optional[ResourceBudget] = None,
+    ):
+        self.config = config
+        self.log_callback = log_callback
+        self.resources = resources or shared_resources()
+        self.resources.configure(config.get("pipeline.budgets", DEFAULT_BUDGETS))
+        self._executors: Dict[str, Executor] = {}
+        self._projects: Dict[str, Dict[str, dict]] = {}
+        self._lock = threading.Lock()
+        self._queued_tasks = 0
+
+    # --- Stufen ------------------------------------------------------------------
+
+    def register_executor(self, stage: str, executor: Executor):
+        """executor(project_dir, result_der_vorstufe) reiht die Stufe ein"""
+        self._executors[stage] = executor
+
+    def on_stage(self, project_dir: Path, stage: str, state: str, result: Optional[dict] = None):
+        """Meldung eines Workers; bei Abschluss werden die nachfolgenden Stufen eingereiht"""
+        project_dir = Path(project_dir)
+        with self._lock:
+            stages = self._projects.setdefault(str(project_dir), {})
+            stages[stage] = {"state": state, "result": result or {}}
+        if state in (STATE_COMPLETED, STATE_FAILED):
+            self._dispatch(project_dir, stage, result or {})
+
+    def _dispatch(self, project_dir: Path, finished: str, result: dict):
+        for stage_type in STAGE_TYPES.values():
+            if finished not in stage_type.upstream or not stage_enabled(self.config, stage_type.name):
+                continue
+            executor = self._executors.get(stage_type.name)
+            with self._lock:
+                stages = self._projects.setdefault(str(project_dir), {})
+                current = stages.get(stage_type.name, {}).get("state")
+                if executor is None or current in (STATE_QUEUED, STATE_RUNNING):
+                    continue
+                if not self._upstream_done(stages, stage_type):
+                    continue
+                stages[stage_type.name] = {"state": STATE_QUEUED, "result": {}}
+            self.log(f"Pipeline: {project_dir.name}: {finished} fertig → {stage_type.name}")
+            try:
+                queued = executor(project_dir, result)
+            except Exception as e:
+                self.log(f"Pipeline: {stage_type.name} für {project_dir.name} nicht gestartet: {e}")
+                queued = False
+            if not queued:
+                with self._lock:
+                    self._projects[str(project_dir)].pop(stage_type.name, None)
+
+    def _upstream_done(self, stages: Dict[str, dict], stage_type: StageType) -> bool:
+        """Jeder aktive Vorgänger ist fertig (optionale Stufen dürfen fehlschlagen)"""
+        for name in stage_type.upstream:
+            state = stages.get(name, {}).get("state")
+            if state == STATE_COMPLETED:
+                continue
+            if state == STATE_FAILED and STAGE_TYPES[name].optional:
+                continue
+            if state is None and not stage_enabled(self.config, name):
+                continue
+            return False
+        return True
+
+    # --- Tasks für Stufen ohne eigene Queue -------------------------------------
+
+    def run_task(self, label: str, func: Callable[[], None], resource: Optional[str] = None):
+        """
+        Führt func in einem eigenen Thread aus, sobald ein Slot der Ressourcenklasse frei ist
+
+        Wartende Tasks belegen keinen Thread: ein Cover hinter einem stundenlangen Upscale
+        hält keinen Export und keinen Merge auf, deren Slot frei ist.
+        """
+        with self._lock:
+            self._queued_tasks += 1
+        self.resources.submit(resource, label, lambda: self._start_task(label, func, resource))
+
+    def _start_task(self, label: str, func: Callable[[], None], resource: Optional[str]):
+        with self._lock:
+            self._queued_tasks -= 1
+        threading.Thread(
+            target=self._run_task, args=(label, func, resource), daemon=True, name=f"PipelineTask-{label}"
+        ).start()
+
+    def _run_task(self, label: str, func: Callable[[], None], resource: Optional[str]):
+        try:
+            func()
+        except Exception as e:
+            self.log(f"Pipeline-Task {label} fehlgeschlagen: {e}")
+        finally:
+            self.resources.release(resource, label)
+
+    # --- Status --------------------------------------------------------------------
+
+    def status(self) -> dict:
+        with self._lock:
+            projects = {
+                Path(project).name: {stage: info["state"] for stage, info in stages.items()}
+                for project, stages in self._projects.items()
+            }
+        return {
+            "resources": self.resources.status(),
+            "stages": {
+                name: {
+                    "resource": stage.resource,
+                    "upstream": list(stage.upstream),
+                    "auto": stage_enabled(self.config, name),
+                }
+                for name, stage in STAGE_TYPES.items()
+            },
+            "projects": projects,
+            "queued_tasks": self._queued_tasks,
+        }
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
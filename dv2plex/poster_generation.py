@@ -20,6 +20,8 @@ from PIL import Image, ImageDraw, ImageFont
 from sklearn.cluster import KMeans
 from rembg import remove
 
+from .ffmpeg_runner import run_ffmpeg
+
 try:
     from playwright.sync_api import sync_playwright
     PLAYWRIGHT_AVAILABLE = True
@@ -38,7 +40,7 @@ logger = logging.getLogger(__name__)
 # ffmpeg helpers
 # ----------------------------
 def run(cmd: list[str]) -> None:
-    p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+    p = run_ffmpeg(cmd)
     if p.returncode != 0:
         raise RuntimeError(f"Command failed:\n{' '.join(cmd)}\n\n{p.stderr}")
 
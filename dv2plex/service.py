@@ -18,10 +18,40 @@ from .config import Config
 from .capture import CaptureEngine
 from .merge import MergeEngine
 from .upscale import UpscaleEngine
+from .chunked_upscale import DEFAULT_CHUNK_SECONDS, ChunkedUpscaler
+from .crop_detect import CropDetector
+from .dead_segments import (
+    DEFAULT_MIN_DEAD_SECONDS,
+    MODE_OFF,
+    MODE_PASSTHROUGH,
+    MODE_TRIM,
+    VideoAnalyzer,
+    describe_segments,
+    write_live_ranges,
+)
+from .ffmpeg_runner import percent_callback
+from .upscale_autoselect import AutoProfileSelector
+from .upscale_preview import DEFAULT_CLIP_COUNT, DEFAULT_CLIP_SECONDS, PREVIEW_DIR_NAME, UpscalePreview
+from .upscale_worker import DEFAULT_IDLE_TIMEOUT, shared_upscale_worker
 from .plex_export import PlexExporter
 from .frame_extraction import FrameExtractionEngine
 from .cover_generation import CoverGenerationEngine
 from .poster_generation import PosterGenerationEngine
+from .job_store import open_job_store, KIND_MERGE, KIND_POSTER, KIND_POSTPROCESS, MAX_ATTEMPTS, OPEN_STATUSES
+from .pipeline import (
+    RESOURCE_IO,
+    RESOURCE_MODEL,
+    STAGE_EXPORT,
+    STAGE_MERGE,
+    STAGE_POSTER,
+    STAGE_UPSCALE,
+    STATE_COMPLETED,
+    STATE_FAILED,
+    STATE_RUNNING,
+    project_dir_of,
+    shared_resources,
+    stage_enabled,
+)
 
 
 logger = logging.getLogger(__name__)
@@ -164,9 +194,14 @@ class PostprocessingService:
         self.log_callback = log_callback or (lambda msg: logger.info(msg))
         self._running = False
         self._stop_event = Event()
+        # Queue enthält Job-IDs; Parameter und Checkpoints liegen im Job-Speicher
         self._queue: Queue = Queue()
+        self._callbacks: dict = {}
         self._worker_thread: Optional[Thread] = None
         self._worker_stop = Event()
+        self.job_store = open_job_store(config.config_dir)
+        # Pipeline: Meldung von Start/Ende der Stufen "upscale" und "export"
+        self.stage_callback: Optional[Callable[[Path, str, str, dict], None]] = None
     
     def _log(self, message: str):
         """Log-Nachricht ausgeben"""
@@ -193,15 +228,47 @@ class PostprocessingService:
         progress_callback: Optional[Callable[[int], None]] = None,
         status_callback: Optional[Callable[[str], None]] = None,
         finished_callback: Optional[Callable[[bool, str], None]] = None,
-    ):
-        self._queue.put({
-            "movie_dir": movie_dir,
-            "profile_name": profile_name,
+    ) -> str:
+        job_id = self.job_store.add(
+            KIND_POSTPROCESS, {"movie_dir": str(movie_dir), "profile_name": profile_name}
+        )
+        self._callbacks[job_id] = {
             "progress_callback": progress_callback,
             "status_callback": status_callback,
             "finished_callback": finished_callback,
-        })
+        }
+        self._queue.put(job_id)
         self._start_worker()
+        return job_id
+
+    def resume_jobs(
+        self,
+        progress_callback: Optional[Callable[[int], None]] = None,
+        status_callback: Optional[Callable[[str], None]] = None,
+        finished_callback: Optional[Callable[[bool, str], None]] = None,
+    ) -> int:
+        """Reiht nach einem Neustart die offenen Postprocessing-Jobs aus dem Job-Speicher wieder ein"""
+        jobs = self.job_store.recover(KIND_POSTPROCESS)
+        for record in jobs:
+            self._callbacks[record["id"]] = {
+                "progress_callback": progress_callback,
+                "status_callback": status_callback,
+                "finished_callback": finished_callback,
+            }
+            self._queue.put(record["id"])
+            self._log(f"Postprocessing-Job nach Neustart wieder eingereiht: {Path(record['params']['movie_dir']).name}")
+        if jobs:
+            self._start_worker()
+        return len(jobs)
+
+    def get_queue_status(self, limit: int = 20) -> dict:
+        """Offene und zuletzt abgeschlossene Postprocessing-Jobs (aus dem Job-Speicher)"""
+        jobs = self.job_store.list(KIND_POSTPROCESS, limit=limit)
+        return {
+            "running": self._running,
+            "pending_count": sum(1 for j in jobs if j["status"] in OPEN_STATUSES),
+            "jobs": jobs,
+        }
 
     def _start_worker(self):
         if self._worker_thread and self._worker_thread.is_alive():
@@ -213,23 +280,40 @@ class PostprocessingService:
     def _worker_loop(self):
         while not self._worker_stop.is_set():
             try:
-                job = self._queue.get(timeout=1)
+                job_id = self._queue.get(timeout=1)
             except Empty:
                 continue
 
-            self._running = True
-            movie_dir = job["movie_dir"]
-            profile_name = job["profile_name"]
-            progress_callback = job.get("progress_callback")
-            status_callback = job.get("status_callback")
-            finished_callback = job.get("finished_callback")
+            record = self.job_store.get(job_id)
+            callbacks = self._callbacks.pop(job_id, {})
+            if not record:
+                self._queue.task_done()
+                continue
 
+            self._running = True
+            movie_dir = Path(record["params"]["movie_dir"])
+            profile_name = record["params"]["profile_name"]
+            status_callback = callbacks.get("status_callback")
+            finished_callback = callbacks.get("finished_callback")
+
+            def progress_callback(pct: int, _job_id=job_id, _callback=callbacks.get("progress_callback")):
+                self.job_store.update(_job_id, progress=pct)
+                if _callback:
+                    _callback(pct)
+
+            success, message = False, "Abgebrochen"
+            self._report_stage(movie_dir, STAGE_UPSCALE, STATE_RUNNING)
             try:
+                attempt = self.job_store.start(job_id)
+                if attempt > 1:
+                    self._log(f"Postprocessing fortgesetzt (Versuch {attempt}/{MAX_ATTEMPTS}): {movie_dir.name}")
                 success, message = self._process_movie_now(
                     movie_dir,
                     profile_name,
                     progress_callback,
                     status_callback,
+                    job_id=job_id,
+                    checkpoints=record["checkpoints"],
                 )
                 # ntfy Notify
                 self._notify_ntfy(f"Upscaling {'erfolgreich' if success else 'fehlgeschlagen'}: {message}")
@@ -240,18 +324,40 @@ class PostprocessingService:
                         logger.exception("Fehler im finished_callback")
             except Exception as e:
                 logger.exception("Fehler im Postprocessing-Worker")
+                message = f"Fehler: {e}"
                 self._notify_ntfy(f"Upscaling fehlgeschlagen: {e}")
             finally:
+                self.job_store.finish(job_id, success, message)
                 self._running = False
                 self._queue.task_done()
+                self._report_stage(
+                    movie_dir,
+                    STAGE_UPSCALE,
+                    STATE_COMPLETED if success else STATE_FAILED,
+                    {"path": str(movie_dir / "HighRes" / f"{movie_dir.name}_4k.mp4")} if success else {},
+                )
 
     def _process_movie_now(
         self,
         movie_dir: Path,
         profile_name: str,
         progress_callback: Optional[Callable[[int], None]] = None,
-        status_callback: Optional[Callable[[str], None]] = None
+        status_callback: Optional[Callable[[str], None]] = None,
+        job_id: Optional[str] = None,
+        checkpoints: Optional[dict] = None,
     ) -> Tuple[bool, str]:
+        """
+        Upscale eines Films (Pipeline-Stufe "upscale", nutzt das Modell-Budget).
+        
+        Mit job_id wird die abgeschlossene Stufe ("upscaled") im Job-Speicher festgehalten;
+        checkpoints aus einem unterbrochenen Lauf überspringen sie.
+        """
+        checkpoints = checkpoints or {}
+
+        def checkpoint(stage: str, data: dict):
+            if job_id:
+                self.job_store.checkpoint(job_id, stage, data)
+
         title, year = parse_movie_folder_name(movie_dir.name)
         movie_name = movie_dir.name
         title = title or movie_name
@@ -275,60 +381,145 @@ class PostprocessingService:
 
         # Timestamp-Overlay wird übersprungen (bereits im LowRes enthalten)
         self._log("Überspringe Timestamp-Overlay (bereits im LowRes enthalten).")
+
+        highres_dir = movie_dir / "HighRes"
+        highres_dir.mkdir(parents=True, exist_ok=True)
+        output_file = highres_dir / f"{movie_name}_4k.mp4"
+
+        # Bluescreen/Schwarzbild/Rauschen (z.B. nach der letzten Aufnahme) nicht in 4K rechnen
+        upscale_input, passthrough_ranges = merged_file, None
+        trimmed = (checkpoints.get("upscaled") or {}).get("trimmed", "")
+        live_file = highres_dir / f".{movie_name}_live.mkv"
+        dead_mode = self.config.get("upscaling.dead_segments", MODE_PASSTHROUGH)
+        if dead_mode != MODE_OFF and not (checkpoints.get("upscaled") and output_file.exists()):
+            upscale_input, passthrough_ranges, trimmed = self._handle_dead_segments(
+                merged_file, live_file, dead_mode, display_name, progress_callback, status_callback
+            )
+        # Sichtbarer Bildbereich (schwarze Ränder, Kopfumschaltung) und Seitenverhältnis, pro Projekt gespeichert
+        crop = None
+        if not (checkpoints.get("upscaled") and output_file.exists()):
+            if status_callback:
+                status_callback(f"Postprocessing: {display_name} – Bildausschnitt")
+            crop = CropDetector(self.config.get_ffmpeg_path(), log_callback=self._log).load_or_detect(
+                merged_file, movie_dir / "crop.json", detect=self.config.get("upscaling.crop_detect", True)
+            )
         if progress_callback:
             progress_callback(25)
 
         # Upscale
         self._log("=== Starte Upscaling ===")
-        highres_dir = movie_dir / "HighRes"
-        highres_dir.mkdir(parents=True, exist_ok=True)
-
         profile = self.config.get_upscaling_profile(profile_name)
-        output_file = highres_dir / f"{movie_name}_4k.mp4"
 
-        upscale_engine = UpscaleEngine(
-            self.config.get_realesrgan_path(),
-            ffmpeg_path=self.config.get_ffmpeg_path(),
-            log_callback=self._log
-        )
+        upscale_engine = self._create_upscale_engine()
 
         def ffmpeg_progress_hook(pct: int):
             if progress_callback:
                 mapped = 25 + int(0.65 * pct)
                 progress_callback(min(90, max(25, mapped)))
 
-        if upscale_engine.upscale(merged_file, output_file, profile, progress_hook=ffmpeg_progress_hook):
-            if progress_callback:
-                progress_callback(95)
-
-            # Export
-            auto_export = self.config.get("capture.auto_export", False)
-            if auto_export:
-                self._log("=== Starte Plex-Export ===")
-                plex_exporter = PlexExporter(
-                    self.config.get_plex_movies_root(),
-                    log_callback=self._log
-                )
-
-                result = plex_exporter.export_movie(
-                    output_file,
-                    title,
-                    year or ""
-                )
+        def ffmpeg_status_hook(text: str):
+            if status_callback:
+                status_callback(f"Postprocessing: {display_name} – Upscale {text}")
 
-                if result:
-                    if progress_callback:
-                        progress_callback(100)
-                    return True, f"{display_name} exportiert: {result}"
-                else:
-                    return True, f"{display_name} verarbeitet (Export fehlgeschlagen)"
-            else:
-                if progress_callback:
-                    progress_callback(100)
-                return True, f"{display_name} verarbeitet: {output_file}"
+        if checkpoints.get("upscaled") and output_file.exists():
+            self._log(f"Upscale bereits abgeschlossen (Checkpoint), überspringe: {output_file.name}")
+            upscaled = True
+        else:
+            if status_callback:
+                status_callback(f"Postprocessing: {display_name} (wartet auf Modell-Slot)")
+            upscaled = False
+            try:
+                with shared_resources().acquire(RESOURCE_MODEL, f"Upscale {display_name}"):
+                    chosen = checkpoints.get("auto_profile", {}).get("profile")
+                    if profile.get("backend") == "auto" and chosen in self.config.get("upscaling.profiles", {}):
+                        # Gleiche Wahl wie im abgebrochenen Lauf, sonst passen die fertigen Abschnitte nicht
+                        profile_name, profile = chosen, self.config.get_upscaling_profile(chosen)
+                        self._log(f"Auto-Profil aus früherem Lauf: {profile_name}")
+                    elif profile.get("backend") == "auto":
+                        # Probelauf auf dem Band: bestes Profil, das ins Zeitbudget passt
+                        selector = AutoProfileSelector(upscale_engine, self.config.get_ffmpeg_path(), log_callback=self._log)
+                        profile_name, profile = selector.select(
+                            upscale_input,
+                            profile,
+                            self.config.get("upscaling.profiles", {}),
+                            status_hook=ffmpeg_status_hook,
+                            crop=crop,
+                        )
+                        if profile_name is None:
+                            return False, f"Auto-Profil ohne gültige Kandidaten für {display_name}"
+                        self._log(f"Auto-Profil gewählt: {profile_name}")
+                        checkpoint("auto_profile", {"profile": profile_name})
+                    if status_callback:
+                        status_callback(f"Postprocessing: {display_name}")
+                    chunk_seconds = self.config.get("upscaling.chunk_seconds", DEFAULT_CHUNK_SECONDS)
+                    if chunk_seconds > 0:
+                        # Abschnittsweise: ein Neustart macht beim ersten unfertigen Abschnitt weiter
+                        upscaler = ChunkedUpscaler(
+                            upscale_engine,
+                            self.config.get_ffmpeg_path(),
+                            highres_dir / f".{movie_name}_chunks",
+                            log_callback=self._log,
+                            chunk_seconds=chunk_seconds,
+                        )
+                    else:
+                        upscaler = upscale_engine
+                    upscaled = upscaler.upscale(
+                        upscale_input,
+                        output_file,
+                        profile,
+                        progress_hook=ffmpeg_progress_hook,
+                        status_hook=ffmpeg_status_hook,
+                        passthrough_ranges=passthrough_ranges,
+                        crop=crop,
+                    )
+            finally:
+                # Bei Fehlern bleibt die Eingabe für die fertigen Abschnitte erhalten
+                if upscaled:
+                    live_file.unlink(missing_ok=True)
+            if upscaled:
+                checkpoint("upscaled", {"path": str(output_file), "profile": profile_name, "trimmed": trimmed})
+
+        if upscaled:
+            # Export nach Plex ist eine eigene Pipeline-Stufe (capture.auto_export)
+            if progress_callback:
+                progress_callback(100)
+            if trimmed:
+                return True, f"{display_name} verarbeitet: {output_file} (herausgeschnitten: {trimmed})"
+            return True, f"{display_name} verarbeitet: {output_file}"
         else:
             return False, f"Upscaling fehlgeschlagen für {display_name}"
 
+    def export_movie(self, movie_dir: Path) -> Tuple[bool, str]:
+        """Exportiert den fertigen 4K-Film nach Plex (Pipeline-Stufe "export", nutzt das I/O-Budget)"""
+        title, year = parse_movie_folder_name(movie_dir.name)
+        title = title or movie_dir.name
+        display_name = f"{title} ({year})" if year else movie_dir.name
+        output_file = movie_dir / "HighRes" / f"{movie_dir.name}_4k.mp4"
+        if not output_file.exists():
+            return False, f"Kein 4K-Film für {display_name}: {output_file}"
+
+        self._report_stage(movie_dir, STAGE_EXPORT, STATE_RUNNING)
+        self._log(f"=== Starte Plex-Export: {display_name} ===")
+        with shared_resources().acquire(RESOURCE_IO, f"Export {display_name}"):
+            plex_exporter = PlexExporter(
+                self.config.get_plex_movies_root(),
+                log_callback=self._log
+            )
+            result = plex_exporter.export_movie(output_file, title, year or "")
+
+        if result:
+            self._report_stage(movie_dir, STAGE_EXPORT, STATE_COMPLETED, {"path": str(result)})
+            return True, f"{display_name} exportiert: {result}"
+        self._report_stage(movie_dir, STAGE_EXPORT, STATE_FAILED)
+        return False, f"Export fehlgeschlagen für {display_name}"
+
+    def _report_stage(self, movie_dir: Path, stage: str, state: str, result: Optional[dict] = None):
+        if self.stage_callback:
+            try:
+                self.stage_callback(movie_dir, stage, state, result or {})
+            except Exception:
+                logger.exception("Fehler im Pipeline-Callback")
+
     def _notify_ntfy(self, message: str):
         """Sendet eine ntfy-Benachrichtigung für Upscaling-Events."""
         try:
@@ -342,6 +533,147 @@ class PostprocessingService:
         except Exception as e:
             self._log(f"ntfy-Benachrichtigung fehlgeschlagen: {e}")
 
+    def _create_upscale_engine(self) -> UpscaleEngine:
+        realesrgan_path = self.config.get_realesrgan_path()
+        worker = None
+        if self.config.get("upscaling.warm_worker", True):
+            # Modelle bleiben zwischen Jobs im Worker-Prozess geladen
+            worker = shared_upscale_worker(
+                realesrgan_path,
+                idle_timeout=self.config.get("upscaling.worker_idle_timeout", DEFAULT_IDLE_TIMEOUT),
+                log_callback=self._log,
+            )
+        return UpscaleEngine(
+            realesrgan_path,
+            ffmpeg_path=self.config.get_ffmpeg_path(),
+            log_callback=self._log,
+            worker=worker,
+            device=self.config.get("upscaling.device", "auto"),
+            cpu_processes=self.config.get("upscaling.cpu_processes", 0),
+            cpu_threads=self.config.get("upscaling.cpu_threads", 2),
+        )
+
+    def preview_profiles(
+        self,
+        movie_dir: Path,
+        profile_names: List[str],
+        count: int = DEFAULT_CLIP_COUNT,
+        clip_seconds: float = DEFAULT_CLIP_SECONDS,
+        progress_callback: Optional[Callable[[int], None]] = None,
+        status_callback: Optional[Callable[[str], None]] = None,
+    ) -> Tuple[bool, Optional[dict], str]:
+        """
+        Vergleicht Profile auf kurzen Clips des LowRes-Films (Aufrufer hält den Modell-Slot)
+
+        Returns:
+            (success, Ergebnis von UpscalePreview.run, Meldung)
+        """
+        merged_file = self._find_existing_merge(movie_dir / "LowRes")
+        if not merged_file:
+            return False, None, f"Kein movie_merged in {movie_dir / 'LowRes'}"
+        all_profiles = self.config.get("upscaling.profiles", {})
+        # "auto" hat kein eigenes Modell, seine Kandidaten lassen sich einzeln vergleichen
+        profiles = {
+            name: all_profiles[name] for name in profile_names
+            if name in all_profiles and all_profiles[name].get("backend") != "auto"
+        }
+        if not profiles:
+            return False, None, "Keine vergleichbaren Profile gewählt"
+
+        ffmpeg_path = self.config.get_ffmpeg_path()
+        # Gleiche Analyse und gleicher Ausschnitt wie beim echten Upscale (beides gecacht)
+        analysis = VideoAnalyzer(
+            ffmpeg_path,
+            log_callback=self._log,
+            min_dead_seconds=self.config.get("upscaling.dead_segment_min_seconds", DEFAULT_MIN_DEAD_SECONDS),
+        ).analyze(merged_file)
+        crop = CropDetector(ffmpeg_path, log_callback=self._log).load_or_detect(
+            merged_file, movie_dir / "crop.json", detect=self.config.get("upscaling.crop_detect", True)
+        )
+        upscale_seconds = None
+        if analysis and self.config.get("upscaling.dead_segments", MODE_PASSTHROUGH) != MODE_OFF:
+            # Tote Abschnitte gehen in beiden Modi nicht durchs Modell
+            upscale_seconds = analysis.duration - analysis.dead_seconds
+
+        preview = UpscalePreview(
+            self._create_upscale_engine(),
+            ffmpeg_path,
+            movie_dir / "HighRes" / PREVIEW_DIR_NAME,
+            log_callback=self._log,
+        )
+        try:
+            result = preview.run(
+                merged_file,
+                profiles,
+                analysis=analysis,
+                crop=crop,
+                count=count,
+                clip_seconds=clip_seconds,
+                upscale_seconds=upscale_seconds,
+                progress_callback=progress_callback,
+                status_callback=status_callback,
+            )
+        except Exception as e:
+            logger.exception("Fehler bei der Profil-Vorschau")
+            return False, None, f"Vorschau fehlgeschlagen: {e}"
+        return True, result, f"Vorschau für {len(profiles)} Profile fertig"
+
+    def _handle_dead_segments(
+        self,
+        merged_file: Path,
+        live_file: Path,
+        mode: str,
+        display_name: str,
+        progress_callback: Optional[Callable[[int], None]],
+        status_callback: Optional[Callable[[str], None]],
+    ) -> Tuple[Path, Optional[List[Tuple[float, float]]], str]:
+        """
+        Analysiert den LowRes-Film auf tote Abschnitte
+
+        Returns:
+            (Upscale-Eingabe, Passthrough-Bereiche, Beschreibung des Herausgeschnittenen):
+            bei "passthrough" der Originalfilm und die nur per Lanczos zu skalierenden Bereiche;
+            bei "trim" zusätzlich eine Kopie ohne die toten Abschnitte am Anfang und Ende
+            (nur dort ist sicher, dass keine stille dunkle Einstellung verloren geht)
+        """
+        def on_progress(pct: int, text: str):
+            if progress_callback:
+                progress_callback(15 + pct * 10 // 100)
+            if status_callback:
+                status_callback(f"Postprocessing: {display_name} – Analyse {text}")
+
+        analyzer = VideoAnalyzer(
+            self.config.get_ffmpeg_path(),
+            log_callback=self._log,
+            min_dead_seconds=self.config.get("upscaling.dead_segment_min_seconds", DEFAULT_MIN_DEAD_SECONDS),
+        )
+        analysis = analyzer.analyze(merged_file, progress_callback=percent_callback(on_progress, 0, 50 if mode == MODE_TRIM else 100))
+        if analysis is None or not analysis.dead_segments:
+            return merged_file, None, ""
+        self._log(
+            f"{len(analysis.dead_segments)} tote Abschnitte, {analysis.dead_seconds:.0f} s von {analysis.duration:.0f} s: "
+            + describe_segments(analysis.dead_segments)
+        )
+        all_ranges = [(segment.start, segment.end) for segment in analysis.dead_segments]
+        edges = analysis.edge_segments() if mode == MODE_TRIM else []
+        if not edges:
+            return merged_file, all_ranges, ""
+
+        trimmed = describe_segments(edges)
+        inner_ranges = analysis.inner_ranges_after_trim() or None
+        if live_file.exists():
+            # Von einem abgebrochenen Lauf (wird atomar geschrieben, ist also vollständig)
+            self._log(f"Verwende vorhandene Upscale-Eingabe ohne tote Abschnitte am Rand: {live_file.name}")
+            return live_file, inner_ranges, trimmed
+        self._log(f"Schneide tote Abschnitte am Anfang/Ende heraus ({trimmed}): {live_file.name}")
+        if write_live_ranges(
+            merged_file, live_file, analysis, self.config.get_ffmpeg_path(), percent_callback(on_progress, 50, 100)
+        ):
+            return live_file, inner_ranges, trimmed
+        self._log("Schneiden fehlgeschlagen, skaliere den ganzen Film (tote Abschnitte nur per Lanczos)")
+        live_file.unlink(missing_ok=True)
+        return merged_file, all_ranges, ""
+
     def _find_existing_merge(self, lowres_dir: Path) -> Optional[Path]:
         """Sucht nach vorhandenen movie_merged-Dateien im LowRes-Ordner."""
         if not lowres_dir.exists():
@@ -380,10 +712,44 @@ class CaptureService:
         self.state_callback = state_callback
         self.capture_engine: Optional[CaptureEngine] = None
         self._capture_running = False
+        self.job_store = open_job_store(config.config_dir)
+        # Pipeline: Meldung der Stufen "capture" und "merge"
+        self.stage_callback: Optional[Callable[[Path, str, str, dict], None]] = None
     
     def _log(self, message: str):
         """Log-Nachricht ausgeben"""
         self.log_callback(message)
+
+    def _ensure_capture_engine(self) -> CaptureEngine:
+        """Erstellt die Capture-Engine (mit Merge-Scheduler und Job-Speicher) bei Bedarf"""
+        if not self.capture_engine:
+            self.capture_engine = CaptureEngine(
+                self.config.get_ffmpeg_path(),
+                device_path=self.config.get_firewire_device(),
+                log_callback=self._log,
+                state_callback=self._on_capture_state,
+                job_store=self.job_store,
+            )
+            # Setze Merge-Progress-Callback
+            if self.merge_progress_callback:
+                self.capture_engine.merge_progress_callback = self.merge_progress_callback
+        self.capture_engine.stage_callback = self.stage_callback
+        self.capture_engine.auto_merge = stage_enabled(self.config, STAGE_MERGE)
+        self.capture_engine.configure_merge_scheduler(
+            max_jobs=self.config.get("capture.merge_concurrency", 2),
+            capture_policy=self.config.get("capture.merge_capture_policy", "nice"),
+            capture_jobs=self.config.get("capture.merge_capture_jobs", 1),
+        )
+        return self.capture_engine
+
+    def resume_jobs(self) -> int:
+        """Setzt nach einem Neustart offene Merge-Jobs aus dem Job-Speicher fort"""
+        if not self.job_store.list(KIND_MERGE, statuses=OPEN_STATUSES, limit=1):
+            return 0
+        resumed = self._ensure_capture_engine().resume_merge_jobs()
+        if resumed:
+            self._log(f"{resumed} Merge-Job(s) nach Neustart fortgesetzt")
+        return resumed
     
     def get_device(self) -> Optional[str]:
         """Ermittelt das verfügbare FireWire-Gerät"""
@@ -482,19 +848,9 @@ class CaptureService:
             part_number = 1
         
         # Create or reuse capture engine (wichtig, um Rewind-Sperre zu behalten)
-        if not self.capture_engine:
-            self.capture_engine = CaptureEngine(
-                ffmpeg_path,
-                device_path=self.config.get_firewire_device(),
-                log_callback=self._log,
-                state_callback=self._on_capture_state,
-            )
-            # Setze Merge-Progress-Callback
-            if self.merge_progress_callback:
-                self.capture_engine.merge_progress_callback = self.merge_progress_callback
-        else:
-            # Update evtl. Gerätpfad falls geändert
-            self.capture_engine.device_path = self.config.get_firewire_device()
+        self._ensure_capture_engine()
+        # Update evtl. Gerätpfad falls geändert
+        self.capture_engine.device_path = self.config.get_firewire_device()
 
         # Blockiere Start, falls Auto-Rewind noch läuft
         if self.capture_engine.is_rewind_block_active():
@@ -511,6 +867,15 @@ class CaptureService:
             auto_rewind_play=auto_rewind_play,
             title=title,
             year=year,
+            capture_mode=self.config.get("capture.capture_mode", "autosplit"),
+            merge_mode=self.config.get("capture.merge_mode", "batch"),
+            timestamp_mode=(
+                self.config.get("capture.timestamp_overlay_mode", "burn")
+                if self.config.get("capture.timestamp_overlay", True)
+                else "off"
+            ),
+            timestamp_duration=self.config.get("capture.timestamp_duration", 4),
+            merge_workers=self.config.get("capture.merge_workers", 0),
         )
         
         if capture_started:
@@ -543,21 +908,12 @@ class CaptureService:
         if not engine:
             return False
 
-        # Aktiver Job
-        current_job = getattr(engine, "current_merge_job", None)
-        if current_job and current_job.status in ("running", "pending"):
+        # Laufende oder wartende Jobs im Merge-Scheduler
+        if engine.has_active_merge():
             return True
 
-        # Jobs in Liste oder Queue
         jobs = getattr(engine, "merge_jobs", [])
-        if any(j.status in ("running", "pending") for j in jobs):
-            return True
-
-        queue = getattr(engine, "merge_queue", None)
-        if queue and hasattr(queue, "empty") and not queue.empty():
-            return True
-
-        return False
+        return any(j.status in ("running", "pending") for j in jobs)
 
     def _on_capture_state(self, state: str):
         """Callback aus CaptureEngine (z.B. stopped)"""
@@ -600,11 +956,15 @@ class MovieModeService:
         self,
         video_paths: List[Path],
         title: str,
-        year: str
+        year: str,
+        progress_callback: Optional[Callable[[int, str], None]] = None,
     ) -> Tuple[bool, Optional[Path], Optional[str]]:
         """
         Merged mehrere Videos zu einem Film
         
+        Args:
+            progress_callback: Optionaler Callback (Prozent, Beschreibung) während des Encodes
+        
         Returns:
             (success, merged_file_path, error_message)
         """
@@ -623,7 +983,8 @@ class MovieModeService:
             # Merge
             merge_engine = MergeEngine(
                 self.config.get_ffmpeg_path(),
-                log_callback=self._log
+                log_callback=self._log,
+                progress_callback=progress_callback,
             )
             
             self._log(f"=== Starte Merge: {len(video_paths)} Videos ===")
@@ -686,13 +1047,25 @@ class CoverService:
         self.log_callback = log_callback or (lambda msg: logger.info(msg))
         self._running = False
         self._stop_event = Event()
+        # Queue enthält Job-IDs; Parameter liegen im Job-Speicher
         self._queue: Queue = Queue()
+        self._callbacks: dict = {}
         self._worker_thread: Optional[Thread] = None
         self._worker_stop = Event()
+        self.job_store = open_job_store(config.config_dir)
+        # Pipeline: Meldung von Start/Ende der Stufe "poster"
+        self.stage_callback: Optional[Callable[[Path, str, str, dict], None]] = None
     
     def _log(self, message: str):
         """Log-Nachricht ausgeben"""
         self.log_callback(message)
+
+    def _report_stage(self, video_path: Path, state: str, result: Optional[dict] = None):
+        if self.stage_callback:
+            try:
+                self.stage_callback(project_dir_of(video_path), STAGE_POSTER, state, result or {})
+            except Exception:
+                logger.exception("Fehler im Pipeline-Callback")
     
     def extract_frames(
         self,
@@ -911,15 +1284,46 @@ class CoverService:
         """
         Fügt einen Poster-Generierungs-Job zur Queue hinzu
         """
-        self._queue.put({
-            "video_path": video_path,
-            "title": title,
-            "year": year,
+        job_id = self.job_store.add(
+            KIND_POSTER, {"video_path": str(video_path), "title": title, "year": year}
+        )
+        self._callbacks[job_id] = {
             "progress_callback": progress_callback,
             "status_callback": status_callback,
             "finished_callback": finished_callback,
-        })
+        }
+        self._queue.put(job_id)
         self._start_worker()
+        return job_id
+
+    def resume_jobs(
+        self,
+        progress_callback: Optional[Callable[[int], None]] = None,
+        status_callback: Optional[Callable[[str], None]] = None,
+        finished_callback: Optional[Callable[[bool, str, Optional[Path]], None]] = None,
+    ) -> int:
+        """Reiht nach einem Neustart die offenen Poster-Jobs aus dem Job-Speicher wieder ein"""
+        jobs = self.job_store.recover(KIND_POSTER)
+        for record in jobs:
+            self._callbacks[record["id"]] = {
+                "progress_callback": progress_callback,
+                "status_callback": status_callback,
+                "finished_callback": finished_callback,
+            }
+            self._queue.put(record["id"])
+        if jobs:
+            self._log(f"{len(jobs)} Poster-Job(s) nach Neustart wieder eingereiht")
+            self._start_worker()
+        return len(jobs)
+
+    def get_queue_status(self, limit: int = 20) -> dict:
+        """Offene und zuletzt abgeschlossene Poster-Jobs (aus dem Job-Speicher)"""
+        jobs = self.job_store.list(KIND_POSTER, limit=limit)
+        return {
+            "running": self._running,
+            "pending_count": sum(1 for j in jobs if j["status"] in OPEN_STATUSES),
+            "jobs": jobs,
+        }
     
     def _start_worker(self):
         """Startet den Worker-Thread für die Queue"""
@@ -933,30 +1337,41 @@ class CoverService:
         """Worker-Loop für automatische Verarbeitung der Queue"""
         while not self._worker_stop.is_set():
             try:
-                job = self._queue.get(timeout=1)
+                job_id = self._queue.get(timeout=1)
             except Empty:
                 continue
 
-            self._running = True
-            video_path = job["video_path"]
-            title = job["title"]
-            year = job.get("year")
-            progress_callback = job.get("progress_callback")
-            status_callback = job.get("status_callback")
-            finished_callback = job.get("finished_callback")
+            record = self.job_store.get(job_id)
+            callbacks = self._callbacks.pop(job_id, {})
+            if not record:
+                self._queue.task_done()
+                continue
 
+            self._running = True
+            video_path = Path(record["params"]["video_path"])
+            title = record["params"]["title"]
+            year = record["params"].get("year")
+            progress_callback = callbacks.get("progress_callback")
+            status_callback = callbacks.get("status_callback")
+            finished_callback = callbacks.get("finished_callback")
+
+            success, message, poster_path = False, "Abgebrochen", None
             try:
+                self.job_store.start(job_id)
                 self._log(f"Starte Poster-Generierung für: {title} ({year}) - {video_path}")
                 logger.info(f"Starte Poster-Generierung für: {title} ({year}) - {video_path}")
                 
-                success, poster_path, error = self.generate_poster(
-                    video_path,
-                    title,
-                    year,
-                    progress_callback=progress_callback,
-                    status_callback=status_callback
-                )
+                self._report_stage(video_path, STATE_RUNNING)
+                with shared_resources().acquire(RESOURCE_MODEL, f"Poster {title}"):
+                    success, poster_path, error = self.generate_poster(
+                        video_path,
+                        title,
+                        year,
+                        progress_callback=progress_callback,
+                        status_callback=status_callback
+                    )
                 
+                message = error or "Poster erfolgreich generiert"
                 if success:
                     self._log(f"Poster erfolgreich generiert: {poster_path}")
                     logger.info(f"Poster erfolgreich generiert: {poster_path}")
@@ -971,6 +1386,7 @@ class CoverService:
                         logger.exception("Fehler im finished_callback")
             except Exception as e:
                 error_msg = f"Fehler im Poster-Worker: {e}"
+                message = f"Fehler: {e}"
                 self._log(error_msg)
                 logger.exception(error_msg)
                 if finished_callback:
@@ -979,8 +1395,14 @@ class CoverService:
                     except Exception:
                         pass
             finally:
+                self.job_store.finish(job_id, success, message, str(poster_path) if poster_path else None)
                 self._running = False
                 self._queue.task_done()
+                self._report_stage(
+                    video_path,
+                    STATE_COMPLETED if success else STATE_FAILED,
+                    {"path": str(poster_path)} if poster_path else {},
+                )
     
     def is_running(self) -> bool:
         """Prüft ob Poster-Generierung läuft"""
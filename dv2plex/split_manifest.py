@@ -0,0 +1,230 @@
+"""
+Split-Manifest: Metadaten aller Split-Dateien einer Aufnahme (LowRes/splits/splits.json)
+
+Jeder Split wird direkt nach dem Fertigschreiben einmal gelesen (dv_index, ohne ffprobe):
+Dauer, Frame-Anzahl, erster/letzter DV-Timecode, Aufnahmezeitpunkt, Größe und Prüfsumme.
+Die Reihenfolge der Aufnahme wird als laufende Nummer festgehalten. Der Merge liest nur noch
+das Manifest; fehlende oder veraltete Einträge (Größe geändert) werden beim Merge im Prozess
+nachgetragen, ohne Prüfsumme.
+"""
+
+import hashlib
+import json
+import os
+import threading
+from datetime import datetime
+from pathlib import Path
+from queue import Queue, Empty
+from typing import Callable, Dict, Iterable, List, Optional
+
+from .dv_index import FLAG_PAL, scan_dv_file
+
+
+MANIFEST_NAME = "splits.json"
+MANIFEST_VERSION = 1
+FPS_PAL = 25.0
+FPS_NTSC = 30000 / 1001
+CHECKSUM_CHUNK = 4 * 1024 * 1024
+
+
+def file_checksum(path: Path) -> str:
+    """BLAKE2b-128 über die komplette Datei"""
+    digest = hashlib.blake2b(digest_size=16)
+    buf = bytearray(CHECKSUM_CHUNK)
+    view = memoryview(buf)
+    with open(path, "rb", buffering=0) as f:
+        while True:
+            n = f.readinto(buf)
+            if not n:
+                break
+            digest.update(view[:n])
+    return f"blake2b:{digest.hexdigest()}"
+
+
+def describe_split(path: Path, checksum: bool = True) -> dict:
+    """Liest die Metadaten eines Splits in einem Durchlauf (mmap, kein Subprozess)"""
+    path = Path(path)
+    stat = path.stat()
+    index = scan_dv_file(path)
+    frames = len(index)
+    pal = bool(frames and index.flags[0] & FLAG_PAL)
+    first = index.frame_info(0) if frames else None
+    last = index.frame_info(frames - 1) if frames else None
+    recorded_at = index.first_recorded_at()
+    recorded_end = None
+    for i in range(frames - 1, -1, -1):
+        recorded_end = index.recorded_at(i)
+        if recorded_end:
+            break
+    return {
+        "size": stat.st_size,
+        "mtime": stat.st_mtime,
+        "frames": frames,
+        "pal": pal,
+        "duration": round(frames / (FPS_PAL if pal else FPS_NTSC), 3),
+        "first_timecode": first.timecode_str() if first else None,
+        "last_timecode": last.timecode_str() if last else None,
+        "recorded_at": recorded_at.isoformat() if recorded_at else None,
+        "recorded_end": recorded_end.isoformat() if recorded_end else None,
+        "checksum": file_checksum(path) if checksum else None,
+        "sequence": None,
+    }
+
+
+class SplitManifest:
+    """
+    Liest/schreibt splits.json und füllt es während der Aufnahme im Hintergrund.
+
+    Args:
+        splits_dir: LowRes/splits/
+    """
+
+    def __init__(self, splits_dir: Path, log_callback: Optional[Callable[[str], None]] = None):
+        self.splits_dir = Path(splits_dir)
+        self.log_callback = log_callback
+        self.entries: Dict[str, dict] = {}
+        self._lock = threading.Lock()
+        self._queue: Queue = Queue()
+        self._stop_event = threading.Event()
+        self._worker: Optional[threading.Thread] = None
+        self._next_sequence = 0
+        self._load()
+
+    @property
+    def path(self) -> Path:
+        return self.splits_dir / MANIFEST_NAME
+
+    def _load(self):
+        if not self.path.exists():
+            return
+        try:
+            data = json.loads(self.path.read_text(encoding="utf-8"))
+        except Exception as e:
+            self.log(f"Split-Manifest unlesbar, wird neu erstellt ({e})")
+            return
+        if data.get("version") != MANIFEST_VERSION:
+            return
+        self.entries = dict(data.get("splits", {}))
+        sequences = [e["sequence"] for e in self.entries.values() if e.get("sequence") is not None]
+        self._next_sequence = max(sequences) + 1 if sequences else 0
+
+    def save(self):
+        with self._lock:
+            data = {"version": MANIFEST_VERSION, "splits": self.entries}
+            tmp = self.path.with_suffix(".json.tmp")
+            tmp.write_text(json.dumps(data, indent=2), encoding="utf-8")
+            os.replace(tmp, self.path)
+
+    def entry(self, split: Path) -> Optional[dict]:
+        """Eintrag eines Splits oder None, falls unbekannt bzw. Datei seitdem geändert"""
+        split = Path(split)
+        with self._lock:
+            entry = self.entries.get(split.name)
+        if not entry:
+            return None
+        try:
+            if split.stat().st_size != entry.get("size"):
+                return None
+        except OSError:
+            return None
+        return entry
+
+    def record(self, split: Path, checksum: bool = True, sequence: Optional[int] = None) -> Optional[dict]:
+        """Liest einen Split ein und speichert den Eintrag (ohne save())."""
+        split = Path(split)
+        try:
+            entry = describe_split(split, checksum=checksum)
+        except Exception as e:
+            self.log(f"Split-Manifest: {split.name} konnte nicht gelesen werden: {e}")
+            return None
+        entry["sequence"] = sequence
+        with self._lock:
+            self.entries[split.name] = entry
+        return entry
+
+    # --- Aufnahme: Hintergrund-Worker ---------------------------------------------
+
+    def start(self):
+        if self._worker and self._worker.is_alive():
+            return
+        self._stop_event.clear()
+        self._worker = threading.Thread(target=self._worker_loop, daemon=True, name="SplitManifest")
+        self._worker.start()
+
+    def add_split(self, split: Path):
+        """Meldet einen fertig geschriebenen Split an (Reihenfolge = Aufnahme-Reihenfolge)."""
+        with self._lock:
+            sequence = self._next_sequence
+            self._next_sequence += 1
+        self._queue.put((Path(split), sequence))
+
+    def stop(self, wait: bool = True):
+        """Beendet den Worker; mit wait=True werden angemeldete Splits noch eingetragen."""
+        if wait and self._worker and self._worker.is_alive():
+            self._queue.join()
+        self._stop_event.set()
+        if self._worker and self._worker.is_alive():
+            self._worker.join(timeout=1)
+
+    def _worker_loop(self):
+        while not self._stop_event.is_set():
+            try:
+                split, sequence = self._queue.get(timeout=0.5)
+            except Empty:
+                continue
+            try:
+                if self.record(split, checksum=True, sequence=sequence):
+                    self.save()
+            except Exception as e:
+                self.log(f"Split-Manifest: Fehler bei {split.name}: {e}")
+            finally:
+                self._queue.task_done()
+
+    # --- Merge -------------------------------------------------------------------
+
+    def ensure(self, splits: Iterable[Path]) -> Dict[str, dict]:
+        """Trägt fehlende/veraltete Splits nach (ohne Prüfsumme) und liefert alle Einträge."""
+        changed = False
+        result: Dict[str, dict] = {}
+        for split in splits:
+            entry = self.entry(split)
+            if entry is None:
+                entry = self.record(split, checksum=False)
+                changed = changed or entry is not None
+            if entry is not None:
+                result[Path(split).name] = entry
+        if changed:
+            self.save()
+        return result
+
+    def ordered(self, splits: Iterable[Path]) -> List[Path]:
+        """
+        Sortiert Splits in Aufnahme-Reihenfolge: laufende Nummer, falls alle Splits während
+        der Aufnahme erfasst wurden, sonst DV-Aufnahmezeitpunkt bzw. mtime.
+        """
+        splits = list(splits)
+        entries = self.ensure(splits)
+
+        def time_key(split: Path):
+            entry = entries.get(split.name, {})
+            recorded_at = recorded_at_of(entry)
+            return (recorded_at.timestamp() if recorded_at else entry.get("mtime", 0.0), split.name)
+
+        if splits and all(entries.get(s.name, {}).get("sequence") is not None for s in splits):
+            return sorted(splits, key=lambda s: (entries[s.name]["sequence"], s.name))
+        return sorted(splits, key=time_key)
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
+
+
+def recorded_at_of(entry: Optional[dict]) -> Optional[datetime]:
+    """Aufnahmezeitpunkt (naiv, Kamerazeit) eines Manifest-Eintrags"""
+    value = (entry or {}).get("recorded_at")
+    if not value:
+        return None
+    try:
+        return datetime.fromisoformat(value)
+    except ValueError:
+        return None
@@ -0,0 +1,407 @@
+"""
+Split-Watcher für den splits-Ordner während einer Aufnahme
+
+Überwacht LowRes/splits/ ereignisbasiert über inotify (Linux) und verteilt
+die Ereignisse an beliebig viele Abonnenten (Preview-Queue, Inaktivitäts-
+monitor, Stop-Logik). Wo inotify nicht verfügbar ist, wird auf Polling
+zurückgefallen.
+"""
+
+from __future__ import annotations
+
+import ctypes
+import ctypes.util
+import fnmatch
+import logging
+import os
+import select
+import struct
+import threading
+import time
+from pathlib import Path
+from typing import Callable, Dict, Iterable, Optional, Set, Tuple
+
+
+# inotify-Konstanten (siehe <sys/inotify.h>)
+IN_MODIFY = 0x00000002
+IN_CLOSE_WRITE = 0x00000008
+IN_MOVED_TO = 0x00000080
+IN_CREATE = 0x00000100
+IN_DELETE = 0x00000200
+IN_IGNORED = 0x00008000
+IN_Q_OVERFLOW = 0x00004000
+IN_NONBLOCK = 0o4000
+IN_CLOEXEC = 0o2000000
+
+_EVENT_HEADER = struct.Struct("iIII")
+
+# Ereignistypen, die an Abonnenten verteilt werden
+EVENT_CREATED = "created"
+EVENT_COMPLETED = "completed"
+EVENT_REMOVED = "removed"
+
+SplitEventCallback = Callable[[str, Path], None]
+
+# Dateinamen der Split-Dateien (dvgrab -autosplit bzw. Tee-Capture)
+SPLIT_PATTERNS = ("dvgrab*.avi", "dvgrab*.dv")
+
+
+def _load_inotify():
+    """Lädt die inotify-Funktionen aus der libc (None, wenn nicht verfügbar)."""
+    if not hasattr(os, "uname") or os.uname().sysname != "Linux":
+        return None
+    try:
+        libc = ctypes.CDLL(ctypes.util.find_library("c") or "libc.so.6", use_errno=True)
+        libc.inotify_init1.argtypes = [ctypes.c_int]
+        libc.inotify_init1.restype = ctypes.c_int
+        libc.inotify_add_watch.argtypes = [ctypes.c_int, ctypes.c_char_p, ctypes.c_uint32]
+        libc.inotify_add_watch.restype = ctypes.c_int
+        return libc
+    except (OSError, AttributeError):
+        return None
+
+
+class SplitWatcher:
+    """Beobachtet den splits-Ordner und meldet neue und fertig geschriebene Split-Dateien"""
+
+    def __init__(
+        self,
+        splits_dir: Path,
+        patterns: Iterable[str] = SPLIT_PATTERNS,
+        log_callback: Optional[Callable[[str], None]] = None,
+        poll_interval: float = 0.5,
+        use_inotify: bool = True,
+    ):
+        """
+        Args:
+            splits_dir: Zu überwachender Ordner (LowRes/splits/)
+            patterns: Dateimuster für Split-Dateien
+            log_callback: Optionaler Callback für Log-Nachrichten
+            poll_interval: Intervall für den Polling-Fallback in Sekunden
+            use_inotify: False erzwingt den Polling-Fallback
+        """
+        self.splits_dir = Path(splits_dir)
+        self.patterns = tuple(patterns)
+        self.log_callback = log_callback
+        self.poll_interval = poll_interval
+        self.logger = logging.getLogger(__name__)
+
+        self._libc = _load_inotify() if use_inotify else None
+        self._inotify_fd: Optional[int] = None
+        self._thread: Optional[threading.Thread] = None
+        self._stop_event = threading.Event()
+
+        self._cond = threading.Condition()
+        self._subscribers: Dict[int, Tuple[SplitEventCallback, Optional[Set[str]]]] = {}
+        self._next_token = 1
+        # Dateien, die (noch) geschrieben werden, und fertige Dateien
+        self._open_files: Set[Path] = set()
+        self._completed_files: Set[Path] = set()
+        # Polling-Fallback: letzte bekannte Größe und Anzahl stabiler Checks
+        self._poll_sizes: Dict[Path, Tuple[int, int]] = {}
+
+        self.last_event_time: Optional[float] = None
+        self.mode = "stopped"
+
+    # ------------------------------------------------------------------
+    # Öffentliche API
+    # ------------------------------------------------------------------
+
+    def start(self) -> bool:
+        """Startet die Überwachung (inotify, sonst Polling)"""
+        if self._thread and self._thread.is_alive():
+            return True
+
+        self.splits_dir.mkdir(parents=True, exist_ok=True)
+        self._stop_event.clear()
+
+        target = self._poll_loop
+        self.mode = "polling"
+        if self._libc is not None:
+            fd = self._libc.inotify_init1(IN_NONBLOCK | IN_CLOEXEC)
+            if fd >= 0:
+                mask = IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MODIFY | IN_DELETE
+                wd = self._libc.inotify_add_watch(fd, os.fsencode(str(self.splits_dir)), mask)
+                if wd >= 0:
+                    self._inotify_fd = fd
+                    target = self._inotify_loop
+                    self.mode = "inotify"
+                else:
+                    err = ctypes.get_errno()
+                    os.close(fd)
+                    self.log(f"Split-Watcher: inotify_add_watch fehlgeschlagen ({os.strerror(err)}), nutze Polling")
+            else:
+                err = ctypes.get_errno()
+                self.log(f"Split-Watcher: inotify nicht verfügbar ({os.strerror(err)}), nutze Polling")
+
+        # Bereits vorhandene Dateien gelten als fertig (vor Beginn der Überwachung geschrieben)
+        for path in self._scan():
+            self._mark_completed(path, announce_created=True)
+
+        self._thread = threading.Thread(target=target, daemon=True, name="SplitWatcher")
+        self._thread.start()
+        self.log(f"Split-Watcher gestartet ({self.mode}): {self.splits_dir}")
+        return True
+
+    def stop(self):
+        """Beendet die Überwachung"""
+        self._stop_event.set()
+        if self._thread and self._thread.is_alive():
+            self._thread.join(timeout=2)
+        self._thread = None
+        if self._inotify_fd is not None:
+            try:
+                os.close(self._inotify_fd)
+            except OSError:
+                pass
+            self._inotify_fd = None
+        self.mode = "stopped"
+        with self._cond:
+            self._cond.notify_all()
+
+    def is_running(self) -> bool:
+        return bool(self._thread and self._thread.is_alive())
+
+    def subscribe(self, callback: SplitEventCallback, events: Optional[Iterable[str]] = None) -> int:
+        """
+        Registriert einen Abonnenten.
+
+        Args:
+            callback: Wird mit (event, path) aufgerufen – im Watcher-Thread, also kurz halten
+            events: Optionaler Filter (z.B. {"completed"}); None = alle Ereignisse
+
+        Returns:
+            Token für unsubscribe()
+        """
+        with self._cond:
+            token = self._next_token
+            self._next_token += 1
+            self._subscribers[token] = (callback, set(events) if events else None)
+            return token
+
+    def unsubscribe(self, token: int):
+        with self._cond:
+            self._subscribers.pop(token, None)
+
+    def known_files(self) -> list[Path]:
+        """Alle bisher gesehenen Split-Dateien (offen + fertig), sortiert nach Name"""
+        with self._cond:
+            return sorted(self._open_files | self._completed_files)
+
+    def completed_files(self) -> list[Path]:
+        with self._cond:
+            return sorted(self._completed_files)
+
+    def is_completed(self, path: Path) -> bool:
+        with self._cond:
+            return Path(path) in self._completed_files
+
+    def wait_for_file(self, path: Path, timeout: float = 5.0) -> bool:
+        """Wartet, bis eine bestimmte Datei fertig geschrieben ist"""
+        path = Path(path)
+        deadline = time.monotonic() + timeout
+        with self._cond:
+            while path not in self._completed_files:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0 or self._stop_event.is_set():
+                    break
+                self._cond.wait(remaining)
+            return path in self._completed_files
+
+    def wait_until_idle(self, timeout: float = 10.0, quiet_period: float = 0.5) -> bool:
+        """
+        Wartet, bis keine Split-Datei mehr geschrieben wird (z.B. nach dem Stoppen von dvgrab).
+
+        Returns:
+            True, wenn alle Dateien fertig sind; False bei Timeout
+        """
+        deadline = time.monotonic() + timeout
+        with self._cond:
+            while True:
+                last = self.last_event_time or 0.0
+                quiet = (time.time() - last) >= quiet_period
+                if not self._open_files and quiet:
+                    return True
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    break
+                if not self.is_running():
+                    # Ohne laufende Überwachung kommen keine Ereignisse mehr – einmal nachprüfen
+                    self._cond.release()
+                    try:
+                        self._poll_once(final=True)
+                    finally:
+                        self._cond.acquire()
+                    if not self._open_files:
+                        return True
+                    break
+                self._cond.wait(min(remaining, quiet_period))
+            if self._open_files:
+                self.log(
+                    f"Split-Watcher: Timeout – noch {len(self._open_files)} Datei(en) in Arbeit: "
+                    f"{', '.join(p.name for p in sorted(self._open_files))}"
+                )
+            return not self._open_files
+
+    # ------------------------------------------------------------------
+    # Interne Logik
+    # ------------------------------------------------------------------
+
+    def _matches(self, name: str) -> bool:
+        return any(fnmatch.fnmatch(name, pattern) for pattern in self.patterns)
+
+    def _scan(self) -> list[Path]:
+        try:
+            return sorted(p for p in self.splits_dir.iterdir() if self._matches(p.name))
+        except OSError:
+            return []
+
+    def _dispatch(self, event: str, path: Path):
+        with self._cond:
+            subscribers = list(self._subscribers.values())
+        for callback, events in subscribers:
+            if events is not None and event not in events:
+                continue
+            try:
+                callback(event, path)
+            except Exception as e:
+                self.log(f"Split-Watcher: Fehler im Abonnenten ({event}, {path.name}): {e}")
+
+    def _mark_open(self, path: Path):
+        with self._cond:
+            self.last_event_time = time.time()
+            if path in self._open_files or path in self._completed_files:
+                self._cond.notify_all()
+                return
+            self._open_files.add(path)
+            self._cond.notify_all()
+        self._dispatch(EVENT_CREATED, path)
+
+    def _mark_completed(self, path: Path, announce_created: bool = False):
+        with self._cond:
+            self.last_event_time = time.time()
+            was_known = path in self._open_files or path in self._completed_files
+            if path in self._completed_files:
+                return
+            self._open_files.discard(path)
+            self._completed_files.add(path)
+            self._poll_sizes.pop(path, None)
+            self._cond.notify_all()
+        if announce_created and not was_known:
+            self._dispatch(EVENT_CREATED, path)
+        self._dispatch(EVENT_COMPLETED, path)
+
+    def _mark_removed(self, path: Path):
+        with self._cond:
+            self.last_event_time = time.time()
+            known = path in self._open_files or path in self._completed_files
+            self._open_files.discard(path)
+            self._completed_files.discard(path)
+            self._poll_sizes.pop(path, None)
+            self._cond.notify_all()
+        if known:
+            self._dispatch(EVENT_REMOVED, path)
+
+    def _touch(self):
+        with self._cond:
+            self.last_event_time = time.time()
+
+    def _inotify_loop(self):
+        fd = self._inotify_fd
+        try:
+            while not self._stop_event.is_set() and fd is not None:
+                try:
+                    ready, _, _ = select.select([fd], [], [], self.poll_interval)
+                except (OSError, ValueError):
+                    break
+                if not ready:
+                    continue
+                try:
+                    data = os.read(fd, 64 * 1024)
+                except BlockingIOError:
+                    continue
+                except OSError as e:
+                    self.log(f"Split-Watcher: Lesefehler ({e}), wechsle zu Polling")
+                    self.mode = "polling"
+                    self._poll_loop()
+                    return
+                self._handle_inotify_buffer(data)
+        except Exception as e:
+            self.log(f"Split-Watcher: Fehler: {e}")
+
+    def _handle_inotify_buffer(self, data: bytes):
+        offset = 0
+        view = memoryview(data)
+        while offset + _EVENT_HEADER.size <= len(data):
+            _wd, mask, _cookie, name_len = _EVENT_HEADER.unpack_from(data, offset)
+            offset += _EVENT_HEADER.size
+            raw_name = bytes(view[offset: offset + name_len]).rstrip(b"\0")
+            offset += name_len
+
+            if mask & IN_Q_OVERFLOW:
+                # Ereignisse verloren – Zustand per Scan nachziehen
+                self._poll_once()
+                continue
+            if mask & IN_IGNORED or not raw_name:
+                continue
+            name = os.fsdecode(raw_name)
+            if not self._matches(name):
+                continue
+            path = self.splits_dir / name
+
+            if mask & IN_CREATE:
+                self._mark_open(path)
+            if mask & IN_MODIFY:
+                if path not in self._open_files and path not in self._completed_files:
+                    self._mark_open(path)
+                else:
+                    self._touch()
+            if mask & (IN_CLOSE_WRITE | IN_MOVED_TO):
+                self._mark_completed(path, announce_created=True)
+            if mask & IN_DELETE:
+                self._mark_removed(path)
+
+    def _poll_loop(self):
+        while not self._stop_event.wait(self.poll_interval):
+            try:
+                self._poll_once()
+            except Exception as e:
+                self.log(f"Split-Watcher (Polling): Fehler: {e}")
+
+    def _poll_once(self, final: bool = False):
+        """
+        Polling-Fallback: Eine Datei gilt als fertig, wenn ihre Größe zwei Prüfungen lang
+        stabil ist oder bereits eine neuere Split-Datei existiert (dvgrab schreibt sequenziell).
+        Mit final=True (Aufnahme gestoppt) gilt jede Datei mit Größe > 0 als fertig.
+        """
+        current = self._scan()
+        current_set = set(current)
+        with self._cond:
+            vanished = (self._open_files | self._completed_files) - current_set
+        for path in vanished:
+            self._mark_removed(path)
+
+        newest = current[-1] if current else None
+        for path in current:
+            if self.is_completed(path):
+                continue
+            try:
+                size = path.stat().st_size
+            except OSError:
+                continue
+            with self._cond:
+                known = path in self._open_files
+            if not known:
+                self._mark_open(path)
+            prev_size, stable = self._poll_sizes.get(path, (-1, 0))
+            stable = stable + 1 if size == prev_size and size > 0 else 0
+            self._poll_sizes[path] = (size, stable)
+            if size != prev_size:
+                self._touch()
+            if size > 0 and (final or stable >= 2 or (newest is not None and path != newest)):
+                self._mark_completed(path)
+
+    def log(self, message: str):
+        self.logger.info(message)
+        if self.log_callback:
+            self.log_callback(message)
@@ -0,0 +1,481 @@
+"""
+Tee-Capture: ein Leser für den rohen DIF-Stream von dvgrab (stdout), Verteilung an mehrere Verbraucher
+
+Architektur:
+    dvgrab -f raw - ──► Leser-Thread ──► DVFrameRing (feste Slots, ein Frame pro Slot)
+                                              ├─► Analyzer  (Timecode/Aufnahmedatum je Frame, verlustfrei)
+                                              ├─► SplitWriter (splits/dvgrab-*.dv, verlustfrei, nach Analyzer)
+                                              └─► Preview    (stdin eines langlebigen ffmpeg, darf Frames auslassen)
+
+Die verlustfreien Verbraucher bekommen memoryview-Slices auf den Ring, die Preview eine Kopie
+ihres Frames – so kann ein hängender Preview-ffmpeg den Leser nie ausbremsen. Von der Platte
+wird nichts zurückgelesen.
+"""
+
+import threading
+import time
+from datetime import datetime
+from pathlib import Path
+from typing import BinaryIO, Callable, List, Optional, Tuple
+
+from .dv_dif import DVFrameInfo, frame_size_from_header, is_header_block, parse_frame_info
+
+
+DEFAULT_RING_SLOTS = 250  # ~10 s PAL (~36 MB)
+SPLIT_GAP_SECONDS = 2  # Sprung im Aufnahmezeitpunkt, ab dem eine neue Split-Datei beginnt
+
+
+class _SinkClosed(Exception):
+    """Ziel eines Verbrauchers wurde geschlossen (z.B. Preview-ffmpeg beendet)"""
+
+
+class RingConsumer:
+    """Lese-Position eines Verbrauchers im DVFrameRing"""
+
+    def __init__(self, name: str, lossless: bool, after: Optional["RingConsumer"] = None):
+        self.name = name
+        self.lossless = lossless  # verlustfrei: Leser wartet, statt Frames zu überschreiben
+        self.after = after  # liest erst Frames, die dieser Verbraucher bereits freigegeben hat
+        self.cursor = 0  # nächste zu lesende Sequenznummer
+        self.in_flight: Optional[int] = None
+        self.consumed = 0
+        self.dropped = 0
+        self.detached = False
+
+
+class DVFrameRing:
+    """
+    Ringpuffer mit festen Frame-Slots (ein DV-Frame pro Slot).
+
+    Der Schreiber blockiert, solange ein verlustfreier Verbraucher den ältesten Slot noch
+    braucht. Verlustbehaftete Verbraucher springen bei Rückstand auf das neueste Frame und
+    bekommen eine Kopie des Slots, damit sie den Schreiber nie blockieren.
+    """
+
+    def __init__(self, frame_size: int, slots: int = DEFAULT_RING_SLOTS):
+        self.frame_size = frame_size
+        self.slots = slots
+        self._buffer = bytearray(frame_size * slots)
+        self._view = memoryview(self._buffer)
+        self._info: List[Optional[DVFrameInfo]] = [None] * slots
+        self._cond = threading.Condition()
+        self._consumers: List[RingConsumer] = []
+        self.write_seq = 0
+        self.closed = False
+
+    # --- Verbraucher -------------------------------------------------------
+
+    def add_consumer(self, name: str, lossless: bool = True, after: Optional[RingConsumer] = None) -> RingConsumer:
+        with self._cond:
+            consumer = RingConsumer(name, lossless, after)
+            consumer.cursor = self.write_seq
+            self._consumers.append(consumer)
+            return consumer
+
+    def detach(self, consumer: RingConsumer):
+        """Entfernt einen Verbraucher (z.B. nach Broken Pipe); der Schreiber wartet nicht mehr auf ihn."""
+        with self._cond:
+            consumer.detached = True
+            consumer.in_flight = None
+            if consumer in self._consumers:
+                self._consumers.remove(consumer)
+            self._cond.notify_all()
+
+    def _read_limit(self, consumer: RingConsumer) -> int:
+        dep = consumer.after
+        if dep is None or dep.detached:
+            return self.write_seq
+        return min(self.write_seq, dep.cursor)
+
+    def read(self, consumer: RingConsumer, timeout: float = 0.5) -> Optional[Tuple[int, memoryview]]:
+        """
+        Liefert (seq, frame) oder None bei Timeout/Ende. Nach der Verarbeitung release() aufrufen.
+        Ende des Streams: None und eof() ist True.
+        """
+        with self._cond:
+            deadline = time.monotonic() + timeout
+            while consumer.cursor >= self._read_limit(consumer):
+                if self.closed and consumer.cursor >= self.write_seq:
+                    return None
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    return None
+                self._cond.wait(remaining)
+
+            if not consumer.lossless and self.write_seq - consumer.cursor >= self.slots - 1:
+                # Zu weit zurück – die Slots werden gleich überschrieben, also zum neuesten Frame springen
+                skip_to = self.write_seq - 1
+                consumer.dropped += skip_to - consumer.cursor
+                consumer.cursor = skip_to
+
+            seq = consumer.cursor
+            start = (seq % self.slots) * self.frame_size
+            frame = self._view[start: start + self.frame_size]
+            if not consumer.lossless:
+                # Kopie unter dem Lock: der Slot darf danach überschrieben werden
+                return seq, memoryview(frame.tobytes())
+            consumer.in_flight = seq
+            return seq, frame
+
+    def release(self, consumer: RingConsumer, seq: int):
+        with self._cond:
+            consumer.in_flight = None
+            consumer.cursor = seq + 1
+            consumer.consumed += 1
+            self._cond.notify_all()
+
+    def eof(self, consumer: RingConsumer) -> bool:
+        with self._cond:
+            return self.closed and consumer.cursor >= self.write_seq
+
+    # --- Metadaten ---------------------------------------------------------
+
+    def set_info(self, seq: int, info: DVFrameInfo):
+        self._info[seq % self.slots] = info
+
+    def get_info(self, seq: int) -> Optional[DVFrameInfo]:
+        return self._info[seq % self.slots]
+
+    # --- Schreiber ---------------------------------------------------------
+
+    def _oldest_needed(self) -> int:
+        oldest = self.write_seq
+        for c in self._consumers:
+            if not c.lossless:
+                continue  # verlustbehaftet: arbeitet auf einer Kopie, bremst den Schreiber nie
+            oldest = min(oldest, c.cursor)
+            if c.in_flight is not None:
+                oldest = min(oldest, c.in_flight)
+        return oldest
+
+    def acquire_write_slot(self) -> Optional[memoryview]:
+        """Wartet, bis der nächste Slot frei ist, und liefert ihn zum Befüllen (None wenn geschlossen)."""
+        with self._cond:
+            while not self.closed and self.write_seq - self._oldest_needed() >= self.slots:
+                self._cond.wait(0.5)
+            if self.closed:
+                return None
+            start = (self.write_seq % self.slots) * self.frame_size
+            return self._view[start: start + self.frame_size]
+
+    def commit(self):
+        with self._cond:
+            self._info[self.write_seq % self.slots] = None
+            self.write_seq += 1
+            self._cond.notify_all()
+
+    def close(self):
+        with self._cond:
+            self.closed = True
+            self._cond.notify_all()
+
+
+class DVSplitWriter:
+    """
+    Schreibt DV-Frames als Roh-DV-Dateien in den splits-Ordner.
+
+    Eine neue Datei beginnt (wie bei dvgrab -autosplit), wenn der Aufnahmezeitpunkt springt
+    oder erscheint/verschwindet. Dateiname wie dvgrab -t: dvgrab-YYYY.MM.DD_HH-MM-SS.dv
+    """
+
+    def __init__(
+        self,
+        splits_dir: Path,
+        prefix: str = "dvgrab",
+        max_bytes: int = 0,
+        log_callback: Optional[Callable[[str], None]] = None,
+    ):
+        self.splits_dir = Path(splits_dir)
+        self.prefix = prefix
+        self.max_bytes = max_bytes
+        self.log_callback = log_callback
+        self.current_path: Optional[Path] = None
+        self.files: List[Path] = []
+        self.bytes_written = 0
+        self._file: Optional[BinaryIO] = None
+        self._file_bytes = 0
+        self._last_recorded: Optional[datetime] = None
+        self._has_recorded = False
+
+    def _needs_split(self, info: Optional[DVFrameInfo]) -> bool:
+        if self._file is None:
+            return True
+        if self.max_bytes and self._file_bytes >= self.max_bytes:
+            return True
+        recorded = info.recorded_at if info else None
+        if (recorded is not None) != self._has_recorded:
+            return True
+        if recorded is not None and self._last_recorded is not None:
+            delta = (recorded - self._last_recorded).total_seconds()
+            if delta < 0 or delta > SPLIT_GAP_SECONDS:
+                return True
+        return False
+
+    def _open_next(self, info: Optional[DVFrameInfo]):
+        self.close()
+        recorded = info.recorded_at if info else None
+        stamp = (recorded or datetime.now()).strftime("%Y.%m.%d_%H-%M-%S")
+        path = self.splits_dir / f"{self.prefix}-{stamp}.dv"
+        counter = 1
+        while path.exists():
+            path = self.splits_dir / f"{self.prefix}-{stamp}-{counter:02d}.dv"
+            counter += 1
+        self._file = open(path, "wb", buffering=0)
+        self._file_bytes = 0
+        self.current_path = path
+        self.files.append(path)
+        self._has_recorded = recorded is not None
+        if self.log_callback:
+            self.log_callback(f"Tee-Capture: neue Split-Datei {path.name}")
+
+    def write(self, frame: memoryview, info: Optional[DVFrameInfo]):
+        if self._needs_split(info):
+            self._open_next(info)
+        recorded = info.recorded_at if info else None
+        if recorded is not None:
+            self._last_recorded = recorded
+        self._file.write(frame)
+        self._file_bytes += len(frame)
+        self.bytes_written += len(frame)
+
+    def close(self):
+        if self._file is not None:
+            try:
+                self._file.close()
+            except OSError:
+                pass
+            self._file = None
+
+
+class TeeCapture:
+    """
+    Liest den DIF-Stream von dvgrab genau einmal und verteilt ihn an Analyzer, Split-Writer und Preview.
+
+    Args:
+        source: stdout von dvgrab (ungepuffert, bufsize=0)
+        splits_dir: Zielordner für Split-Dateien
+        preview_sink: stdin eines Preview-ffmpeg (-f dv -i -) oder None
+        frame_callback: optional, wird im Analyzer-Thread mit (seq, DVFrameInfo) aufgerufen
+    """
+
+    def __init__(
+        self,
+        source: BinaryIO,
+        splits_dir: Path,
+        preview_sink: Optional[BinaryIO] = None,
+        log_callback: Optional[Callable[[str], None]] = None,
+        frame_callback: Optional[Callable[[int, DVFrameInfo], None]] = None,
+        ring_slots: int = DEFAULT_RING_SLOTS,
+        split_max_bytes: int = 0,
+    ):
+        self.source = source
+        self.splits_dir = Path(splits_dir)
+        self.preview_sink = preview_sink
+        self.log_callback = log_callback
+        self.frame_callback = frame_callback
+        self.ring_slots = ring_slots
+        self.ring: Optional[DVFrameRing] = None
+        self.writer = DVSplitWriter(self.splits_dir, max_bytes=split_max_bytes, log_callback=log_callback)
+        self.last_info: Optional[DVFrameInfo] = None
+        self.frames_read = 0
+        self.resyncs = 0
+        self.error: Optional[str] = None
+        self._threads: List[threading.Thread] = []
+        self._consumers: List[RingConsumer] = []
+        self._reader_thread: Optional[threading.Thread] = None
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
+
+    # --- Steuerung ---------------------------------------------------------
+
+    def start(self):
+        self._reader_thread = threading.Thread(target=self._reader_loop, daemon=True)
+        self._reader_thread.start()
+
+    def wait(self, timeout: Optional[float] = None) -> bool:
+        """Wartet, bis der Stream zu Ende ist und alle Verbraucher fertig sind."""
+        deadline = None if timeout is None else time.monotonic() + timeout
+        if self._reader_thread:
+            self._reader_thread.join(timeout)
+            if self._reader_thread.is_alive():
+                return False
+        # Verbraucher-Threads werden erst vom Leser gestartet, daher erst danach einsammeln
+        for thread in list(self._threads):
+            remaining = None if deadline is None else max(0.0, deadline - time.monotonic())
+            thread.join(remaining)
+            if thread.is_alive():
+                return False
+        return True
+
+    def stop(self, timeout: float = 10.0) -> bool:
+        """Beendet die Verteilung; erwartet, dass dvgrab bereits beendet wurde (EOF auf stdout)."""
+        finished = self.wait(timeout)
+        if not finished and self.ring:
+            self.log("Tee-Capture: Stream endet nicht rechtzeitig, schließe Ringpuffer")
+            self.ring.close()
+            finished = self.wait(2.0)
+        self.writer.close()
+        return finished
+
+    def stats(self) -> dict:
+        info = self.last_info
+        return {
+            "frames": self.frames_read,
+            "bytes": self.writer.bytes_written,
+            "files": len(self.writer.files),
+            "resyncs": self.resyncs,
+            "timecode": info.timecode_str() if info else None,
+            "recorded_at": info.recorded_at.isoformat() if info and info.recorded_at else None,
+            "consumers": {
+                c.name: {"consumed": c.consumed, "dropped": c.dropped, "detached": c.detached}
+                for c in self._consumers
+            },
+        }
+
+    # --- Leser -------------------------------------------------------------
+
+    def _read_into(self, view: memoryview) -> int:
+        """Füllt view vollständig (Pipes liefern Teilstücke); gibt die gelesene Länge zurück."""
+        filled = 0
+        total = len(view)
+        while filled < total:
+            n = self.source.readinto(view[filled:])
+            if not n:
+                break
+            filled += n
+        return filled
+
+    def _resync(self, slot: memoryview) -> bool:
+        """Sucht im Slot den nächsten Frame-Anfang, schiebt ihn nach vorn und liest den Rest nach."""
+        size = len(slot)
+        for offset in range(1, size - 160):
+            if is_header_block(slot, offset):
+                tail = size - offset
+                slot[:tail] = slot[offset:]
+                return self._read_into(slot[tail:]) == size - tail
+        return False
+
+    def _reader_loop(self):
+        try:
+            probe = bytearray(480)
+            if self._read_into(memoryview(probe)) < len(probe):
+                self.log("Tee-Capture: Kein DV-Signal von dvgrab erhalten")
+                return
+            frame_size = frame_size_from_header(probe)
+            if frame_size is None:
+                self.error = "Kein gültiger DIF-Header am Stream-Anfang"
+                self.log(f"Tee-Capture: {self.error}")
+                return
+
+            self.ring = DVFrameRing(frame_size, self.ring_slots)
+            self.log(
+                f"Tee-Capture: {'PAL' if frame_size == 144000 else 'NTSC'}-Stream erkannt, "
+                f"Ringpuffer {self.ring_slots} Frames ({frame_size * self.ring_slots // (1024 * 1024)} MB)"
+            )
+            self._start_consumers()
+
+            first = True
+            while True:
+                slot = self.ring.acquire_write_slot()
+                if slot is None:
+                    break
+                if first:
+                    slot[: len(probe)] = probe
+                    n = len(probe) + self._read_into(slot[len(probe):])
+                    first = False
+                else:
+                    n = self._read_into(slot)
+                if n < frame_size:
+                    if n:
+                        self.log(f"Tee-Capture: unvollständiges letztes Frame verworfen ({n} Bytes)")
+                    break
+                if not is_header_block(slot):
+                    self.resyncs += 1
+                    if not self._resync(slot):
+                        break
+                self.ring.commit()
+                self.frames_read += 1
+        except Exception as e:
+            self.error = str(e)
+            self.log(f"Tee-Capture: Fehler beim Lesen: {e}")
+        finally:
+            if self.ring:
+                self.ring.close()
+            self.log(f"Tee-Capture: Stream beendet ({self.frames_read} Frames, {self.resyncs} Resyncs)")
+
+    # --- Verbraucher-Threads -------------------------------------------------
+
+    def _start_consumers(self):
+        analyzer = self.ring.add_consumer("analyzer", lossless=True)
+        writer = self.ring.add_consumer("writer", lossless=True, after=analyzer)
+        self._consumers = [analyzer, writer]
+        targets = [(self._analyzer_loop, analyzer), (self._writer_loop, writer)]
+        if self.preview_sink is not None:
+            preview = self.ring.add_consumer("preview", lossless=False)
+            self._consumers.append(preview)
+            targets.append((self._preview_loop, preview))
+        for target, consumer in targets:
+            thread = threading.Thread(target=target, args=(consumer,), daemon=True)
+            thread.start()
+            self._threads.append(thread)
+
+    def _consume(self, consumer: RingConsumer, handle: Callable[[int, memoryview], None]):
+        ring = self.ring
+        try:
+            while True:
+                item = ring.read(consumer)
+                if item is None:
+                    if ring.eof(consumer):
+                        break
+                    continue
+                seq, frame = item
+                try:
+                    handle(seq, frame)
+                finally:
+                    ring.release(consumer, seq)
+        except _SinkClosed:
+            pass
+        except Exception as e:
+            self.log(f"Tee-Capture: Verbraucher '{consumer.name}' abgebrochen: {e}")
+        finally:
+            ring.detach(consumer)
+
+    def _analyzer_loop(self, consumer: RingConsumer):
+        def handle(seq: int, frame: memoryview):
+            info = parse_frame_info(frame)
+            self.ring.set_info(seq, info)
+            self.last_info = info
+            if self.frame_callback:
+                self.frame_callback(seq, info)
+
+        self._consume(consumer, handle)
+
+    def _writer_loop(self, consumer: RingConsumer):
+        def handle(seq: int, frame: memoryview):
+            self.writer.write(frame, self.ring.get_info(seq))
+
+        try:
+            self._consume(consumer, handle)
+        finally:
+            self.writer.close()
+
+    def _preview_loop(self, consumer: RingConsumer):
+        sink = self.preview_sink
+
+        def handle(seq: int, frame: memoryview):
+            written = 0
+            try:
+                while written < len(frame):
+                    written += sink.write(frame[written:]) or 0
+            except (BrokenPipeError, ValueError) as e:
+                raise _SinkClosed() from e
+
+        try:
+            self._consume(consumer, handle)
+        finally:
+            try:
+                sink.close()
+            except (OSError, ValueError):
+                pass
@@ -0,0 +1,81 @@
+import subprocess
+from pathlib import Path
+
+import dv2plex.chunked_upscale as chunked_upscale
+from dv2plex.chunked_upscale import ChunkedUpscaler, chunk_ranges
+
+
+class _FakeEngine:
+    """Schreibt je Abschnitt eine Ausgabe; fail_on = Name der Quelle, die einmal fehlschlägt"""
+
+    def __init__(self, fail_on=None):
+        self.fail_on = fail_on
+        self.calls = []
+
+    def upscale(self, input_path, output_path, profile, progress_hook=None, status_hook=None,
+                passthrough_ranges=None, crop=None):
+        self.calls.append((input_path.name, passthrough_ranges))
+        if input_path.name == self.fail_on:
+            self.fail_on = None
+            return False
+        progress_hook(100)
+        output_path.write_text(f"4k {input_path.name}")
+        return True
+
+
+def _fake_ffmpeg(commands):
+    def run_ffmpeg(cmd, **kwargs):
+        commands.append(cmd)
+        if "segment" in cmd:
+            work_dir = Path(cmd[-1]).parent
+            rows = []
+            for index, (start, end) in enumerate([(0.0, 300.04), (300.04, 600.0), (600.0, 750.5)]):
+                name = f"source_{index:04d}.mkv"
+                (work_dir / name).write_text("dv")
+                rows.append(f"{name},{start},{end}")
+            Path(cmd[cmd.index("-segment_list") + 1]).write_text("\n".join(rows) + "\n")
+        else:
+            concat_list = Path(cmd[cmd.index("concat") + 4])
+            Path(cmd[-1]).write_text(concat_list.read_text())
+        return subprocess.CompletedProcess(cmd, 0, None, "")
+
+    return run_ffmpeg
+
+
+def test_chunk_ranges_are_relative_to_chunk():
+    ranges = [(10.0, 20.0), (290.0, 320.0), (700.0, 800.0)]
+    assert chunk_ranges(ranges, 0.0, 300.0) == [(10.0, 20.0), (290.0, 300.0)]
+    assert chunk_ranges(ranges, 300.0, 600.0) == [(0.0, 20.0)]
+    assert chunk_ranges(None, 0.0, 300.0) == []
+
+
+def test_restart_skips_finished_chunks(monkeypatch, tmp_path: Path):
+    commands = []
+    monkeypatch.setattr(chunked_upscale, "run_ffmpeg", _fake_ffmpeg(commands))
+    source = tmp_path / "movie_merged.mp4"
+    source.write_text("lowres")
+    output = tmp_path / "HighRes" / "movie_4k.mp4"
+    work_dir = tmp_path / "HighRes" / ".movie_chunks"
+    profile = {"backend": "realesrgan", "model": "RealESRGAN_x4plus"}
+    dead = [(720.0, 750.5)]
+
+    engine = _FakeEngine(fail_on="source_0001.mkv")
+    upscaler = ChunkedUpscaler(engine, None, work_dir)
+    assert not upscaler.upscale(source, output, profile, passthrough_ranges=dead)
+    assert [name for name, _ in engine.calls] == ["source_0000.mkv", "source_0001.mkv"]
+    assert (work_dir / "upscaled_0000.mp4").exists()
+
+    # Neustart: nur der fehlgeschlagene und der letzte Abschnitt, ohne erneutes Teilen
+    engine.calls.clear()
+    progress = []
+    assert upscaler.upscale(source, output, profile, progress_hook=progress.append, passthrough_ranges=dead)
+    assert engine.calls == [("source_0001.mkv", None), ("source_0002.mkv", [(120.0, 150.5)])]
+    assert sum("segment" in cmd for cmd in commands) == 1
+    assert progress[0] >= 40 and progress[-1] == 100
+    assert output.read_text().count("upscaled_") == 3
+    assert not work_dir.exists()
+
+    # Anderes Profil: Arbeitsordner wird verworfen und neu geteilt
+    engine.calls.clear()
+    ChunkedUpscaler(engine, None, work_dir).upscale(source, output, dict(profile, tile_size=200))
+    assert len(engine.calls) == 3
@@ -0,0 +1,55 @@
+import json
+from fractions import Fraction
+from pathlib import Path
+
+import dv2plex.crop_detect as crop_detect
+from dv2plex.crop_detect import CropArea, CropDetector, combine_samples, head_switching_lines
+
+
+def test_output_size_follows_display_aspect():
+    # PAL 4:3 und 16:9, volles Frame
+    assert CropArea(0, 0, 720, 576, 720, 576, Fraction(16, 15)).output_size() == (2880, 2160)
+    assert CropArea(0, 0, 720, 576, 720, 576, Fraction(64, 45)).output_size() == (3840, 2160)
+    # 704 statt 720 Pixel (Ränder abgeschnitten) und 8 Zeilen Kopfumschaltung weniger
+    assert CropArea(8, 0, 704, 568, 720, 576, Fraction(16, 15)).output_size() == (2856, 2160)
+    # Breiter als 16:9 wird in die Breite eingepasst
+    assert CropArea(0, 72, 720, 432, 720, 576, Fraction(64, 45)).output_size() == (3840, 1620)
+    assert CropArea(0, 0, 720, 576, 720, 576, Fraction(16, 15)).output_size(1920, 1080) == (1440, 1080)
+
+
+def test_head_switching_counts_noisy_bands_from_bottom():
+    assert head_switching_lines([40.0, 35.0, 3.0, 2.5], reference_diff=3.0) == 8
+    assert head_switching_lines([4.0, 3.0, 3.0, 3.0], reference_diff=3.0) == 0
+    # Ruhiges Bild: die Mindestdifferenz verhindert Fehlalarme bei winzigen Werten
+    assert head_switching_lines([1.0, 1.0, 0.5, 0.5], reference_diff=0.2) == 0
+
+
+def test_combine_samples_ignores_outliers():
+    samples = [(8, 0, 8, 8)] * 9 + [(0, 0, 0, 0), (40, 60, 40, 60), (8, 2, 8, 9)]
+    assert combine_samples(samples, 720, 576) == (8, 0, 704, 568)
+    assert combine_samples([], 720, 576) == (0, 0, 720, 576)
+    # Mehr als ein Viertel pro Seite ist eine Fehlmessung
+    assert combine_samples([(400, 0, 0, 0)], 720, 576) == (180, 0, 540, 576)
+
+
+def test_load_or_detect_keeps_manual_crop(monkeypatch, tmp_path: Path):
+    video = tmp_path / "movie_merged.avi"
+    video.write_bytes(b"dv")
+    store = tmp_path / "crop.json"
+    manual = CropArea(16, 0, 688, 560, 720, 576, Fraction(16, 15), manual=True)
+    store.write_text(json.dumps({"key": {}, "crop": manual.to_dict()}))
+
+    monkeypatch.setattr(crop_detect, "probe_geometry", lambda path, ffmpeg_path=None: (720, 576, Fraction(16, 15)))
+    detected = []
+    detector = CropDetector()
+    monkeypatch.setattr(
+        detector, "detect", lambda *args: detected.append(args) or CropArea(8, 0, 704, 576, 720, 576, Fraction(16, 15))
+    )
+    assert detector.load_or_detect(video, store) == manual
+    assert detector.load_or_detect(video, store, detect=False).is_cropped is False
+    assert not detected
+
+    store.unlink()
+    first = detector.load_or_detect(video, store)
+    assert detector.load_or_detect(video, store) == first
+    assert len(detected) == 1
@@ -0,0 +1,84 @@
+from dv2plex.dead_segments import (
+    EDGE_MARGIN_SECONDS,
+    VideoAnalysis,
+    classify_frame,
+    describe_segments,
+    find_dead_segments,
+)
+
+
+def _stats(ylow, yhigh, yavg, uavg=128, chroma_spread=2, ydif=0, satavg=2):
+    return {
+        "YLOW": ylow, "YHIGH": yhigh, "YAVG": yavg,
+        "ULOW": uavg - chroma_spread / 2, "UHIGH": uavg + chroma_spread / 2, "UAVG": uavg,
+        "VLOW": 127, "VHIGH": 129, "YDIF": ydif, "SATAVG": satavg,
+    }
+
+
+def _frames(start, end, kind, fps=25):
+    return [(start + i / fps, kind) for i in range(int((end - start) * fps))]
+
+
+def test_classify_frame():
+    assert classify_frame(_stats(16, 20, 17)) == "black"
+    assert classify_frame(_stats(38, 44, 41, uavg=200)) == "blue"
+    assert classify_frame(_stats(120, 126, 123)) == "flat"
+    assert classify_frame(_stats(16, 235, 120, ydif=35)) == "snow"
+    # Dunkle, aber strukturierte Szene und bewegtes Bild mit Farbe sind lebendig
+    assert classify_frame(_stats(16, 60, 25)) is None
+    assert classify_frame(_stats(16, 235, 120, ydif=35, satavg=40)) is None
+    assert classify_frame({}) is None
+
+
+def test_blue_tail_with_silence_is_dead_up_to_file_end():
+    frames = _frames(0, 60, None) + _frames(60, 120, "blue")
+    segments = find_dead_segments(frames, [(60.1, 120.0)], duration=120.0)
+    assert len(segments) == 1
+    assert segments[0].kind == "blue"
+    assert segments[0].start == round(60.1 + EDGE_MARGIN_SECONDS, 3)
+    assert segments[0].end == 120.0
+
+
+def test_dark_scene_with_sound_is_kept():
+    frames = _frames(0, 30, None) + _frames(30, 45, "black") + _frames(45, 90, None)
+    assert find_dead_segments(frames, [], duration=90.0) == []
+    # Ohne Tonspur zählt nur das Bild, mit Puffer zu beiden Seiten
+    segments = find_dead_segments(frames, None, duration=90.0)
+    assert [(s.start, s.end, s.kind) for s in segments] == [
+        (30.0 + EDGE_MARGIN_SECONDS, 45.0 - EDGE_MARGIN_SECONDS, "black")
+    ]
+
+
+def test_short_runs_are_ignored():
+    frames = _frames(0, 10, None) + _frames(10, 12, "black") + _frames(12, 20, None)
+    assert find_dead_segments(frames, None, duration=20.0, min_seconds=5) == []
+
+
+def test_live_ranges_and_cache_roundtrip():
+    analysis = VideoAnalysis(
+        duration=100.0,
+        has_audio=True,
+        dead_segments=find_dead_segments(_frames(0, 20, "snow") + _frames(20, 100, None), None, 100.0),
+        scene_scores=[(25.0, 42.0), (50.0, 12.0)],
+    )
+    assert analysis.live_ranges() == [(analysis.dead_segments[0].end, 100.0)]
+    assert analysis.scene_changes(0.3) == [25.0]
+    restored = VideoAnalysis.from_dict(analysis.to_dict())
+    assert restored == analysis
+
+
+def test_trim_only_cuts_segments_at_file_edges():
+    frames = (
+        _frames(0, 10, "black") + _frames(10, 50, None) + _frames(50, 60, "black")
+        + _frames(60, 100, None) + _frames(100, 120, "blue")
+    )
+    analysis = VideoAnalysis(
+        duration=120.0, has_audio=False, dead_segments=find_dead_segments(frames, None, duration=120.0)
+    )
+    assert [s.kind for s in analysis.edge_segments()] == ["black", "blue"]
+    lead = analysis.dead_segments[0].duration
+    # Die stille dunkle Einstellung in der Mitte bleibt drin, nur ohne Modell
+    assert analysis.inner_ranges_after_trim() == [
+        (round(50.0 + EDGE_MARGIN_SECONDS - lead, 3), round(60.0 - EDGE_MARGIN_SECONDS - lead, 3))
+    ]
+    assert describe_segments(analysis.edge_segments()[1:]) == "1:40-2:00 Bluescreen"
@@ -0,0 +1,91 @@
+from dv2plex.dv_dif import (
+    DIF_BLOCK_SIZE,
+    DV_FRAME_SIZE_NTSC,
+    DV_FRAME_SIZE_PAL,
+    frame_size_from_header,
+    iter_dv_frames,
+    parse_frame_info,
+    parse_rec_date_pack,
+    parse_timecode_pack,
+)
+
+
+def _bcd(v: int) -> int:
+    return (v // 10) << 4 | (v % 10)
+
+
+def _frame(second: int, pal: bool = True, recorded: bool = True) -> bytearray:
+    """Synthetisches DV-Frame mit Timecode (Subcode) und Aufnahmezeit (VAUX) in der ersten Sequenz."""
+    size = DV_FRAME_SIZE_PAL if pal else DV_FRAME_SIZE_NTSC
+    frame = bytearray(b"\xff" * size)
+    for block in range(size // DIF_BLOCK_SIZE):
+        seq, idx = divmod(block, 150)
+        sct = 0 if idx == 0 else 1 if idx < 3 else 2 if idx < 6 else 3 if (idx - 6) % 16 == 0 else 4
+        frame[block * DIF_BLOCK_SIZE: block * DIF_BLOCK_SIZE + 3] = bytes([sct << 5 | 0x1F, seq << 4 | 0x07, 0])
+    frame[3] = 0xBF if pal else 0x3F  # DSF
+
+    tc = DIF_BLOCK_SIZE + 3 + 3
+    frame[tc: tc + 5] = bytes([0x13, _bcd(second % 25), _bcd(second % 60), _bcd(2), _bcd(1)])
+    if recorded:
+        vaux = DIF_BLOCK_SIZE * 3 + 3
+        frame[vaux: vaux + 5] = bytes([0x62, 0xFF, _bcd(24), _bcd(12), _bcd(99)])
+        frame[vaux + 5: vaux + 10] = bytes([0x63, 0xFF, _bcd(second % 60), _bcd(59), _bcd(23)])
+    return frame
+
+
+def _avi(frames) -> bytes:
+    chunks = b"".join(b"00__" + len(f).to_bytes(4, "little") + bytes(f) for f in frames)
+    audio = b"01wb" + (3).to_bytes(4, "little") + b"pcm\x00"  # ungerade Länge -> Padding
+    movi = b"LIST" + (len(chunks) + len(audio) + 4).to_bytes(4, "little") + b"movi" + audio + chunks
+    hdrl = b"LIST" + (16).to_bytes(4, "little") + b"hdrl" + b"JUNK" + (4).to_bytes(4, "little") + b"abcd"
+    body = b"AVI " + hdrl + movi
+    return b"RIFF" + len(body).to_bytes(4, "little") + body
+
+
+def test_frame_size_from_dsf_bit():
+    assert frame_size_from_header(_frame(0, pal=True)) == DV_FRAME_SIZE_PAL
+    assert frame_size_from_header(_frame(0, pal=False)) == DV_FRAME_SIZE_NTSC
+    assert frame_size_from_header(bytes(480)) is None
+
+
+def test_parse_frame_info():
+    info = parse_frame_info(_frame(7))
+    assert info.pal
+    assert info.timecode_str() == "01:02:07:07"
+    assert info.recorded_at.isoformat() == "1999-12-24T23:59:07"
+
+    info = parse_frame_info(_frame(3, pal=False, recorded=False))
+    assert not info.pal
+    assert info.timecode == (1, 2, 3, 3)
+    assert info.recorded_at is None
+
+
+def test_invalid_packs_are_rejected():
+    assert parse_timecode_pack(bytes([0x13, 0xFF, 0xFF, 0xFF, 0xFF])) is None
+    assert parse_timecode_pack(bytes([0x62, 0, 0, 0, 0])) is None
+    assert parse_rec_date_pack(bytes([0x62, 0xFF, _bcd(31), _bcd(13), _bcd(5)])) is None
+    assert parse_rec_date_pack(bytes([0x62, 0xFF, _bcd(1), _bcd(2), _bcd(5)])) == (2005, 2, 1)
+
+
+def test_iter_raw_frames(tmp_path):
+    for pal in (True, False):
+        path = tmp_path / f"raw-{pal}.dv"
+        path.write_bytes(b"".join(_frame(s, pal=pal) for s in range(3)) + b"\x00" * 100)
+        seconds = [parse_frame_info(f).timecode[2] for f in iter_dv_frames(path)]
+        assert seconds == [0, 1, 2]
+        assert len(next(iter_dv_frames(path))) == (DV_FRAME_SIZE_PAL if pal else DV_FRAME_SIZE_NTSC)
+
+
+def test_iter_avi_frames_skips_other_chunks(tmp_path):
+    path = tmp_path / "split.avi"
+    path.write_bytes(_avi([_frame(s, pal=False) for s in range(4)]))
+    frames = [bytes(f) for f in iter_dv_frames(path)]
+    assert len(frames) == 4
+    assert all(len(f) == DV_FRAME_SIZE_NTSC for f in frames)
+    assert frames[2] == bytes(_frame(2, pal=False))
+
+
+def test_non_dv_file_yields_nothing(tmp_path):
+    path = tmp_path / "other.dv"
+    path.write_bytes(bytes(DV_FRAME_SIZE_PAL))
+    assert list(iter_dv_frames(path)) == []
@@ -0,0 +1,84 @@
+import pytest
+
+from dv2plex.dv_dif import DIF_BLOCK_SIZE, DV_FRAME_SIZE_PAL
+from dv2plex.dv_index import FLAG_AAUX, FLAG_PAL, FLAG_VAUX, scan_dv_buffer
+
+
+def _bcd(v: int) -> int:
+    return (v // 10) << 4 | (v % 10)
+
+
+def _frame(second: int, timecode=True, broken_first_pack=False) -> bytearray:
+    """Synthetisches PAL-Frame: nur die erste DIF-Sequenz trägt Metadaten."""
+    frame = bytearray(b"\xff" * DV_FRAME_SIZE_PAL)
+    for block in range(DV_FRAME_SIZE_PAL // DIF_BLOCK_SIZE):
+        seq, idx = divmod(block, 150)
+        sct = 0 if idx == 0 else 1 if idx < 3 else 2 if idx < 6 else 3 if (idx - 6) % 16 == 0 else 4
+        frame[block * DIF_BLOCK_SIZE: block * DIF_BLOCK_SIZE + 3] = bytes([sct << 5 | 0x1F, seq << 4 | 0x07, 0])
+    frame[3] = 0xBF  # DSF = PAL
+
+    packs = []
+    if broken_first_pack:
+        packs.append(bytes([0x13, 0xFF, 0xFF, 0xFF, 0xFF]))
+    if timecode:
+        packs.append(bytes([0x13, _bcd(second % 25), _bcd(second % 60), _bcd(2), _bcd(1)]))
+    for ssyb, pack in enumerate(packs):
+        off = DIF_BLOCK_SIZE + 3 + ssyb * 8 + 3
+        frame[off: off + 5] = pack
+
+    vaux = DIF_BLOCK_SIZE * 3 + 3
+    frame[vaux: vaux + 5] = bytes([0x60, 0x00, 0x00, 0x00, 0x00])
+    frame[vaux + 5: vaux + 10] = bytes([0x62, 0xFF, _bcd(24), _bcd(12), _bcd(99)])
+    frame[vaux + 10: vaux + 15] = bytes([0x63, 0xFF, _bcd(second % 60), _bcd(59), _bcd(23)])
+
+    audio = DIF_BLOCK_SIZE * 6 + 3
+    frame[audio: audio + 5] = bytes([0x50, 0x00, 0x00, 0x00, 0x00])
+    return frame
+
+
+def _avi(frames) -> bytes:
+    chunks = b"".join(b"00__" + len(f).to_bytes(4, "little") + bytes(f) for f in frames)
+    movi = b"LIST" + (len(chunks) + 4).to_bytes(4, "little") + b"movi" + chunks
+    junk = b"JUNK" + (3).to_bytes(4, "little") + b"abc\x00"
+    body = b"AVI " + junk + movi
+    return b"RIFF" + len(body).to_bytes(4, "little") + body
+
+
+def test_raw_stream_with_leading_garbage():
+    data = b"\x00" * 7 + b"".join(_frame(s) for s in range(5))
+    index = scan_dv_buffer(data, use_numpy=False)
+    assert index.offsets == [7 + i * DV_FRAME_SIZE_PAL for i in range(5)]
+    assert index.flags == [FLAG_PAL | FLAG_AAUX | FLAG_VAUX] * 5
+    assert index.timecodes[3] == 1020303
+    assert index.rec_dates[3] == 19991224
+    assert index.rec_times[3] == 235903
+    assert index.frame_info(3).timecode_str() == "01:02:03:03"
+    assert index.first_recorded_at().isoformat() == "1999-12-24T23:59:00"
+
+
+def test_resync_after_damaged_frame_and_first_valid_pack():
+    damaged = bytes(1000)
+    data = bytes(_frame(0)) + damaged + bytes(_frame(1, broken_first_pack=True)) + bytes(_frame(2, timecode=False))
+    index = scan_dv_buffer(data, use_numpy=False)
+    assert index.offsets == [0, DV_FRAME_SIZE_PAL + 1000, 2 * DV_FRAME_SIZE_PAL + 1000]
+    assert index.timecodes == [1020000, 1020101, -1]
+
+
+def test_avi_and_max_frames():
+    index = scan_dv_buffer(_avi([_frame(s) for s in range(4)]), max_frames=3, use_numpy=False)
+    assert len(index) == 3
+    assert [index.rec_times[i] % 100 for i in range(3)] == [0, 1, 2]
+
+
+def test_non_dv_data_is_rejected_quickly():
+    assert len(scan_dv_buffer(b"\x00\x00\x00\x18ftypisom" + bytes(10 * DV_FRAME_SIZE_PAL), use_numpy=False)) == 0
+
+
+def test_numpy_matches_python():
+    pytest.importorskip("numpy")
+    data = bytes(_frame(0, broken_first_pack=True)) + bytes(5) + bytes(_frame(1, timecode=False)) + bytes(_frame(2))
+    python = scan_dv_buffer(data, use_numpy=False)
+    vectorized = scan_dv_buffer(data, use_numpy=True)
+    assert vectorized.backend == "numpy"
+    for column in ("offsets", "flags", "timecodes", "rec_dates", "rec_times"):
+        assert getattr(vectorized, column) == getattr(python, column)
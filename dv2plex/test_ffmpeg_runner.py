@@ -0,0 +1,55 @@
+import os
+import sys
+from pathlib import Path
+
+from dv2plex.ffmpeg_runner import ProgressParser, run_ffmpeg, with_progress_args
+
+
+_FAKE_FFMPEG = """#!{python}
+import sys
+assert sys.argv[1:4] == ["-progress", "pipe:2", "-nostats"], sys.argv
+for i in range(500):
+    sys.stderr.write(f"[dv @ 0x1] Concealing bitstream errors {{i}}\\n")
+for frame in (250, 500):
+    sys.stderr.write(
+        f"frame={{frame}}\\nfps=125.00\\nbitrate=1200.0kbits/s\\ntotal_size=4096\\n"
+        f"out_time_us={{frame * 40000}}\\nout_time=00:00:10.000000\\ndup_frames=0\\ndrop_frames=2\\n"
+        f"speed=5.0x\\nprogress={{'end' if frame == 500 else 'continue'}}\\n"
+    )
+sys.stderr.write("frame=  500 fps=125 q=-1.0 Lsize=4kB time=00:00:20.00 bitrate=1.6kbits/s speed=5x\\n")
+"""
+
+
+def test_run_ffmpeg_reports_percent_and_keeps_bounded_tail(tmp_path: Path):
+    script = tmp_path / "ffmpeg"
+    script.write_text(_FAKE_FFMPEG.format(python=sys.executable), encoding="utf-8")
+    os.chmod(script, 0o755)
+    updates = []
+
+    result = run_ffmpeg(
+        [str(script), "-stats", "-i", "in.avi", "out.mp4"],
+        duration=40.0,
+        progress_callback=lambda p: updates.append((p.percent, p.eta)),
+        tail_lines=50,
+    )
+
+    assert result.returncode == 0
+    assert "-stats" not in result.args
+    # 10 s von 40 s bei 5x Tempo: noch 6 s
+    assert updates[0] == (25.0, 6.0)
+    assert updates[1][0] == 100.0 and updates[1][1] == 0.0
+    assert result.progress.frame == 500 and result.progress.drop_frames == 2
+    lines = result.stderr.splitlines()
+    assert len(lines) == 50
+    assert lines[-1].startswith("frame=  500")
+    assert not any(line.startswith("out_time_us=") for line in lines)
+
+
+def test_parser_falls_back_to_frame_count():
+    parser = ProgressParser(total_frames=1000)
+    for line in ("frame=100", "fps=50.0", "speed=N/A", "progress=continue"):
+        parser.feed(line)
+    assert parser.progress.percent == 10.0
+    assert parser.progress.speed == 0.0
+    assert parser.feed("frame=  100 fps= 50 q=-1.0 size=1kB") is None
+    assert with_progress_args(["ffmpeg", "-progress", "pipe:1", "-i", "x"]) == ["ffmpeg", "-progress", "pipe:1", "-i", "x"]
@@ -0,0 +1,87 @@
+from pathlib import Path
+from types import SimpleNamespace
+
+from dv2plex import incremental_merge
+from dv2plex.incremental_merge import IncrementalMerger
+from dv2plex.split_manifest import SplitManifest
+from dv2plex.test_dv_dif import _frame
+
+
+def _fake_ffmpeg(monkeypatch, calls: list):
+    def fake_run_ffmpeg(cmd, duration=None, progress_callback=None, **_kwargs):
+        lists = [Path(cmd[i + 1]) for i, arg in enumerate(cmd[:-1]) if arg == "-i" and cmd[i + 1].endswith(".txt")]
+        calls.append(SimpleNamespace(cmd=cmd, duration=duration, lists=[p.read_text() for p in lists]))
+        Path(cmd[-1]).write_bytes(b"out")
+        return SimpleNamespace(returncode=0, stderr="")
+
+    monkeypatch.setattr(incremental_merge, "run_ffmpeg", fake_run_ffmpeg)
+
+
+def _splits(tmp_path: Path) -> list:
+    # Dateiname (dvgrab-Zeit) weicht absichtlich von der Aufnahmezeit in den DV-Daten ab
+    splits_dir = tmp_path / "LowRes" / "splits"
+    splits_dir.mkdir(parents=True)
+    splits = []
+    for i in range(3):
+        split = splits_dir / f"dvgrab-2000.01.01_00-00-0{i}.dv"
+        split.write_bytes(b"".join(_frame(10 * i + s) for s in range(2)))
+        splits.append(split)
+    return splits
+
+
+def test_segments_resume_and_final_stream_copy(monkeypatch, tmp_path: Path):
+    calls = []
+    _fake_ffmpeg(monkeypatch, calls)
+    splits = _splits(tmp_path)
+    splits_dir = splits[0].parent
+
+    first = IncrementalMerger(Path("ffmpeg"), splits_dir, timestamp_mode="burn")
+    first.segments_dir.mkdir(parents=True)
+    manifest = SplitManifest(splits_dir)
+    assert first._encode_segment(splits[0], manifest.ensure([splits[0]])[splits[0].name])
+    assert first.is_encoded(splits[0])
+    assert (first.segments_dir / "seg_dvgrab-2000.01.01_00-00-00.mp4").exists()
+    encode = calls[0].cmd
+    assert "-an" in encode
+    assert "1999-12-24 23\\:59\\:00" in encode[encode.index("-vf") + 1]
+    assert calls[0].duration == 0.08
+
+    # Neuer Merger (z.B. nach Absturz): Segment 0 wird übernommen, nicht neu kodiert
+    calls.clear()
+    resumed = IncrementalMerger(Path("ffmpeg"), splits_dir, timestamp_mode="burn")
+    assert resumed.is_encoded(splits[0])
+    output = tmp_path / "Movie.mp4"
+    assert resumed.finish(output, manifest=SplitManifest(splits_dir)) == output
+
+    encoded = [c.cmd[c.cmd.index("-i") + 1] for c in calls if "libx264" in c.cmd]
+    assert encoded == [str(splits[1]), str(splits[2])]
+    assert "1999-12-24 23\\:59\\:20" in calls[1].cmd[calls[1].cmd.index("-vf") + 1]
+
+    audio, concat = calls[-2], calls[-1]
+    assert audio.cmd[-1].endswith("audio.m4a") and "-vn" in audio.cmd
+    assert [line.rsplit("/", 1)[-1] for line in audio.lists[0].splitlines()] == [f"{s.name}'" for s in splits]
+
+    assert concat.cmd[-1] == str(output)
+    assert concat.cmd[concat.cmd.index("-c") + 1] == "copy"
+    assert "-map" in concat.cmd and "1:a?" in concat.cmd
+    assert [line.rsplit("/", 1)[-1] for line in concat.lists[0].splitlines()] == [
+        f"seg_{s.stem}.mp4'" for s in splits
+    ]
+    assert not resumed.segments_dir.exists()
+
+
+def test_changed_split_is_encoded_again(monkeypatch, tmp_path: Path):
+    calls = []
+    _fake_ffmpeg(monkeypatch, calls)
+    splits = _splits(tmp_path)
+    merger = IncrementalMerger(Path("ffmpeg"), splits[0].parent, timestamp_mode="off")
+    merger.segments_dir.mkdir(parents=True)
+    assert merger._encode_segment(splits[0])
+    assert "-vf" not in calls[0].cmd
+
+    assert IncrementalMerger(Path("ffmpeg"), splits[0].parent, timestamp_mode="off").is_encoded(splits[0])
+    # Andere Overlay-Einstellung: Manifest wird verworfen
+    assert not IncrementalMerger(Path("ffmpeg"), splits[0].parent, timestamp_mode="burn").is_encoded(splits[0])
+
+    splits[0].write_bytes(splits[0].read_bytes() + bytes(_frame(2)))
+    assert not IncrementalMerger(Path("ffmpeg"), splits[0].parent, timestamp_mode="off").is_encoded(splits[0])
@@ -0,0 +1,48 @@
+from pathlib import Path
+
+from dv2plex.job_store import (
+    KIND_MERGE,
+    KIND_POSTPROCESS,
+    MAX_ATTEMPTS,
+    STATUS_COMPLETED,
+    STATUS_FAILED,
+    STATUS_PENDING,
+    JobStore,
+)
+
+
+def test_recover_requeues_interrupted_jobs_with_checkpoints(tmp_path: Path):
+    path = tmp_path / "jobs.sqlite3"
+    store = JobStore(path)
+    done = store.add(KIND_MERGE, {"title": "fertig"})
+    interrupted = store.add(KIND_MERGE, {"title": "unterbrochen"})
+    urgent = store.add(KIND_MERGE, {"title": "dringend"}, priority=5)
+    other = store.add(KIND_POSTPROCESS, {"movie_dir": "/x"})
+    store.start(done)
+    store.finish(done, True, "ok")
+    store.start(interrupted)
+    store.checkpoint(interrupted, "manifest", {"splits": 3})
+    store.close()
+
+    # Neustart: neue Verbindung auf dieselbe Datei
+    store = JobStore(path)
+    jobs = store.recover(KIND_MERGE)
+    assert [j["id"] for j in jobs] == [urgent, interrupted]
+    assert jobs[1]["status"] == STATUS_PENDING
+    assert jobs[1]["checkpoints"] == {"manifest": {"splits": 3}}
+    assert jobs[1]["params"] == {"title": "unterbrochen"}
+    assert store.get(done)["status"] == STATUS_COMPLETED
+    assert store.get(other)["status"] == STATUS_PENDING
+    store.close()
+
+
+def test_recover_gives_up_after_max_attempts(tmp_path: Path):
+    store = JobStore(tmp_path / "jobs.sqlite3")
+    job_id = store.add(KIND_POSTPROCESS, {"movie_dir": "/x"})
+    for _ in range(MAX_ATTEMPTS):
+        store.start(job_id)
+    assert store.recover(KIND_POSTPROCESS) == []
+    job = store.get(job_id)
+    assert job["status"] == STATUS_FAILED
+    assert job["attempts"] == MAX_ATTEMPTS
+    store.close()
@@ -0,0 +1,136 @@
+import subprocess
+import sys
+import threading
+import time
+from pathlib import Path
+
+import pytest
+
+from dv2plex import job_control
+from dv2plex.merge_scheduler import POLICY_NICE, POLICY_PAUSE, STATE_PAUSED, MergeScheduler
+
+
+class _Job:
+    def __init__(self, title):
+        self.title = title
+
+
+def _wait_for(condition, timeout=3.0):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if condition():
+            return True
+        time.sleep(0.01)
+    return False
+
+
+def test_higher_priority_starts_first():
+    started = []
+    gate = threading.Event()
+
+    def run(job):
+        started.append(job.title)
+        gate.wait(2)
+
+    scheduler = MergeScheduler(run, lambda: False, max_workers=1, poll_interval=0.02)
+    scheduler.submit(_Job("blocker"))
+    scheduler.start()
+    assert _wait_for(lambda: started == ["blocker"])
+    low, high, normal = _Job("low"), _Job("high"), _Job("normal")
+    scheduler.submit(low, priority=-1)
+    scheduler.submit(normal)
+    scheduler.submit(high)
+    assert scheduler.set_priority(high, 5)
+    assert [j.title for j in scheduler.pending_jobs()] == ["high", "normal", "low"]
+    gate.set()
+    assert _wait_for(lambda: len(started) == 4)
+    scheduler.stop()
+    assert started == ["blocker", "high", "normal", "low"]
+
+
+def test_capture_limits_admission():
+    capturing = [True]
+    running = []
+    gate = threading.Event()
+
+    def run(job):
+        running.append(job.title)
+        gate.wait(2)
+
+    scheduler = MergeScheduler(
+        run, lambda: capturing[0], max_workers=3, capture_policy=POLICY_NICE, capture_workers=1, poll_interval=0.02
+    )
+    scheduler.start()
+    assert _wait_for(lambda: scheduler.capture_active)
+    for n in range(3):
+        scheduler.submit(_Job(str(n)))
+    assert _wait_for(lambda: len(running) == 1)
+    time.sleep(0.1)
+    assert len(running) == 1
+
+    scheduler.configure(capture_policy=POLICY_PAUSE)
+    capturing[0] = False
+    assert _wait_for(lambda: len(running) == 3)
+    gate.set()
+    assert _wait_for(lambda: not scheduler.has_work())
+    scheduler.stop()
+
+
+def test_pause_stops_running_child_process():
+    if not Path("/proc/self/stat").exists():
+        pytest.skip("/proc nicht verfügbar")
+    capturing = [False]
+    pids = []
+
+    def run(job):
+        control = job_control.current_control()
+        with subprocess.Popen(["sleep", "5"]) as process:
+            control.attach(process)
+            pids.append(process.pid)
+            _wait_for(lambda: not capturing[0] and job.resumed, timeout=5)
+            process.kill()
+
+    def state(pid):
+        return Path(f"/proc/{pid}/stat").read_text().split(") ")[1][0]
+
+    job = _Job("tape")
+    job.resumed = False
+    scheduler = MergeScheduler(run, lambda: capturing[0], capture_policy=POLICY_PAUSE, poll_interval=0.02)
+    scheduler.submit(job)
+    scheduler.start()
+    assert _wait_for(lambda: pids)
+    capturing[0] = True
+    assert _wait_for(lambda: state(pids[0]) == "T")
+    assert scheduler.worker_states()[0]["state"] == STATE_PAUSED
+    capturing[0] = False
+    assert _wait_for(lambda: state(pids[0]) != "T")
+    job.resumed = True
+    assert _wait_for(lambda: not scheduler.has_work(), timeout=5)
+    scheduler.stop()
+
+
+def test_throttle_reaches_worker_threads():
+    if not Path("/proc/self/task").exists():
+        pytest.skip("/proc nicht verfügbar")
+    script = "import threading, time; threading.Thread(target=time.sleep, args=(5,)).start(); time.sleep(5)"
+
+    def niceness(pid, tid):
+        return int(Path(f"/proc/{pid}/task/{tid}/stat").read_text().split(") ")[1].split()[16])
+
+    control = job_control.JobControl("tape")
+    with subprocess.Popen([sys.executable, "-c", script]) as process:
+        try:
+            tasks = Path(f"/proc/{process.pid}/task")
+            assert _wait_for(lambda: len(list(tasks.iterdir())) == 2)
+            worker = next(int(t.name) for t in tasks.iterdir() if int(t.name) != process.pid)
+            control.attach(process)
+            assert control.set_niceness(job_control.NICE_THROTTLED)
+            assert niceness(process.pid, worker) == job_control.NICE_THROTTLED
+
+            # Zurücksetzen klappt nur mit CAP_SYS_NICE; sonst bleibt der Job als gedrosselt markiert
+            restored = control.set_niceness(job_control.NICE_NORMAL)
+            assert niceness(process.pid, worker) == (job_control.NICE_NORMAL if restored else job_control.NICE_THROTTLED)
+            assert control.niceness == niceness(process.pid, worker)
+        finally:
+            control.detach(process)
+            process.kill()
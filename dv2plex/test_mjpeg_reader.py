@@ -0,0 +1,46 @@
+import io
+
+from dv2plex.mjpeg_reader import MJPEGFrameExtractor
+
+
+def _jpeg(i: int, size: int = 1000) -> bytes:
+    return b"\xff\xd8" + bytes([i % 250]) * size + b"\xff\xd9"
+
+
+def test_frames_split_across_reads_and_buffer_wrap():
+    frames = [_jpeg(i, 3000 + i) for i in range(50)]
+    got = []
+    extractor = MJPEGFrameExtractor(got.append, buffer_size=16 * 1024, read_size=7 * 1024 + 1)
+    # Garbage vor dem ersten Frame, Marker liegen über Read-Grenzen hinweg
+    extractor.run(io.BytesIO(b"\x00\xff" + b"".join(frames)))
+    assert got == frames
+    assert extractor.frames_skipped == 0
+    assert extractor.overflows == 0
+
+
+def test_feed_byte_by_byte():
+    frames = [_jpeg(1, 10), _jpeg(2, 20)]
+    got = []
+    extractor = MJPEGFrameExtractor(got.append, buffer_size=1024, read_size=64)
+    for b in b"".join(frames):
+        extractor.feed(bytes([b]))
+    assert got == frames
+
+
+def test_throttled_frames_are_skipped():
+    ticks = iter(i * 0.04 for i in range(100))
+    got = []
+    extractor = MJPEGFrameExtractor(got.append, max_fps=10, clock=lambda: next(ticks))
+    extractor.feed(b"".join(_jpeg(i) for i in range(25)))
+    assert extractor.frames_seen == 25
+    assert len(got) == extractor.frames_emitted
+    assert 8 <= len(got) <= 10
+    assert extractor.frames_skipped == 25 - len(got)
+
+
+def test_oversized_frame_is_dropped():
+    got = []
+    extractor = MJPEGFrameExtractor(got.append, buffer_size=4096, read_size=1024)
+    extractor.feed(_jpeg(1, 10000) + _jpeg(2, 100))
+    assert extractor.overflows >= 1
+    assert got[-1] == _jpeg(2, 100)
@@ -0,0 +1,32 @@
+from dv2plex.parallel_encode import parse_frame_stats, plan_chunks, sections_from_boundaries
+from dv2plex.timestamp_overlay import TimestampCue, window_cues
+
+
+def test_chunks_cut_only_at_section_boundaries():
+    lengths = [750, 750, 100, 1400, 750, 750, 750]
+    chunks = plan_chunks(lengths, workers=2, min_length=500)
+    assert chunks[0][0] == 0 and chunks[-1][1] == len(lengths)
+    assert all(a[1] == b[0] for a, b in zip(chunks, chunks[1:]))
+    assert len(chunks) == 4
+    assert all(sum(lengths[a:b]) >= 500 for a, b in chunks)
+
+
+def test_short_material_is_not_split():
+    assert plan_chunks([100, 100], workers=8, min_length=750) == [(0, 2)]
+    assert plan_chunks([], workers=4) == []
+
+
+def test_boundaries_snap_to_frame_grid():
+    assert sections_from_boundaries([0.0, 1.02, 2.0, 2.0, 99.0], 25.0, 100) == [26, 24, 50]
+
+
+def test_last_stats_line_wins():
+    stderr = "frame=  120 fps=0.0 q=28.0\rframe= 2500 fps=310 q=-1.0 Lsize=1kB dup=2 drop=1 speed=12x\n"
+    assert parse_frame_stats(stderr) == (2500, 2, 1)
+    assert parse_frame_stats("Error opening input") == (None, 0, 0)
+
+
+def test_cues_are_shifted_into_chunk_window():
+    cues = [TimestampCue(0.0, 4.0, "a"), TimestampCue(28.0, 32.0, "b"), TimestampCue(60.0, 64.0, "c")]
+    window = window_cues(cues, 30.0, 60.0)
+    assert [(c.start, c.end, c.text) for c in window] == [(0.0, 2.0, "b")]
@@ -0,0 +1,101 @@
+import threading
+import time
+from pathlib import Path
+
+from dv2plex.pipeline import (
+    RESOURCE_IO,
+    RESOURCE_MODEL,
+    STAGE_EXPORT,
+    STAGE_MERGE,
+    STAGE_POSTER,
+    STAGE_UPSCALE,
+    STATE_COMPLETED,
+    STATE_FAILED,
+    PipelineScheduler,
+    ResourceBudget,
+)
+
+
+class _Config(dict):
+    def get(self, key, default=None):
+        return super().get(key, default)
+
+
+def test_downstream_stages_follow_enabled_edges():
+    config = _Config({"capture.auto_upscale": True, "capture.auto_poster": True, "capture.auto_export": True})
+    pipeline = PipelineScheduler(config, resources=ResourceBudget())
+    queued = []
+    for stage in (STAGE_UPSCALE, STAGE_POSTER, STAGE_EXPORT):
+        pipeline.register_executor(stage, lambda project, result, stage=stage: queued.append(stage) or True)
+    project = Path("/DV_Import/Urlaub (2001)")
+
+    pipeline.on_stage(project, STAGE_MERGE, STATE_COMPLETED, {"path": "movie_merged.mp4"})
+    assert queued == [STAGE_UPSCALE]
+    pipeline.on_stage(project, STAGE_UPSCALE, STATE_COMPLETED)
+    # Export wartet auf das Poster; ein fehlgeschlagenes Poster blockiert ihn nicht
+    assert queued == [STAGE_UPSCALE, STAGE_POSTER]
+    pipeline.on_stage(project, STAGE_POSTER, STATE_FAILED)
+    assert queued == [STAGE_UPSCALE, STAGE_POSTER, STAGE_EXPORT]
+
+    config["capture.auto_poster"] = False
+    other = Path("/DV_Import/Hochzeit (1999)")
+    pipeline.on_stage(other, STAGE_UPSCALE, STATE_COMPLETED)
+    assert queued[-1] == STAGE_EXPORT and queued.count(STAGE_POSTER) == 1
+    assert pipeline.status()["projects"]["Hochzeit (1999)"][STAGE_EXPORT] == "queued"
+
+
+def test_resource_budget_limits_concurrency():
+    budget = ResourceBudget({RESOURCE_MODEL: 1})
+    active, peak = [0], [0]
+    lock = threading.Lock()
+
+    def work():
+        with budget.acquire(RESOURCE_MODEL, "upscale"):
+            with lock:
+                active[0] += 1
+                peak[0] = max(peak[0], active[0])
+            time.sleep(0.02)
+            with lock:
+                active[0] -= 1
+
+    threads = [threading.Thread(target=work) for _ in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert peak[0] == 1
+    assert budget.status()[RESOURCE_MODEL]["in_use"] == 0
+
+
+def test_waiting_model_tasks_do_not_block_other_resources():
+    budget = ResourceBudget({RESOURCE_MODEL: 1, RESOURCE_IO: 1})
+    pipeline = PipelineScheduler(_Config(), resources=budget)
+    upscale_done = threading.Event()
+    started = []
+    exported = threading.Event()
+
+    def upscale():
+        with budget.acquire(RESOURCE_MODEL, "Upscale"):
+            started.append("upscale")
+            upscale_done.wait(5)
+
+    worker = threading.Thread(target=upscale)
+    worker.start()
+    while not started:
+        time.sleep(0.01)
+    # Cover und Vorschau warten auf den Modell-Slot, der Export läuft trotzdem sofort
+    pipeline.run_task("Cover", lambda: started.append("cover"), RESOURCE_MODEL)
+    pipeline.run_task("Vorschau", lambda: started.append("preview"), RESOURCE_MODEL)
+    pipeline.run_task("Export", exported.set, RESOURCE_IO)
+    pipeline.run_task("Export-All", lambda: started.append("export-all"))
+    assert exported.wait(1)
+    assert budget.status()[RESOURCE_MODEL]["waiting"] == 2
+    assert pipeline.status()["queued_tasks"] == 2
+
+    upscale_done.set()
+    worker.join()
+    deadline = time.monotonic() + 2
+    while (len(started) < 4 or budget.status()[RESOURCE_MODEL]["in_use"]) and time.monotonic() < deadline:
+        time.sleep(0.01)
+    assert [name for name in started if name in ("cover", "preview")] == ["cover", "preview"]
+    assert budget.status()[RESOURCE_MODEL]["in_use"] == 0
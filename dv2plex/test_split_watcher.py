@@ -0,0 +1,66 @@
+import time
+from pathlib import Path
+
+from dv2plex.split_watcher import EVENT_COMPLETED, EVENT_CREATED, SplitWatcher
+
+
+def _wait(predicate, timeout: float = 2.0) -> bool:
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if predicate():
+            return True
+        time.sleep(0.01)
+    return predicate()
+
+
+def _grow_and_close(watcher: SplitWatcher, splits_dir: Path):
+    events = []
+    watcher.subscribe(lambda event, path: events.append((event, path.name)))
+    old = splits_dir / "dvgrab-001.dv"
+    old.write_bytes(b"x" * 10)  # vor dem Start vorhanden: gilt als fertig
+    watcher.start()
+    try:
+        assert watcher.is_completed(old)
+
+        split = splits_dir / "dvgrab-002.dv"
+        (splits_dir / "notes.txt").write_text("kein Split")
+        with open(split, "wb") as f:
+            f.write(b"x" * 100)
+            f.flush()
+            assert _wait(lambda: split in watcher.known_files())
+            for _ in range(10):  # Datei wächst weiter: darf nicht als fertig gelten
+                f.write(b"x" * 100)
+                f.flush()
+                time.sleep(0.02)
+                assert not watcher.is_completed(split)
+            assert not watcher.wait_until_idle(timeout=0.01, quiet_period=0.05)
+
+        assert watcher.wait_for_file(split, timeout=2)
+        assert watcher.wait_until_idle(timeout=2, quiet_period=0.05)
+        assert watcher.known_files() == [old, split]
+        assert watcher.completed_files() == [old, split]
+        assert events[:2] == [(EVENT_CREATED, old.name), (EVENT_COMPLETED, old.name)]
+        assert events.count((EVENT_CREATED, split.name)) == 1
+        assert events[-1] == (EVENT_COMPLETED, split.name)
+    finally:
+        watcher.stop()
+
+
+def test_polling_fallback(tmp_path: Path):
+    watcher = SplitWatcher(tmp_path, poll_interval=0.05, use_inotify=False)
+    _grow_and_close(watcher, tmp_path)
+    assert watcher.mode == "stopped"
+
+
+def test_inotify(tmp_path: Path):
+    watcher = SplitWatcher(tmp_path, poll_interval=0.05)
+    _grow_and_close(watcher, tmp_path)
+
+
+def test_wait_for_file_times_out_for_unknown_file(tmp_path: Path):
+    watcher = SplitWatcher(tmp_path, poll_interval=0.05, use_inotify=False)
+    watcher.start()
+    try:
+        assert not watcher.wait_for_file(tmp_path / "dvgrab-999.dv", timeout=0.1)
+    finally:
+        watcher.stop()
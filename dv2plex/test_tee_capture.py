@@ -0,0 +1,94 @@
+import io
+import threading
+
+from dv2plex.dv_dif import DV_FRAME_SIZE_PAL
+from dv2plex.tee_capture import DVFrameRing, TeeCapture
+from dv2plex.test_dv_dif import _frame
+
+
+def _write(ring: DVFrameRing, payloads, close: bool = True):
+    for payload in payloads:
+        slot = ring.acquire_write_slot()
+        if slot is None:
+            return
+        slot[:] = payload
+        ring.commit()
+    if close:
+        ring.close()
+
+
+def _drain(ring: DVFrameRing, consumer) -> list:
+    seen = []
+    while not ring.eof(consumer):
+        item = ring.read(consumer, timeout=1.0)
+        if item is None:
+            continue
+        seq, frame = item
+        seen.append(bytes(frame))
+        ring.release(consumer, seq)
+    return seen
+
+
+def test_ring_wraps_without_losing_lossless_frames():
+    ring = DVFrameRing(frame_size=2, slots=4)
+    analyzer = ring.add_consumer("analyzer")
+    writer = ring.add_consumer("writer", after=analyzer)
+    payloads = [bytes([i, i]) for i in range(20)]
+    threading.Thread(target=_write, args=(ring, payloads), daemon=True).start()
+
+    got_writer = []
+    thread = threading.Thread(target=lambda: got_writer.extend(_drain(ring, writer)), daemon=True)
+    thread.start()
+    assert _drain(ring, analyzer) == payloads
+    thread.join(5)
+    assert got_writer == payloads
+
+
+def test_stalled_lossy_consumer_does_not_block_writer():
+    ring = DVFrameRing(frame_size=2, slots=4)
+    preview = ring.add_consumer("preview", lossless=False)
+    _write(ring, [bytes([0, 0])], close=False)
+    seq, held = ring.read(preview)  # hängender Preview-ffmpeg: Frame wird nie freigegeben
+
+    done = threading.Event()
+    threading.Thread(target=lambda: (_write(ring, [bytes([i, i]) for i in range(1, 20)]), done.set()), daemon=True).start()
+    assert done.wait(5)
+    assert bytes(held) == bytes([0, 0])  # Kopie, vom Schreiber nicht überschrieben
+
+    ring.release(preview, seq)
+    _, frame = ring.read(preview)
+    assert bytes(frame) == bytes([19, 19])  # springt auf das neueste Frame
+    assert preview.dropped > 0
+
+
+class _Sink:
+    def __init__(self):
+        self.data = bytearray()
+
+    def write(self, chunk):
+        self.data += chunk
+        return len(chunk)
+
+    def close(self):
+        pass
+
+
+def test_tee_capture_resyncs_and_splits_on_recording_gap(tmp_path):
+    frames = [_frame(0), _frame(1), _frame(2), _frame(30)]
+    stream = bytes(frames[0]) + b"\x00" * 1000 + b"".join(bytes(f) for f in frames[1:])
+    sink = _Sink()
+    tee = TeeCapture(io.BytesIO(stream), tmp_path, preview_sink=sink, ring_slots=8)
+    tee.start()
+    assert tee.stop(timeout=10)
+
+    stats = tee.stats()
+    assert stats["frames"] == 4
+    assert stats["resyncs"] == 1
+    assert stats["timecode"] == "01:02:30:05"
+    assert [p.name for p in tee.writer.files] == [
+        "dvgrab-1999.12.24_23-59-00.dv",
+        "dvgrab-1999.12.24_23-59-30.dv",
+    ]
+    assert (tmp_path / "dvgrab-1999.12.24_23-59-00.dv").read_bytes() == b"".join(bytes(f) for f in frames[:3])
+    assert (tmp_path / "dvgrab-1999.12.24_23-59-30.dv").stat().st_size == DV_FRAME_SIZE_PAL
+    assert len(sink.data) % DV_FRAME_SIZE_PAL == 0 and sink.data[:DV_FRAME_SIZE_PAL] == frames[0]
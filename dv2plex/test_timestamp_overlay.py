@@ -0,0 +1,37 @@
+from datetime import datetime
+from pathlib import Path
+
+from dv2plex.timestamp_overlay import (
+    burn_filter,
+    cues_from_offsets,
+    cues_from_splits,
+    escape_filter_path,
+    write_ass,
+)
+
+
+def test_cues_follow_split_durations_and_do_not_overlap():
+    t = datetime(2001, 6, 30, 1, 42, 2)
+    cues = cues_from_splits([t, t, None, t], [2.5, 10.0, 30.0, 2.0], display_seconds=4)
+    assert [(c.start, c.end) for c in cues] == [(0.0, 2.5), (2.5, 6.5), (42.5, 46.5)]
+    assert cues[0].text == "2001-06-30 01:42:02"
+
+
+def test_offsets_without_base_show_running_time():
+    cues = cues_from_offsets(None, [3725.4, 10.0], display_seconds=4)
+    assert [c.text for c in cues] == ["00:00:10", "01:02:05"]
+    based = cues_from_offsets(datetime(2001, 1, 1, 23, 59, 0), [90.0])
+    assert based[0].text == "2001-01-02 00:00:30"
+
+
+def test_ass_has_one_event_per_cue(tmp_path: Path):
+    cues = cues_from_splits([datetime(2001, 6, 30, 1, 42, 2)] * 400, [30.0] * 400)
+    path = write_ass(cues, tmp_path / "ts.ass")
+    events = [line for line in path.read_text(encoding="utf-8").splitlines() if line.startswith("Dialogue:")]
+    assert len(events) == 400
+    assert events[-1].startswith("Dialogue: 0,3:19:30.00,3:19:34.00,Timestamp,")
+
+
+def test_filter_path_escaping():
+    assert burn_filter(Path("/srv/Film (2001)/ts.ass")) == "subtitles=filename=/srv/Film (2001)/ts.ass"
+    assert escape_filter_path(Path("/a/it's:[x],y.ass")) == "/a/it\\\\\\'s\\\\:\\[x\\]\\,y.ass"
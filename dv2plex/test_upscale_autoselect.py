@@ -0,0 +1,63 @@
+import subprocess
+from pathlib import Path
+
+import dv2plex.upscale_autoselect as autoselect
+
+
+class _FakeClock:
+    def __init__(self):
+        self.now = 0.0
+
+    def perf_counter(self):
+        return self.now
+
+
+class _FakeEngine:
+    """Rechensekunden pro Sekunde Video je Modell; Modell-Laden kostet pauschal 30 s"""
+
+    def __init__(self, clock, rates):
+        self.clock = clock
+        self.rates = rates
+        self.tried = []
+
+    def upscale(self, sample, output_path, profile, progress_hook=None, status_hook=None, crop=None):
+        self.tried.append(profile["model"])
+        self.clock.now += 30
+        for pct in range(0, 101, 10):
+            progress_hook(pct)
+            self.clock.now += self.rates[profile["model"]] * 10 * 0.1
+        return True
+
+
+def test_picks_best_candidate_within_budget(monkeypatch, tmp_path: Path):
+    clock = _FakeClock()
+    engine = _FakeEngine(clock, {"x4plus": 20.0, "general": 3.0, "anime": 1.0})
+    profiles = {
+        "hq": {"model": "x4plus"},
+        "compact": {"model": "general"},
+        "tiny": {"model": "anime"},
+    }
+    auto = {"backend": "auto", "candidates": ["hq", "missing", "compact", "tiny"], "time_budget_hours": 5}
+
+    monkeypatch.setattr(autoselect, "time", clock)
+    # 90-Minuten-Band, Probe 10 s
+    monkeypatch.setattr(
+        autoselect, "probe_duration", lambda path, **kwargs: 5400.0 if "band" in Path(path).name else 10.0
+    )
+
+    def fake_run_ffmpeg(cmd, **kwargs):
+        Path(cmd[-1]).write_bytes(b"probe")
+        return subprocess.CompletedProcess(cmd, 0, "", "")
+
+    monkeypatch.setattr(autoselect, "run_ffmpeg", fake_run_ffmpeg)
+    tape = tmp_path / "band.avi"
+    tape.write_bytes(b"dv")
+    selector = autoselect.AutoProfileSelector(engine)
+
+    # x4plus: 20 s/s * 5400 s = 30 h > 5 h; general: 4.5 h passt (Laden zählt nicht)
+    assert selector.select(tape, auto, profiles) == ("compact", profiles["compact"])
+    assert engine.tried == ["x4plus", "general"]
+
+    # Zu knappes Budget: schnellster Kandidat
+    auto["time_budget_hours"] = 1
+    assert selector.select(tape, auto, profiles)[0] == "tiny"
@@ -0,0 +1,24 @@
+from dv2plex.upscale_preview import SCENE_OFFSET_SECONDS, format_size, pick_clip_starts
+
+
+def test_clips_spread_evenly_without_scene_changes():
+    assert pick_clip_starts(100.0, 5, 3.0) == [8.5, 28.5, 48.5, 68.5, 88.5]
+
+
+def test_clips_start_after_nearest_scene_change():
+    starts = pick_clip_starts(100.0, 2, 3.0, scene_changes=[5.0, 20.0, 30.0, 90.0])
+    assert starts == [20.0 + SCENE_OFFSET_SECONDS, 90.0 + SCENE_OFFSET_SECONDS]
+
+
+def test_clips_stay_out_of_dead_segments():
+    # Zweite Hälfte ist Bluescreen: kein Clip und kein Szenenwechsel dort
+    live = [(0.0, 50.0)]
+    starts = pick_clip_starts(100.0, 4, 3.0, scene_changes=[70.0], live_ranges=live)
+    assert starts == [11.0, 36.0, 47.0]
+    assert all(start + 3.0 <= 50.0 for start in starts)
+
+
+def test_short_video_and_sizes():
+    assert pick_clip_starts(2.0, 5, 3.0) == [0.0]
+    assert format_size(512) == "512 B"
+    assert format_size(3 * 1024 ** 3) == "3.0 GB"
@@ -0,0 +1,50 @@
+from pathlib import Path
+
+from dv2plex.upscale_worker import UpscaleWorker
+
+
+# Ersetzt upscale_server.py: gleiches Protokoll, "Modell" ist ein Zähler im Prozess
+_FAKE_SERVER = """
+import argparse, os, sys
+from multiprocessing.connection import Listener
+parser = argparse.ArgumentParser()
+parser.add_argument('--address'); parser.add_argument('--idle_timeout'); parser.add_argument('--parent_pid')
+opts = parser.parse_args()
+listener = Listener(opts.address, authkey=bytes.fromhex(os.environ['DV2PLEX_UPSCALE_AUTHKEY']))
+loads = 0
+while True:
+    conn = listener.accept()
+    argv = conn.recv()['argv']
+    if argv[0] == 'crash':
+        os._exit(3)
+    if loads == 0:
+        loads += 1
+        conn.send({'type': 'status', 'message': 'Modell geladen'})
+    else:
+        conn.send({'type': 'status', 'message': 'Modell aus dem Speicher'})
+    for done in (1, 2):
+        conn.send({'type': 'progress', 'done': done, 'total': 2})
+    conn.send({'type': 'done', 'ok': True, 'error': str(os.getpid())})
+    conn.close()
+"""
+
+
+def test_worker_stays_warm_and_restarts_after_crash(tmp_path: Path):
+    script = tmp_path / "inference_realesrgan_video.py"
+    script.write_text("", encoding="utf-8")
+    (tmp_path / "upscale_server.py").write_text(_FAKE_SERVER, encoding="utf-8")
+    worker = UpscaleWorker(script, idle_timeout=60)
+    statuses, progress = [], []
+    try:
+        ok, first_pid = worker.run(["-i", "a.mp4"], lambda done, total: progress.append(done), statuses.append)
+        assert ok and progress == [1, 2]
+        ok, second_pid = worker.run(["-i", "b.mp4"], status_callback=statuses.append)
+        assert ok and second_pid == first_pid
+        assert statuses == ["Modell geladen", "Modell aus dem Speicher"]
+
+        ok, error = worker.run(["crash"])
+        assert not ok and "abgestürzt" in error
+        ok, third_pid = worker.run(["-i", "c.mp4"])
+        assert ok and third_pid != first_pid
+    finally:
+        worker.stop()
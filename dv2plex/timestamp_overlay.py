@@ -0,0 +1,168 @@
+"""
+Timestamp-Overlay als Untertitel: eine ASS-Datei statt einer drawtext-Kette
+
+Alle Einblendungen (Aufnahmezeit je Split bzw. je Szene) landen als Events in einer
+ASS-Datei. Eingebrannt wird sie mit genau einem subtitles-Filter (libass rendert pro Frame
+nur das gerade aktive Event), die Kosten pro Frame hängen also nicht von der Anzahl der
+Splits ab und die Kommandozeile bleibt kurz. Alternativ wird dieselbe Datei als weiche
+Untertitelspur (MP4: mov_text) gemuxt bzw. als Sidecar neben das Video gelegt – ohne Encode.
+"""
+
+import re
+from dataclasses import dataclass
+from datetime import datetime, timedelta
+from pathlib import Path
+from typing import Iterable, List, Optional, Tuple
+
+
+MODE_BURN = "burn"  # in das Bild eingebrannt (subtitles-Filter)
+MODE_SOFT = "soft"  # weiche Untertitelspur / Sidecar, kein Re-Encode
+MODE_OFF = "off"
+MODES = (MODE_BURN, MODE_SOFT, MODE_OFF)
+
+TIMESTAMP_FORMAT = "%Y-%m-%d %H:%M:%S"
+SUBTITLE_TITLE = "Aufnahmezeit"
+
+# Gleiche Optik wie das bisherige drawtext-Overlay: 24px weiß, halbtransparente Box, unten links
+ASS_HEADER = """[Script Info]
+ScriptType: v4.00+
+PlayResX: {width}
+PlayResY: {height}
+WrapStyle: 2
+ScaledBorderAndShadow: yes
+
+[V4+ Styles]
+Format: Name, Fontname, Fontsize, PrimaryColour, SecondaryColour, OutlineColour, BackColour, Bold, Italic, Underline, StrikeOut, ScaleX, ScaleY, Spacing, Angle, BorderStyle, Outline, Shadow, Alignment, MarginL, MarginR, MarginV, Encoding
+Style: Timestamp,Sans,24,&H00FFFFFF,&H00FFFFFF,&H80000000,&H80000000,0,0,0,0,100,100,0,0,3,2,0,1,10,10,10,1
+
+[Events]
+Format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text
+"""
+
+
+@dataclass
+class TimestampCue:
+    """Eine Einblendung: Text von start bis end (Sekunden im Video)"""
+
+    start: float
+    end: float
+    text: str
+
+
+def normalize_mode(mode: Optional[str]) -> str:
+    return mode if mode in MODES else MODE_BURN
+
+
+def cues_from_splits(
+    timestamps: Iterable[Optional[datetime]],
+    durations: Iterable[float],
+    display_seconds: float = 4,
+) -> List[TimestampCue]:
+    """Eine Einblendung am Anfang jedes Splits mit Aufnahmezeit (Splits ohne Zeit zählen nur zur Dauer)."""
+    starts: List[Tuple[float, datetime]] = []
+    current_time = 0.0
+    for timestamp, duration in zip(timestamps, durations):
+        if timestamp:
+            starts.append((current_time, timestamp))
+        current_time += duration
+    return _cues_from_starts(starts, display_seconds)
+
+
+def cues_from_offsets(
+    base: Optional[datetime],
+    offsets: Iterable[float],
+    display_seconds: float = 4,
+) -> List[TimestampCue]:
+    """Einblendungen an festen Zeitpunkten (z.B. Szenenwechsel): Startzeit + Offset bzw. Laufzeit."""
+    starts = []
+    for offset in sorted(offsets):
+        if base:
+            starts.append((offset, base + timedelta(seconds=int(offset))))
+        else:
+            starts.append((offset, None))
+    return _cues_from_starts(starts, display_seconds)
+
+
+def _cues_from_starts(starts, display_seconds: float) -> List[TimestampCue]:
+    cues = []
+    for i, (start, timestamp) in enumerate(starts):
+        end = start + display_seconds
+        # Nicht in die nächste Einblendung hineinragen (kurze Splits/Szenen)
+        if i + 1 < len(starts):
+            end = min(end, starts[i + 1][0])
+        if end <= start:
+            continue
+        if timestamp is None:
+            text = _format_clock(start)
+        else:
+            text = timestamp.strftime(TIMESTAMP_FORMAT)
+        cues.append(TimestampCue(start, end, text))
+    return cues
+
+
+def window_cues(cues: List[TimestampCue], start: float, end: float) -> List[TimestampCue]:
+    """Einblendungen im Zeitfenster [start, end), auf den Fensteranfang verschoben (Chunk-Encode)"""
+    result = []
+    for cue in cues:
+        cue_start = max(cue.start, start)
+        cue_end = min(cue.end, end)
+        if cue_end > cue_start:
+            result.append(TimestampCue(cue_start - start, cue_end - start, cue.text))
+    return result
+
+
+def _format_clock(seconds: float) -> str:
+    total = int(seconds)
+    return f"{total // 3600:02d}:{total // 60 % 60:02d}:{total % 60:02d}"
+
+
+def _ass_time(seconds: float) -> str:
+    centis = int(round(seconds * 100))
+    h, rest = divmod(centis, 360000)
+    m, rest = divmod(rest, 6000)
+    s, cs = divmod(rest, 100)
+    return f"{h}:{m:02d}:{s:02d}.{cs:02d}"
+
+
+def _ass_text(text: str) -> str:
+    return text.replace("\\", "\\\\").replace("{", "\\{").replace("}", "\\}").replace("\n", "\\N")
+
+
+def write_ass(cues: List[TimestampCue], path: Path, width: int = 720, height: int = 576) -> Path:
+    """Schreibt die Einblendungen als ASS-Datei (PlayRes = DV-Auflösung, libass skaliert)."""
+    path = Path(path)
+    lines = [ASS_HEADER.format(width=width, height=height)]
+    for cue in cues:
+        lines.append(
+            f"Dialogue: 0,{_ass_time(cue.start)},{_ass_time(cue.end)},Timestamp,,0,0,0,,{_ass_text(cue.text)}\n"
+        )
+    path.write_text("".join(lines), encoding="utf-8")
+    return path
+
+
+def escape_filter_path(path: Path) -> str:
+    """Escaping eines Pfads als Filter-Optionswert innerhalb eines Filtergraphen (zwei Ebenen)."""
+    value = str(path).replace("\\", "\\\\").replace("'", "\\'").replace(":", "\\:")
+    return re.sub(r"([\\'\[\],;])", r"\\\1", value)
+
+
+def burn_filter(ass_path: Path) -> str:
+    """Ein einziger subtitles-Filter für alle Einblendungen"""
+    return f"subtitles=filename={escape_filter_path(ass_path)}"
+
+
+def soft_subtitle_args(subtitle_input_index: int, audio_input_index: int = 0) -> List[str]:
+    """Mapping/Codec-Argumente, um die ASS-Datei als mov_text-Spur in ein MP4 zu muxen."""
+    return [
+        "-map", "0:v",
+        "-map", f"{audio_input_index}:a?",
+        "-map", f"{subtitle_input_index}:0",
+        "-c:s", "mov_text",
+        "-metadata:s:s:0", f"title={SUBTITLE_TITLE}",
+        "-disposition:s:0", "default",
+    ]
+
+
+def sidecar_path(video_path: Path) -> Path:
+    """Sidecar-Untertitel neben dem Video (von Plex automatisch erkannt)"""
+    return Path(video_path).with_suffix(".ass")
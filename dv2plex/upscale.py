@@ -4,15 +4,41 @@ Upscale-Engine für Real-ESRGAN Video-Integration
 
 import subprocess
 import sys
+import time
+from collections import deque
 from pathlib import Path
-from typing import Dict, Any, Optional, Callable
+from typing import Dict, Any, List, Optional, Callable, Tuple
 import logging
+import re
+
+from .crop_detect import CropArea
+from .ffmpeg_runner import STDERR_TAIL_LINES, FFmpegProgress, FFmpegResult, probe_duration, run_ffmpeg
+from .upscale_worker import UpscaleWorker
+
+
+FINAL_SIZE_4K = "3840x2160"
+# Anteil des Modells am Fortschritt im zweistufigen Modus (Rest: 4K-Encode)
+MODEL_PROGRESS_SHARE = 85
+# Unveränderte Frames (Standbilder, Kamera-Pause) übernehmen die vorige Ausgabe: mittlere Abweichung
+# (0-255) je 32x32-Block, ab der neu gerechnet wird. 0 = aus; pro Profil per skip_threshold einschalten
+DEFAULT_SKIP_THRESHOLD = 0
+# tqdm-Zeile des Skripts, z.B. "inference:  42%|████      | 1234/2934 [01:02<01:25, 19.8frame/s]"
+_TQDM_RE = re.compile(r"(\d+)/(\d+) \[")
 
 
 class UpscaleEngine:
     """Verwaltet Video-Upscaling mit Real-ESRGAN Video-Skript"""
     
-    def __init__(self, realesrgan_path: Path, ffmpeg_path: Optional[Path] = None, log_callback: Optional[Callable] = None):
+    def __init__(
+        self,
+        realesrgan_path: Path,
+        ffmpeg_path: Optional[Path] = None,
+        log_callback: Optional[Callable] = None,
+        worker: Optional[UpscaleWorker] = None,
+        device: str = "auto",
+        cpu_processes: int = 0,
+        cpu_threads: int = 2,
+    ):
         """
         Initialisiert die Upscale-Engine
         
@@ -20,12 +46,21 @@ class UpscaleEngine:
             realesrgan_path: Pfad zu inference_realesrgan_video.py
             ffmpeg_path: Pfad zu ffmpeg (wird vom Skript benötigt)
             log_callback: Optionaler Callback für Log-Nachrichten
+            worker: Optionaler warmer Real-ESRGAN-Worker (sonst ein Skript-Prozess pro Job)
+            device: "auto", "cpu" oder "cuda" (auto: CUDA falls vorhanden)
+            cpu_processes: Parallele Modell-Prozesse auf der CPU (0 = physische Kerne / cpu_threads)
+            cpu_threads: Rechen-Threads je CPU-Prozess
         """
         self.realesrgan_path = realesrgan_path
         self.ffmpeg_path = ffmpeg_path
         self.log_callback = log_callback
+        self.worker = worker
+        self.device = device
+        self.cpu_processes = cpu_processes
+        self.cpu_threads = cpu_threads
         self.logger = logging.getLogger(__name__)
         self.process: Optional[subprocess.Popen] = None
+        self._worker_job = False
     
     def upscale(
         self,
@@ -33,6 +68,9 @@ class UpscaleEngine:
         output_path: Path,
         profile: Dict[str, Any],
         progress_hook: Optional[Callable[[int], None]] = None,
+        status_hook: Optional[Callable[[str], None]] = None,
+        passthrough_ranges: Optional[List[Tuple[float, float]]] = None,
+        crop: Optional[CropArea] = None,
     ) -> bool:
         """
         Führt Video-Upscaling mit Real-ESRGAN Video-Skript durch (direkt Video-zu-Video)
@@ -41,6 +79,12 @@ class UpscaleEngine:
             input_path: Pfad zur Eingabedatei (movie_merged.avi)
             output_path: Pfad zur Ausgabedatei (4K-Video)
             profile: Upscaling-Profil (aus Config)
+            progress_hook: Optionaler Callback mit Prozent der ffmpeg-Stufe
+            status_hook: Optionaler Callback mit Fortschrittstext (Prozent, fps, Tempo, ETA)
+            passthrough_ranges: Zeitbereiche (s), die statt mit dem Modell nur mit Lanczos skaliert
+                werden (tote Abschnitte, siehe dead_segments)
+            crop: Sichtbarer Bildbereich (siehe crop_detect); nur er geht durchs Modell, die
+                Ausgabegröße folgt seinem Seitenverhältnis statt fest 3840x2160
         
         Returns:
             True wenn erfolgreich, False bei Fehler
@@ -56,7 +100,7 @@ class UpscaleEngine:
         
         # Prüfe ob ffmpeg-only Backend
         if backend == "ffmpeg":
-            return self._ffmpeg_only_upscale(input_path, output_path, profile)
+            return self._ffmpeg_only_upscale(input_path, output_path, profile, progress_hook, status_hook, crop)
         
         # Real-ESRGAN Backend
         if not self.realesrgan_path.exists():
@@ -77,8 +121,8 @@ class UpscaleEngine:
             model_name = profile.get("model", "RealESRGAN_x4plus")
             target_scale = profile.get("scale_factor", 4)
             
-            # Verwende 2x für Real-ESRGAN (schneller)
-            realesrgan_scale = 2
+            # Ausgabegröße des Modells (Standard 2x; kompakte SRVGG-Modelle sind günstig genug für 4x)
+            realesrgan_scale = profile.get("model_scale", 2) if target_scale > 2 else 2
             tile_size = profile.get("tile_size", 400)  # 400 für bessere Performance
             tile_pad = profile.get("tile_pad", 10)
             
@@ -87,65 +131,91 @@ class UpscaleEngine:
                 str(self.realesrgan_path),
                 "-i", str(input_path),
                 "-n", model_name,
-                "-s", str(realesrgan_scale),  # Immer 2x für Real-ESRGAN
+                "-s", str(realesrgan_scale),
                 "-o", str(temp_output_dir),
                 "--tile", str(tile_size),
                 "--tile_pad", str(tile_pad),
                 "--num_process_per_gpu", "1"
             ]
+            if "denoise_strength" in profile:
+                # realesr-general-x4v3: DNI-Mischung mit der wdn-Variante (0 = Rauschen behalten, 1 = stark entrauschen)
+                cmd.extend(["-dn", str(profile["denoise_strength"])])
             
-            # Füge ffmpeg-Pfad hinzu falls vorhanden
-            if self.ffmpeg_path and self.ffmpeg_path.exists():
-                cmd.extend(["--ffmpeg_bin", str(self.ffmpeg_path)])
+            # ONNX Runtime (CPU): Modell wird beim ersten Lauf exportiert und unter weights/onnx gecacht
+            if backend == "onnx":
+                if not self._script_supports("--backend"):
+                    self.log("ONNX-Backend benötigt das mitgelieferte Real-ESRGAN-Skript")
+                    return False
+                cmd.extend(["--backend", "onnx"])
+                if profile.get("quantize") == "int8":
+                    cmd.append("--int8")
             
-            self.log(f"Real-ESRGAN Video-Befehl: {' '.join(cmd)}")
+            # Duplikat-Erkennung vor dem Modell (skip_tile_size > 0: pro Kachel statt ganzer Frame)
+            if self._script_supports("--skip_threshold"):
+                cmd.extend([
+                    "--skip_threshold", str(profile.get("skip_threshold", DEFAULT_SKIP_THRESHOLD)),
+                    "--skip_tile_size", str(profile.get("skip_tile_size", 0)),
+                ])
             
-            # Starte Prozess
-            self.process = subprocess.Popen(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True,
-                cwd=str(self.realesrgan_path.parent),
-                bufsize=1
-            )
+            if crop and crop.is_cropped:
+                if self._script_supports("--crop"):
+                    cmd.extend(["--crop", f"{crop.width}:{crop.height}:{crop.x}:{crop.y}"])
+                else:
+                    self.log("Real-ESRGAN-Skript kennt --crop nicht, skaliere das volle Bild")
+                    crop = crop.uncropped()
+            final_size = self._final_size(crop, target_scale)
             
-            # Zeige Fortschritt (stderr enthält Progress-Info)
-            import time
-            last_log_time = time.time()
+            if passthrough_ranges:
+                if self._script_supports("--passthrough_ranges"):
+                    cmd.extend([
+                        "--passthrough_ranges",
+                        ",".join(f"{start:.3f}-{end:.3f}" for start, end in passthrough_ranges),
+                    ])
+                else:
+                    self.log("Real-ESRGAN-Skript kennt --passthrough_ranges nicht, tote Abschnitte laufen durchs Modell")
             
-            while True:
-                returncode = self.process.poll()
-                if returncode is not None:
-                    break
-                
-                # Lese stderr für Fortschrittsanzeige
-                try:
-                    line = self.process.stderr.readline()
-                    if line:
-                        line = line.strip()
-                        if line and ("%" in line or "frame" in line.lower() or "fps" in line.lower()):
-                            # Zeige Fortschritt alle 2 Sekunden
-                            current_time = time.time()
-                            if current_time - last_log_time >= 2.0:
-                                self.log(f"Real-ESRGAN: {line}")
-                                last_log_time = current_time
-                except:
-                    pass
-                
-                time.sleep(0.1)
+            # CPU-Modus: mehrere Prozesse mit festen Thread-Zahlen bearbeiten Frame-Abschnitte parallel
+            if self._script_supports("--cpu_threads"):
+                cmd.extend([
+                    "--device", "cpu" if backend == "onnx" else self.device,
+                    "--num_process", str(profile.get("processes", self.cpu_processes)),
+                    "--cpu_threads", str(profile.get("threads", self.cpu_threads)),
+                ])
+            
+            # Füge ffmpeg-Pfad hinzu falls vorhanden
+            if self.ffmpeg_path and self.ffmpeg_path.exists():
+                cmd.extend(["--ffmpeg_bin", str(self.ffmpeg_path)])
             
-            # Warte auf vollständige Beendigung
-            stdout, stderr = self.process.communicate()
+            # Fusioniert: Modell-Frames gehen direkt in ein ffmpeg, das auf 4K skaliert und final
+            # kodiert (kein Zwischen-MP4, kein zweiter Decode/Encode, keine GB an Temp-Daten)
+            fused = profile.get("fused", True) and self._script_supports("--final_size")
+            partial_path = output_path.with_name(f"{output_path.stem}.part{output_path.suffix}")
+            if fused:
+                cmd.extend([
+                    "--save_path", str(partial_path),
+                    "--vcodec", profile.get("encoder", "libx264"),
+                    "--encoder_options", self._encoder_options_arg(profile),
+                ])
+                if target_scale > 2:
+                    cmd.extend(["--final_size", final_size])
             
-            if returncode != 0:
-                self.log(f"Real-ESRGAN-Fehler (Code {returncode})")
-                if stderr:
-                    self.log(f"stderr: {stderr[-2000:]}")
-                if stdout:
-                    self.log(f"stdout: {stdout[-1000:]}")
+            self.log(f"Real-ESRGAN Video-Befehl: {' '.join(cmd)}")
+            
+            # Zweistufig zählt das Modell bis MODEL_PROGRESS_SHARE, der 4K-Encode den Rest
+            model_share = 100 if fused or target_scale <= 2 else MODEL_PROGRESS_SHARE
+            if not self._run_realesrgan(cmd, progress_hook, status_hook, model_share):
+                if fused:
+                    partial_path.unlink(missing_ok=True)
                 return False
             
+            if fused:
+                if not partial_path.exists():
+                    self.log(f"Real-ESRGAN hat keine Ausgabe erzeugt: {partial_path}")
+                    return False
+                partial_path.replace(output_path)
+                self.log(f"Video erfolgreich erstellt (Modell → {final_size if target_scale > 2 else f'{realesrgan_scale}x'} in einem Durchgang): {output_path}")
+                return True
+            
             # Finde Output-Datei (Skript erstellt: input_name_out.mp4)
             input_stem = input_path.stem
             realesrgan_output = temp_output_dir / f"{input_stem}_out.mp4"
@@ -161,13 +231,18 @@ class UpscaleEngine:
                     self.log(f"Verfügbare Dateien: {list(temp_output_dir.iterdir())}")
                     return False
             
-            self.log(f"Real-ESRGAN 2x abgeschlossen: {realesrgan_output}")
+            self.log(f"Real-ESRGAN {realesrgan_scale}x abgeschlossen: {realesrgan_output}")
             
             # Schritt 2: ffmpeg auf 4K hochskalieren (wenn target_scale > 2)
-            target_scale = profile.get("scale_factor", 4)
             if target_scale > 2:
                 self.log(f"Skaliere mit ffmpeg auf {target_scale}x (4K)...")
-                if not self._ffmpeg_upscale_to_4k(realesrgan_output, output_path, profile, progress_hook):
+                encode_hook = None
+                if progress_hook:
+                    def encode_hook(pct: int):
+                        progress_hook(model_share + (100 - model_share) * pct // 100)
+                if not self._ffmpeg_upscale_to_4k(
+                    realesrgan_output, output_path, profile, encode_hook, status_hook, final_size
+                ):
                     return False
             else:
                 # Wenn target_scale <= 2, kopiere einfach die Real-ESRGAN Ausgabe
@@ -190,7 +265,106 @@ class UpscaleEngine:
             except:
                 pass
     
-    def _ffmpeg_only_upscale(self, input_video: Path, output_path: Path, profile: Dict[str, Any], progress_hook: Optional[Callable[[int], None]] = None) -> bool:
+    def _run_realesrgan(
+        self,
+        cmd: List[str],
+        progress_hook: Optional[Callable[[int], None]],
+        status_hook: Optional[Callable[[str], None]],
+        share: int,
+    ) -> bool:
+        """Startet Real-ESRGAN (warmer Worker oder Skript-Prozess); Frame-Fortschritt geht an die Hooks"""
+        last_percent = [-1]
+
+        def on_frames(done: int, total: int):
+            if total <= 0:
+                return
+            percent = min(100, done * 100 // total)
+            if percent == last_percent[0]:
+                return
+            last_percent[0] = percent
+            if progress_hook:
+                progress_hook(share * percent // 100)
+            if status_hook:
+                status_hook(f"{percent}% · Frame {done}/{total}")
+
+        if self.worker and self.worker.available():
+            # cmd = [python, Skript, Argumente...]: der Worker bekommt nur die Argumente
+            self._worker_job = True
+            try:
+                ok, error = self.worker.run(cmd[2:], progress_callback=on_frames)
+            finally:
+                self._worker_job = False
+            if not ok:
+                self.log(f"Real-ESRGAN-Fehler (Worker): {error}")
+            return ok
+
+        # stdout und stderr zusammen, nur das Ende wird behalten
+        self.process = subprocess.Popen(
+            cmd,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            text=True,
+            cwd=str(self.realesrgan_path.parent),
+            bufsize=1
+        )
+        
+        tail: deque = deque(maxlen=STDERR_TAIL_LINES)
+        last_log_time = time.time()
+        for line in self.process.stdout:
+            line = line.strip()
+            if not line:
+                continue
+            tail.append(line)
+            match = _TQDM_RE.search(line)
+            if match:
+                on_frames(int(match.group(1)), int(match.group(2)))
+            if line.startswith("skipped "):
+                self.log(f"Real-ESRGAN Duplikate: {line}")
+            elif "%" in line or "frame" in line.lower() or "fps" in line.lower():
+                # Zeige Fortschritt alle 2 Sekunden
+                current_time = time.time()
+                if current_time - last_log_time >= 2.0:
+                    self.log(f"Real-ESRGAN: {line}")
+                    last_log_time = current_time
+        returncode = self.process.wait()
+        
+        if returncode != 0:
+            self.log(f"Real-ESRGAN-Fehler (Code {returncode})")
+            self.log("Ausgabe: " + "\n".join(list(tail)[-30:]))
+            return False
+        return True
+    
+    def _script_supports(self, option: str) -> bool:
+        """Kennt das Real-ESRGAN-Skript die Option (mitgelieferte Version, z.B. --final_size)?"""
+        try:
+            return option in self.realesrgan_path.read_text(encoding="utf-8", errors="ignore")
+        except OSError:
+            return False
+    
+    @staticmethod
+    def _final_size(crop: Optional[CropArea], scale_factor: float) -> str:
+        """Zielgröße "BxH": 4K (bzw. 1080p bei Faktor 2) im Seitenverhältnis des Ausschnitts"""
+        if crop is None:
+            return FINAL_SIZE_4K if scale_factor > 2 else "1920x1080"
+        width, height = crop.output_size(int(960 * scale_factor), int(540 * scale_factor))
+        return f"{width}x{height}"
+    
+    @staticmethod
+    def _encoder_options_arg(profile: Dict[str, Any]) -> str:
+        """Encoder-Optionen des Profils wie beim 4K-Encode (preset veryfast, crf 18)"""
+        options = {"preset": "veryfast", "crf": 18}
+        options.update(profile.get("encoder_options", {}))
+        return ",".join(f"{key}={value}" for key, value in options.items())
+    
+    def _ffmpeg_only_upscale(
+        self,
+        input_video: Path,
+        output_path: Path,
+        profile: Dict[str, Any],
+        progress_hook: Optional[Callable[[int], None]] = None,
+        status_hook: Optional[Callable[[str], None]] = None,
+        crop: Optional[CropArea] = None,
+    ) -> bool:
         """Nur ffmpeg Upscaling (schnell, keine AI) - einfacher Ansatz"""
         if not self.ffmpeg_path or not self.ffmpeg_path.exists():
             self.log("ffmpeg nicht gefunden")
@@ -200,7 +374,11 @@ class UpscaleEngine:
         encoder_options = profile.get("encoder_options", {})
         
         # Bestimme Ziel-Auflösung basierend auf scale_factor
-        if scale_factor == 4:
+        if crop:
+            # Ausschnitt zuschneiden, quadratische Pixel im Seitenverhältnis des Ausschnitts
+            width, height = self._final_size(crop, scale_factor).split("x")
+            scale_filter = f"{crop.filter},scale={width}:{height}:flags=lanczos,setsar=1"
+        elif scale_factor == 4:
             scale_filter = "scale=3840:2160:flags=lanczos"
         elif scale_factor == 2:
             scale_filter = "scale=1920:1080:flags=lanczos"
@@ -221,66 +399,13 @@ class UpscaleEngine:
         
         try:
             self.log(f"ffmpeg-only Upscaling ({scale_factor}x): {' '.join(cmd)}")
-            self.process = subprocess.Popen(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True,
-                bufsize=1
-            )
-            
-            # Zeige Fortschritt
-            import time
-            last_log_time = time.time()
-            stderr_lines = []
-            last_progress = 0
-            
-            while True:
-                returncode = self.process.poll()
-                if returncode is not None:
-                    break
-                
-                try:
-                    line = self.process.stderr.readline()
-                    if line:
-                        line = line.strip()
-                        stderr_lines.append(line)
-                        if line.startswith("frame=") or ("fps=" in line and "size=" in line):
-                            current_time = time.time()
-                            if current_time - last_log_time >= 2.0:
-                                self.log(f"ffmpeg: {line[:100]}")
-                                last_log_time = current_time
-                            if progress_hook:
-                                try:
-                                    if "frame=" in line:
-                                        parts = line.split()
-                                        for p in parts:
-                                            if p.startswith("frame="):
-                                                frame_val = int(p.split("=")[1])
-                                                est = min(100, max(last_progress, int(frame_val / 3000 * 100)))
-                                                last_progress = est
-                                                progress_hook(est)
-                                                break
-                                except Exception:
-                                    pass
-                except:
-                    pass
-                
-                time.sleep(0.1)
-            
-            # Warte auf vollständige Beendigung
-            stdout, stderr = self.process.communicate()
-            
-            # Kombiniere alle stderr-Lines
-            full_stderr = "\n".join(stderr_lines)
-            if stderr:
-                full_stderr += "\n" + stderr
+            result = self._run_ffmpeg(cmd, input_video, progress_hook, status_hook)
             
-            if returncode != 0:
+            if result.returncode != 0:
                 # Zeige nur relevante Fehler (ohne "Concealing bitstream errors")
-                error_lines = [l for l in full_stderr.split("\n") if l and "Concealing" not in l and "repeated" not in l and "AC EOB" not in l]
+                error_lines = [l for l in result.stderr.split("\n") if l and "Concealing" not in l and "repeated" not in l and "AC EOB" not in l]
                 error_msg = "\n".join(error_lines[-20:])
-                self.log(f"ffmpeg Upscaling Fehler (Code {returncode}): {error_msg}")
+                self.log(f"ffmpeg Upscaling Fehler (Code {result.returncode}): {error_msg}")
                 return False
             
             if output_path.exists():
@@ -294,7 +419,15 @@ class UpscaleEngine:
             self.log(f"Fehler beim ffmpeg Upscaling: {e}")
             return False
     
-    def _ffmpeg_upscale_to_4k(self, input_video: Path, output_path: Path, profile: Dict[str, Any], progress_hook: Optional[Callable[[int], None]] = None) -> bool:
+    def _ffmpeg_upscale_to_4k(
+        self,
+        input_video: Path,
+        output_path: Path,
+        profile: Dict[str, Any],
+        progress_hook: Optional[Callable[[int], None]] = None,
+        status_hook: Optional[Callable[[str], None]] = None,
+        final_size: str = FINAL_SIZE_4K,
+    ) -> bool:
         """Skaliert Video mit ffmpeg schnell auf 4K hoch (Lanczos)"""
         if not self.ffmpeg_path or not self.ffmpeg_path.exists():
             self.log("ffmpeg nicht gefunden für 4K-Upscaling")
@@ -304,10 +437,11 @@ class UpscaleEngine:
         encoder_options = profile.get("encoder_options", {})
         
         # ffmpeg-Befehl für schnelles 4K-Upscaling
+        width, height = final_size.split("x")
         cmd = [
             str(self.ffmpeg_path),
             "-i", str(input_video),
-            "-vf", "scale=3840:2160:flags=lanczos",  # 4K mit Lanczos
+            "-vf", f"scale={width}:{height}:flags=lanczos,setsar=1",  # 4K mit Lanczos
             "-c:v", encoder,
             "-preset", "veryfast",  # Schnell
             "-crf", str(encoder_options.get("crf", 18)),  # Qualität aus Profil
@@ -324,54 +458,10 @@ class UpscaleEngine:
         
         try:
             self.log(f"ffmpeg 4K-Upscaling: {' '.join(cmd)}")
-            self.process = subprocess.Popen(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True
-            )
-            import time
-            last_log_time = time.time()
-            last_progress = 0
-            stderr_lines = []
-
-            while True:
-                returncode = self.process.poll()
-                if returncode is not None:
-                    break
-
-                try:
-                    line = self.process.stderr.readline()
-                    if line:
-                        line = line.strip()
-                        stderr_lines.append(line)
-                        if line.startswith("frame=") or ("fps=" in line and "size=" in line):
-                            current_time = time.time()
-                            if current_time - last_log_time >= 2.0:
-                                self.log(f"ffmpeg: {line[:100]}")
-                                last_log_time = current_time
-                            if progress_hook:
-                                try:
-                                    if "frame=" in line:
-                                        parts = line.split()
-                                        for p in parts:
-                                            if p.startswith("frame="):
-                                                frame_val = int(p.split("=")[1])
-                                                est = min(100, max(last_progress, int(frame_val / 4000 * 100)))
-                                                last_progress = est
-                                                progress_hook(est)
-                                                break
-                                except Exception:
-                                    pass
-                except:
-                    pass
-
-                time.sleep(0.1)
-
-            stdout, stderr = self.process.communicate()
+            result = self._run_ffmpeg(cmd, input_video, progress_hook, status_hook)
             
-            if self.process.returncode != 0:
-                self.log(f"ffmpeg 4K-Upscaling Fehler: {stderr[-1000:]}")
+            if result.returncode != 0:
+                self.log(f"ffmpeg 4K-Upscaling Fehler: {result.stderr[-1000:]}")
                 return False
             
             if output_path.exists():
@@ -385,15 +475,45 @@ class UpscaleEngine:
             self.log(f"Fehler beim 4K-Upscaling: {e}")
             return False
     
+    def _run_ffmpeg(
+        self,
+        cmd: List[str],
+        input_video: Path,
+        progress_hook: Optional[Callable[[int], None]] = None,
+        status_hook: Optional[Callable[[str], None]] = None,
+    ) -> FFmpegResult:
+        """ffmpeg mit Fortschritt über die Eingangsdauer (Prozent an progress_hook, fps/ETA an status_hook)"""
+        duration = probe_duration(input_video, ffmpeg_path=self.ffmpeg_path)
+        last_log_time = [0.0]
+
+        def on_progress(progress: FFmpegProgress):
+            current_time = time.time()
+            if current_time - last_log_time[0] >= 2.0:
+                self.log(f"ffmpeg: {progress.describe()}")
+                last_log_time[0] = current_time
+            if status_hook:
+                status_hook(progress.describe())
+            if progress_hook and progress.percent is not None:
+                progress_hook(int(progress.percent))
+
+        return run_ffmpeg(cmd, duration=duration, progress_callback=on_progress, on_start=self._set_process)
+
+    def _set_process(self, process: subprocess.Popen):
+        self.process = process
+
     def is_running(self) -> bool:
         """Prüft ob Upscaling läuft"""
+        if self._worker_job:
+            return True
         if self.process is None:
             return False
         return self.process.poll() is None
     
     def stop(self):
         """Stoppt laufendes Upscaling (falls möglich)"""
-        if self.process and self.is_running():
+        if self._worker_job and self.worker:
+            self.worker.cancel()
+        if self.process and self.process.poll() is None:
             try:
                 self.process.terminate()
                 self.process.wait(timeout=5)
@@ -0,0 +1,151 @@
+"""
+Automatische Modellwahl für das Upscaling (Profil mit "backend": "auto")
+
+Schneidet eine kurze Probe aus dem tatsächlichen Band, skaliert sie nacheinander mit den
+Kandidaten-Profilen (beste Qualität zuerst) und nimmt das erste, dessen gemessenes Tempo das
+ganze Band innerhalb von `time_budget_hours` schafft. Gemessen wird zwischen erstem und letztem
+Frame-Fortschritt, Modell-Laden und Prozessstart zählen also nicht mit. Schafft es keiner, wird
+der letzte (schnellste) Kandidat genommen.
+
+Beispiel (settings.json):
+    "auto": {
+        "backend": "auto",
+        "candidates": ["realesrgan_4x_balanced", "realesr_general_4x", "realesr_animevideo_4x", "ffmpeg_fast"],
+        "time_budget_hours": 12,
+        "sample_seconds": 10
+    }
+"""
+
+import shutil
+import tempfile
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+from .crop_detect import CropArea
+from .ffmpeg_runner import format_duration, probe_duration, run_ffmpeg
+from .upscale import UpscaleEngine
+
+
+DEFAULT_TIME_BUDGET_HOURS = 12.0
+DEFAULT_SAMPLE_SECONDS = 10.0
+
+
+def measure_rate(
+    engine: UpscaleEngine,
+    sample: Path,
+    sample_duration: float,
+    profile: Dict[str, Any],
+    output_path: Path,
+    crop: Optional[CropArea] = None,
+) -> Optional[float]:
+    """
+    Skaliert die Probe mit dem Profil und misst das Tempo
+
+    Returns:
+        Rechensekunden pro Sekunde Video (None wenn das Profil fehlschlägt)
+    """
+    updates: List[Tuple[float, int]] = []
+
+    def on_progress(pct: int):
+        if not updates or updates[-1][1] != pct:
+            updates.append((time.perf_counter(), pct))
+
+    start = time.perf_counter()
+    ok = engine.upscale(sample, output_path, profile, progress_hook=on_progress, crop=crop)
+    elapsed = time.perf_counter() - start
+    if not ok:
+        return None
+    if len(updates) >= 2 and updates[-1][1] > updates[0][1]:
+        (first_time, first_pct), (last_time, last_pct) = updates[0], updates[-1]
+        return max(1e-6, (last_time - first_time) / ((last_pct - first_pct) / 100 * sample_duration))
+    # Kein verwertbarer Fortschritt: ganze Laufzeit (inkl. Start) als obere Schranke
+    return elapsed / sample_duration
+
+
+class AutoProfileSelector:
+    """Wählt per Probelauf das beste Profil, das in das Zeitbudget passt"""
+
+    def __init__(
+        self,
+        engine: UpscaleEngine,
+        ffmpeg_path: Optional[Path] = None,
+        log_callback: Optional[Callable[[str], None]] = None,
+    ):
+        self.engine = engine
+        self.ffmpeg_path = ffmpeg_path
+        self.log_callback = log_callback
+
+    def select(
+        self,
+        input_path: Path,
+        auto_profile: Dict[str, Any],
+        profiles: Dict[str, Dict[str, Any]],
+        status_hook: Optional[Callable[[str], None]] = None,
+        crop: Optional[CropArea] = None,
+    ) -> Tuple[Optional[str], Dict[str, Any]]:
+        """
+        Args:
+            crop: Bildausschnitt wie beim eigentlichen Upscale (weniger Pixel, schnelleres Tempo)
+
+        Returns:
+            (Profilname, Profil) - (None, {}) wenn kein Kandidat verwendbar ist
+        """
+        candidates = [
+            name for name in auto_profile.get("candidates", [])
+            if name in profiles and profiles[name].get("backend") != "auto"
+        ]
+        if not candidates:
+            self.log("Auto-Profil: keine gültigen Kandidaten konfiguriert")
+            return None, {}
+
+        budget = float(auto_profile.get("time_budget_hours", DEFAULT_TIME_BUDGET_HOURS)) * 3600
+        ffmpeg = str(self.ffmpeg_path) if self.ffmpeg_path else "ffmpeg"
+        duration = probe_duration(input_path, ffmpeg_path=self.ffmpeg_path)
+        if not duration:
+            self.log(f"Auto-Profil: Dauer von {input_path.name} unbekannt, nehme {candidates[0]}")
+            return candidates[0], profiles[candidates[0]]
+
+        sample_duration = min(float(auto_profile.get("sample_seconds", DEFAULT_SAMPLE_SECONDS)), duration)
+        work_dir = Path(tempfile.mkdtemp(prefix="dv2plex_autoselect_"))
+        try:
+            sample = work_dir / f"sample{input_path.suffix}"
+            # Probe aus der Bandmitte (Anfang ist oft Vorlauf/Bluescreen), Stream-Copy ohne Neukodierung
+            start = max(0.0, duration / 2 - sample_duration / 2)
+            result = run_ffmpeg([
+                ffmpeg, "-hide_banner", "-nostdin", "-y",
+                "-ss", f"{start:.3f}", "-i", str(input_path), "-t", f"{sample_duration:.3f}",
+                "-map", "0:v:0", "-map", "0:a?", "-c", "copy", str(sample),
+            ])
+            if result.returncode != 0 or not sample.exists():
+                self.log(f"Auto-Profil: Probe konnte nicht geschnitten werden, nehme {candidates[-1]}")
+                return candidates[-1], profiles[candidates[-1]]
+            sample_duration = probe_duration(sample, ffmpeg_path=self.ffmpeg_path) or sample_duration
+
+            self.log(
+                f"Auto-Profil: Band {format_duration(duration)}, Budget {format_duration(budget)}, "
+                f"Probe {sample_duration:.0f} s"
+            )
+            for name in candidates:
+                if status_hook:
+                    status_hook(f"Modellwahl: teste {name}")
+                rate = measure_rate(self.engine, sample, sample_duration, profiles[name], work_dir / f"{name}.mp4", crop)
+                if rate is None:
+                    self.log(f"Auto-Profil: {name} fehlgeschlagen, überspringe")
+                    continue
+                estimate = rate * duration
+                fits = estimate <= budget
+                self.log(
+                    f"Auto-Profil: {name} {1 / rate:.2f}x Echtzeit, geschätzt {format_duration(estimate)}"
+                    + (" - passt" if fits else " - zu langsam")
+                )
+                if fits:
+                    return name, profiles[name]
+            self.log(f"Auto-Profil: kein Kandidat passt ins Budget, nehme den schnellsten ({candidates[-1]})")
+            return candidates[-1], profiles[candidates[-1]]
+        finally:
+            shutil.rmtree(work_dir, ignore_errors=True)
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
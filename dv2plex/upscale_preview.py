@@ -0,0 +1,257 @@
+"""
+Profil-Vorschau: wenige kurze Clips statt eines ganzen Bandes
+
+Schneidet `count` Clips zu `clip_seconds` aus dem gemergten LowRes-Film (bevorzugt direkt nach
+einem Szenenwechsel, außerhalb toter Abschnitte; beides aus der gecachten VideoAnalysis), skaliert
+sie mit jedem gewählten Profil und liefert pro Clip Standbilder zum Vergleich (Quelle per Lanczos
+und je Profil) sowie pro Profil das gemessene Tempo, die hochgerechnete Gesamtdauer und -größe.
+
+Tempo wie bei der Auto-Modellwahl (upscale_autoselect.measure_rate): zwischen erstem und letztem
+Frame-Fortschritt, Modell-Laden zählt nicht mit. Die Dateien liegen in HighRes/.preview/ und werden
+beim nächsten Vorschau-Lauf ersetzt.
+"""
+
+import shutil
+import subprocess
+from fractions import Fraction
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+from .crop_detect import CropArea
+from .dead_segments import VideoAnalysis
+from .ffmpeg_runner import ffprobe_for, probe_duration, run_ffmpeg
+from .upscale import FINAL_SIZE_4K, UpscaleEngine
+from .upscale_autoselect import measure_rate
+
+
+DEFAULT_CLIP_COUNT = 5
+DEFAULT_CLIP_SECONDS = 3.0
+# Clip beginnt kurz nach dem Szenenwechsel (nicht auf dem Übergangs-Frame)
+SCENE_OFFSET_SECONDS = 0.5
+SCENE_THRESHOLD = 0.3
+PREVIEW_DIR_NAME = ".preview"
+SOURCE_COLUMN = "source"
+
+
+def pick_clip_starts(
+    duration: float,
+    count: int,
+    clip_seconds: float,
+    scene_changes: Optional[List[float]] = None,
+    live_ranges: Optional[List[Tuple[float, float]]] = None,
+) -> List[float]:
+    """
+    Startzeiten der Clips, gleichmäßig über das Band verteilt
+
+    Pro Abschnitt des Bandes wird der Szenenwechsel nächst seiner Mitte genommen, sonst die Mitte
+    selbst; Clips liegen immer ganz in einem lebenden Bereich (live_ranges, Standard: ganzes Band).
+    """
+    ranges = [(start, end) for start, end in (live_ranges or [(0.0, duration)]) if end - start >= clip_seconds]
+    if not ranges:
+        return [0.0] if duration > 0 else []
+
+    def fits(start: float) -> bool:
+        return any(range_start <= start and start + clip_seconds <= range_end for range_start, range_end in ranges)
+
+    def nearest_live(target: float) -> float:
+        positions = [min(max(target, start), end - clip_seconds) for start, end in ranges]
+        return min(positions, key=lambda position: abs(position - target))
+
+    slot = duration / count
+    starts: List[float] = []
+    for index in range(count):
+        target = slot * (index + 0.5)
+        candidates = [
+            change + SCENE_OFFSET_SECONDS for change in scene_changes or []
+            if abs(change - target) <= slot / 2 and fits(change + SCENE_OFFSET_SECONDS)
+        ]
+        start = min(candidates, key=lambda c: abs(c - target)) if candidates else nearest_live(target - clip_seconds / 2)
+        if all(abs(start - other) >= clip_seconds for other in starts):
+            starts.append(round(start, 3))
+    return sorted(starts)
+
+
+def format_size(size: float) -> str:
+    for unit in ("B", "KB", "MB"):
+        if size < 1024:
+            return f"{size:.0f} {unit}"
+        size /= 1024
+    return f"{size:.1f} GB"
+
+
+class UpscalePreview:
+    """Vergleicht Upscaling-Profile auf kurzen Clips eines Films"""
+
+    def __init__(
+        self,
+        engine: UpscaleEngine,
+        ffmpeg_path: Optional[Path],
+        work_dir: Path,
+        log_callback: Optional[Callable[[str], None]] = None,
+    ):
+        self.engine = engine
+        self.ffmpeg_path = ffmpeg_path
+        self.work_dir = Path(work_dir)
+        self.log_callback = log_callback
+
+    def run(
+        self,
+        input_path: Path,
+        profiles: Dict[str, Dict[str, Any]],
+        analysis: Optional[VideoAnalysis] = None,
+        crop: Optional[CropArea] = None,
+        count: int = DEFAULT_CLIP_COUNT,
+        clip_seconds: float = DEFAULT_CLIP_SECONDS,
+        upscale_seconds: Optional[float] = None,
+        progress_callback: Optional[Callable[[int], None]] = None,
+        status_callback: Optional[Callable[[str], None]] = None,
+    ) -> Dict[str, Any]:
+        """
+        Args:
+            profiles: Name -> Profil (in Anzeigereihenfolge)
+            analysis: Szenenwechsel und tote Abschnitte für die Clip-Auswahl
+            upscale_seconds: Länge, die beim echten Upscale durchs Modell geht (Standard: ganzes Band)
+
+        Returns:
+            {"clips": [{"start", "stills": {Spalte: Pfad}, "videos": {Profil: Pfad}}],
+             "profiles": {Name: {"ok", "fps", "speed", "projected_seconds", "projected_bytes", ...}}}
+        """
+        duration = (analysis.duration if analysis else None) or probe_duration(input_path, ffmpeg_path=self.ffmpeg_path)
+        if not duration:
+            raise RuntimeError(f"Dauer von {input_path.name} unbekannt")
+        upscale_seconds = upscale_seconds or duration
+        clip_seconds = min(clip_seconds, duration)
+        starts = pick_clip_starts(
+            duration,
+            count,
+            clip_seconds,
+            analysis.scene_changes(SCENE_THRESHOLD) if analysis else None,
+            analysis.live_ranges() if analysis else None,
+        )
+
+        shutil.rmtree(self.work_dir, ignore_errors=True)
+        self.work_dir.mkdir(parents=True, exist_ok=True)
+        width, height = crop.output_size() if crop else (int(v) for v in FINAL_SIZE_4K.split("x"))
+        source_filter = f"{crop.filter}," if crop else ""
+        source_filter += f"scale={width}:{height}:flags=lanczos,setsar=1"
+
+        clips = []
+        for index, start in enumerate(starts):
+            clip_path = self.work_dir / f"clip_{index}.mkv"
+            if status_callback:
+                status_callback(f"Vorschau: schneide Clip {index + 1}/{len(starts)}")
+            if not self._cut(input_path, start, clip_seconds, clip_path):
+                continue
+            still = self.work_dir / f"clip_{index}_{SOURCE_COLUMN}.jpg"
+            stills = {}
+            if self._still(clip_path, clip_seconds / 2, still, source_filter):
+                stills[SOURCE_COLUMN] = str(still)
+            clips.append({"start": start, "path": clip_path, "stills": stills, "videos": {}})
+        if not clips:
+            raise RuntimeError("Keine Vorschau-Clips geschnitten")
+
+        results: Dict[str, Dict[str, Any]] = {}
+        steps = len(profiles) * len(clips)
+        step = 0
+        for name, profile in profiles.items():
+            rates, output_bytes = [], 0
+            for index, clip in enumerate(clips):
+                if status_callback:
+                    status_callback(f"Vorschau: {name}, Clip {index + 1}/{len(clips)}")
+                output = self.work_dir / f"clip_{index}_{name}.mp4"
+                rate = measure_rate(self.engine, clip["path"], clip_seconds, profile, output, crop)
+                step += 1
+                if progress_callback:
+                    progress_callback(step * 100 // steps)
+                if rate is None or not output.exists():
+                    self.log(f"Vorschau: {name} auf Clip {index + 1} fehlgeschlagen")
+                    continue
+                rates.append(rate)
+                output_bytes += output.stat().st_size
+                clip["videos"][name] = str(output)
+                still = self.work_dir / f"clip_{index}_{name}.jpg"
+                if self._still(output, clip_seconds / 2, still):
+                    clip["stills"][name] = str(still)
+            results[name] = self._summary(name, rates, output_bytes, clip_seconds, upscale_seconds, input_path)
+
+        for clip in clips:
+            clip["path"] = str(clip["path"])
+        return {
+            "duration": duration,
+            "upscale_seconds": upscale_seconds,
+            "clip_seconds": clip_seconds,
+            "output_size": f"{width}x{height}",
+            "clips": clips,
+            "profiles": results,
+        }
+
+    def _summary(
+        self,
+        name: str,
+        rates: List[float],
+        output_bytes: int,
+        clip_seconds: float,
+        upscale_seconds: float,
+        input_path: Path,
+    ) -> Dict[str, Any]:
+        if not rates:
+            return {"ok": False}
+        rate = sum(rates) / len(rates)  # Rechensekunden pro Sekunde Video
+        fps = self._source_fps(input_path)
+        projected_seconds = rate * upscale_seconds
+        projected_bytes = output_bytes / (clip_seconds * len(rates)) * upscale_seconds
+        self.log(
+            f"Vorschau {name}: {1 / rate:.2f}x Echtzeit"
+            + (f" ({fps / rate:.1f} fps)" if fps else "")
+            + f", hochgerechnet {projected_seconds / 3600:.1f} h, {format_size(projected_bytes)}"
+        )
+        return {
+            "ok": True,
+            "speed": round(1 / rate, 3),
+            "fps": round(fps / rate, 2) if fps else None,
+            "projected_seconds": round(projected_seconds),
+            "projected_bytes": int(projected_bytes),
+        }
+
+    def _source_fps(self, input_path: Path) -> Optional[float]:
+        try:
+            result = subprocess.run(
+                [
+                    ffprobe_for(self.ffmpeg_path or "ffmpeg"), "-v", "error", "-select_streams", "v:0",
+                    "-show_entries", "stream=r_frame_rate", "-of", "csv=p=0", str(input_path),
+                ],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.DEVNULL,
+                text=True,
+                timeout=30,
+            )
+            fps = float(Fraction(result.stdout.strip().splitlines()[0]))
+            return fps if fps > 0 else None
+        except (OSError, ValueError, IndexError, ZeroDivisionError, subprocess.SubprocessError):
+            return None
+
+    def _cut(self, input_path: Path, start: float, seconds: float, output: Path) -> bool:
+        """Frame-genauer Clip ohne Ton (FFV1, verlustfrei; Stream-Copy könnte nur an Keyframes schneiden)"""
+        ffmpeg = str(self.ffmpeg_path) if self.ffmpeg_path else "ffmpeg"
+        result = run_ffmpeg([
+            ffmpeg, "-hide_banner", "-nostdin", "-y",
+            "-ss", f"{start:.3f}", "-i", str(input_path), "-t", f"{seconds:.3f}",
+            "-map", "0:v:0", "-an", "-c:v", "ffv1", str(output),
+        ], duration=seconds)
+        if result.returncode != 0 or not output.exists():
+            self.log(f"Vorschau: Clip bei {start:.0f} s fehlgeschlagen: {result.stderr[-300:]}")
+            return False
+        return True
+
+    def _still(self, video: Path, at: float, output: Path, video_filter: Optional[str] = None) -> bool:
+        ffmpeg = str(self.ffmpeg_path) if self.ffmpeg_path else "ffmpeg"
+        cmd = [ffmpeg, "-hide_banner", "-nostdin", "-y", "-ss", f"{at:.3f}", "-i", str(video), "-frames:v", "1"]
+        if video_filter:
+            cmd += ["-vf", video_filter]
+        cmd += ["-q:v", "2", str(output)]
+        result = run_ffmpeg(cmd)
+        return result.returncode == 0 and output.exists()
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
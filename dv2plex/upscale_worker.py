@@ -0,0 +1,231 @@
+"""
+Warmer Real-ESRGAN-Worker für das Upscaling
+
+Statt pro Job `python inference_realesrgan_video.py` zu starten (torch/basicsr importieren,
+RRDBNet bauen, .pth-Gewichte laden), hält ein langlebiger Prozess (bin/realesrgan/upscale_server.py)
+die RealESRGANer je Modell/Tile-Größe im Speicher. Die Verbindung läuft über
+multiprocessing.connection (Unix-Socket bzw. Named Pipe unter Windows, mit Authkey).
+
+Der Worker ist ein eigener Prozess: stürzt er ab (CUDA-Fehler, OOM-Kill), schlägt nur der
+laufende Job fehl, der Webserver bleibt unberührt, und der nächste Job startet ihn neu. Nach
+`upscaling.worker_idle_timeout` Sekunden ohne Job beendet er sich selbst (gibt VRAM frei).
+"""
+
+import os
+import secrets
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+from multiprocessing.connection import Client
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Tuple
+
+
+SERVER_SCRIPT = "upscale_server.py"
+AUTHKEY_ENV = "DV2PLEX_UPSCALE_AUTHKEY"
+DEFAULT_IDLE_TIMEOUT = 600
+# torch-Import und CUDA-Initialisierung können auf langsamen Systemen dauern
+STARTUP_TIMEOUT = 300
+
+
+class UpscaleWorker:
+    """
+    Client des warmen Real-ESRGAN-Workers (ein Job gleichzeitig)
+
+    Args:
+        script_path: Pfad zu inference_realesrgan_video.py (upscale_server.py liegt daneben)
+        idle_timeout: Sekunden ohne Job, nach denen sich der Worker beendet
+    """
+
+    def __init__(
+        self,
+        script_path: Path,
+        idle_timeout: float = DEFAULT_IDLE_TIMEOUT,
+        log_callback: Optional[Callable[[str], None]] = None,
+    ):
+        self.script_path = Path(script_path)
+        self.server_path = self.script_path.with_name(SERVER_SCRIPT)
+        self.idle_timeout = idle_timeout
+        self.log_callback = log_callback
+        self.process: Optional[subprocess.Popen] = None
+        self._authkey = secrets.token_bytes(32)
+        self._address = self._make_address()
+        self._lock = threading.Lock()
+        self._conn = None
+        self._cancelled = False
+        self._log_path = Path(tempfile.gettempdir()) / f"dv2plex-upscale-worker-{os.getpid()}.log"
+
+    def _make_address(self) -> str:
+        name = f"dv2plex-upscale-{os.getpid()}-{secrets.token_hex(4)}"
+        if sys.platform == "win32":
+            return rf"\\.\pipe\{name}"
+        return str(Path(tempfile.gettempdir()) / f"{name}.sock")
+
+    def available(self) -> bool:
+        """Gibt es den Server neben dem Skript (mitgelieferte Real-ESRGAN-Version)?"""
+        return self.server_path.exists()
+
+    def is_running(self) -> bool:
+        return self.process is not None and self.process.poll() is None
+
+    # --- Jobs ------------------------------------------------------------------------
+
+    def run(
+        self,
+        argv: List[str],
+        progress_callback: Optional[Callable[[int, int], None]] = None,
+        status_callback: Optional[Callable[[str], None]] = None,
+    ) -> Tuple[bool, str]:
+        """
+        Führt einen Upscale-Job aus (argv wie für inference_realesrgan_video.py)
+
+        Returns:
+            (Erfolg, Fehlermeldung)
+        """
+        with self._lock:
+            self._cancelled = False
+            try:
+                conn = self._connect()
+            except Exception as e:
+                return False, f"Upscale-Worker nicht erreichbar: {e}"
+            self._conn = conn
+            try:
+                conn.send({"type": "job", "argv": [str(arg) for arg in argv]})
+                while True:
+                    message = conn.recv()
+                    kind = message.get("type")
+                    if kind == "progress" and progress_callback:
+                        progress_callback(message["done"], message["total"])
+                    elif kind == "status":
+                        self.log(f"Upscale-Worker: {message['message']}")
+                        if status_callback:
+                            status_callback(message["message"])
+                    elif kind == "done":
+                        return bool(message["ok"]), message.get("error", "")
+            except (EOFError, OSError):
+                if self._cancelled:
+                    return False, "Upscale abgebrochen"
+                code = None
+                if self.process:
+                    try:
+                        # Verbindung weg ohne Abbruch: meist ist der Worker gerade abgestürzt
+                        code = self.process.wait(timeout=5)
+                    except subprocess.TimeoutExpired:
+                        pass
+                if code is not None:
+                    self.process = None
+                    return False, f"Upscale-Worker abgestürzt (Code {code}), Log: {self._log_path}"
+                return False, "Verbindung zum Upscale-Worker verloren"
+            finally:
+                self._conn = None
+                try:
+                    conn.close()
+                except OSError:
+                    pass
+
+    def cancel(self):
+        """Bricht den laufenden Job ab (der Worker bemerkt die geschlossene Verbindung)"""
+        conn = self._conn
+        if conn is None:
+            return
+        self._cancelled = True
+        try:
+            conn.close()
+        except OSError:
+            pass
+
+    # --- Prozess -----------------------------------------------------------------------
+
+    def _connect(self):
+        if self.is_running():
+            try:
+                return Client(self._address, authkey=self._authkey)
+            except OSError:
+                # Worker hat sich gerade beendet (Leerlauf) - neu starten
+                self.stop()
+        self._start()
+        deadline = time.time() + STARTUP_TIMEOUT
+        while True:
+            try:
+                return Client(self._address, authkey=self._authkey)
+            except OSError:
+                if not self.is_running():
+                    code = self.process.returncode if self.process else None
+                    self.process = None
+                    raise RuntimeError(f"Worker beim Start beendet (Code {code}), Log: {self._log_path}")
+                if time.time() > deadline:
+                    self.stop()
+                    raise RuntimeError("Zeitüberschreitung beim Start")
+                time.sleep(0.5)
+
+    def _start(self):
+        if not self.available():
+            raise RuntimeError(f"{self.server_path} nicht gefunden")
+        if sys.platform != "win32":
+            try:
+                os.unlink(self._address)
+            except OSError:
+                pass
+        env = dict(os.environ)
+        env[AUTHKEY_ENV] = self._authkey.hex()
+        cmd = [
+            sys.executable,
+            str(self.server_path),
+            "--address", self._address,
+            "--idle_timeout", str(self.idle_timeout),
+            "--parent_pid", str(os.getpid()),
+        ]
+        self.log("Starte Upscale-Worker (Modelle bleiben zwischen Jobs geladen)...")
+        with open(self._log_path, "wb") as log_file:
+            self.process = subprocess.Popen(
+                cmd,
+                cwd=str(self.server_path.parent),
+                env=env,
+                stdin=subprocess.DEVNULL,
+                stdout=log_file,
+                stderr=subprocess.STDOUT,
+            )
+
+    def stop(self):
+        """Beendet den Worker-Prozess"""
+        process, self.process = self.process, None
+        if process and process.poll() is None:
+            process.terminate()
+            try:
+                process.wait(timeout=10)
+            except subprocess.TimeoutExpired:
+                process.kill()
+
+    def log(self, message: str):
+        if self.log_callback:
+            self.log_callback(message)
+
+
+_workers: Dict[Path, UpscaleWorker] = {}
+_workers_lock = threading.Lock()
+
+
+def shared_upscale_worker(
+    script_path: Path,
+    idle_timeout: float = DEFAULT_IDLE_TIMEOUT,
+    log_callback: Optional[Callable[[str], None]] = None,
+) -> UpscaleWorker:
+    """Gemeinsamer Worker je Real-ESRGAN-Skript (alle Postprocessing-Jobs teilen sich die Modelle)"""
+    key = Path(script_path).resolve()
+    with _workers_lock:
+        worker = _workers.get(key)
+        if worker is None:
+            worker = _workers[key] = UpscaleWorker(key, idle_timeout, log_callback)
+        worker.idle_timeout = idle_timeout
+        if log_callback:
+            worker.log_callback = log_callback
+        return worker
+
+
+def shutdown_upscale_workers():
+    with _workers_lock:
+        workers = list(_workers.values())
+    for worker in workers:
+        worker.stop()
@@ -90,15 +90,102 @@ function connectWebSocket() {
         console.log('WebSocket closed, reconnecting...');
         setTimeout(connectWebSocket, 3000);
     };
+
+    connectPreviewSocket();
+}
+
+// Binärer Preview-Kanal: jede Nachricht ist ein rohes JPEG (Blob)
+let previewWs = null;
+let previewPendingBlob = null;
+let previewDecoding = false;
+let previewObjectUrl = null;
+
+function connectPreviewSocket() {
+    if (previewWs && previewWs.readyState <= WebSocket.OPEN) return;
+    const protocol = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
+    previewWs = new WebSocket(`${protocol}//${window.location.host}/ws/preview`);
+    previewWs.binaryType = 'blob';
+
+    previewWs.onmessage = (event) => {
+        if (event.data instanceof Blob) {
+            updatePreview(event.data);
+        }
+    };
+
+    previewWs.onclose = () => {
+        previewWs = null;
+        setTimeout(connectPreviewSocket, 3000);
+    };
+}
+
+function updatePreview(blob) {
+    // Latest-Frame-Wins: während ein Frame dekodiert wird, nur das neueste vormerken
+    previewPendingBlob = blob;
+    if (!previewDecoding) {
+        renderPendingPreview();
+    }
+}
+
+async function renderPendingPreview() {
+    previewDecoding = true;
+    try {
+        while (previewPendingBlob) {
+            const blob = previewPendingBlob;
+            previewPendingBlob = null;
+            if (window.createImageBitmap) {
+                let bitmap;
+                try {
+                    bitmap = await createImageBitmap(blob);
+                } catch (e) {
+                    continue;  // defektes Frame überspringen
+                }
+                const canvas = getPreviewCanvas();
+                if (canvas.width !== bitmap.width || canvas.height !== bitmap.height) {
+                    canvas.width = bitmap.width;
+                    canvas.height = bitmap.height;
+                }
+                canvas.getContext('2d').drawImage(bitmap, 0, 0);
+                bitmap.close();
+            } else {
+                renderPreviewFallback(blob);
+            }
+        }
+    } finally {
+        previewDecoding = false;
+    }
+}
+
+function getPreviewCanvas() {
+    const preview = document.getElementById('preview');
+    let canvas = preview.querySelector('canvas');
+    if (!canvas) {
+        // Erstes Bild - ersetze Placeholder
+        preview.innerHTML = '<canvas class="preview-canvas" aria-label="Preview"></canvas>';
+        canvas = preview.querySelector('canvas');
+    }
+    return canvas;
+}
+
+function renderPreviewFallback(blob) {
+    // Ohne createImageBitmap: Object-URL am img, vorherige URL freigeben
+    const preview = document.getElementById('preview');
+    let img = preview.querySelector('img');
+    if (!img) {
+        preview.innerHTML = '<img alt="Preview">';
+        img = preview.querySelector('img');
+    }
+    const url = URL.createObjectURL(blob);
+    img.src = url;
+    if (previewObjectUrl) {
+        URL.revokeObjectURL(previewObjectUrl);
+    }
+    previewObjectUrl = url;
 }
 
 function handleWebSocketMessage(data) {
     switch(data.type) {
-        case 'preview_frame':
-            updatePreview(data.data);
-            break;
         case 'progress':
-            updateProgress(data.value, data.operation);
+            updateProgress(data.value, data.operation, data.message);
             break;
         case 'status':
             updateStatus(data.status, data.operation, data.data);
@@ -119,42 +206,40 @@ function handleWebSocketMessage(data) {
         case 'merge_progress':
             updateMergeQueue(data.job);
             break;
+        case 'upscale_preview_finished':
+            handleUpscalePreviewFinished(data);
+            break;
     }
 }
 
-function updatePreview(imageData) {
-    const preview = document.getElementById('preview');
-    // Prüfe ob bereits ein img-Element existiert
-    let img = preview.querySelector('img');
-    if (img) {
-        // Nur src aktualisieren für flüssigere Updates
-        img.src = imageData;
-    } else {
-        // Erstes Bild - ersetze Placeholder
-        preview.innerHTML = `<img src="${imageData}" alt="Preview">`;
-    }
-}
-
-function updateProgress(value, operation) {
+function updateProgress(value, operation, message) {
+    // message: ffmpeg-Fortschritt (Prozent, fps, Tempo, ETA), falls vorhanden
+    const label = message || value + '%';
     if (operation === 'postprocessing') {
         const progress = document.getElementById('postprocess-progress');
         const fill = document.getElementById('postprocess-progress-fill');
         progress.style.display = 'block';
         fill.style.width = value + '%';
-        fill.textContent = value + '%';
+        fill.textContent = label;
     } else if (operation === 'cover_generation' || operation === 'poster_generation' || operation === 'poster_generation_batch') {
         const progress = document.getElementById('cover-progress');
         const fill = document.getElementById('cover-progress-fill');
         progress.style.display = 'block';
         fill.style.width = value + '%';
-        fill.textContent = value + '%';
+        fill.textContent = label;
+    } else if (operation === 'upscale_preview') {
+        const progress = document.getElementById('preview-progress');
+        const fill = document.getElementById('preview-progress-fill');
+        progress.style.display = 'block';
+        fill.style.width = value + '%';
+        fill.textContent = label;
     } else if (operation === 'movie_export_all') {
         const progress = document.getElementById('movie-export-progress');
         const fill = document.getElementById('movie-export-progress-fill');
         if (progress && fill) {
             progress.style.display = 'block';
             fill.style.width = value + '%';
-            fill.textContent = value + '%';
+            fill.textContent = label;
         }
     } else if (operation === 'movie_export_single' || operation === 'movie_merge') {
         const progress = document.getElementById('movie-export-progress');
@@ -162,7 +247,7 @@ function updateProgress(value, operation) {
         if (progress && fill) {
             progress.style.display = 'block';
             fill.style.width = value + '%';
-            fill.textContent = value + '%';
+            fill.textContent = label;
         }
     }
 }
@@ -237,6 +322,9 @@ function updateStatus(status, operation, payload = null) {
     } else if (operation === 'cover_generation') {
         const statusEl = document.getElementById('cover-status');
         statusEl.textContent = status;
+    } else if (operation === 'upscale_preview') {
+        const statusEl = document.getElementById('preview-status');
+        statusEl.textContent = status;
     }
 
     // Movie Export All status handling
@@ -615,6 +703,20 @@ async function loadUpscalingProfiles() {
             }
             select.appendChild(option);
         });
+
+        const previewList = document.getElementById('preview-profiles');
+        previewList.innerHTML = '';
+        (data.previewable || data.profiles).forEach(profile => {
+            const label = document.createElement('label');
+            const checkbox = document.createElement('input');
+            checkbox.type = 'checkbox';
+            checkbox.value = profile;
+            checkbox.checked = profile === data.default_profile;
+            const name = document.createElement('span');
+            name.textContent = profile;
+            label.append(checkbox, name);
+            previewList.appendChild(label);
+        });
     } catch (error) {
         console.error('Fehler beim Laden der Profile:', error);
         // Fallback
@@ -711,6 +813,113 @@ async function processSelected() {
     }
 }
 
+// Profil-Vorschau
+async function previewProfiles() {
+    if (!selectedPostprocessMovie) {
+        alert('Bitte einen Film auswählen');
+        return;
+    }
+    const profiles = Array.from(document.querySelectorAll('#preview-profiles input:checked')).map(c => c.value);
+    if (profiles.length === 0) {
+        alert('Bitte mindestens ein Profil auswählen');
+        return;
+    }
+
+    try {
+        const response = await fetch('/api/upscaling/preview', {
+            method: 'POST',
+            headers: {'Content-Type': 'application/json'},
+            body: JSON.stringify({movie_dir: selectedPostprocessMovie, profiles})
+        });
+        const data = await response.json();
+        if (response.ok) {
+            document.getElementById('preview-btn').disabled = true;
+            document.getElementById('preview-status').textContent = 'Vorschau gestartet (wartet auf Modell-Slot)...';
+            document.getElementById('preview-results').innerHTML = '';
+        } else {
+            alert(data.detail || 'Fehler beim Starten der Vorschau');
+        }
+    } catch (error) {
+        alert('Fehler: ' + error.message);
+    }
+}
+
+function handleUpscalePreviewFinished(data) {
+    document.getElementById('preview-btn').disabled = false;
+    document.getElementById('preview-progress').style.display = 'none';
+    const status = document.getElementById('preview-status');
+    status.textContent = data.message;
+    status.className = data.success ? 'status success' : 'status error';
+    if (data.success && data.result) {
+        renderUpscalePreview(data.result);
+    }
+}
+
+function renderUpscalePreview(result) {
+    const container = document.getElementById('preview-results');
+    container.innerHTML = '';
+    const names = Object.keys(result.profiles);
+
+    // Kennzahlen je Profil
+    const table = document.createElement('table');
+    table.className = 'preview-table';
+    table.innerHTML = '<tr><th>Profil</th><th>Tempo</th><th>fps</th><th>Dauer (hochgerechnet)</th><th>Größe (hochgerechnet)</th><th></th></tr>';
+    names.forEach(name => {
+        const info = result.profiles[name];
+        const row = document.createElement('tr');
+        const cells = info.ok
+            ? [name, `${info.speed.toFixed(2)}x`, info.fps ?? '—', formatElapsed(info.projected_seconds * 1000), formatBytes(info.projected_bytes)]
+            : [name, 'fehlgeschlagen', '—', '—', '—'];
+        cells.forEach(text => {
+            const cell = document.createElement('td');
+            cell.textContent = text;
+            row.appendChild(cell);
+        });
+        const action = document.createElement('td');
+        if (info.ok) {
+            const button = document.createElement('button');
+            button.textContent = 'Übernehmen';
+            button.onclick = () => {
+                document.getElementById('profile-select').value = name;
+            };
+            action.appendChild(button);
+        }
+        row.appendChild(action);
+        table.appendChild(row);
+    });
+    container.appendChild(table);
+
+    // Standbilder je Clip nebeneinander (Klick: volle Auflösung bzw. Clip abspielen)
+    const columns = ['source', ...names];
+    result.clips.forEach(clip => {
+        const heading = document.createElement('div');
+        heading.className = 'status';
+        heading.textContent = `Clip bei ${formatElapsed(clip.start * 1000)} (${result.output_size})`;
+        container.appendChild(heading);
+        const row = document.createElement('div');
+        row.className = 'preview-clip';
+        columns.forEach(column => {
+            const still = clip.stills[column];
+            if (!still) return;
+            const figure = document.createElement('figure');
+            const link = document.createElement('a');
+            link.target = '_blank';
+            link.href = clip.videos[column]
+                ? `/api/player/stream?path=${encodeURIComponent(clip.videos[column])}`
+                : `/api/upscaling/preview/image?path=${encodeURIComponent(still)}`;
+            const img = document.createElement('img');
+            img.src = `/api/upscaling/preview/image?path=${encodeURIComponent(still)}`;
+            img.alt = column;
+            link.appendChild(img);
+            const caption = document.createElement('figcaption');
+            caption.textContent = column === 'source' ? 'Quelle (Lanczos)' : column;
+            figure.append(link, caption);
+            row.appendChild(figure);
+        });
+        container.appendChild(row);
+    });
+}
+
 async function processAll() {
     // Similar to processSelected but for all movies
     const response = await fetch('/api/postprocess/list');
@@ -1538,8 +1747,10 @@ async function loadSettings() {
         document.getElementById('settings-plex-root').value = data.plex_movies_root || '';
         document.getElementById('settings-dv-root').value = data.dv_import_root || '';
         document.getElementById('settings-ffmpeg').value = data.ffmpeg_path || '';
+        document.getElementById('settings-auto-merge').checked = data.auto_merge !== false;
         document.getElementById('settings-auto-postprocess').checked = data.auto_postprocess || false;
         document.getElementById('settings-auto-upscale').checked = data.auto_upscale || false;
+        document.getElementById('settings-auto-poster').checked = data.auto_poster || false;
         document.getElementById('settings-auto-export').checked = data.auto_export || false;
         const showCover = (data.show_cover_tab === undefined || data.show_cover_tab === null) ? true : !!data.show_cover_tab;
         const coverCb = document.getElementById('settings-show-cover');
@@ -1572,8 +1783,10 @@ async function saveSettings() {
         plex_movies_root: document.getElementById('settings-plex-root').value,
         dv_import_root: document.getElementById('settings-dv-root').value,
         ffmpeg_path: document.getElementById('settings-ffmpeg').value,
+        auto_merge: document.getElementById('settings-auto-merge').checked,
         auto_postprocess: document.getElementById('settings-auto-postprocess').checked,
         auto_upscale: document.getElementById('settings-auto-upscale').checked,
+        auto_poster: document.getElementById('settings-auto-poster').checked,
         auto_export: document.getElementById('settings-auto-export').checked,
         ui_theme: normalizeThemeName(document.getElementById('settings-theme')?.value || getStoredTheme() || 'plex'),
         show_cover_tab: document.getElementById('settings-show-cover')?.checked ?? true
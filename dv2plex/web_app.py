@@ -39,6 +39,19 @@ from dv2plex.service import (
     parse_movie_folder_name
 )
 from dv2plex.update_manager import UpdateManager
+from dv2plex.job_store import KIND_MERGE, open_job_store
+from dv2plex.pipeline import (
+    RESOURCE_CPU,
+    RESOURCE_IO,
+    RESOURCE_MODEL,
+    STAGE_EXPORT,
+    STAGE_POSTER,
+    STAGE_UPSCALE,
+    PipelineScheduler,
+    shared_resources,
+)
+from dv2plex.upscale_preview import PREVIEW_DIR_NAME
+from dv2plex.upscale_worker import shutdown_upscale_workers
 
 QIMAGE_AVAILABLE = False
 
@@ -61,12 +74,69 @@ postprocessing_service: Optional[PostprocessingService] = None
 movie_mode_service: Optional[MovieModeService] = None
 cover_service: Optional[CoverService] = None
 update_manager: Optional[UpdateManager] = None
+pipeline_scheduler: Optional[PipelineScheduler] = None
 update_task: Optional[asyncio.Task] = None
 main_event_loop: Optional[asyncio.AbstractEventLoop] = None
 
 # WebSocket connections for broadcasting
 websocket_connections: List[WebSocket] = []
 
+
+class PreviewClient:
+    """
+    Binärer Preview-Client (/ws/preview) mit Latest-Frame-Postfach.
+
+    Es liegt höchstens ein Frame bereit; kommt ein neues, bevor das alte gesendet wurde,
+    wird das alte verworfen. Langsame Clients bekommen so weniger Frames statt einer Queue.
+    """
+
+    def __init__(self, websocket: WebSocket, client_id: int):
+        self.websocket = websocket
+        self.client_id = client_id
+        self.address = f"{websocket.client.host}:{websocket.client.port}" if websocket.client else "?"
+        self.connected_at = datetime.now().isoformat()
+        self.pending: Optional[bytes] = None
+        self.wakeup = asyncio.Event()
+        self.sent = 0
+        self.dropped = 0
+
+    def offer(self, frame: bytes):
+        """Legt ein Frame ins Postfach (nur aus der Event-Loop aufrufen)"""
+        if self.pending is not None:
+            self.dropped += 1
+        self.pending = frame
+        self.wakeup.set()
+
+    async def run_sender(self):
+        """Sendet jeweils das neueste Frame; endet, wenn die Verbindung weg ist"""
+        try:
+            while True:
+                await self.wakeup.wait()
+                self.wakeup.clear()
+                frame, self.pending = self.pending, None
+                if frame is None:
+                    continue
+                await self.websocket.send_bytes(frame)
+                self.sent += 1
+        except asyncio.CancelledError:
+            raise
+        except Exception:
+            pass
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            "id": self.client_id,
+            "address": self.address,
+            "connected_at": self.connected_at,
+            "sent": self.sent,
+            "dropped": self.dropped,
+        }
+
+
+# Binäre Preview-Clients
+preview_clients: List[PreviewClient] = []
+preview_client_counter = 0
+
 # Active operations
 active_capture: Optional[Dict[str, Any]] = None
 active_postprocessing: Optional[Dict[str, Any]] = None
@@ -116,6 +186,7 @@ def add_log_entry(msg: str, category: str = "general"):
 def setup_services():
     """Initialisiert die Services"""
     global capture_service, postprocessing_service, movie_mode_service, cover_service, update_manager
+    global pipeline_scheduler
     
     def log_callback(msg: str):
         logger.info(msg)
@@ -128,11 +199,13 @@ def setup_services():
         broadcast_message_sync({
             "type": "merge_progress",
             "job": {
+                "id": job.job_id,
                 "title": job.title,
                 "year": job.year,
                 "status": job.status,
                 "progress": job.progress,
-                "message": job.message
+                "message": job.message,
+                "worker": job.worker
             }
         })
 
@@ -163,6 +236,103 @@ def setup_services():
         capture_service,
         log_callback=lambda msg: add_log_entry(msg, "update"),
     )
+    pipeline_scheduler = PipelineScheduler(config, log_callback=lambda msg: add_log_entry(msg, "pipeline"))
+    _setup_pipeline()
+    _resume_persistent_jobs()
+
+
+def _postprocess_broadcast_callbacks() -> Dict[str, Any]:
+    """WebSocket-Callbacks für Postprocessing-Jobs, die nicht aus einem Request stammen"""
+    def finished(success: bool, message: str):
+        broadcast_message_sync({"type": "postprocessing_finished", "success": success, "message": message})
+
+    return {
+        "progress_callback": lambda value: broadcast_message_sync(
+            {"type": "progress", "value": value, "operation": "postprocessing"}
+        ),
+        "status_callback": lambda status: broadcast_message_sync(
+            {"type": "status", "status": status, "operation": "postprocessing"}
+        ),
+        "finished_callback": finished,
+    }
+
+
+def _poster_broadcast_callbacks() -> Dict[str, Any]:
+    """WebSocket-Callbacks für Poster-Jobs, die nicht aus einem Request stammen"""
+    def finished(success: bool, message: str, poster_path: Optional[Path]):
+        broadcast_message_sync({
+            "type": "poster_generation_finished",
+            "success": success,
+            "message": message,
+            "poster_path": str(poster_path) if poster_path else None
+        })
+
+    return {
+        "progress_callback": lambda value: broadcast_message_sync(
+            {"type": "progress", "value": value, "operation": "poster_generation"}
+        ),
+        "status_callback": lambda status: broadcast_message_sync(
+            {"type": "status", "status": status, "operation": "poster_generation"}
+        ),
+        "finished_callback": finished,
+    }
+
+
+def _setup_pipeline():
+    """Verbindet die Services zum Projekt-DAG (Merge → Upscale → Poster → Export)"""
+    def on_stage(project_dir: Path, stage: str, state: str, result: dict):
+        pipeline_scheduler.on_stage(project_dir, stage, state, result)
+        broadcast_message_sync({
+            "type": "pipeline_stage",
+            "project": project_dir.name,
+            "stage": stage,
+            "state": state,
+        })
+
+    capture_service.stage_callback = on_stage
+    postprocessing_service.stage_callback = on_stage
+    cover_service.stage_callback = on_stage
+
+    def run_upscale(project_dir: Path, _result: dict) -> bool:
+        postprocessing_service.enqueue_movie(
+            project_dir,
+            config.get("upscaling.default_profile", "realesrgan_2x"),
+            **_postprocess_broadcast_callbacks(),
+        )
+        return True
+
+    def run_poster(project_dir: Path, _result: dict) -> bool:
+        video_path = project_dir / "HighRes" / f"{project_dir.name}_4k.mp4"
+        if not video_path.exists():
+            return False
+        title, year = parse_movie_folder_name(project_dir.name)
+        cover_service.enqueue_poster(video_path, title, year or None, **_poster_broadcast_callbacks())
+        return True
+
+    def run_export(project_dir: Path, _result: dict) -> bool:
+        def export():
+            success, message = postprocessing_service.export_movie(project_dir)
+            add_log_entry(message, "pipeline")
+            broadcast_message_sync({"type": "log", "message": message})
+
+        pipeline_scheduler.run_task(f"Export {project_dir.name}", export)
+        return True
+
+    pipeline_scheduler.register_executor(STAGE_UPSCALE, run_upscale)
+    pipeline_scheduler.register_executor(STAGE_POSTER, run_poster)
+    pipeline_scheduler.register_executor(STAGE_EXPORT, run_export)
+
+
+def _resume_persistent_jobs():
+    """Setzt nach einem Neustart (z.B. Auto-Update) die offenen Jobs aus dem Job-Speicher fort"""
+    open_job_store(config.config_dir).prune()
+    try:
+        capture_service.resume_jobs()
+        postprocessing_service.resume_jobs(**_postprocess_broadcast_callbacks())
+        cover_service.resume_jobs(**_poster_broadcast_callbacks())
+    except Exception as e:
+        logger.exception(f"Fehler beim Fortsetzen gespeicherter Jobs: {e}")
+        add_log_entry(f"Fehler beim Fortsetzen gespeicherter Jobs: {e}", "merge")
 
 
 async def broadcast_message(message: Dict[str, Any]):
@@ -254,12 +424,23 @@ class PostprocessRequest(BaseModel):
     profile_name: str = "realesrgan_2x"
 
 
+class UpscalePreviewRequest(BaseModel):
+    movie_dir: str
+    profiles: List[str]
+    clips: int = 5
+    clip_seconds: float = 3.0
+
+
 class MergeRequest(BaseModel):
     video_paths: List[str]
     title: str
     year: str
 
 
+class MergePriorityRequest(BaseModel):
+    priority: int
+
+
 class ExportRequest(BaseModel):
     video_path: str
     title: Optional[str] = None
@@ -295,19 +476,25 @@ class PlayerRenameRequest(BaseModel):
     new_year: Optional[str] = None
 
 
+def _offer_preview_frame(frame: bytes):
+    """Verteilt ein Preview-Frame an die Postfächer aller Preview-Clients (läuft in der Event-Loop)"""
+    for client in preview_clients:
+        client.offer(frame)
+
+
 # Preview callback for capture
 def preview_callback(image):
     """Callback für Preview-Frames während Capture"""
-    # Erwartet rohe JPEG-Bytes
-    if isinstance(image, (bytes, bytearray)):
-        try:
-            base64_image = base64.b64encode(image).decode('utf-8')
-            broadcast_message_sync({
-                "type": "preview_frame",
-                "data": f"data:image/jpeg;base64,{base64_image}"
-            })
-        except Exception:
-            pass
+    # Erwartet rohe JPEG-Bytes; gesendet wird binär über /ws/preview (kein Base64/JSON)
+    if not isinstance(image, (bytes, bytearray)) or not preview_clients:
+        return
+    loop = main_event_loop
+    if loop is None or not loop.is_running():
+        return
+    try:
+        loop.call_soon_threadsafe(_offer_preview_frame, bytes(image))
+    except RuntimeError:
+        pass
 
 
 # API Routes
@@ -376,7 +563,9 @@ async def get_upscaling_profiles():
     default_profile = config.get("upscaling.default_profile", "realesrgan_2x")
     return {
         "profiles": list(profiles.keys()),
-        "default_profile": default_profile
+        "default_profile": default_profile,
+        # Für die Vorschau: alle außer "auto" (das wählt selbst unter seinen Kandidaten)
+        "previewable": [name for name, profile in profiles.items() if profile.get("backend") != "auto"],
     }
 
 
@@ -894,6 +1083,57 @@ async def process_movie(request: PostprocessRequest):
     return {"success": True, "message": "Postprocessing gestartet"}
 
 
+@app.post("/api/upscaling/preview")
+async def preview_upscaling_profiles(request: UpscalePreviewRequest):
+    """Vergleicht Profile auf kurzen Clips (Standbilder, Tempo, hochgerechnete Dauer/Größe)"""
+    if not postprocessing_service:
+        raise HTTPException(status_code=500, detail="Postprocessing-Service nicht initialisiert")
+    if not request.profiles:
+        raise HTTPException(status_code=400, detail="Keine Profile gewählt")
+    if not 1 <= request.clips <= 10 or not 1 <= request.clip_seconds <= 10:
+        raise HTTPException(status_code=400, detail="1-10 Clips zu je 1-10 Sekunden")
+
+    movie_dir = _ensure_in_dv_import_root(Path(request.movie_dir))
+    if not movie_dir.is_dir():
+        raise HTTPException(status_code=404, detail=f"Film-Ordner nicht gefunden: {movie_dir}")
+
+    def run_preview():
+        def progress_cb(value: int):
+            broadcast_message_sync({"type": "progress", "value": value, "operation": "upscale_preview"})
+
+        def status_cb(status: str):
+            broadcast_message_sync({"type": "status", "status": status, "operation": "upscale_preview"})
+
+        success, result, message = postprocessing_service.preview_profiles(
+            movie_dir,
+            request.profiles,
+            count=request.clips,
+            clip_seconds=request.clip_seconds,
+            progress_callback=progress_cb,
+            status_callback=status_cb,
+        )
+        broadcast_message_sync({
+            "type": "upscale_preview_finished",
+            "success": success,
+            "message": message,
+            "movie_dir": str(movie_dir),
+            "result": result,
+        })
+
+    # Modell-Slot: läuft nicht parallel zu einem Upscale
+    pipeline_scheduler.run_task(f"Vorschau {movie_dir.name}", run_preview, RESOURCE_MODEL)
+    return {"success": True, "message": "Vorschau gestartet"}
+
+
+@app.get("/api/upscaling/preview/image")
+async def get_preview_image(path: str):
+    """Gibt ein Vorschau-Standbild zurück (nur aus HighRes/.preview im DV_Import-Ordner)"""
+    image_path = _ensure_in_dv_import_root(Path(path))
+    if image_path.parent.name != PREVIEW_DIR_NAME or image_path.suffix.lower() != ".jpg" or not image_path.is_file():
+        raise HTTPException(status_code=404, detail="Vorschaubild nicht gefunden")
+    return FileResponse(image_path, media_type="image/jpeg")
+
+
 @app.post("/api/movie/merge")
 async def merge_videos(request: MergeRequest):
     """Merged mehrere Videos zu einem Film (läuft im Hintergrund)"""
@@ -925,11 +1165,15 @@ async def merge_videos(request: MergeRequest):
                 "data": {"title": request.title, "year": request.year, "count": len(video_paths)},
             })
 
-            success, merged_file, error = movie_mode_service.merge_videos(
-                video_paths,
-                request.title,
-                request.year
-            )
+            with shared_resources().acquire(RESOURCE_CPU, f"Film-Merge {request.title}"):
+                success, merged_file, error = movie_mode_service.merge_videos(
+                    video_paths,
+                    request.title,
+                    request.year,
+                    progress_callback=lambda percent, message: broadcast_message_sync(
+                        {"type": "progress", "value": percent, "operation": "movie_merge", "message": message}
+                    ),
+                )
 
             if not success or not merged_file:
                 broadcast_message_sync({
@@ -941,11 +1185,12 @@ async def merge_videos(request: MergeRequest):
                 return
 
             # Export to Plex
-            export_success, exported_path, export_error = movie_mode_service.export_to_plex(
-                merged_file,
-                request.title,
-                request.year
-            )
+            with shared_resources().acquire(RESOURCE_IO, f"Export {request.title}"):
+                export_success, exported_path, export_error = movie_mode_service.export_to_plex(
+                    merged_file,
+                    request.title,
+                    request.year
+                )
 
             # Clean up temp file
             try:
@@ -980,7 +1225,7 @@ async def merge_videos(request: MergeRequest):
             active_movie_merge["running"] = False
             active_movie_merge["current"] = None
 
-    threading.Thread(target=run_merge, daemon=True).start()
+    pipeline_scheduler.run_task(f"Film-Merge {request.title}", run_merge)
     return {"success": True, "message": "Merge gestartet (läuft im Hintergrund)."}
 
 
@@ -1045,7 +1290,7 @@ async def export_video(request: ExportRequest):
             active_export_single["running"] = False
             active_export_single["current"] = None
 
-    threading.Thread(target=run_export_single, daemon=True).start()
+    pipeline_scheduler.run_task(f"Export {video_path.name}", run_export_single, RESOURCE_IO)
     return {"success": True, "message": "Export gestartet (läuft im Hintergrund)."}
 
 
@@ -1128,12 +1373,13 @@ async def export_all_videos(request: ExportAllRequest):
                     },
                 })
 
-                success, exported_path, error = movie_mode_service.export_to_plex(
-                    Path(video_path),
-                    title,
-                    year,
-                    overwrite=True,
-                )
+                with shared_resources().acquire(RESOURCE_IO, f"Export {title}"):
+                    success, exported_path, error = movie_mode_service.export_to_plex(
+                        Path(video_path),
+                        title,
+                        year,
+                        overwrite=True,
+                    )
 
                 active_export_all["done"] += 1
                 percent = int(round(active_export_all["done"] * 100 / max(active_export_all["total"], 1)))
@@ -1194,8 +1440,7 @@ async def export_all_videos(request: ExportAllRequest):
             active_export_all["running"] = False
             active_export_all["current"] = None
 
-    thread = threading.Thread(target=run_export_all, daemon=True)
-    thread.start()
+    pipeline_scheduler.run_task("Export-All", run_export_all)
 
     return {"success": True, "message": f"Export-All gestartet ({total} Videos).", "total": total}
 
@@ -1326,8 +1571,7 @@ async def generate_cover(request: CoverGenerateRequest):
             "cover_path": str(cover_path) if cover_path else None
         })
     
-    thread = threading.Thread(target=run_generation, daemon=True)
-    thread.start()
+    pipeline_scheduler.run_task(f"Cover {request.title}", run_generation, RESOURCE_MODEL)
     
     return {"success": True, "message": "Cover-Generierung gestartet"}
 
@@ -1455,8 +1699,10 @@ async def get_settings():
         "plex_movies_root": str(config.get_plex_movies_root()),
         "dv_import_root": str(config.get_dv_import_root()),
         "ffmpeg_path": str(config.get_ffmpeg_path()),
+        "auto_merge": config.get("capture.auto_merge", True),
         "auto_postprocess": config.get("capture.auto_postprocess", False),
         "auto_upscale": config.get("capture.auto_upscale", True),
+        "auto_poster": config.get("capture.auto_poster", False),
         "auto_export": config.get("capture.auto_export", False),
         "ui_theme": config.get("ui.theme", "plex"),
         "show_cover_tab": config.get("ui.show_cover_tab", True),
@@ -1474,10 +1720,14 @@ async def update_settings(settings: Dict[str, Any]):
         config.set("paths.dv_import_root", settings["dv_import_root"])
     if "ffmpeg_path" in settings:
         config.set("paths.ffmpeg_path", settings["ffmpeg_path"])
+    if "auto_merge" in settings:
+        config.set("capture.auto_merge", settings["auto_merge"])
     if "auto_postprocess" in settings:
         config.set("capture.auto_postprocess", settings["auto_postprocess"])
     if "auto_upscale" in settings:
         config.set("capture.auto_upscale", settings["auto_upscale"])
+    if "auto_poster" in settings:
+        config.set("capture.auto_poster", settings["auto_poster"])
     if "auto_export" in settings:
         config.set("capture.auto_export", settings["auto_export"])
     if "ui_theme" in settings:
@@ -1636,16 +1886,73 @@ async def get_logs(limit: int = 100, category: str = None):
 async def get_merge_queue():
     """Gibt den Status der Merge-Queue zurück"""
     if not capture_service or not capture_service.capture_engine:
+        jobs = capture_service.job_store.list(KIND_MERGE, limit=10) if capture_service else []
         return {
+            "workers": [],
+            "waiting": [],
             "pending_count": 0,
+            "running_count": 0,
             "current_job": None,
-            "completed_count": 0,
-            "jobs": []
+            "completed_count": len(jobs),
+            "jobs": [
+                {
+                    "id": j["id"],
+                    "title": j["params"].get("title", ""),
+                    "year": j["params"].get("year", ""),
+                    "status": j["status"],
+                    "progress": j["progress"],
+                    "message": j["message"],
+                    "priority": j["priority"],
+                    "worker": None,
+                }
+                for j in reversed(jobs)
+            ]
         }
     
     return capture_service.capture_engine.get_merge_queue_status()
 
 
+@app.get("/api/pipeline")
+async def get_pipeline_status():
+    """Ressourcen-Budgets, Stufen-DAG und Stufenstatus je Projekt"""
+    if not pipeline_scheduler:
+        raise HTTPException(status_code=500, detail="Pipeline nicht initialisiert")
+    return pipeline_scheduler.status()
+
+
+@app.get("/api/jobs")
+async def get_jobs(kind: Optional[str] = None, status: Optional[str] = None, limit: int = 50):
+    """Jobs aus dem persistenten Job-Speicher (kind: merge, postprocess, poster)"""
+    store = open_job_store(config.config_dir)
+    return {"jobs": store.list(kind, statuses=[status] if status else None, limit=limit)}
+
+
+@app.get("/api/postprocess/queue")
+async def get_postprocess_queue():
+    """Offene und zuletzt abgeschlossene Postprocessing-Jobs"""
+    if not postprocessing_service:
+        raise HTTPException(status_code=500, detail="Postprocessing-Service nicht initialisiert")
+    return postprocessing_service.get_queue_status()
+
+
+@app.get("/api/poster/queue")
+async def get_poster_queue():
+    """Offene und zuletzt abgeschlossene Poster-Jobs"""
+    if not cover_service:
+        raise HTTPException(status_code=500, detail="Cover-Service nicht initialisiert")
+    return cover_service.get_queue_status()
+
+
+@app.post("/api/merge/jobs/{job_id}/priority")
+async def set_merge_job_priority(job_id: str, request: MergePriorityRequest):
+    """Ändert die Priorität eines wartenden Merge-Jobs (höher = früher)"""
+    if not capture_service or not capture_service.capture_engine:
+        raise HTTPException(status_code=404, detail="Keine Merge-Queue aktiv")
+    if not capture_service.capture_engine.set_merge_job_priority(job_id, request.priority):
+        raise HTTPException(status_code=404, detail="Wartender Merge-Job nicht gefunden")
+    return capture_service.capture_engine.get_merge_queue_status()
+
+
 @app.post("/api/logs/clear")
 async def clear_logs():
     """Löscht alle Logs"""
@@ -1654,7 +1961,39 @@ async def clear_logs():
     return {"status": "ok"}
 
 
+@app.get("/api/preview/clients")
+async def get_preview_clients():
+    """Gesendete/verworfene Preview-Frames pro verbundenem Client"""
+    return {"clients": [client.stats() for client in preview_clients]}
+
+
 # WebSocket endpoint
+@app.websocket("/ws/preview")
+async def preview_websocket_endpoint(websocket: WebSocket):
+    """Binärer Preview-Kanal: jede Nachricht ist ein rohes JPEG-Frame"""
+    global preview_client_counter
+    await websocket.accept()
+    preview_client_counter += 1
+    client = PreviewClient(websocket, preview_client_counter)
+    preview_clients.append(client)
+    sender = asyncio.create_task(client.run_sender())
+    try:
+        # Eingehende Nachrichten werden nur gelesen, um den Disconnect zu erkennen
+        while True:
+            await websocket.receive_text()
+    except WebSocketDisconnect:
+        pass
+    except Exception as e:
+        logger.error(f"Preview-WebSocket-Fehler: {e}")
+    finally:
+        sender.cancel()
+        if client in preview_clients:
+            preview_clients.remove(client)
+        logger.info(
+            f"Preview-Client {client.address} getrennt (gesendet: {client.sent}, verworfen: {client.dropped})"
+        )
+
+
 @app.websocket("/ws")
 async def websocket_endpoint(websocket: WebSocket):
     """WebSocket-Endpoint für Live-Updates"""
@@ -1705,6 +2044,12 @@ async def on_startup():
             add_log_entry(f"Fehler beim Aktivieren des Autostarts: {e}", "update")
 
 
+@app.on_event("shutdown")
+async def on_shutdown():
+    """Beendet den warmen Upscale-Worker zusammen mit dem Webserver"""
+    shutdown_upscale_workers()
+
+
 def get_html_interface() -> str:
     """Gibt das HTML-Interface zurück"""
     try:
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+Benchmark: Real-ESRGAN im CPU-Modus mit 1, 2, 4 ... Prozessen
+
+Erzeugt einen kurzen SD-Clip (testsrc2 + Sinuston, 720x576 wie DV), skaliert ihn mit dem
+mitgelieferten Skript auf der CPU (--device cpu --num_process N --cpu_threads T) und gibt
+Frames/s und die Skalierung gegenüber einem Prozess aus.
+
+Aufruf:
+    python3 scripts/bench_cpu_upscale.py --realesrgan dv2plex/bin/realesrgan/inference_realesrgan_video.py
+        [--ffmpeg ffmpeg] [--seconds 4] [--model RealESRGAN_x4plus] [--tile 0] [--cpu-threads 2]
+"""
+
+import argparse
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+
+from bench_upscale_pipeline import make_clip  # noqa: E402
+
+
+def physical_cores(script: Path) -> int:
+    """Gleiche Kernzählung wie der Standard von --num_process im Skript"""
+    sys.path.insert(0, str(script.parent))
+    from inference_realesrgan_video import physical_cores as script_physical_cores
+    return script_physical_cores()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--realesrgan", type=Path, required=True, help="Pfad zu inference_realesrgan_video.py")
+    parser.add_argument("--ffmpeg", default=shutil.which("ffmpeg") or "ffmpeg")
+    parser.add_argument("--seconds", type=int, default=4, help="Länge des Test-Clips in Sekunden")
+    parser.add_argument("--model", default="RealESRGAN_x4plus")
+    parser.add_argument("--tile", type=int, default=0)
+    parser.add_argument("--cpu-threads", type=int, default=2, help="Threads je Prozess")
+    args = parser.parse_args()
+    args.realesrgan = args.realesrgan.resolve()
+
+    max_processes = max(1, physical_cores(args.realesrgan) // args.cpu_threads)
+    counts = [1]
+    while counts[-1] * 2 <= max_processes:
+        counts.append(counts[-1] * 2)
+    if counts[-1] != max_processes:
+        counts.append(max_processes)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        clip = Path(tmp) / "clip.mp4"
+        make_clip(args.ffmpeg, clip, args.seconds)
+        frames = args.seconds * 25
+        print(f"Test-Clip: {frames} Frames 720x576, Modell {args.model} 2x, {args.cpu_threads} Threads je Prozess")
+
+        baseline = None
+        for processes in counts:
+            output = Path(tmp) / f"out_{processes}.mp4"
+            cmd = [
+                sys.executable, str(args.realesrgan),
+                "-i", str(clip), "-n", args.model, "-s", "2", "-o", tmp,
+                "--tile", str(args.tile), "--ffmpeg_bin", args.ffmpeg, "--save_path", str(output),
+                "--device", "cpu", "--num_process", str(processes), "--cpu_threads", str(args.cpu_threads),
+            ]
+            start = time.perf_counter()
+            result = subprocess.run(cmd, cwd=str(args.realesrgan.parent), capture_output=True, text=True)
+            elapsed = time.perf_counter() - start
+            if result.returncode != 0:
+                print(f"{processes} Prozesse: fehlgeschlagen\n{result.stdout[-2000:]}{result.stderr[-2000:]}")
+                return 1
+            fps = frames / elapsed
+            baseline = baseline or fps
+            print(f"{processes:3d} Prozesse  {elapsed:7.1f} s  {fps:6.2f} Frames/s  "
+                  f"Skalierung {fps / baseline:5.2f}x (ideal {processes}x)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
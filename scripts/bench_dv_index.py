@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+Micro-Benchmark: DV-Metadaten-Scan einer Split-Datei
+
+Vergleicht die bisherige Block-Schleife aus MergeEngine._extract_dv_datecode (80-Byte-Slices,
+5-Byte-Pack-Slices, hier über die ganze Datei statt nur 8 MB) mit dv2plex.dv_index.scan_dv_file
+(mmap, ein Durchlauf, Index pro Frame) – mit numpy, falls installiert, und mit dem
+Python-Fallback. Die Datei liegt nach dem Erzeugen im Page-Cache, gemessen wird also die
+CPU-Seite.
+
+Aufruf:
+    python3 scripts/bench_dv_index.py [--frames 750] [--keep /tmp/bench.dv]
+"""
+
+import argparse
+import os
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+
+from dv2plex.dv_dif import DIF_BLOCK_SIZE, DV_FRAME_SIZE_PAL  # noqa: E402
+from dv2plex.dv_index import np, scan_dv_file  # noqa: E402
+
+
+def _bcd(v: int) -> int:
+    return (v // 10) << 4 | (v % 10)
+
+
+def make_frame(n: int) -> bytes:
+    """PAL-Frame mit Header/Subcode/VAUX/Audio-IDs, Timecode, Datum/Zeit und AAUX in jeder Sequenz."""
+    frame = bytearray(os.urandom(DV_FRAME_SIZE_PAL))
+    s, f = divmod(n, 25)
+    timecode = bytes([0x13, _bcd(f), _bcd(s % 60), _bcd(s // 60 % 60), _bcd(10)])
+    date = bytes([0x62, 0xFF, _bcd(24), _bcd(12), _bcd(4)])
+    rec_time = bytes([0x63, 0xFF, _bcd(s % 60), _bcd(s // 60 % 60), _bcd(18)])
+    for block in range(DV_FRAME_SIZE_PAL // DIF_BLOCK_SIZE):
+        seq, idx = divmod(block, 150)
+        base = block * DIF_BLOCK_SIZE
+        sct = 0 if idx == 0 else 1 if idx < 3 else 2 if idx < 6 else 3 if (idx - 6) % 16 == 0 else 4
+        frame[base: base + 3] = bytes([sct << 5 | 0x1F, seq << 4 | 0x07, 0])
+        if sct == 0:
+            frame[base + 3: base + DIF_BLOCK_SIZE] = b"\xbf" + b"\xff" * (DIF_BLOCK_SIZE - 4)
+        elif sct == 1:
+            for ssyb in range(6):
+                off = base + 3 + ssyb * 8
+                frame[off: off + 8] = b"\x00\x00\xff" + (timecode if ssyb % 3 == 0 else rec_time)
+        elif sct == 2:
+            packs = (b"\x60\x00\x00\x00\x00", b"\x61\x00\x00\x00\x00", date, rec_time) + (b"\xff" * 5,) * 11
+            frame[base + 3: base + 78] = b"".join(packs)
+        elif sct == 3:
+            frame[base + 3: base + 8] = b"\x50\x00\x00\x00\x00"
+    return bytes(frame)
+
+
+def legacy_scan(path: Path) -> int:
+    """Block-Schleife wie in _extract_dv_datecode, aber ohne Abbruch über die ganze Datei"""
+    block_size = 80
+    packs = 0
+    with open(path, "rb") as f:
+        while True:
+            data = f.read(8 * 1024 * 1024)
+            if not data:
+                break
+            for i in range(0, len(data) - block_size + 1, block_size):
+                block = data[i: i + block_size]
+                if block[0] != 0x1F:
+                    continue
+                if block[1] >> 5 not in (0, 1):
+                    continue
+                payload = block[3:]
+                for p in range(0, len(payload) - 4, 5):
+                    pack = payload[p: p + 5]
+                    if pack[0] in (0x13, 0x62):
+                        packs += 1
+    return packs
+
+
+def measure(name, func, size, frames):
+    start = time.perf_counter()
+    result = func()
+    elapsed = time.perf_counter() - start
+    print(f"{name:14s} {elapsed * 1000:8.1f} ms  {size / elapsed / 1e6:8.1f} MB/s  {frames / elapsed:9.0f} Frames/s")
+    return elapsed, result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--frames", type=int, default=750, help="Anzahl PAL-Frames (750 = 30 s, 108 MB)")
+    parser.add_argument("--keep", type=Path, help="Testdatei hier ablegen statt in einem Temp-Ordner")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = args.keep or Path(tmp) / "bench.dv"
+        with open(path, "wb") as f:
+            for n in range(args.frames):
+                f.write(make_frame(n))
+        size = path.stat().st_size
+        print(f"{args.frames} PAL-Frames, {size / 1e6:.0f} MB, numpy: {'ja' if np is not None else 'nein'}")
+
+        legacy, _ = measure("alt (Schleife)", lambda: legacy_scan(path), size, args.frames)
+        fallback, index = measure("neu (Python)", lambda: scan_dv_file(path, use_numpy=False), size, args.frames)
+        assert len(index) == args.frames and index.first_recorded_at() is not None
+        print(f"Faktor Python-Fallback: {legacy / fallback:.1f}x")
+        if np is not None:
+            vectorized, vindex = measure("neu (numpy)", lambda: scan_dv_file(path, use_numpy=True), size, args.frames)
+            assert vindex.timecodes == index.timecodes and vindex.rec_times == index.rec_times
+            print(f"Faktor numpy: {legacy / vectorized:.1f}x")
+
+
+if __name__ == "__main__":
+    main()
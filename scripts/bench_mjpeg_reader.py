@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+Micro-Benchmark: MJPEG-Frame-Extraktion für die Preview
+
+Vergleicht die bisherige bytearray/find/reslice-Schleife (read(8192), bytes() pro Frame)
+mit dv2plex.mjpeg_reader.MJPEGFrameExtractor (readinto, fester Puffer, inkrementelle Suche).
+Gemessen werden Frames pro Sekunde, Allokationen und kopierte Bytes von Frame-Daten
+pro Frame (große Blöcke: read()-Chunks, Reslices, bytes()) sowie der Speicher-Peak (tracemalloc).
+
+Aufruf:
+    python3 scripts/bench_mjpeg_reader.py [--frames 3000] [--frame-kb 40] [--fps-limit 10]
+"""
+
+import argparse
+import io
+import random
+import sys
+import time
+import tracemalloc
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+
+from dv2plex.mjpeg_reader import MJPEGFrameExtractor  # noqa: E402
+
+
+def make_stream(frames: int, frame_kb: int) -> bytes:
+    """Synthetischer MJPEG-Strom: SOI + Nutzdaten ohne 0xFF + EOI (wie ffmpeg image2pipe)."""
+    rng = random.Random(1)
+    payload = bytes(b if b != 0xFF else 0xFE for b in rng.randbytes(frame_kb * 1024))
+    out = bytearray()
+    for i in range(frames):
+        out += b"\xff\xd8" + payload[i % 97:] + payload[: i % 97] + b"\xff\xd9"
+    return bytes(out)
+
+
+class FakeClock:
+    """Deterministische Uhr: jedes Frame rückt 1/25 s vor (Quelle liefert 25 fps)."""
+
+    def __init__(self):
+        self.t = 0.0
+
+    def __call__(self):
+        self.t += 0.04
+        return self.t
+
+
+class Counter:
+    """Zählt Allokationen/Kopien von Frame-Daten (große Blöcke) und kopierte Bytes."""
+
+    def __init__(self):
+        self.allocs = 0
+        self.copied = 0
+
+    def add(self, nbytes):
+        self.allocs += 1
+        self.copied += nbytes
+
+
+def legacy_reader(stream, on_frame, fps_limit, clock, counter):
+    """Nachbau der bisherigen Schleife aus CaptureEngine._read_preview_stream (mit Zählern)"""
+    buffer = bytearray()
+    jpeg_start = b"\xff\xd8"
+    jpeg_end = b"\xff\xd9"
+    last_frame_time = -1e9
+    target_frame_interval = 1.0 / fps_limit if fps_limit else 0.0
+    while True:
+        chunk = stream.read(8192)
+        if not chunk:
+            break
+        counter.add(len(chunk))  # neues bytes-Objekt pro read()
+        buffer.extend(chunk)
+        while True:
+            start_idx = buffer.find(jpeg_start)
+            if start_idx == -1:
+                if len(buffer) > 500000:
+                    buffer = bytearray()
+                break
+            if start_idx > 0:
+                buffer = buffer[start_idx:]
+                counter.add(len(buffer))
+            end_idx = buffer.find(jpeg_end, 2)
+            if end_idx == -1:
+                break
+            jpeg_data = bytes(buffer[: end_idx + 2])
+            counter.add(2 * (end_idx + 2))  # Slice + bytes()
+            buffer = buffer[end_idx + 2:]
+            counter.add(len(buffer))
+            current_time = clock()
+            if current_time - last_frame_time >= target_frame_interval:
+                on_frame(jpeg_data)
+                last_frame_time = current_time
+
+
+class CountingExtractor(MJPEGFrameExtractor):
+    """MJPEGFrameExtractor mit Zählern für Frame-Kopien und Puffer-Verschiebungen"""
+
+    def __init__(self, *args, counter, **kwargs):
+        super().__init__(*args, **kwargs)
+        self.counter = counter
+
+    def _make_room(self):
+        end_before = self._end
+        super()._make_room()
+        if self._end != end_before and self._end:
+            self.counter.copied += self._end  # memmove im festen Puffer, keine Allokation
+
+    def _emit(self, start, end):
+        emitted_before = self.frames_emitted
+        super()._emit(start, end)
+        if self.frames_emitted != emitted_before:
+            self.counter.add(end - start)  # bytes() für das ausgegebene Frame
+
+
+def new_reader(stream, on_frame, fps_limit, clock, counter):
+    extractor = CountingExtractor(on_frame, max_fps=fps_limit or None, clock=clock, counter=counter)
+    extractor.run(stream)
+
+
+def run(name, reader, data, frames, fps_limit):
+    emitted = [0]
+
+    def on_frame(_jpeg):
+        emitted[0] += 1
+
+    # Durchsatz (die Zähler kosten in beiden Varianten gleich wenig)
+    counter = Counter()
+    start = time.perf_counter()
+    reader(io.BytesIO(data), on_frame, fps_limit, FakeClock(), counter)
+    elapsed = time.perf_counter() - start
+
+    # Speicher-Peak (separater Lauf, tracemalloc verlangsamt stark)
+    tracemalloc.start()
+    reader(io.BytesIO(data), lambda _jpeg: None, fps_limit, FakeClock(), Counter())
+    _current, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+
+    print(
+        f"{name:4s} {frames / elapsed:9.0f} Frames/s  {len(data) / elapsed / 1e6:7.1f} MB/s  "
+        f"ausgegeben {emitted[0]:5d}  "
+        f"Allokationen/Frame {counter.allocs / frames:6.2f}  "
+        f"kopiert/Frame {counter.copied / frames / 1024:7.1f} KB  "
+        f"Peak {peak / 1024:6.0f} KB"
+    )
+    return elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--frames", type=int, default=3000)
+    parser.add_argument("--frame-kb", type=int, default=40)
+    parser.add_argument("--fps-limit", type=float, default=10.0, help="Preview-FPS (0 = alle Frames ausgeben)")
+    args = parser.parse_args()
+
+    data = make_stream(args.frames, args.frame_kb)
+    print(f"{args.frames} Frames à {args.frame_kb} KB, Quelle 25 fps, Preview-Limit {args.fps_limit or 'aus'}")
+    legacy = run("alt", legacy_reader, data, args.frames, args.fps_limit)
+    new = run("neu", new_reader, data, args.frames, args.fps_limit)
+    print(f"Faktor: {legacy / new:.1f}x")
+
+
+if __name__ == "__main__":
+    main()
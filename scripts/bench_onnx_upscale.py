@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+Benchmark: Real-ESRGAN auf der CPU mit PyTorch vs. ONNX Runtime (fp32 und int8)
+
+Liest N Frames aus einem Video (Standard: erzeugter 720x576-Testclip wie DV), skaliert dieselben
+Frames mit allen drei Varianten und gibt Frames/s sowie die PSNR gegenüber der PyTorch-Ausgabe aus.
+Export und Quantisierung (nur beim ersten Lauf) zählen nicht zur Laufzeit.
+
+Aufruf:
+    python3 scripts/bench_onnx_upscale.py [--input band.avi] [--frames 20] [--model RealESRGAN_x4plus]
+        [--tile 400] [--threads 4] [--ffmpeg ffmpeg]
+"""
+
+import argparse
+import math
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+REALESRGAN_DIR = Path(__file__).resolve().parent.parent / "dv2plex" / "bin" / "realesrgan"
+sys.path.insert(0, str(REALESRGAN_DIR))
+
+import numpy as np  # noqa: E402
+import torch  # noqa: E402
+
+import inference_realesrgan_video as irv  # noqa: E402
+
+WIDTH, HEIGHT = 720, 576
+
+
+def read_frames(ffmpeg: str, video: str, count: int):
+    """count Frames als BGR-Arrays, auf 720x576 skaliert"""
+    cmd = [
+        ffmpeg, "-hide_banner", "-loglevel", "error", "-i", video,
+        "-vf", f"scale={WIDTH}:{HEIGHT}", "-frames:v", str(count),
+        "-f", "rawvideo", "-pix_fmt", "bgr24", "pipe:",
+    ]
+    data = subprocess.run(cmd, check=True, capture_output=True).stdout
+    frame_size = WIDTH * HEIGHT * 3
+    return [
+        np.frombuffer(data[i:i + frame_size], np.uint8).reshape(HEIGHT, WIDTH, 3)
+        for i in range(0, len(data) - frame_size + 1, frame_size)
+    ]
+
+
+def psnr(a: np.ndarray, b: np.ndarray) -> float:
+    mse = np.mean((a.astype(np.float64) - b.astype(np.float64)) ** 2)
+    return math.inf if mse == 0 else 10 * math.log10(255.0 ** 2 / mse)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--input", help="Video (Standard: testsrc2-Clip)")
+    parser.add_argument("--frames", type=int, default=20)
+    parser.add_argument("--model", default="RealESRGAN_x4plus")
+    parser.add_argument("--tile", type=int, default=400)
+    parser.add_argument("--threads", type=int, default=irv.physical_cores(), help="Threads (Standard: physische Kerne)")
+    parser.add_argument("--ffmpeg", default=shutil.which("ffmpeg") or "ffmpeg")
+    opts = parser.parse_args()
+
+    torch.set_num_threads(opts.threads)  # gilt auch für die ONNX-Session (intra-op threads)
+    with tempfile.TemporaryDirectory() as tmp:
+        video = opts.input
+        if not video:
+            video = str(Path(tmp) / "clip.mp4")
+            subprocess.run([
+                opts.ffmpeg, "-hide_banner", "-loglevel", "error",
+                "-f", "lavfi", "-i", f"testsrc2=size={WIDTH}x{HEIGHT}:rate=25:duration={opts.frames / 25 + 1}",
+                "-c:v", "libx264", "-crf", "18", "-pix_fmt", "yuv420p", "-y", video,
+            ], check=True)
+        frames = read_frames(opts.ffmpeg, video, opts.frames)
+
+    print(f"{len(frames)} Frames {WIDTH}x{HEIGHT}, Modell {opts.model} 2x, Tile {opts.tile}, {opts.threads} Threads")
+    reference = None
+    for name, extra in (("PyTorch fp32", ["--device", "cpu"]),
+                        ("ONNX fp32", ["--backend", "onnx"]),
+                        ("ONNX int8", ["--backend", "onnx", "--int8"])):
+        args = irv.build_parser().parse_args(
+            ["-n", opts.model, "-s", "2", "--tile", str(opts.tile), "--pre_pad", "0"] + extra)
+        device = irv.resolve_device(args)
+        upsampler, _ = irv.build_upsampler(args, device)
+        upsampler.enhance(frames[0], outscale=args.outscale)  # Aufwärmen (Allokationen, Graph-Optimierung)
+        start = time.perf_counter()
+        outputs = [upsampler.enhance(frame, outscale=args.outscale)[0] for frame in frames]
+        elapsed = time.perf_counter() - start
+        if reference is None:
+            reference = outputs
+            quality = "Referenz"
+        else:
+            quality = f"PSNR {np.mean([psnr(a, b) for a, b in zip(reference, outputs)]):6.2f} dB"
+        print(f"{name:13s} {len(frames) / elapsed:6.2f} Frames/s  {quality}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Benchmark: Merge-Encode in einem Prozess vs. chunk-parallel (MergeEngine.encode_workers)
+
+Erzeugt mit ffmpeg synthetische PAL-DV-Splits (testsrc2 + Sinuston), mergt sie einmal mit
+einem x264-Prozess und einmal in parallelen Chunks und vergleicht Laufzeit und Frame-Anzahl
+(der parallele Pfad prüft die Nahtstellen selbst und fällt sonst auf einen Prozess zurück).
+
+Aufruf:
+    python3 scripts/bench_parallel_merge.py [--ffmpeg ffmpeg] [--splits 8] [--seconds 60]
+        [--workers 0] [--timestamps burn]
+"""
+
+import argparse
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+
+from dv2plex.merge import MergeEngine  # noqa: E402
+from dv2plex.parallel_encode import resolve_workers  # noqa: E402
+
+
+def make_split(ffmpeg: str, path: Path, seconds: int, seed: int):
+    cmd = [
+        ffmpeg, "-hide_banner", "-loglevel", "error", "-nostdin",
+        "-f", "lavfi", "-i", f"testsrc2=size=720x576:rate=25:duration={seconds}",
+        "-f", "lavfi", "-i", f"sine=frequency={220 + seed * 40}:sample_rate=48000:duration={seconds}",
+        "-c:v", "dvvideo", "-pix_fmt", "yuv420p", "-c:a", "pcm_s16le", "-ac", "2",
+        "-y", str(path),
+    ]
+    subprocess.run(cmd, check=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--ffmpeg", default=shutil.which("ffmpeg") or "ffmpeg")
+    parser.add_argument("--splits", type=int, default=8, help="Anzahl Splits")
+    parser.add_argument("--seconds", type=int, default=60, help="Länge je Split in Sekunden")
+    parser.add_argument("--workers", type=int, default=0, help="Worker für den parallelen Lauf (0 = automatisch)")
+    parser.add_argument("--timestamps", choices=("burn", "soft", "off"), default="burn")
+    args = parser.parse_args()
+
+    workers = resolve_workers(args.workers)
+    if workers < 2:
+        workers = 2
+    with tempfile.TemporaryDirectory() as tmp:
+        splits_dir = Path(tmp) / "splits"
+        splits_dir.mkdir()
+        for n in range(args.splits):
+            make_split(args.ffmpeg, splits_dir / f"dvgrab-2001.06.30_01-{n:02d}-00.avi", args.seconds, n)
+        frames = args.splits * args.seconds * 25
+        print(f"{args.splits} Splits à {args.seconds} s ({frames} Frames), Timestamps: {args.timestamps}")
+
+        results = {}
+        for name, count in (("ein Prozess", 1), (f"{workers} Worker", workers)):
+            log = []
+            engine = MergeEngine(
+                Path(args.ffmpeg), log_callback=log.append, timestamp_mode=args.timestamps, encode_workers=count
+            )
+            output = Path(tmp) / f"merged_{count}.mp4"
+            start = time.perf_counter()
+            result = engine.merge_splits(splits_dir, output)
+            elapsed = time.perf_counter() - start
+            if not result:
+                print(f"{name}: Merge fehlgeschlagen")
+                print("\n".join(log[-10:]))
+                return 1
+            parallel = any("ohne Verlust an den Nahtstellen" in line for line in log)
+            results[count] = elapsed
+            print(
+                f"{name:12s} {elapsed:7.1f} s  {frames / elapsed:7.0f} Frames/s"
+                + ("  (Nahtstellen geprüft)" if parallel else "")
+            )
+        print(f"Faktor: {results[1] / results[workers]:.2f}x")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""
+Benchmark: Real-ESRGAN-Upscale zweistufig (2x-Zwischen-MP4, danach ffmpeg auf 4K) vs. fusioniert
+(Modell-Frames direkt in einen ffmpeg, der skaliert und final kodiert)
+
+Erzeugt mit ffmpeg einen kurzen SD-Clip (testsrc2 + Sinuston, 720x576), skaliert ihn mit beiden
+Varianten über UpscaleEngine und vergleicht Laufzeit und größten Temp-Platz (Zwischen-MP4).
+
+Aufruf:
+    python3 scripts/bench_upscale_pipeline.py --realesrgan dv2plex/bin/realesrgan/inference_realesrgan_video.py
+        [--ffmpeg ffmpeg] [--seconds 10] [--model RealESRGAN_x4plus] [--tile 400]
+"""
+
+import argparse
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+
+from dv2plex.upscale import UpscaleEngine  # noqa: E402
+
+
+def make_clip(ffmpeg: str, path: Path, seconds: int):
+    cmd = [
+        ffmpeg, "-hide_banner", "-loglevel", "error", "-nostdin",
+        "-f", "lavfi", "-i", f"testsrc2=size=720x576:rate=25:duration={seconds}",
+        "-f", "lavfi", "-i", f"sine=frequency=440:sample_rate=48000:duration={seconds}",
+        "-c:v", "libx264", "-crf", "20", "-pix_fmt", "yuv420p", "-c:a", "aac",
+        "-y", str(path),
+    ]
+    subprocess.run(cmd, check=True)
+
+
+def watch_temp_usage(stop: threading.Event, peak: list):
+    """Größter belegter Platz in realesrgan_video_*-Ordnern (Zwischenausgabe des Skripts)"""
+    tmp_root = Path(tempfile.gettempdir())
+    while not stop.wait(0.5):
+        used = sum(
+            f.stat().st_size
+            for d in tmp_root.glob("realesrgan_video_*")
+            for f in d.rglob("*")
+            if f.is_file()
+        )
+        peak[0] = max(peak[0], used)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--realesrgan", required=True, help="Pfad zu inference_realesrgan_video.py")
+    parser.add_argument("--ffmpeg", default=shutil.which("ffmpeg") or "ffmpeg")
+    parser.add_argument("--seconds", type=int, default=10, help="Länge des Test-Clips in Sekunden")
+    parser.add_argument("--model", default="RealESRGAN_x4plus")
+    parser.add_argument("--tile", type=int, default=400)
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        clip = Path(tmp) / "clip.mp4"
+        make_clip(args.ffmpeg, clip, args.seconds)
+        frames = args.seconds * 25
+        print(f"Test-Clip: {args.seconds} s, {frames} Frames, 720x576 → 3840x2160, Modell {args.model}")
+
+        results = {}
+        for name, fused in (("zweistufig", False), ("fusioniert", True)):
+            log = []
+            engine = UpscaleEngine(Path(args.realesrgan), ffmpeg_path=Path(args.ffmpeg), log_callback=log.append)
+            profile = {
+                "backend": "realesrgan",
+                "scale_factor": 4,
+                "model": args.model,
+                "tile_size": args.tile,
+                "encoder": "libx264",
+                "encoder_options": {"crf": 18, "preset": "veryfast", "tune": "film"},
+                "fused": fused,
+            }
+            output = Path(tmp) / f"out_{name}.mp4"
+            stop, peak = threading.Event(), [0]
+            watcher = threading.Thread(target=watch_temp_usage, args=(stop, peak), daemon=True)
+            watcher.start()
+            start = time.perf_counter()
+            ok = engine.upscale(clip, output, profile)
+            elapsed = time.perf_counter() - start
+            stop.set()
+            watcher.join()
+            if not ok:
+                print(f"{name}: Upscale fehlgeschlagen")
+                print("\n".join(log[-10:]))
+                return 1
+            results[name] = elapsed
+            print(
+                f"{name:11s} {elapsed:7.1f} s  {frames / elapsed:6.2f} Frames/s  "
+                f"Temp max. {peak[0] / 1e6:7.1f} MB  Ausgabe {output.stat().st_size / 1e6:.1f} MB"
+            )
+        print(f"Faktor: {results['zweistufig'] / results['fusioniert']:.2f}x")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -51,10 +51,15 @@ a = Analysis(
         # Real-ESRGAN Skripte und Module
         (str(realesrgan_dir / "inference_realesrgan_video.py"), "dv2plex/bin/realesrgan"),
         (str(realesrgan_dir / "inference_realesrgan.py"), "dv2plex/bin/realesrgan"),
+        (str(realesrgan_dir / "upscale_server.py"), "dv2plex/bin/realesrgan"),
+        (str(realesrgan_dir / "onnx_backend.py"), "dv2plex/bin/realesrgan"),
         (str(realesrgan_dir / "realesrgan"), "dv2plex/bin/realesrgan/realesrgan"),
         
         # Real-ESRGAN Optionen
         (str(realesrgan_dir / "options"), "dv2plex/bin/realesrgan/options"),
+        
+        # Kalibrierbilder für die int8-Quantisierung (ONNX-Backend)
+        (str(realesrgan_dir / "inputs"), "dv2plex/bin/realesrgan/inputs"),
     ],
     hiddenimports=[
         # Desktop Wrapper (pywebview)